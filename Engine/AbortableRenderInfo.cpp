@@ -56,6 +56,8 @@ struct AbortableRenderInfoPrivate
     bool canAbort;
     QAtomicInt aborted;
     U64 age;
+    RenderPriorityEnum priority;
+    AbortableRenderInfoPtr parent;
     mutable QMutex threadsMutex;
     ThreadSet threadsForThisRender;
     mutable QMutex timerMutex;
@@ -70,6 +72,8 @@ struct AbortableRenderInfoPrivate
         , canAbort(canAbort)
         , aborted()
         , age(age)
+        , priority(eRenderPriorityInteractive)
+        , parent()
         , threadsMutex()
         , threadsForThisRender()
         , timerMutex()
@@ -110,6 +114,18 @@ AbortableRenderInfo::getRenderAge() const
     return _imp->age;
 }
 
+void
+AbortableRenderInfo::setPriority(RenderPriorityEnum priority)
+{
+    _imp->priority = priority;
+}
+
+RenderPriorityEnum
+AbortableRenderInfo::getPriority() const
+{
+    return _imp->priority;
+}
+
 bool
 AbortableRenderInfo::canAbort() const
 {
@@ -119,7 +135,14 @@ AbortableRenderInfo::canAbort() const
 bool
 AbortableRenderInfo::isAborted() const
 {
-    return (int)_imp->aborted > 0;
+    return ( (int)_imp->aborted > 0 ) || ( _imp->parent && _imp->parent->isAborted() );
+}
+
+void
+AbortableRenderInfo::setParentRender(const AbortableRenderInfoPtr& parent)
+{
+    assert(parent.get() != this);
+    _imp->parent = parent;
 }
 
 void
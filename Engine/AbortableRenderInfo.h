@@ -104,9 +104,17 @@ public:
     // Is this render abortable ?
     bool canAbort() const;
 
-    // Is this render aborted ? This is extremely fast as it just dereferences an atomic integer
+    // Is this render aborted ? This is extremely fast as it just dereferences an atomic integer (and the one of the parent render if any)
     bool isAborted() const;
 
+    /**
+     * @brief Set the render this render belongs to, e.g: the sequential render a frame render is part of.
+     * When the parent render is aborted, this render is considered aborted as well, so that all renders
+     * of a sequence can be cancelled at once without querying the scheduler.
+     * This must be set before the render starts.
+     **/
+    void setParentRender(const AbortableRenderInfoPtr& parent);
+
     /**
      * @brief Set this render as aborted, cannot be reversed. This is call when the function GenericSchedulerThread::abortThreadedTask() is called
      **/
@@ -119,6 +127,14 @@ public:
      **/
     U64 getRenderAge() const;
 
+    /**
+     * @brief The priority class of this render. The tiles of renders of higher priority go ahead of the ones of renders
+     * of lower priority in the thread pool queue. By default a render has the interactive priority.
+     * This must be set before the render starts.
+     **/
+    void setPriority(RenderPriorityEnum priority);
+    RenderPriorityEnum getPriority() const;
+
     /**
      * @brief Registers the thread as part of this render request. Whenever AbortableThread::setAbortInfo is called, the thread is automatically registered
      * in this class as to be part of this render. This is used to monitor running threads for a specific render and to know if a thread has stalled when
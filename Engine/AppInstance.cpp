@@ -1221,6 +1221,15 @@ AppInstance::createNodeInternal(CreateNodeArgs& args)
 
             assert(ofxDesc);
             plugin->setOfxDesc(ofxDesc, ctx);
+        } else if ( plugin->isOfxPluginDeferred() ) {
+            // The plug-in is in the OpenFX plug-ins index but the OpenFX host could not load it
+            if (!isSilentCreation) {
+                errorDialog(tr("Error while creating node").toStdString(), tr("Failed to load the OpenFX plug-in %1.").arg(argsPluginID).toStdString(), false);
+            } else {
+                std::cerr << tr("Failed to load the OpenFX plug-in %1.").arg(argsPluginID).toStdString() << std::endl;
+            }
+
+            return NodePtr();
         }
     }
 
@@ -103,6 +103,7 @@
 #include "Global/FloatingPointExceptions.h"
 #endif
 
+#include "Engine/AbortableRenderInfo.h"
 #include "Engine/AppInstance.h"
 #include "Engine/Backdrop.h"
 #include "Engine/CLArgs.h"
@@ -117,6 +118,7 @@
 #include "Engine/Log.h"
 #include "Engine/MemoryInfo.h" // getSystemTotalRAM, printAsRAM
 #include "Engine/Node.h"
+#include "Engine/NonKeyParams.h" // getSizeOfForBitDepth
 #include "Engine/OfxImageEffectInstance.h"
 #include "Engine/OfxEffectInstance.h"
 #include "Engine/OfxHost.h"
@@ -594,6 +596,8 @@ AppManager::~AppManager()
     _imp->_nodeCache->waitForDeleterThread();
     _imp->_diskCache->waitForDeleterThread();
     _imp->_viewerCache->waitForDeleterThread();
+    _imp->pluginMemoryPool.reset();
+    _imp->convertedImagesCache.reset();
     _imp->_nodeCache.reset();
     _imp->_viewerCache.reset();
     _imp->_diskCache.reset();
@@ -1071,6 +1075,8 @@ AppManager::loadInternalAfterInitGui(const CLArgs& cl)
         _imp->_nodeCache = boost::make_shared<Cache<Image> >("NodeCache", NATRON_CACHE_VERSION, maxCacheRAM, 1.);
         _imp->_diskCache = boost::make_shared<Cache<Image> >("DiskCache", NATRON_CACHE_VERSION, maxDiskCacheNode, 0.);
         _imp->_viewerCache = boost::make_shared<Cache<FrameEntry> >("ViewerCache", NATRON_CACHE_VERSION, viewerCacheSize, 0.);
+        _imp->pluginMemoryPool.reset( new PluginMemoryPool() );
+        _imp->convertedImagesCache.reset( new ConvertedImagesCache() );
         _imp->setViewerCacheTileSize();
     } catch (std::logic_error) {
         // ignore
@@ -1208,7 +1214,12 @@ AppManagerPrivate::setViewerCacheTileSize()
     switch (viewerDepth) {
         case eImageBitDepthFloat:
         case eImageBitDepthHalf:
-            tileSize *= sizeof(float);
+            // Compressed tiles are stored as half-floats
+            if ( _settings->isViewerCacheTilesCompressionEnabled() ) {
+                tileSize *= getSizeOfForBitDepth(eImageBitDepthHalf);
+            } else {
+                tileSize *= sizeof(float);
+            }
             break;
         default:
             break;
@@ -1379,6 +1390,12 @@ AppManager::clearNodeCache()
     for (AppInstanceVec::iterator it = copy.begin(); it != copy.end(); ++it) {
         (*it)->clearAllLastRenderedImages();
     }
+    if (_imp->pluginMemoryPool) {
+        _imp->pluginMemoryPool->clear();
+    }
+    if (_imp->convertedImagesCache) {
+        _imp->convertedImagesCache->clear();
+    }
     _imp->_nodeCache->clear();
 }
 
@@ -1388,6 +1405,13 @@ AppManager::clearPluginsLoadedCache()
     _imp->ofxHost->clearPluginsLoadedCache();
 }
 
+void
+AppManager::loadDeferredOFXPlugin(const std::string& binaryFilePath,
+                                  const std::string& bundlePath)
+{
+    _imp->ofxHost->loadDeferredOFXPlugin(binaryFilePath, bundlePath);
+}
+
 void
 AppManager::clearAllCaches()
 {
@@ -2847,12 +2871,52 @@ AppManager::qt_tildeExpansion(const QString &path,
 
 #endif
 
+void
+AppManager::getNodeCacheMemoryUsage(std::size_t* size,
+                                    std::size_t* maximumSize) const
+{
+    if (!_imp->_nodeCache) {
+        *size = *maximumSize = 0;
+
+        return;
+    }
+    *size = _imp->_nodeCache->getMemoryCacheSize();
+    *maximumSize = _imp->_nodeCache->getMaximumMemorySize();
+}
+
+void
+AppManager::registerMemoryInNodeCache(std::size_t oldSize,
+                                      std::size_t newSize) const
+{
+    if (_imp->_nodeCache) {
+        _imp->_nodeCache->notifyEntrySizeChanged(oldSize, newSize);
+    }
+}
+
+std::size_t
+AppManager::releaseMemoryRegisteredInCache(const CacheAPI* cache,
+                                           std::size_t nBytes) const
+{
+    // Only the node cache accounts the plug-ins scratch buffers kept for reuse
+    if ( !_imp->pluginMemoryPool || (cache != _imp->_nodeCache.get()) ) {
+        return 0;
+    }
+
+    return _imp->pluginMemoryPool->trim(nBytes);
+}
+
 bool
 AppManager::isNodeCacheAlmostFull() const
 {
     std::size_t nodeCacheSize = _imp->_nodeCache->getMemoryCacheSize();
     std::size_t nodeMaxCacheSize = _imp->_nodeCache->getMaximumMemorySize();
 
+    // The plug-ins scratch buffers kept for reuse are freed before any image gets evicted, do not count them
+    if (_imp->pluginMemoryPool) {
+        std::size_t poolSize = _imp->pluginMemoryPool->getRetainedSize();
+        nodeCacheSize = poolSize > nodeCacheSize ? 0 : nodeCacheSize - poolSize;
+    }
+
     if (nodeMaxCacheSize == 0) {
         return true;
     }
@@ -2871,6 +2935,12 @@ AppManager::checkCacheFreeMemoryIsGoodEnough()
     size_t systemRAMToKeepFree = getSystemTotalRAM() * appPTR->getCurrentSettings()->getUnreachableRamPercent();
     size_t totalFreeRAM = getAmountFreePhysicalRAM();
 
+    if ( (totalFreeRAM <= systemRAMToKeepFree) && _imp->pluginMemoryPool && (_imp->pluginMemoryPool->getRetainedSize() > 0) ) {
+        // Release the plug-ins scratch buffers kept for reuse before evicting images
+        _imp->pluginMemoryPool->clear();
+        totalFreeRAM = getAmountFreePhysicalRAM();
+    }
+
     while (totalFreeRAM <= systemRAMToKeepFree) {
 #ifdef NATRON_DEBUG_CACHE
         qDebug() << "Total system free RAM is below the threshold:" << printAsRAM(totalFreeRAM)
@@ -3733,6 +3803,18 @@ AppManager::getGPUContextPool() const
     return _imp->renderingContextPool.get();
 }
 
+PluginMemoryPool*
+AppManager::getPluginMemoryPool() const
+{
+    return _imp->pluginMemoryPool.get();
+}
+
+ConvertedImagesCache*
+AppManager::getConvertedImagesCache() const
+{
+    return _imp->convertedImagesCache.get();
+}
+
 void
 AppManager::refreshOpenGLRenderingFlagOnAllInstances()
 {
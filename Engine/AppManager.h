@@ -452,6 +452,20 @@ public:
 
     bool isNodeCacheAlmostFull() const;
 
+    void getNodeCacheMemoryUsage(std::size_t* size, std::size_t* maximumSize) const;
+
+    /**
+     * @brief Accounts memory held outside of the node cache in its size, so that it counts against the cache memory budget.
+     * This is used for the plug-ins scratch buffers kept for reuse by the PluginMemoryPool.
+     **/
+    void registerMemoryInNodeCache(std::size_t oldSize, std::size_t newSize) const;
+
+    /**
+     * @brief Called by a cache before it evicts entries from memory: frees up to nBytes of the memory accounted in its size
+     * that is not held by entries, so that it goes first. Returns the amount of memory freed.
+     **/
+    std::size_t releaseMemoryRegisteredInCache(const CacheAPI* cache, std::size_t nBytes) const;
+
     bool isAggressiveCachingEnabled() const;
 
     void refreshDiskCacheLocation();
@@ -495,6 +509,8 @@ public:
     AppTLS* getAppTLS() const;
     const OfxHost* getOFXHost() const;
     GPUContextPool* getGPUContextPool() const;
+    PluginMemoryPool* getPluginMemoryPool() const;
+    ConvertedImagesCache* getConvertedImagesCache() const;
 
 
     /**
@@ -614,6 +630,9 @@ public Q_SLOTS:
 
     void clearPluginsLoadedCache();
 
+    // Loads an OpenFX bundle whose plug-ins were registered from the plug-ins index, see OfxHost::loadDeferredOFXPlugin
+    void loadDeferredOFXPlugin(const std::string& binaryFilePath, const std::string& bundlePath);
+
     void clearAllCaches();
 
     void wipeAndCreateDiskCacheStructure();
@@ -133,6 +133,8 @@ AppManagerPrivate::AppManagerPrivate()
     , hasInitializedOpenGLFunctions(false)
     , openGLFunctionsMutex()
     , renderingContextPool()
+    , pluginMemoryPool()
+    , convertedImagesCache()
     , openGLRenderers()
 {
     setMaxCacheFiles();
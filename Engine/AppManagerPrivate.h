@@ -36,6 +36,7 @@
 #include <QtCore/QMutex>
 #include <QtCore/QString>
 #include <QtCore/QAtomicInt>
+#include <QtCore/QWaitCondition>
 #include <QtCore/QCoreApplication>
 
 
@@ -52,6 +53,8 @@
 #include "Engine/FrameEntry.h"
 #include "Engine/Image.h"
 #include "Engine/GPUContextPool.h"
+#include "Engine/PluginMemoryPool.h"
+#include "Engine/ConvertedImagesCache.h"
 #include "Engine/GenericSchedulerThreadWatcher.h"
 #include "Engine/TLSHolder.h"
 
@@ -196,6 +199,12 @@ public:
 #endif
 
     boost::scoped_ptr<GPUContextPool> renderingContextPool;
+
+    // The scratch buffers of the plug-ins kept for reuse
+    boost::scoped_ptr<PluginMemoryPool> pluginMemoryPool;
+
+    // The input images converted to the format expected by the effects, shared by the renders using them
+    boost::scoped_ptr<ConvertedImagesCache> convertedImagesCache;
     std::list<OpenGLRendererInfo> openGLRenderers;
     boost::scoped_ptr<QCoreApplication> _qApp;
 
@@ -779,6 +779,7 @@ private:
         ///Before allocating the memory check that there's enough space to fit in memory
         appPTR->checkCacheFreeMemoryIsGoodEnough();
 
+        releaseMemoryRegisteredIfFull();
 
         ///Just in case, we don't allow more than X files to be removed at once.
         int safeCounter = 0;
@@ -1128,6 +1129,8 @@ public:
 
     void clearExceedingEntries()
     {
+        releaseMemoryRegisteredIfFull();
+
         ///Make sure the shared_ptrs live in this list and are destroyed not while under the lock
         ///so that the memory freeing (which might be expensive for large images) doesn't happen while under the lock
         std::list<EntryTypePtr> entriesToBeDeleted;
@@ -1199,6 +1202,25 @@ public:
         }
     }
 
+    /**
+     * @brief If the in-memory portion of the cache is over its limit, frees the memory accounted in the cache that is not
+     * held by entries (see AppManager::registerMemoryInNodeCache) before any entry gets evicted.
+     * _lock must not be taken here.
+     **/
+    void releaseMemoryRegisteredIfFull() const
+    {
+        U64 memoryCacheSize, maximumInMemorySize;
+        {
+            QMutexLocker k(&_sizeLock);
+            memoryCacheSize = _memoryCacheSize;
+            maximumInMemorySize = std::max( (std::size_t)1, _maximumInMemorySize );
+        }
+        U64 limit = (U64)(maximumInMemorySize * NATRON_CACHE_LIMIT_PERCENT);
+        if (memoryCacheSize > limit) {
+            appPTR->releaseMemoryRegisteredInCache(this, memoryCacheSize - limit);
+        }
+    }
+
     /**
      * @brief Removes the last recently used entry from the in-memory cache.
      * This is expensive since it takes the lock. Returns false
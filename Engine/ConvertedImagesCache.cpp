@@ -0,0 +1,214 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "ConvertedImagesCache.h"
+
+#include <map>
+#include <list>
+
+#include <QtCore/QMutex>
+
+#include "Engine/Image.h"
+
+NATRON_NAMESPACE_ENTER
+
+namespace {
+struct ConvertedImage
+{
+    // The source image is checked against the entry, since another image may be allocated at the same address
+    ImageWPtr source;
+    RectI sourceBounds;
+    ImageWPtr converted;
+    RectI convertedRect;
+};
+
+typedef std::map<ConvertedImagesCache::ConversionKey, ConvertedImage> ConversionsMap;
+typedef std::map<const Image*, ConversionsMap> ConvertedImagesMap;
+}
+
+struct ConvertedImagesCache::Implementation
+{
+    QMutex lock;
+    ConvertedImagesMap images;
+
+    Implementation()
+        : lock()
+        , images()
+    {
+    }
+
+    // Drops the entries of the source images that were released
+    void removeExpiredEntries()
+    {
+        ConvertedImagesMap::iterator it = images.begin();
+        while ( it != images.end() ) {
+            ConversionsMap::iterator it2 = it->second.begin();
+            while ( it2 != it->second.end() ) {
+                if ( it2->second.source.expired() ) {
+                    it->second.erase(it2++);
+                } else {
+                    ++it2;
+                }
+            }
+            if ( it->second.empty() ) {
+                images.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+    }
+};
+
+ConvertedImagesCache::ConversionKey::ConversionKey()
+    : targetComponents()
+    , targetDepth(eImageBitDepthNone)
+    , srcColorSpace(eViewerColorSpaceLinear)
+    , dstColorSpace(eViewerColorSpaceLinear)
+    , channelForAlpha(-1)
+    , useAlpha0(false)
+    , unPremult(false)
+{
+}
+
+bool
+ConvertedImagesCache::ConversionKey::operator<(const ConversionKey& other) const
+{
+    if (targetDepth != other.targetDepth) {
+        return targetDepth < other.targetDepth;
+    }
+    if (srcColorSpace != other.srcColorSpace) {
+        return srcColorSpace < other.srcColorSpace;
+    }
+    if (dstColorSpace != other.dstColorSpace) {
+        return dstColorSpace < other.dstColorSpace;
+    }
+    if (channelForAlpha != other.channelForAlpha) {
+        return channelForAlpha < other.channelForAlpha;
+    }
+    if (useAlpha0 != other.useAlpha0) {
+        return !useAlpha0;
+    }
+    if (unPremult != other.unPremult) {
+        return !unPremult;
+    }
+    // ImagePlaneDesc::operator< only compares the plane ID, which is the same for all the color planes
+    if ( targetComponents.getNumComponents() != other.targetComponents.getNumComponents() ) {
+        return targetComponents.getNumComponents() < other.targetComponents.getNumComponents();
+    }
+
+    return targetComponents < other.targetComponents;
+}
+
+ConvertedImagesCache::ConvertedImagesCache()
+    : _imp( new Implementation() )
+{
+}
+
+ConvertedImagesCache::~ConvertedImagesCache()
+{
+}
+
+ImagePtr
+ConvertedImagesCache::get(const ImagePtr& source,
+                          const ConversionKey& key,
+                          const RectI& roi,
+                          RectI* roiToConvert)
+{
+    *roiToConvert = roi;
+
+    bool convertedBefore = false;
+    {
+        QMutexLocker k(&_imp->lock);
+        ConvertedImagesMap::iterator found = _imp->images.find( source.get() );
+        if ( found == _imp->images.end() ) {
+            return ImagePtr();
+        }
+        ConversionsMap::iterator foundConversion = found->second.find(key);
+        if ( foundConversion == found->second.end() ) {
+            return ImagePtr();
+        }
+
+        ConvertedImage& entry = foundConversion->second;
+        if ( (entry.source.lock() != source) || (entry.sourceBounds != source->getBounds()) ) {
+            // The source was released or resized since
+            found->second.erase(foundConversion);
+            if ( found->second.empty() ) {
+                _imp->images.erase(found);
+            }
+
+            return ImagePtr();
+        }
+
+        ImagePtr converted = entry.converted.lock();
+        if ( converted && entry.convertedRect.contains(roi) ) {
+            return converted;
+        }
+        convertedBefore = true;
+    }
+
+    // The image is fetched with several regions (e.g: by several tiles), convert it entirely if all its pixels are valid.
+    // Images without a bitmap do not tell which pixels were rendered.
+    if ( convertedBefore && source->usesBitMap() ) {
+        std::list<RectI> restToRender;
+        source->getRestToRender(source->getBounds(), restToRender);
+        if ( restToRender.empty() ) {
+            *roiToConvert = source->getBounds();
+        }
+    }
+
+    return ImagePtr();
+} // ConvertedImagesCache::get
+
+void
+ConvertedImagesCache::insert(const ImagePtr& source,
+                             const ConversionKey& key,
+                             const ImagePtr& converted,
+                             const RectI& convertedRect)
+{
+    QMutexLocker k(&_imp->lock);
+
+    _imp->removeExpiredEntries();
+
+    ConvertedImage& entry = _imp->images[source.get()][key];
+    ImagePtr existing = entry.converted.lock();
+    if ( existing && (entry.source.lock() == source) && (entry.sourceBounds == source->getBounds()) && entry.convertedRect.contains(convertedRect) ) {
+        // Another thread converted a larger region meanwhile
+        return;
+    }
+    entry.source = source;
+    entry.sourceBounds = source->getBounds();
+    entry.converted = converted;
+    entry.convertedRect = convertedRect;
+}
+
+void
+ConvertedImagesCache::clear()
+{
+    QMutexLocker k(&_imp->lock);
+
+    _imp->images.clear();
+}
+
+NATRON_NAMESPACE_EXIT
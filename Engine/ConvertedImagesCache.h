@@ -0,0 +1,94 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef Natron_Engine_ConvertedImagesCache_h
+#define Natron_Engine_ConvertedImagesCache_h
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#if !defined(Q_MOC_RUN) && !defined(SBK_RUN)
+#include <boost/scoped_ptr.hpp>
+#endif
+
+#include "Global/Enums.h"
+
+#include "Engine/ImagePlaneDesc.h"
+#include "Engine/RectI.h"
+#include "Engine/EngineFwd.h"
+
+NATRON_NAMESPACE_ENTER
+
+/**
+ * @brief Keeps track of the images converted to other components or bit depth by EffectInstance::convertPlanesFormatsIfNeeded,
+ * so that an input image fetched with the same conversion from several tiles or threads is converted once.
+ * Only weak references are held: a converted image lives as long as a render uses it, and an entry is dropped
+ * once its source image is released.
+ **/
+class ConvertedImagesCache
+{
+public:
+
+    struct ConversionKey
+    {
+        ImagePlaneDesc targetComponents;
+        ImageBitDepthEnum targetDepth;
+        ViewerColorSpaceEnum srcColorSpace;
+        ViewerColorSpaceEnum dstColorSpace;
+        int channelForAlpha;
+        bool useAlpha0;
+        bool unPremult;
+
+        ConversionKey();
+
+        bool operator<(const ConversionKey& other) const;
+    };
+
+    ConvertedImagesCache();
+
+    ~ConvertedImagesCache();
+
+    /**
+     * @brief Returns the conversion of the source image if it is still in use and covers roi.
+     * Otherwise returns NULL and sets roiToConvert to the region that should be converted and inserted:
+     * this is roi, or the bounds of the source image if it was already converted for another region and
+     * all its pixels are rendered.
+     **/
+    ImagePtr get(const ImagePtr& source, const ConversionKey& key, const RectI& roi, RectI* roiToConvert);
+
+    /**
+     * @brief Registers the conversion of the given region of the source image
+     **/
+    void insert(const ImagePtr& source, const ConversionKey& key, const ImagePtr& converted, const RectI& convertedRect);
+
+    void clear();
+
+private:
+
+    struct Implementation;
+    boost::scoped_ptr<Implementation> _imp;
+};
+
+NATRON_NAMESPACE_EXIT
+
+#endif // Natron_Engine_ConvertedImagesCache_h
@@ -391,6 +391,27 @@ EffectInstance::getParallelRenderArgsTLS() const
     return tls->frameArgs.back();
 }
 
+const KnobValuesSnapshot*
+EffectInstance::getKnobValuesSnapshotTLS(double* currentTime,
+                                         ViewIdx* currentView) const
+{
+    EffectTLSDataPtr tls = _imp->tlsData->getTLSData();
+
+    if ( !tls || tls->frameArgs.empty() || !tls->frameArgs.back()->knobValues ) {
+        return 0;
+    }
+    const ParallelRenderArgsPtr& frameArgs = tls->frameArgs.back();
+    if (tls->currentRenderArgs.validArgs) {
+        *currentTime = tls->currentRenderArgs.time;
+        *currentView = tls->currentRenderArgs.view;
+    } else {
+        *currentTime = frameArgs->time;
+        *currentView = frameArgs->view;
+    }
+
+    return frameArgs->knobValues.get();
+}
+
 U64
 EffectInstance::getHash() const
 {
@@ -422,62 +443,28 @@ EffectInstance::getRenderHash() const
 
 bool
 EffectInstance::Implementation::aborted(bool isRenderResponseToUserInteraction,
-                                        const AbortableRenderInfoPtr& abortInfo,
-                                        const EffectInstancePtr& treeRoot)
+                                        const AbortableRenderInfo* abortInfo)
 {
-    if (!isRenderResponseToUserInteraction) {
-        // Rendering is playback or render on disk
-
-        // If we have abort info, e just peek the atomic int inside the abort info, this is very fast
-        if ( abortInfo && abortInfo->isAborted() ) {
-            return true;
-        }
-
-        // Fallback on the flag set on the node that requested the render in OutputSchedulerThread
-        if (treeRoot) {
-            OutputEffectInstance* effect = dynamic_cast<OutputEffectInstance*>( treeRoot.get() );
-            assert(effect);
-            if (effect) {
-                return effect->isSequentialRenderBeingAborted();
-            }
-        }
-
+    if (!abortInfo) {
         // We have no other means to know if abort was called
         return false;
-    } else {
-        // This is a render issued to refresh the image on the Viewer
-
-        if ( !abortInfo || !abortInfo->canAbort() ) {
-            // We do not have any abortInfo set or this render is not abortable. This should be avoided as much as possible!
-            return false;
-        }
-
-        // This is very fast, we just peek the atomic int inside the abort info
-        if ( (int)abortInfo->isAborted() ) {
-            return true;
-        }
-
-        // If this node can start sequential renders (e.g: start playback like on the viewer or render on disk) and it is already doing a sequential render, abort
-        // this render
-        OutputEffectInstance* isRenderEffect = dynamic_cast<OutputEffectInstance*>( treeRoot.get() );
-        if (isRenderEffect) {
-            if ( isRenderEffect->isDoingSequentialRender() ) {
-                return true;
-            }
-        }
+    }
 
-        // The render was not aborted
+    if ( isRenderResponseToUserInteraction && !abortInfo->canAbort() ) {
+        // This render is issued to refresh the image on the Viewer but is not abortable. This should be avoided as much as possible!
         return false;
     }
+
+    // This is very fast, we just peek the atomic int inside the abort info and the ones of its parent renders:
+    // sequential renders and current frame renders are cancelled through their parent render, see RenderEngine::getCurrentFrameRendersAbortInfo()
+    return abortInfo->isAborted();
 }
 
 bool
 EffectInstance::aborted() const
 {
-    QThread* thisThread = QThread::currentThread();
-
     /* If this thread is an AbortableThread, this function will be extremely fast*/
-    AbortableThread* isAbortableThread = dynamic_cast<AbortableThread*>(thisThread);
+    AbortableThread* isAbortableThread = AbortableThread::getCurrentAbortableThread();
 
     /**
        The solution here is to store per-render info on the thread that we retrieve.
@@ -488,35 +475,34 @@ EffectInstance::aborted() const
        threads spawned from the thread pool may not.
      **/
     bool isRenderUserInteraction;
-    AbortableRenderInfoPtr abortInfo;
-    EffectInstancePtr treeRoot;
+    const AbortableRenderInfo* token = 0;
 
+    if ( isAbortableThread && isAbortableThread->getCancellationToken(&isRenderUserInteraction, &token) ) {
+        return Implementation::aborted(isRenderUserInteraction, token);
+    }
 
-    if ( !isAbortableThread || !isAbortableThread->getAbortInfo(&isRenderUserInteraction, &abortInfo, &treeRoot) ) {
-        // If this thread is not abortable or we did not set the abort info for this render yet, retrieve them from the TLS of this node.
-        EffectTLSDataPtr tls = _imp->tlsData->getTLSData();
-        if (!tls) {
-            return false;
-        }
-        if ( tls->frameArgs.empty() ) {
-            return false;
-        }
-        const ParallelRenderArgsPtr & args = tls->frameArgs.back();
-        isRenderUserInteraction = args->isRenderResponseToUserInteraction;
-        abortInfo = args->abortInfo.lock();
+    // If this thread is not abortable or we did not set the abort info for this render yet, retrieve them from the TLS of this node.
+    EffectTLSDataPtr tls = _imp->tlsData->getTLSData();
+    if (!tls) {
+        return false;
+    }
+    if ( tls->frameArgs.empty() ) {
+        return false;
+    }
+    const ParallelRenderArgsPtr & args = tls->frameArgs.back();
+    isRenderUserInteraction = args->isRenderResponseToUserInteraction;
+    AbortableRenderInfoPtr abortInfo = args->abortInfo.lock();
+
+    if (isAbortableThread) {
+        EffectInstancePtr treeRoot;
         if (args->treeRoot) {
             treeRoot = args->treeRoot->getEffectInstance();
         }
-
-        if (isAbortableThread) {
-            isAbortableThread->setAbortInfo(isRenderUserInteraction, abortInfo, treeRoot);
-        }
+        isAbortableThread->setAbortInfo(isRenderUserInteraction, abortInfo, treeRoot);
     }
 
     // The internal function that given a AbortableRenderInfoPtr determines if a render was aborted or not
-    return Implementation::aborted(isRenderUserInteraction,
-                                   abortInfo,
-                                   treeRoot);
+    return Implementation::aborted( isRenderUserInteraction, abortInfo.get() );
 } // EffectInstance::aborted
 
 bool
@@ -752,6 +738,34 @@ EffectInstance::getImage(int inputNb,
         }
     }
 
+    // If the same image was already fetched while rendering the current render window, return it directly.
+    // OpenGL textures are not kept since they are bound to the context of the render.
+    const bool useFetchedImages = tls && tls->currentRenderArgs.validArgs && returnStorage == eStorageModeRAM;
+    FetchedImageKey fetchedImageKey;
+    if (useFetchedImages) {
+        fetchedImageKey.inputNb = inputNb;
+        fetchedImageKey.time = time;
+        fetchedImageKey.view = view;
+        fetchedImageKey.scale = scale;
+        if (layer) {
+            fetchedImageKey.layer = *layer;
+        }
+        fetchedImageKey.mapToClipPrefs = mapToClipPrefs;
+        fetchedImageKey.dontUpscale = dontUpscale;
+        fetchedImageKey.hasBounds = optionalBoundsParam != 0;
+        if (optionalBoundsParam) {
+            fetchedImageKey.bounds = *optionalBoundsParam;
+        }
+        FetchedImagesMap::const_iterator found = tls->currentRenderArgs.fetchedImages.find(fetchedImageKey);
+        if ( found != tls->currentRenderArgs.fetchedImages.end() ) {
+            if (roiPixel) {
+                *roiPixel = found->second.roiPixel;
+            }
+
+            return found->second.image;
+        }
+    }
+
     NodePtr node = getNode();
 
     if (!inputEffect) {
@@ -1150,7 +1164,10 @@ EffectInstance::getImage(int inputNb,
 
 
     if (mapToClipPrefs) {
-        inputImg = convertPlanesFormatsIfNeeded(getApp(), inputImg, pixelRoI, clipPrefComps, depth, node->usesAlpha0ToConvertFromRGBToRGBA(), outputPremult, channelForMask);
+        // Share the conversion with the other tiles and threads fetching the same image, unless the image
+        // is being updated by a paint stroke
+        inputImg = convertPlanesFormatsIfNeeded(getApp(), inputImg, pixelRoI, clipPrefComps, depth, node->usesAlpha0ToConvertFromRGBToRGBA(), outputPremult, channelForMask,
+                                                !duringPaintStroke /*useConvertedImagesCache*/);
     }
 
 #ifdef DEBUG
@@ -1173,6 +1190,13 @@ EffectInstance::getImage(int inputNb,
         tls->currentRenderArgs.inputImages[inputNb].push_back(inputImg);
     }
 
+    // The returned pixel RoI depends on roiPixel being set when the image was upscaled, only keep complete results
+    if (useFetchedImages && roiPixel) {
+        FetchedImage& fetched = tls->currentRenderArgs.fetchedImages[fetchedImageKey];
+        fetched.image = inputImg;
+        fetched.roiPixel = *roiPixel;
+    }
+
     return inputImg;
 } // getImage
 
@@ -2176,8 +2200,10 @@ EffectInstance::Implementation::tiledRenderingFunctor(EffectInstance::Implementa
                                                                         args.processChannels,
                                                                         args.planes);
 
-    //Exit of the host frame threading thread
-    appPTR->getAppTLS()->cleanupTLSForThread();
+    //Exit of the host frame threading thread. The calling thread also renders tiles: keep its thread-local storage
+    if (callingThread != curThread) {
+        appPTR->getAppTLS()->cleanupTLSForThread();
+    }
 
     return ret;
 }
@@ -2289,6 +2315,11 @@ EffectInstance::Implementation::tiledRenderingFunctor(const RectToRender & rectT
         maskImage = foundMaskInput->second.front();
     }
 
+    // Resolve all the planes needed by multi-planar effects in one go, before the render action requests them one at a time
+    if ( !rectToRender.isIdentity && !planes->useOpenGL && compsNeeded && _publicInterface->isMultiPlanar() ) {
+        prefetchInputImages(time, view, renderMappedMipMapLevel, *compsNeeded);
+    }
+
 #ifndef NDEBUG
     RenderScale scale( Image::getScaleFromMipMapLevel(mipMapLevel) );
     // check the dimensions of all input and output images
@@ -2380,6 +2411,34 @@ EffectInstance::Implementation::tiledRenderingFunctor(const RectToRender & rectT
     }
 } // EffectInstance::tiledRenderingFunctor
 
+void
+EffectInstance::Implementation::prefetchInputImages(double time,
+                                                    ViewIdx view,
+                                                    unsigned int mipMapLevel,
+                                                    const ComponentsNeededMap& compsNeeded)
+{
+    RenderScale scale( Image::getScaleFromMipMapLevel(mipMapLevel) );
+
+    for (ComponentsNeededMap::const_iterator it = compsNeeded.begin(); it != compsNeeded.end(); ++it) {
+        // Only inputs from which several planes are fetched benefit from it, -1 is the output
+        if ( (it->first < 0) || (it->second.size() < 2) ) {
+            continue;
+        }
+        for (std::list<ImagePlaneDesc>::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
+            if ( _publicInterface->aborted() ) {
+                return;
+            }
+            // Fetch the images the way the render action will: the color plane mapped to the clip preferences, other planes as is.
+            // The images were rendered by renderInputImagesForRoI, this only resolves them into the fetched images table.
+            RectI roiPixel;
+            Transform::Matrix3x3Ptr transform;
+            ImagePtr image = _publicInterface->getImage(it->first, time, scale, view, NULL, &(*it2), it2->isColorPlane(), false /*dontUpscale*/,
+                                                        eStorageModeRAM, NULL /*textureDepth*/, &roiPixel, &transform);
+            Q_UNUSED(image);
+        }
+    }
+}
+
 EffectInstance::RenderingFunctorRetEnum
 EffectInstance::Implementation::renderHandler(const EffectTLSDataPtr& tls,
                                               const unsigned int mipMapLevel,
@@ -3068,6 +3127,10 @@ EffectInstance::evaluate(bool isSignificant,
     NodePtr node = getNode();
 
     if ( refreshMetadatas && node->isNodeCreated() ) {
+        if (!isSignificant) {
+            // The hash is only updated for significant changes
+            clearMetadataActionCache();
+        }
         refreshMetadata_public(true);
     }
 
@@ -3901,6 +3964,18 @@ EffectInstance::getRegionOfDefinition_public(U64 hash,
             return preferredInput->getEffectInstance()->getRegionOfDefinition_public(preferredInput->getEffectInstance()->getRenderHash(), time, scale, view, rod, isProjectFormat);
         }
 
+        // If neither this node nor its inputs are frame varying or animated, the RoD only depends on the hash
+        // and the result computed for another frame can be re-used
+        const bool isTimeInvariant = !isFrameVaryingOrAnimated_Recursive();
+        if ( isTimeInvariant && _imp->actionsCache->getTimeInvariantRoDResult(hash, view, mipMapLevel, rod) ) {
+            _imp->actionsCache->setRoDResult(hash, time, view, mipMapLevel, *rod);
+            if (isProjectFormat) {
+                *isProjectFormat = false;
+            }
+
+            return eStatusOK;
+        }
+
         StatusEnum ret;
         RenderScale scaleOne(1.);
         {
@@ -3936,6 +4011,9 @@ EffectInstance::getRegionOfDefinition_public(U64 hash,
 
         //if (!isDuringStrokeCreation) {
         _imp->actionsCache->setRoDResult(hash, time, view,  mipMapLevel, *rod);
+        if (isTimeInvariant) {
+            _imp->actionsCache->setTimeInvariantRoDResult(hash, view, mipMapLevel, *rod);
+        }
 
         //}
         return ret;
@@ -4232,6 +4310,19 @@ void
 EffectInstance::clearActionsCache()
 {
     _imp->actionsCache->clearAll();
+    _imp->renderPlanCache->clearAll();
+}
+
+void
+EffectInstance::clearRenderPlanCache()
+{
+    _imp->renderPlanCache->clearAll();
+}
+
+void
+EffectInstance::clearMetadataActionCache()
+{
+    _imp->actionsCache->clearMetadataResults();
 }
 
 
@@ -5116,6 +5207,8 @@ EffectInstance::onNodeHashChanged(U64 hash)
 {
     ///Invalidate actions cache
     _imp->actionsCache->invalidateAll(hash);
+    // Plans of the previous hash will never be used again, release the nodes they hold
+    _imp->renderPlanCache->clearAll();
 
     const KnobsVec & knobs = getKnobs();
     for (KnobsVec::const_iterator it = knobs.begin(); it != knobs.end(); ++it) {
@@ -5293,6 +5386,19 @@ EffectInstance::isPaintingOverItselfEnabled() const
 StatusEnum
 EffectInstance::getPreferredMetadata_public(NodeMetadata& metadata)
 {
+    bool mustSyncPrivateData;
+    {
+        QMutexLocker l(&_imp->mustSyncPrivateDataMutex);
+        mustSyncPrivateData = _imp->mustSyncPrivateData;
+    }
+
+    // The metadata only change with the hash: a previous refresh with the same hash is re-used,
+    // unless the plug-in must first sync its private data
+    const U64 hash = getHash();
+    if ( !mustSyncPrivateData && _imp->actionsCache->getMetadataResult(hash, &metadata) ) {
+        return eStatusOK;
+    }
+
     StatusEnum stat = getDefaultMetadata(metadata);
 
     if (stat == eStatusFailed) {
@@ -5300,7 +5406,6 @@ EffectInstance::getPreferredMetadata_public(NodeMetadata& metadata)
     }
     if (!getNode()->isNodeDisabled()) {
         // call syncPrivateData if necessary
-        bool mustSyncPrivateData;
         {
             QMutexLocker l(&_imp->mustSyncPrivateDataMutex);
             mustSyncPrivateData = _imp->mustSyncPrivateData;
@@ -5315,10 +5420,13 @@ EffectInstance::getPreferredMetadata_public(NodeMetadata& metadata)
                 effect->onSyncPrivateDataRequested(); //syncPrivateData_other_thread();
             }
         }
-        return getPreferredMetadata(metadata);
+        stat = getPreferredMetadata(metadata);
+    }
+    if (stat != eStatusFailed) {
+        _imp->actionsCache->setMetadataResult(hash, metadata);
     }
-    return stat;
 
+    return stat;
 }
 
 static int
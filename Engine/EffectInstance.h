@@ -686,6 +686,22 @@ public:
 
     ParallelRenderArgsPtr getParallelRenderArgsTLS() const;
 
+    /**
+     * @brief If the current thread renders a frame for which the parameter values were captured, returns them along with the
+     * current time and view of the thread, otherwise returns NULL. The snapshot is valid until the render of the frame ends.
+     **/
+    const KnobValuesSnapshot* getKnobValuesSnapshotTLS(double* currentTime, ViewIdx* currentView) const;
+
+    /**
+     * @brief Called when the render of a frame in which this effect takes part starts, to capture the values of the parameters
+     * that may be read without locking during the render. Returns NULL by default: the values are read from the knobs.
+     **/
+    virtual KnobValuesSnapshotPtr captureKnobValues(double /*time*/,
+                                                    ViewIdx /*view*/) const
+    {
+        return KnobValuesSnapshotPtr();
+    }
+
     //Implem in ParallelRenderArgs.cpp
     static StatusEnum getInputsRoIsFunctor(bool useTransforms,
                                            double time,
@@ -1223,6 +1239,17 @@ public:
 
     void clearActionsCache();
 
+    /**
+     * @brief Forgets the request passes made with this effect as tree root, releasing the nodes upstream they reference.
+     **/
+    void clearRenderPlanCache();
+
+    /**
+     * @brief Forgets the metadata computed for all the hashes of this node, so that the next metadata refresh
+     * calls getPreferredMetadata again. Called when something the metadata depend on, but not the hash, changed.
+     **/
+    void clearMetadataActionCache();
+
     /**
      * @brief Use this function to post a transient message to the user. It will be displayed using
      * a dialog. The message can be of 4 types...
@@ -1845,6 +1872,32 @@ public:
                                    const RenderScale & scale,
                                    RoIMap* inputRois,
                                    std::map<int, EffectInstancePtr>* reroutesMap);
+    /**
+     * @brief Identifies a getImage() call made from the render action
+     **/
+    struct FetchedImageKey
+    {
+        int inputNb;
+        double time;
+        ViewIdx view;
+        RenderScale scale;
+        ImagePlaneDesc layer; //< empty if the clip preferences were requested
+        bool mapToClipPrefs;
+        bool dontUpscale;
+        bool hasBounds;
+        RectD bounds;
+
+        bool operator<(const FetchedImageKey& other) const;
+    };
+
+    struct FetchedImage
+    {
+        ImagePtr image;
+        RectI roiPixel;
+    };
+
+    typedef std::map<FetchedImageKey, FetchedImage> FetchedImagesMap;
+
     struct RenderArgs
     {
         RectD rod; //!< the effect's RoD in CANONICAL coordinates
@@ -1866,6 +1919,10 @@ public:
         InputMatrixMapPtr transformRedirections;
         bool isDoingOpenGLRender;
 
+        // The images returned by getImage() while rendering the render window, so that fetching the same
+        // plane again (e.g: in the render action of another plane) does not go through renderRoI again
+        FetchedImagesMap fetchedImages;
+
         RenderArgs();
 
         RenderArgs(const RenderArgs & o);
@@ -2186,7 +2243,8 @@ private:
                                                                  ImageBitDepthEnum targetDepth,
                                                                  bool useAlpha0ForRGBToRGBAConversion,
                                                                  ImagePremultiplicationEnum outputPremult,
-                                                                 int channelForAlpha);
+                                                                 int channelForAlpha,
+                                                                 bool useConvertedImagesCache = false);
 
 
     /**
@@ -42,7 +42,11 @@ ActionsCache::ActionsCacheInstance::ActionsCacheInstance()
     , _timeDomainSet(false)
     , _identityCache()
     , _rodCache()
+    , _timeInvariantRodCache()
     , _framesNeededCache()
+    , _componentsNeededCache()
+    , _metadata()
+    , _metadataSet(false)
 {
 }
 
@@ -260,6 +264,52 @@ ActionsCache::setRoDResult(U64 hash,
     cache._rodCache[key] = rod;
 }
 
+bool
+ActionsCache::getTimeInvariantRoDResult(U64 hash,
+                                        ViewIdx view,
+                                        unsigned int mipMapLevel,
+                                        RectD* rod)
+{
+    QMutexLocker l(&_cacheMutex);
+
+    for (std::list<ActionsCacheInstance>::iterator it = _instances.begin(); it != _instances.end(); ++it) {
+        if (it->_hash == hash) {
+            ActionKey key;
+            key.time = 0.;
+            key.view = view;
+            key.mipMapLevel = mipMapLevel;
+
+            RoDCacheMap::const_iterator found = it->_timeInvariantRodCache.find(key);
+            if ( found != it->_timeInvariantRodCache.end() ) {
+                *rod = found->second;
+
+                return true;
+            }
+
+            return false;
+        }
+    }
+
+    return false;
+}
+
+void
+ActionsCache::setTimeInvariantRoDResult(U64 hash,
+                                        ViewIdx view,
+                                        unsigned int mipMapLevel,
+                                        const RectD & rod)
+{
+    QMutexLocker l(&_cacheMutex);
+    ActionsCacheInstance & cache = getOrCreateActionCache(hash);
+    ActionKey key;
+
+    key.time = 0.;
+    key.view = view;
+    key.mipMapLevel = mipMapLevel;
+
+    cache._timeInvariantRodCache[key] = rod;
+}
+
 bool
 ActionsCache::getFramesNeededResult(U64 hash,
                                     double time,
@@ -340,6 +390,184 @@ ActionsCache::setTimeDomainResult(U64 hash,
     cache._timeDomain.max = last;
 }
 
+bool
+ActionsCache::getMetadataResult(U64 hash,
+                                NodeMetadata* metadata)
+{
+    QMutexLocker l(&_cacheMutex);
+
+    for (std::list<ActionsCacheInstance>::iterator it = _instances.begin(); it != _instances.end(); ++it) {
+        if ( (it->_hash == hash) && it->_metadataSet ) {
+            *metadata = it->_metadata;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+ActionsCache::setMetadataResult(U64 hash,
+                                const NodeMetadata& metadata)
+{
+    QMutexLocker l(&_cacheMutex);
+    ActionsCacheInstance & cache = getOrCreateActionCache(hash);
+
+    cache._metadataSet = true;
+    cache._metadata = metadata;
+}
+
+void
+ActionsCache::clearMetadataResults()
+{
+    QMutexLocker l(&_cacheMutex);
+
+    for (std::list<ActionsCacheInstance>::iterator it = _instances.begin(); it != _instances.end(); ++it) {
+        it->_metadataSet = false;
+    }
+}
+
+RenderPlanCache::RenderPlanCache(int maxPlans)
+    : _cacheMutex()
+    , _plans()
+    , _maxPlans( (std::size_t)maxPlans )
+{
+}
+
+void
+RenderPlanCache::clearAll()
+{
+    QMutexLocker l(&_cacheMutex);
+
+    _plans.clear();
+}
+
+/**
+ * @brief Copy a time invariant plan computed at fromTime so that it can be used to render toTime.
+ * Such a plan only references fromTime (see isRenderPlanTimeInvariant in ParallelRenderArgs.cpp).
+ **/
+static void
+copyPlanAtTime(const FrameRequestMap& from,
+               double fromTime,
+               double toTime,
+               FrameRequestMap* to)
+{
+    for (FrameRequestMap::const_iterator it = from.begin(); it != from.end(); ++it) {
+        NodeFrameRequestPtr nodeRequest = boost::make_shared<NodeFrameRequest>();
+        nodeRequest->nodeHash = it->second->nodeHash;
+        nodeRequest->mappedScale = it->second->mappedScale;
+        for (NodeFrameViewRequestData::const_iterator it2 = it->second->frames.begin(); it2 != it->second->frames.end(); ++it2) {
+            assert(it2->first.time == fromTime);
+            FrameViewPair frameView = it2->first;
+            frameView.time = toTime;
+            FrameViewRequest& fvRequest = nodeRequest->frames[frameView];
+            fvRequest = it2->second;
+            if (fvRequest.globalData.inputIdentityTime == fromTime) {
+                fvRequest.globalData.inputIdentityTime = toTime;
+            }
+            for (FramesNeededMap::iterator it3 = fvRequest.globalData.frameViewsNeeded.begin(); it3 != fvRequest.globalData.frameViewsNeeded.end(); ++it3) {
+                for (FrameRangesMap::iterator it4 = it3->second.begin(); it4 != it3->second.end(); ++it4) {
+                    for (std::size_t i = 0; i < it4->second.size(); ++i) {
+                        it4->second[i].min = it4->second[i].max = toTime;
+                    }
+                }
+            }
+        }
+        to->insert( std::make_pair(it->first, nodeRequest) );
+    }
+}
+
+bool
+RenderPlanCache::getPlan(U64 hash,
+                         double time,
+                         ViewIdx view,
+                         unsigned int mipMapLevel,
+                         const RectD& renderWindow,
+                         bool useTransforms,
+                         FrameRequestMap* request)
+{
+    QMutexLocker l(&_cacheMutex);
+
+    for (std::list<RenderPlan>::iterator it = _plans.begin(); it != _plans.end(); ++it) {
+        if ( (it->hash != hash) || (it->view != view) || (it->mipMapLevel != mipMapLevel) ||
+             (it->useTransforms != useTransforms) || (it->renderWindow != renderWindow) ) {
+            continue;
+        }
+        if ( (it->time != time) && !it->isTimeInvariant ) {
+            continue;
+        }
+
+        FrameRequestMap planRequest;
+        bool nodeDeleted = false;
+        for (std::list<std::pair<NodeWPtr, NodeFrameRequestPtr> >::const_iterator it2 = it->request.begin(); it2 != it->request.end(); ++it2) {
+            NodePtr node = it2->first.lock();
+            if (!node) {
+                nodeDeleted = true;
+                break;
+            }
+            planRequest.insert( std::make_pair(node, it2->second) );
+        }
+        if (nodeDeleted) {
+            // A node of the tree was deleted, the hash changed anyway
+            _plans.erase(it);
+
+            return false;
+        }
+
+        if (it->time == time) {
+            *request = planRequest;
+        } else {
+            copyPlanAtTime(planRequest, it->time, time, request);
+        }
+
+        // Move it to the back of the LRU list
+        _plans.splice(_plans.end(), _plans, it);
+
+        return true;
+    }
+
+    return false;
+}
+
+void
+RenderPlanCache::setPlan(U64 hash,
+                         double time,
+                         ViewIdx view,
+                         unsigned int mipMapLevel,
+                         const RectD& renderWindow,
+                         bool useTransforms,
+                         bool isTimeInvariant,
+                         const FrameRequestMap& request)
+{
+    QMutexLocker l(&_cacheMutex);
+
+    // Plans computed for another hash will never be used again
+    for (std::list<RenderPlan>::iterator it = _plans.begin(); it != _plans.end(); ) {
+        if (it->hash != hash) {
+            it = _plans.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if ( !_plans.empty() && (_plans.size() >= _maxPlans) ) {
+        _plans.pop_front();
+    }
+
+    RenderPlan plan;
+    plan.hash = hash;
+    plan.time = time;
+    plan.view = view;
+    plan.mipMapLevel = mipMapLevel;
+    plan.renderWindow = renderWindow;
+    plan.useTransforms = useTransforms;
+    plan.isTimeInvariant = isTimeInvariant;
+    for (FrameRequestMap::const_iterator it = request.begin(); it != request.end(); ++it) {
+        plan.request.push_back( std::make_pair(NodeWPtr(it->first), it->second) );
+    }
+    _plans.push_back(plan);
+}
+
 EffectInstance::RenderArgs::RenderArgs()
     : rod()
     , regionOfInterestResults()
@@ -357,6 +585,7 @@ EffectInstance::RenderArgs::RenderArgs()
     , lastFrame(0)
     , transformRedirections()
     , isDoingOpenGLRender(false)
+    , fetchedImages()
 {
 }
 
@@ -377,9 +606,59 @@ EffectInstance::RenderArgs::RenderArgs(const RenderArgs & o)
     , lastFrame(o.lastFrame)
     , transformRedirections(o.transformRedirections)
     , isDoingOpenGLRender(o.isDoingOpenGLRender)
+    , fetchedImages(o.fetchedImages)
 {
 }
 
+bool
+EffectInstance::FetchedImageKey::operator<(const FetchedImageKey& other) const
+{
+    if (inputNb != other.inputNb) {
+        return inputNb < other.inputNb;
+    }
+    if (time != other.time) {
+        return time < other.time;
+    }
+    if (view != other.view) {
+        return view < other.view;
+    }
+    if (scale.x != other.scale.x) {
+        return scale.x < other.scale.x;
+    }
+    if (scale.y != other.scale.y) {
+        return scale.y < other.scale.y;
+    }
+    if (mapToClipPrefs != other.mapToClipPrefs) {
+        return !mapToClipPrefs;
+    }
+    if (dontUpscale != other.dontUpscale) {
+        return !dontUpscale;
+    }
+    if (hasBounds != other.hasBounds) {
+        return !hasBounds;
+    }
+    if (hasBounds) {
+        if (bounds.x1 != other.bounds.x1) {
+            return bounds.x1 < other.bounds.x1;
+        }
+        if (bounds.y1 != other.bounds.y1) {
+            return bounds.y1 < other.bounds.y1;
+        }
+        if (bounds.x2 != other.bounds.x2) {
+            return bounds.x2 < other.bounds.x2;
+        }
+        if (bounds.y2 != other.bounds.y2) {
+            return bounds.y2 < other.bounds.y2;
+        }
+    }
+    // ImagePlaneDesc::operator< only compares the plane ID, which is the same for all the color planes
+    if ( layer.getNumComponents() != other.layer.getNumComponents() ) {
+        return layer.getNumComponents() < other.layer.getNumComponents();
+    }
+
+    return layer < other.layer;
+}
+
 EffectInstance::Implementation::Implementation(EffectInstance* publicInterface)
     : _publicInterface(publicInterface)
     , tlsData()
@@ -389,6 +668,7 @@ EffectInstance::Implementation::Implementation(EffectInstance* publicInterface)
     , pluginMemoryChunks()
     , supportsRenderScale(eSupportsMaybe)
     , actionsCache()
+    , renderPlanCache()
 #if NATRON_ENABLE_TRIMAP
     , imagesBeingRenderedMutex()
     , imagesBeingRendered()
@@ -408,6 +688,7 @@ EffectInstance::Implementation::Implementation(EffectInstance* publicInterface)
 {
     tlsData = boost::make_shared<TLSHolder<EffectTLSData> >();
     actionsCache = boost::make_shared<ActionsCache>(appPTR->getHardwareIdealThreadCount() * 2);
+    renderPlanCache = boost::make_shared<RenderPlanCache>(appPTR->getHardwareIdealThreadCount() * 2);
 }
 
 EffectInstance::Implementation::Implementation(const Implementation& other)
@@ -419,6 +700,7 @@ EffectInstance::Implementation::Implementation(const Implementation& other)
 , pluginMemoryChunks()
 , supportsRenderScale(other.supportsRenderScale)
 , actionsCache(other.actionsCache)
+, renderPlanCache(other.renderPlanCache)
 #if NATRON_ENABLE_TRIMAP
 , imagesBeingRenderedMutex()
 , imagesBeingRendered()
@@ -700,6 +982,7 @@ EffectInstance::Implementation::ScopedRenderArgs::~ScopedRenderArgs()
     assert(tlsData);
     tlsData->currentRenderArgs.outputPlanes.clear();
     tlsData->currentRenderArgs.inputImages.clear();
+    tlsData->currentRenderArgs.fetchedImages.clear();
     tlsData->currentRenderArgs.validArgs = false;
 }
 
@@ -105,8 +105,11 @@ typedef std::map<ActionKey, ComponentsNeededResults, CompareActionsCacheKeys> Co
 
 /**
  * @brief This class stores all results of the following actions:
-   - getRegionOfDefinition (invalidated on hash change, mapped across time + scale)
+   - getRegionOfDefinition (invalidated on hash change, mapped across time + scale). The results of the nodes
+     whose tree is neither frame varying nor animated are also mapped across scale only, so that they are shared by all frames
    - getTimeDomain (invalidated on hash change, only 1 value possible
+   - getPreferredMetadata, i.e getClipPreferences for OpenFX (invalidated on hash change, only 1 value possible). They also
+     depend on the project settings, which are not in the hash: they are cleared when the project forces their refresh
    - isIdentity (invalidated on hash change,mapped across time + scale)
  * The reason we store them is that the OFX Clip API can potentially call these actions recursively
  * but this is forbidden by the spec:
@@ -135,6 +138,10 @@ public:
 
     void setRoDResult(U64 hash, double time, ViewIdx view, unsigned int mipMapLevel, const RectD & rod);
 
+    bool getTimeInvariantRoDResult(U64 hash, ViewIdx view, unsigned int mipMapLevel, RectD* rod);
+
+    void setTimeInvariantRoDResult(U64 hash, ViewIdx view, unsigned int mipMapLevel, const RectD & rod);
+
     bool getFramesNeededResult(U64 hash, double time, ViewIdx view, unsigned int mipMapLevel, FramesNeededMap* framesNeeded);
 
     void setFramesNeededResult(U64 hash, double time, ViewIdx view, unsigned int mipMapLevel, const FramesNeededMap & framesNeeded);
@@ -143,6 +150,12 @@ public:
 
     void setTimeDomainResult(U64 hash, double first, double last);
 
+    bool getMetadataResult(U64 hash, NodeMetadata* metadata);
+
+    void setMetadataResult(U64 hash, const NodeMetadata& metadata);
+
+    void clearMetadataResults();
+
 private:
     mutable QMutex _cacheMutex; //< protects everything in the cache
     struct ActionsCacheInstance
@@ -152,8 +165,11 @@ private:
         bool _timeDomainSet;
         IdentityCacheMap _identityCache;
         RoDCacheMap _rodCache;
+        RoDCacheMap _timeInvariantRodCache; // the time of the keys is always 0
         FramesNeededCacheMap _framesNeededCache;
         ComponentsNeededCacheMap _componentsNeededCache;
+        NodeMetadata _metadata;
+        bool _metadataSet;
 
         ActionsCacheInstance();
     };
@@ -165,6 +181,48 @@ private:
     ActionsCacheInstance & getOrCreateActionCache(U64 newHash);
 };
 
+/**
+ * @brief This class stores the results of the request pass (see EffectInstance::computeRequestPass) made from a tree root:
+   - regions of interest, frames needed, identity and region of definition of each node upstream
+   - concatenated transforms (InputMatrixMap)
+ * A plan is keyed on the hash of the tree root (which depends on the hash of all nodes upstream), the time, view,
+ * mipmap level and render window. Plans whose nodes are neither frame varying nor animated and which only
+ * reference the frame being rendered are time invariant: they are re-used for all frames. The other plans
+ * (e.g: trees with a Reader) are only re-used for the time they were computed at.
+ * The nodes of a plan are only weakly referenced, since the tree root itself is part of its plan.
+ **/
+class RenderPlanCache
+{
+public:
+    RenderPlanCache(int maxPlans);
+
+    void clearAll();
+
+    bool getPlan(U64 hash, double time, ViewIdx view, unsigned int mipMapLevel, const RectD& renderWindow, bool useTransforms, FrameRequestMap* request);
+
+    void setPlan(U64 hash, double time, ViewIdx view, unsigned int mipMapLevel, const RectD& renderWindow, bool useTransforms, bool isTimeInvariant, const FrameRequestMap& request);
+
+private:
+    struct RenderPlan
+    {
+        U64 hash;
+        double time;
+        ViewIdx view;
+        unsigned int mipMapLevel;
+        RectD renderWindow;
+        bool useTransforms;
+        bool isTimeInvariant;
+        std::list<std::pair<NodeWPtr, NodeFrameRequestPtr> > request;
+    };
+
+    mutable QMutex _cacheMutex; //< protects _plans
+
+    //In a list to track the LRU
+    std::list<RenderPlan> _plans;
+    std::size_t _maxPlans;
+};
+
+
 
 class EffectInstance::Implementation
 {
@@ -194,6 +252,9 @@ public:
     /// Mt-Safe actions cache
     ActionsCachePtr actionsCache;
 
+    /// Mt-Safe cache of the request passes made with this effect as tree root
+    RenderPlanCachePtr renderPlanCache;
+
 #if NATRON_ENABLE_TRIMAP
     ///Store all images being rendered to avoid 2 threads rendering the same portion of an image
     struct ImageBeingRendered
@@ -358,6 +419,12 @@ public:
                                                   const std::bitset<4>& processChannels,
                                                   const ImagePlanesToRenderPtr & planes);
 
+    /**
+     * @brief Fetches all the planes needed from the inputs of a multi-planar effect into the fetched images table
+     * of the current render window, see RenderArgs::fetchedImages
+     **/
+    void prefetchInputImages(double time, ViewIdx view, unsigned int mipMapLevel, const ComponentsNeededMap& compsNeeded);
+
 
     ///These are the image passed to the plug-in to render
     /// - fullscaleMappedImage is the fullscale image remapped to what the plugin can support (components/bitdepth)
@@ -397,8 +464,7 @@ public:
                                           ImagePlanesToRender & planes);
 
     static bool aborted(bool isRenderResponseToUserInteraction,
-                        const AbortableRenderInfoPtr& abortInfo,
-                        const EffectInstancePtr& treeRoot)  WARN_UNUSED_RETURN;
+                        const AbortableRenderInfo* abortInfo)  WARN_UNUSED_RETURN;
 
     void checkMetadata(NodeMetadata &metadata);
 };
@@ -34,11 +34,14 @@
 #include <sstream> // stringstream
 
 #include <boost/scoped_ptr.hpp>
+#include <boost/function.hpp>
 
 #include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QCoreApplication>
-#include <QtConcurrentMap> // QtCore on Qt4, QtConcurrent on Qt5
 #include <QtConcurrentRun> // QtCore on Qt4, QtConcurrent on Qt5
 
 #if !defined(SBK_RUN) && !defined(Q_MOC_RUN)
@@ -50,9 +53,11 @@ GCC_DIAG_UNUSED_LOCAL_TYPEDEFS_ON
 
 #include "Global/QtCompat.h"
 
+#include "Engine/AbortableRenderInfo.h"
 #include "Engine/AppInstance.h"
 #include "Engine/AppManager.h"
 #include "Engine/BlockingBackgroundRender.h"
+#include "Engine/ConvertedImagesCache.h"
 #include "Engine/DiskCacheNode.h"
 #include "Engine/Cache.h"
 #include "Engine/Image.h"
@@ -84,6 +89,112 @@ GCC_DIAG_UNUSED_LOCAL_TYPEDEFS_ON
 
 NATRON_NAMESPACE_ENTER
 
+NATRON_NAMESPACE_ANONYMOUS_ENTER
+
+/**
+ * @brief The tiles of a render window, shared between the thread rendering it and the thread pool threads helping it.
+ * Each tile is rendered by the first free thread taking it, and the thread rendering the window takes tiles too, so
+ * that it never waits on helpers that did not start. The priority of a render is thus only applied through the
+ * order in which the thread pool starts the helpers: a render of lower priority is never held back once it has a thread.
+ * RESULT is the status returned for each tile and FAILED the one reported when rendering a tile throws.
+ **/
+template <typename RESULT, RESULT FAILED>
+class TilesRenderQueue
+{
+public:
+
+    typedef boost::function<RESULT (const EffectInstance::RectToRender&)> TileRenderFunctor;
+
+    TilesRenderQueue(const std::list<EffectInstance::RectToRender>& tiles,
+                     const TileRenderFunctor& functor)
+        : _lock()
+        , _tilesDone()
+        , _tiles( tiles.begin(), tiles.end() )
+        , _nextTile(0)
+        , _nTilesDone(0)
+        , _results( tiles.size(), FAILED )
+        , _functor(functor)
+    {
+    }
+
+    /**
+     * @brief Renders tiles until there is none left to take
+     **/
+    void renderTiles()
+    {
+        for (;;) {
+            std::size_t index;
+            {
+                QMutexLocker k(&_lock);
+                if ( _nextTile >= _tiles.size() ) {
+                    return;
+                }
+                index = _nextTile++;
+            }
+            RESULT ret;
+            try {
+                ret = _functor(_tiles[index]);
+            } catch (...) {
+                ret = FAILED;
+            }
+            QMutexLocker k(&_lock);
+            _results[index] = ret;
+            if ( ++_nTilesDone == _tiles.size() ) {
+                _tilesDone.wakeAll();
+            }
+        }
+    }
+
+    /**
+     * @brief Waits for the tiles taken by other threads to be rendered and returns the status of each tile
+     **/
+    const std::vector<RESULT>& waitForTiles()
+    {
+        QMutexLocker k(&_lock);
+
+        while ( _nTilesDone < _tiles.size() ) {
+            _tilesDone.wait(&_lock);
+        }
+
+        return _results;
+    }
+
+private:
+
+    QMutex _lock;
+    QWaitCondition _tilesDone;
+    std::vector<EffectInstance::RectToRender> _tiles;
+    std::size_t _nextTile;
+    std::size_t _nTilesDone;
+    std::vector<RESULT> _results;
+    TileRenderFunctor _functor;
+};
+
+template <typename QUEUE>
+class TilesRenderRunnable
+    : public QRunnable
+{
+    boost::shared_ptr<QUEUE> _queue;
+
+public:
+
+    TilesRenderRunnable(const boost::shared_ptr<QUEUE>& queue)
+        : _queue(queue)
+    {
+    }
+
+    virtual ~TilesRenderRunnable()
+    {
+    }
+
+    virtual void run() OVERRIDE FINAL
+    {
+        _queue->renderTiles();
+    }
+};
+
+NATRON_NAMESPACE_ANONYMOUS_EXIT
+
 /*
  * @brief Split all rects to render in smaller rects and check if each one of them is identity.
  * For identity rectangles, we just call renderRoI again on the identity input in the tiledRenderingFunctor.
@@ -171,7 +282,8 @@ EffectInstance::convertPlanesFormatsIfNeeded(const AppInstancePtr& app,
                                              ImageBitDepthEnum targetDepth,
                                              bool useAlpha0ForRGBToRGBAConversion,
                                              ImagePremultiplicationEnum outputPremult,
-                                             int channelForAlpha)
+                                             int channelForAlpha,
+                                             bool useConvertedImagesCache)
 {
     // Do not do any conversion for OpenGL textures, OpenGL is managing it for us.
     if (inputImage->getStorageMode() == eStorageModeGLTex) {
@@ -180,6 +292,8 @@ EffectInstance::convertPlanesFormatsIfNeeded(const AppInstancePtr& app,
     bool imageConversionNeeded = ( /*!targetIsMultiPlanar &&*/ targetComponents.getNumComponents() != inputImage->getComponents().getNumComponents() ) || targetDepth != inputImage->getBitDepth();
 
     if (!imageConversionNeeded) {
+        // Images are stored contiguously, so an image with the same components and bit depth has the same layout:
+        // hand the image over as is
         return inputImage;
     } else {
         /**
@@ -187,6 +301,28 @@ EffectInstance::convertPlanesFormatsIfNeeded(const AppInstancePtr& app,
          **/
         Image::ReadAccess acc = inputImage->getReadRights();
         RectI bounds = inputImage->getBounds();
+        RectI clippedRoi;
+        roi.intersect(bounds, &clippedRoi);
+
+        bool unPremultIfNeeded = outputPremult == eImagePremultiplicationPremultiplied && inputImage->getComponentsCount() == 4 && targetComponents.getNumComponents() == 3;
+
+        // Look for a conversion of the same image made for another tile or thread
+        ConvertedImagesCache* cache = useConvertedImagesCache ? appPTR->getConvertedImagesCache() : 0;
+        ConvertedImagesCache::ConversionKey conversionKey;
+        if (cache) {
+            conversionKey.targetComponents = targetComponents;
+            conversionKey.targetDepth = targetDepth;
+            conversionKey.srcColorSpace = app->getDefaultColorSpaceForBitDepth( inputImage->getBitDepth() );
+            conversionKey.dstColorSpace = app->getDefaultColorSpaceForBitDepth(targetDepth);
+            conversionKey.channelForAlpha = channelForAlpha;
+            conversionKey.useAlpha0 = useAlpha0ForRGBToRGBAConversion;
+            conversionKey.unPremult = unPremultIfNeeded;
+            ImagePtr converted = cache->get(inputImage, conversionKey, clippedRoi, &clippedRoi);
+            if (converted) {
+                return converted;
+            }
+        }
+
 #if 0 //def BOOST_NO_CXX11_VARIADIC_TEMPLATES
        ImagePtr tmp( new Image(targetComponents,
                                 inputImage->getRoD(),
@@ -210,10 +346,6 @@ EffectInstance::convertPlanesFormatsIfNeeded(const AppInstancePtr& app,
 
 #endif
         tmp->setKey(inputImage->getKey());
-        RectI clippedRoi;
-        roi.intersect(bounds, &clippedRoi);
-
-        bool unPremultIfNeeded = outputPremult == eImagePremultiplicationPremultiplied && inputImage->getComponentsCount() == 4 && tmp->getComponentsCount() == 3;
 
         if (useAlpha0ForRGBToRGBAConversion) {
             inputImage->convertToFormatAlpha0( clippedRoi,
@@ -227,9 +359,13 @@ EffectInstance::convertPlanesFormatsIfNeeded(const AppInstancePtr& app,
                                          channelForAlpha, false, unPremultIfNeeded, tmp.get() );
         }
 
+        if (cache) {
+            cache->insert(inputImage, conversionKey, tmp, clippedRoi);
+        }
+
         return tmp;
     }
-}
+} // EffectInstance::convertPlanesFormatsIfNeeded
 
 #if NATRON_ENABLE_TRIMAP
 class ImageBitMapMarker_RAII
@@ -891,7 +1027,15 @@ EffectInstance::renderRoI(const RenderRoIArgs & args,
         createInCache = false;
     } else {
         // in Analysis, the node upstream of te analysis node should always cache
-        createInCache = (frameArgs->isAnalysis && frameArgs->treeRoot->getEffectInstance().get() == args.caller) ? true : shouldCacheOutput(isFrameVaryingOrAnimated, args.time, args.view, frameArgs->visitsCount);
+        const bool isAnalysisRoot = frameArgs->isAnalysis && frameArgs->treeRoot->getEffectInstance().get() == args.caller;
+        createInCache = isAnalysisRoot ? true : shouldCacheOutput(isFrameVaryingOrAnimated, args.time, args.view, frameArgs->visitsCount);
+
+        // Renders of low priority (previews, renders to disk) should not evict from the cache the images
+        // needed by the viewer once the cache is full.
+        // The frames decoded ahead of playback (analysis renders of the Read node) are only rendered to be cached: they are never skipped.
+        if ( createInCache && !isAnalysisRoot && abortInfo && (abortInfo->getPriority() < eRenderPriorityPlayback) && appPTR->isNodeCacheAlmostFull() ) {
+            createInCache = false;
+        }
     }
     ///Do we want to render the graph upstream at scale 1 or at the requested render scale ? (user setting)
     bool renderScaleOneUpstreamIfRenderScaleSupportDisabled = getNode()->useScaleOneImagesWhenRenderScaleSupportIsDisabled();
@@ -1964,6 +2108,7 @@ EffectInstance::renderRoIInternal(EffectInstance* self,
             QThread* currentThread = QThread::currentThread();
             boost::scoped_ptr<Implementation::TiledRenderingFunctorArgs> tiledArgs(new Implementation::TiledRenderingFunctorArgs);
             tiledArgs->renderFullScaleThenDownscale = renderFullScaleThenDownscale;
+            tiledArgs->isSequentialRender = isSequentialRender;
             tiledArgs->isRenderResponseToUserInteraction = isRenderMadeInResponseToUserInteraction;
             tiledArgs->firstFrame = firstFrame;
             tiledArgs->lastFrame = lastFrame;
@@ -1995,14 +2140,25 @@ EffectInstance::renderRoIInternal(EffectInstance* self,
 #else
 
 
-            QFuture<RenderingFunctorRetEnum> ret = QtConcurrent::mapped( planesToRender->rectsToRender,
-                                                                         boost::bind(&EffectInstance::Implementation::tiledRenderingFunctor,
-                                                                                     self->_imp.get(),
-                                                                                     *tiledArgs,
-                                                                                     _1,
-                                                                                     currentThread) );
-            ret.waitForFinished();
-            QFuture<EffectInstance::RenderingFunctorRetEnum>::const_iterator it2;
+            // The helpers go ahead of the ones queued by renders of lower priority in the thread pool
+            AbortableRenderInfoPtr abortInfo = frameArgs->abortInfo.lock();
+            const int priority = abortInfo ? (int)abortInfo->getPriority() : (int)eRenderPriorityInteractive;
+            typedef TilesRenderQueue<RenderingFunctorRetEnum, eRenderingFunctorRetFailed> RenderTilesQueue;
+            boost::shared_ptr<RenderTilesQueue> tilesQueue =
+                boost::make_shared<RenderTilesQueue>( planesToRender->rectsToRender,
+                                                      boost::bind(&EffectInstance::Implementation::tiledRenderingFunctor,
+                                                                  self->_imp.get(),
+                                                                  *tiledArgs,
+                                                                  _1,
+                                                                  currentThread) );
+            QThreadPool* pool = QThreadPool::globalInstance();
+            const int nHelpers = std::min( (int)planesToRender->rectsToRender.size() - 1, pool->maxThreadCount() );
+            for (int i = 0; i < nHelpers; ++i) {
+                pool->start(new TilesRenderRunnable<RenderTilesQueue>(tilesQueue), priority);
+            }
+            tilesQueue->renderTiles();
+            const std::vector<EffectInstance::RenderingFunctorRetEnum>& ret = tilesQueue->waitForTiles();
+            std::vector<EffectInstance::RenderingFunctorRetEnum>::const_iterator it2;
 
 #endif
             for (it2 = ret.begin(); it2 != ret.end(); ++it2) {
@@ -76,6 +76,7 @@ SOURCES += \
     BlockingBackgroundRender.cpp \
     CLArgs.cpp \
     Cache.cpp \
+    ConvertedImagesCache.cpp \
     CoonsRegularization.cpp \
     CreateNodeArgs.cpp \
     Curve.cpp \
@@ -145,7 +146,9 @@ SOURCES += \
     OfxHost.cpp \
     OfxImageEffectInstance.cpp \
     OfxMemory.cpp \
+    OfxMutex.cpp \
     OfxOverlayInteract.cpp \
+    OfxPluginIndex.cpp \
     OfxParamInstance.cpp \
     OneViewNode.cpp \
     OutputEffectInstance.cpp \
@@ -153,6 +156,7 @@ SOURCES += \
     ParallelRenderArgs.cpp \
     Plugin.cpp \
     PluginMemory.cpp \
+    PluginMemoryPool.cpp \
     PrecompNode.cpp \
     ProcessHandler.cpp \
     Project.cpp \
@@ -199,6 +203,7 @@ SOURCES += \
     TrackerUndoCommand.cpp \
     Transform.cpp \
     Utils.cpp \
+    ViewerFlipbookCache.cpp \
     ViewerInstance.cpp \
     WriteNode.cpp \
     ../Global/glad_source.c \
@@ -276,6 +281,7 @@ HEADERS += \
     CacheEntryHolder.h \
     CacheSerialization.h \
     ChoiceOption.h \
+    ConvertedImagesCache.h \
     CoonsRegularization.h \
     CreateNodeArgs.h \
     Curve.h \
@@ -357,7 +363,9 @@ HEADERS += \
     OfxHost.h \
     OfxImageEffectInstance.h \
     OfxMemory.h \
+    OfxMutex.h \
     OfxOverlayInteract.h \
+    OfxPluginIndex.h \
     OfxParamInstance.h \
     OneViewNode.h \
     OpenGLViewerI.h \
@@ -368,6 +376,7 @@ HEADERS += \
     Plugin.h \
     PluginActionShortcut.h \
     PluginMemory.h \
+    PluginMemoryPool.h \
     PrecompNode.h \
     ProcessHandler.h \
     Project.h \
@@ -435,6 +444,7 @@ HEADERS += \
     Variant.h \
     VariantSerialization.h \
     ViewIdx.h \
+    ViewerFlipbookCache.h \
     ViewerInstance.h \
     ViewerInstancePrivate.h \
     WriteNode.h \
@@ -129,10 +129,12 @@ class BezierSerialization;
 class BlockingBackgroundRender;
 class BufferableObject;
 class CLArgs;
+class CacheAPI;
 class CacheEntryHolder;
 class CacheSignalEmitter;
 class ChoiceExtraData;
 class CreateNodeArgs;
+class ConvertedImagesCache;
 class Curve;
 class Dimension;
 class DockablePanelI;
@@ -190,6 +192,7 @@ class KnobSignalSlotHandler;
 class KnobString;
 class KnobTLSData;
 class KnobTable;
+class KnobValuesSnapshot;
 class LibraryBinary;
 class LogEntry;
 class MemoryFile;
@@ -224,6 +227,7 @@ class ParallelRenderArgsSetter;
 class Plugin;
 class PluginGroupNode;
 class PluginMemory;
+class PluginMemoryPool;
 class PrecompNode;
 class ProcessHandler;
 class ProcessInputChannel;
@@ -233,6 +237,7 @@ class ProjectSerialization;
 class RectD;
 class RectI;
 class RenderEngine;
+class RenderPlanCache;
 class RenderStats;
 class RenderingFlagSetter;
 class RotoContext;
@@ -377,6 +382,7 @@ typedef boost::shared_ptr<KnobSignalSlotHandler> KnobSignalSlotHandlerPtr;
 typedef boost::shared_ptr<KnobString> KnobStringPtr;
 typedef boost::shared_ptr<KnobTLSData> KnobTLSDataPtr;
 typedef boost::shared_ptr<KnobTable> KnobTablePtr;
+typedef boost::shared_ptr<const KnobValuesSnapshot> KnobValuesSnapshotPtr;
 typedef boost::shared_ptr<MemoryFile> MemoryFilePtr;
 typedef boost::shared_ptr<Node> NodePtr;
 typedef boost::shared_ptr<NodeCollection> NodeCollectionPtr;
@@ -399,6 +405,7 @@ typedef boost::shared_ptr<PrecompNode> PrecompNodePtr;
 typedef boost::shared_ptr<ProcessHandler> ProcessHandlerPtr;
 typedef boost::shared_ptr<Project> ProjectPtr;
 typedef boost::shared_ptr<RenderEngine> RenderEnginePtr;
+typedef boost::shared_ptr<RenderPlanCache> RenderPlanCachePtr;
 typedef boost::shared_ptr<RenderStats> RenderStatsPtr;
 typedef boost::shared_ptr<RenderingFlagSetter> RenderingFlagSetterPtr;
 typedef boost::shared_ptr<RotoContext> RotoContextPtr;
@@ -28,10 +28,92 @@
 #include <cstring> // for std::memcpy, std::memset
 #include <stdexcept>
 
+#include <boost/cstdint.hpp>
+
 #include "Engine/RectI.h"
 
 NATRON_NAMESPACE_ENTER
 
+namespace {
+// IEEE 754 binary32 <-> binary16 conversions, rounding to nearest even.
+// Values out of the half-float range are clamped to infinity, NaNs are preserved.
+inline boost::uint16_t
+floatToHalf(float f)
+{
+    boost::uint32_t x;
+
+    std::memcpy( &x, &f, sizeof(x) );
+
+    const boost::uint32_t sign = (x >> 16) & 0x8000;
+    const boost::uint32_t absx = x & 0x7fffffff;
+
+    if (absx >= 0x7f800000) {
+        // Infinity or NaN
+        return (boost::uint16_t)( sign | 0x7c00 | ( (absx > 0x7f800000) ? 0x200 : 0 ) );
+    }
+    if (absx >= 0x477ff000) {
+        // Rounds to a value greater than the largest half
+        return (boost::uint16_t)(sign | 0x7c00);
+    }
+    if (absx < 0x38800000) {
+        // Denormalized half or zero
+        if (absx < 0x33000000) {
+            return (boost::uint16_t)sign;
+        }
+        const boost::uint32_t e = absx >> 23;
+        const boost::uint32_t m = (absx & 0x007fffff) | 0x00800000;
+        const boost::uint32_t shift = 126 - e;
+        boost::uint32_t h = m >> shift;
+        const boost::uint32_t rest = m & ( (1u << shift) - 1 );
+        const boost::uint32_t halfway = 1u << (shift - 1);
+        if ( (rest > halfway) || ( (rest == halfway) && (h & 1) ) ) {
+            ++h;
+        }
+
+        return (boost::uint16_t)(sign | h);
+    }
+
+    // Normalized half: rebias the exponent and round the mantissa
+    boost::uint32_t h = (absx - 0x38000000) >> 13;
+    const boost::uint32_t rest = absx & 0x1fff;
+    if ( (rest > 0x1000) || ( (rest == 0x1000) && (h & 1) ) ) {
+        ++h;
+    }
+
+    return (boost::uint16_t)(sign | h);
+}
+
+inline float
+halfToFloat(boost::uint16_t h)
+{
+    const boost::uint32_t sign = (boost::uint32_t)(h & 0x8000) << 16;
+    const boost::uint32_t e = (h >> 10) & 0x1f;
+    boost::uint32_t m = h & 0x3ff;
+    boost::uint32_t x;
+
+    if (e == 0x1f) {
+        // Infinity or NaN
+        x = sign | 0x7f800000 | (m << 13);
+    } else if (e != 0) {
+        x = sign | ( (e + 112) << 23 ) | (m << 13);
+    } else if (m == 0) {
+        x = sign;
+    } else {
+        // Denormalized half: normalize it
+        boost::uint32_t exp = 113;
+        while ( !(m & 0x400) ) {
+            m <<= 1;
+            --exp;
+        }
+        x = sign | (exp << 23) | ( (m & 0x3ff) << 13 );
+    }
+    float f;
+    std::memcpy( &f, &x, sizeof(f) );
+
+    return f;
+}
+}
+
 
 const U8*
 FrameEntry::pixelAt(int x,
@@ -43,10 +125,7 @@ FrameEntry::pixelAt(int x,
         return 0;
     }
     std::size_t rowSize = bounds.width();
-    unsigned int srcPixelSize = 4;
-    if ( (ImageBitDepthEnum)_key.getBitDepth() == eImageBitDepthFloat ) {
-        srcPixelSize *= sizeof(float);
-    }
+    unsigned int srcPixelSize = 4 * getSizeOfForBitDepth( (ImageBitDepthEnum)_key.getBitDepth() );
     rowSize *= srcPixelSize;
 
     return data() +  (y - bounds.y1) * rowSize + (x - bounds.x1) * srcPixelSize;
@@ -65,17 +144,11 @@ FrameEntry::copy(const FrameEntry& other)
     const TextureRect& srcBounds = other.getKey().getTexRect();
     const TextureRect& dstBounds = _key.getTexRect();
     std::size_t srcRowSize = srcBounds.width();
-    unsigned int srcPixelSize = 4;
-    if ( (ImageBitDepthEnum)other.getKey().getBitDepth() == eImageBitDepthFloat ) {
-        srcPixelSize *= sizeof(float);
-    }
+    unsigned int srcPixelSize = 4 * getSizeOfForBitDepth( (ImageBitDepthEnum)other.getKey().getBitDepth() );
     srcRowSize *= srcPixelSize;
 
     std::size_t dstRowSize = srcBounds.width();
-    unsigned int dstPixelSize = 4;
-    if ( (ImageBitDepthEnum)_key.getBitDepth() == eImageBitDepthFloat ) {
-        dstPixelSize *= sizeof(float);
-    }
+    unsigned int dstPixelSize = 4 * getSizeOfForBitDepth( (ImageBitDepthEnum)_key.getBitDepth() );
     dstRowSize *= dstPixelSize;
 
     // Fill with black and transparent because src might be smaller
@@ -111,4 +184,36 @@ FrameEntry::copy(const FrameEntry& other)
     }
 } // FrameEntry::copy
 
+void
+FrameEntry::compress(const float* src)
+{
+    assert( isCompressed() );
+    boost::uint16_t* dst = (boost::uint16_t*)data();
+    assert(dst && src);
+    if (!dst || !src) {
+        return;
+    }
+    const CacheEntryStorageInfo& info = _params->getStorageInfo();
+    const std::size_t nElements = info.bounds.area() * info.numComponents;
+    for (std::size_t i = 0; i < nElements; ++i) {
+        dst[i] = floatToHalf(src[i]);
+    }
+}
+
+void
+FrameEntry::decompress(float* dst) const
+{
+    assert( isCompressed() );
+    const boost::uint16_t* src = (const boost::uint16_t*)data();
+    assert(dst && src);
+    if (!dst || !src) {
+        return;
+    }
+    const CacheEntryStorageInfo& info = _params->getStorageInfo();
+    const std::size_t nElements = info.bounds.area() * info.numComponents;
+    for (std::size_t i = 0; i < nElements; ++i) {
+        dst[i] = halfToFloat(src[i]);
+    }
+}
+
 NATRON_NAMESPACE_EXIT
@@ -56,6 +56,10 @@ public:
                const FrameParamsPtr &  params,
                const CacheAPI* cache)
         : CacheEntryHelper<U8, FrameKey, FrameParams>(key, params, cache)
+        , _autoContrastRangeSet(false)
+        , _autoContrastChannels(eDisplayChannelsRGB)
+        , _autoContrastMin(0.)
+        , _autoContrastMax(0.)
     {
     }
 
@@ -75,6 +79,25 @@ public:
 
     const U8* pixelAt(int x, int y ) const WARN_UNUSED_RETURN;
 
+    /**
+     * @brief Returns true if the entry holds a 32-bit floating point texture stored as 16-bit half-floats,
+     * in which case the texture must go through compress() and decompress() instead of data().
+     **/
+    bool isCompressed() const
+    {
+        return (ImageBitDepthEnum)_key.getBitDepth() == eImageBitDepthHalf;
+    }
+
+    /**
+     * @brief Stores the given RGBA 32-bit floating point texture, which must have the size of the entry, as half-floats.
+     **/
+    void compress(const float* src);
+
+    /**
+     * @brief Expands the half-floats held by the entry to a 32-bit floating point texture in dst.
+     **/
+    void decompress(float* dst) const;
+
     void copy(const FrameEntry& other);
 
 
@@ -92,8 +115,43 @@ public:
         _params->setInternalImage(image);
     }
 
+    /**
+     * @brief Returns the range of the values of the texture for the given display channels, as computed when
+     * the texture was converted, so that the auto-contrast does not have to scan it again.
+     * Returns false if it was not computed for these channels.
+     **/
+    bool getAutoContrastRange(DisplayChannelsEnum channels,
+                              double* vmin,
+                              double* vmax) const
+    {
+        QReadLocker k(&_entryLock);
+
+        if ( !_autoContrastRangeSet || (_autoContrastChannels != channels) ) {
+            return false;
+        }
+        *vmin = _autoContrastMin;
+        *vmax = _autoContrastMax;
+
+        return true;
+    }
+
+    void setAutoContrastRange(DisplayChannelsEnum channels,
+                              double vmin,
+                              double vmax)
+    {
+        QWriteLocker k(&_entryLock);
+
+        _autoContrastRangeSet = true;
+        _autoContrastChannels = channels;
+        _autoContrastMin = vmin;
+        _autoContrastMax = vmax;
+    }
 
+private:
 
+    bool _autoContrastRangeSet;
+    DisplayChannelsEnum _autoContrastChannels;
+    double _autoContrastMin, _autoContrastMax;
 };
 
 NATRON_NAMESPACE_EXIT
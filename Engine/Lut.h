@@ -32,6 +32,7 @@
 ///
 
 
+#include <cassert>
 #include <cmath>
 #include <map>
 #include <string>
@@ -214,6 +215,16 @@ public:
      */
     unsigned short toColorSpaceUint8xxFromLinearFloatFast(float v) const;
 
+    /* @brief The look-up table used by toColorSpaceUint8xxFromLinearFloatFast(), indexed by the 16 high bits of the float.
+     * This is used by vectorized conversions.
+     */
+    const unsigned short* getToColorSpaceUint8xxTable() const
+    {
+        assert(init_);
+
+        return toFunc_hipart_to_uint8xx;
+    }
+
     /* @brief Converts a float ranging in [0 - 1.f] in linear color-space using the look-up tables.
      * @return An unsigned short in [0 - 65535] in the destination color-space.
      * This function uses localluy linear approximations of the transfer function.
@@ -2808,6 +2808,9 @@ Node::deactivate(const std::list<NodePtr> & outputsToDisconnect,
         _imp->abortPreview_non_blocking();
     }
 
+    // The render plans hold the effects of the nodes upstream
+    _imp->effect->clearRenderPlanCache();
+
     NodeCollectionPtr parentCol = getGroup();
 
 
@@ -3337,6 +3340,7 @@ Node::makePreviewImage(SequenceTime time,
 
     {
         AbortableRenderInfoPtr abortInfo = AbortableRenderInfo::create(true, 0);
+        abortInfo->setPriority(eRenderPriorityPreview);
         const bool isRenderUserInteraction = true;
         const bool isSequentialRender = false;
         AbortableThread* isAbortable = dynamic_cast<AbortableThread*>( QThread::currentThread() );
@@ -6246,6 +6250,8 @@ Node::markAllInputRelatedDataDirty()
         QMutexLocker k(&_imp->pluginsPropMutex);
         _imp->mustComputeInputRelatedData = true;
     }
+    // The refresh is forced because something the metadata depend on changed, but not the hash (e.g. the project format)
+    _imp->effect->clearMetadataActionCache();
     if ( isRotoPaintingNode() ) {
         RotoContextPtr roto = getRotoContext();
         assert(roto);
@@ -62,6 +62,7 @@ CLANG_DIAG_ON(unknown-pragmas)
 #include "Engine/OfxImageEffectInstance.h"
 #include "Engine/OfxOverlayInteract.h"
 #include "Engine/OfxParamInstance.h"
+#include "Engine/ParallelRenderArgs.h"
 #include "Engine/Project.h"
 #include "Engine/ReadNode.h"
 #include "Engine/RotoLayer.h"
@@ -240,6 +241,10 @@ struct OfxEffectInstancePrivate
     bool doesTemporalAccess;
     bool multiplanar;
 
+    // The knobs captured by captureKnobValues, indexed by their slot
+    mutable QMutex knobValuesSlotsMutex;
+    std::vector<KnobIWPtr> knobValuesSlots;
+
     OfxEffectInstancePrivate()
         : effect()
         , natronPluginID()
@@ -268,6 +273,8 @@ struct OfxEffectInstancePrivate
         , supportsMultipleClipDepths(false)
         , doesTemporalAccess(false)
         , multiplanar(false)
+        , knobValuesSlotsMutex()
+        , knobValuesSlots()
     {
     }
 
@@ -295,6 +302,8 @@ struct OfxEffectInstancePrivate
         , supportsMultipleClipDepths(other.supportsMultipleClipDepths)
         , doesTemporalAccess(other.doesTemporalAccess)
         , multiplanar(other.multiplanar)
+        , knobValuesSlotsMutex()
+        , knobValuesSlots(other.knobValuesSlots)
     {
     }
 };
@@ -3137,6 +3146,42 @@ OfxEffectInstance::supportsConcurrentOpenGLRenders() const
     return _imp->supportsConcurrentGLRenders;
 }
 
+int
+OfxEffectInstance::addKnobValuesSnapshotSlot(const KnobIPtr& knob)
+{
+    QMutexLocker k(&_imp->knobValuesSlotsMutex);
+
+    for (std::size_t i = 0; i < _imp->knobValuesSlots.size(); ++i) {
+        if (_imp->knobValuesSlots[i].lock() == knob) {
+            return (int)i;
+        }
+    }
+    _imp->knobValuesSlots.push_back(knob);
+
+    return (int)_imp->knobValuesSlots.size() - 1;
+}
+
+KnobValuesSnapshotPtr
+OfxEffectInstance::captureKnobValues(double time,
+                                     ViewIdx view) const
+{
+    std::vector<KnobIPtr> knobs;
+    {
+        QMutexLocker k(&_imp->knobValuesSlotsMutex);
+        if ( _imp->knobValuesSlots.empty() ) {
+            return KnobValuesSnapshotPtr();
+        }
+        knobs.reserve( _imp->knobValuesSlots.size() );
+        for (std::vector<KnobIWPtr>::const_iterator it = _imp->knobValuesSlots.begin(); it != _imp->knobValuesSlots.end(); ++it) {
+            // A knob that was deleted keeps its slot, it is just not captured
+            knobs.push_back( it->lock() );
+        }
+    }
+
+    // Do not hold the lock while reading the values: expressions may read parameters of other effects
+    return boost::make_shared<KnobValuesSnapshot>(knobs, time, view);
+}
+
 StatusEnum
 OfxEffectInstance::attachOpenGLContext(EffectInstance::OpenGLContextEffectDataPtr* data)
 {
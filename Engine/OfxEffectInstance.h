@@ -208,6 +208,7 @@ public:
                             int* inputNb) OVERRIDE;
     virtual RenderSafetyEnum renderThreadSafety() const OVERRIDE FINAL WARN_UNUSED_RETURN;
     virtual void purgeCaches() OVERRIDE;
+    virtual KnobValuesSnapshotPtr captureKnobValues(double time, ViewIdx view) const OVERRIDE FINAL WARN_UNUSED_RETURN;
 
     /**
      * @brief Does this effect supports tiling ?
@@ -300,6 +301,13 @@ public:
     void onClipLabelChanged(int inputNb, const std::string& label);
     void onClipHintChanged(int inputNb, const std::string& hint);
     void onClipSecretChanged(int inputNb, bool isSecret);
+
+    /**
+     * @brief Registers a knob whose values are captured by captureKnobValues and returns its slot in the captured values.
+     * Registering the same knob twice returns the same slot.
+     **/
+    int addKnobValuesSnapshotSlot(const KnobIPtr& knob);
+
 public Q_SLOTS:
 
     void onSyncPrivateDataRequested();
@@ -32,7 +32,10 @@
 #include <stdexcept> // std::exception
 #include <cctype> // tolower
 #include <algorithm> // transform, min, max
+#include <list>
+#include <set>
 #include <string>
+#include <vector>
 #include <cstring> // for std::memcpy, std::memset, std::strcmp
 
 CLANG_DIAG_OFF(deprecated)
@@ -40,16 +43,17 @@ CLANG_DIAG_OFF(uninitialized)
 CLANG_DIAG_OFF(deprecated-register) //'register' storage class specifier is deprecated
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QMutex>
 #include <QtCore/QThreadPool>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDebug>
-#include <QtCore/QTemporaryFile>
+#include <QtConcurrentMap> // QtCore on Qt4, QtConcurrent on Qt5
 CLANG_DIAG_ON(deprecated-register)
 #ifdef OFX_SUPPORTS_MULTITHREAD
 #include <QtCore/QThread>
 #include <QtCore/QThreadStorage>
-#include <QtConcurrentMap> // QtCore on Qt4, QtConcurrent on Qt5
 GCC_DIAG_UNUSED_LOCAL_TYPEDEFS_OFF
 // /usr/local/include/boost/bind/arg.hpp:37:9: warning: unused typedef 'boost_static_assert_typedef_37' [-Wunused-local-typedef]
 #include <boost/bind.hpp>
@@ -84,7 +88,6 @@ CLANG_DIAG_ON(unknown-pragmas)
 #include <ofxhParametricParam.h> //our version of parametric param suite support
 
 #include "Global/GlobalDefines.h"
-#include "Global/FStreamsSupport.h"
 #include "Global/QtCompat.h"
 #include "Global/KeySymbols.h"
 #ifdef DEBUG
@@ -103,12 +106,17 @@ CLANG_DIAG_ON(unknown-pragmas)
 #include "Engine/OfxImageEffectInstance.h"
 #include "Engine/OutputSchedulerThread.h"
 #include "Engine/OfxMemory.h"
+#include "Engine/OfxMutex.h"
+#include "Engine/OfxPluginIndex.h"
+#include "Engine/ParallelRenderArgs.h"
 #include "Engine/Plugin.h"
 #include "Engine/Project.h"
+#include "Engine/RenderStats.h"
 #include "Engine/Settings.h"
 #include "Engine/StandardPaths.h"
 #include "Engine/TLSHolder.h"
 #include "Engine/ThreadPool.h"
+#include "Engine/Timer.h"
 
 //An effect may not use more than this amount of threads
 #define NATRON_MULTI_THREAD_SUITE_MAX_NUM_CPU 4
@@ -151,24 +159,30 @@ struct OfxHostPrivate
     OFX::Host::ImageEffect::PluginCachePtr imageEffectPluginCache;
     boost::shared_ptr<TLSHolder<OfxHost::OfxHostTLSData> > tlsData;
 
-#ifdef MULTI_THREAD_SUITE_USES_THREAD_SAFE_MUTEX_ALLOCATION
-    std::list<QMutex*> pluginsMutexes;
-    QMutex* pluginsMutexesLock; //<protects _pluginsMutexes
-#endif
-    std::string loadingPluginID; // ID of the plugin being loaded
-    int loadingPluginVersionMajor;
-    int loadingPluginVersionMinor;
+    // The mutexes of the multi-thread suite
+    OfxMutexPool mutexPool;
+
+    // Protects deferredBinariesLoaded
+    QMutex deferredPluginsLoadMutex;
+
+    // The bundle binaries of the plug-ins registered from the plug-ins index that were loaded on first use,
+    // including those that failed to load, so that they are not tried again
+    std::set<std::string> deferredBinariesLoaded;
+
+    // The binaries loaded by loadOFXPluginBinary(): the other binaries are owned by the OpenFX plug-ins cache
+    std::list<OFX::Host::PluginBinary*> ownedBinaries;
+
+    // Protects the OpenFX plug-ins cache and ownedBinaries while bundles are loaded concurrently
+    QMutex pluginCacheMutex;
 
     OfxHostPrivate()
         : imageEffectPluginCache()
         , tlsData( new TLSHolder<OfxHost::OfxHostTLSData>() )
-#ifdef MULTI_THREAD_SUITE_USES_THREAD_SAFE_MUTEX_ALLOCATION
-        , pluginsMutexes()
-        , pluginsMutexesLock(0)
-#endif
-        , loadingPluginID()
-        , loadingPluginVersionMajor(0)
-        , loadingPluginVersionMinor(0)
+        , mutexPool()
+        , deferredPluginsLoadMutex()
+        , deferredBinariesLoaded()
+        , ownedBinaries()
+        , pluginCacheMutex()
     {
     }
 };
@@ -182,11 +196,11 @@ OfxHost::OfxHost()
 OfxHost::~OfxHost()
 {
     //Clean up, to be polite.
+    for (std::list<OFX::Host::PluginBinary*>::iterator it = _imp->ownedBinaries.begin(); it != _imp->ownedBinaries.end(); ++it) {
+        delete *it;
+    }
+    _imp->ownedBinaries.clear();
     OFX::Host::PluginCache::clearPluginCache();
-
-#ifdef MULTI_THREAD_SUITE_USES_THREAD_SAFE_MUTEX_ALLOCATION
-    delete _imp->pluginsMutexesLock;
-#endif
 }
 
 OfxHost::OfxHostDataTLSPtr
@@ -418,13 +432,13 @@ OfxHost::getStringProperty(const std::string &name,
         std::string pluginID;
         int pluginVersionMajor = 0;
         int pluginVersionMinor = 0;
-        if ( !_imp->loadingPluginID.empty() ) {
+        OfxHostDataTLSPtr tls = _imp->tlsData->getOrCreateTLSData();
+        if ( tls && !tls->loadingPluginID.empty() ) {
             // plugin is not yet created: we are loading or describing it
-            pluginID = _imp->loadingPluginID;
-            pluginVersionMajor = _imp->loadingPluginVersionMajor;
-            pluginVersionMinor = _imp->loadingPluginVersionMinor;
+            pluginID = tls->loadingPluginID;
+            pluginVersionMajor = tls->loadingPluginVersionMajor;
+            pluginVersionMinor = tls->loadingPluginVersionMinor;
         } else {
-            OfxHostDataTLSPtr tls = _imp->tlsData->getOrCreateTLSData();
             if (tls && tls->lastEffectCallingMainEntry) {
                 pluginID = tls->lastEffectCallingMainEntry->getPlugin()->getIdentifier();
                 pluginVersionMajor = tls->lastEffectCallingMainEntry->getPlugin()->getVersionMajor();
@@ -639,9 +653,10 @@ OFX::Host::ImageEffect::Descriptor*
 OfxHost::getPluginContextAndDescribe(OFX::Host::ImageEffect::ImageEffectPlugin* plugin,
                                      ContextEnum* ctx)
 {
-    _imp->loadingPluginID = plugin->getRawIdentifier();
-    _imp->loadingPluginVersionMajor = plugin->getVersionMajor();
-    _imp->loadingPluginVersionMinor = plugin->getVersionMajor();
+    OfxHostDataTLSPtr tls = _imp->tlsData->getOrCreateTLSData();
+    tls->loadingPluginID = plugin->getRawIdentifier();
+    tls->loadingPluginVersionMajor = plugin->getVersionMajor();
+    tls->loadingPluginVersionMinor = plugin->getVersionMinor();
 
     OFX::Host::PluginHandle *pluginHandle;
     // getPluginHandle() must be called before getContexts():
@@ -696,7 +711,7 @@ OfxHost::getPluginContextAndDescribe(OFX::Host::ImageEffect::ImageEffectPlugin*
 
 
     *ctx = OfxEffectInstance::mapToContextEnum(context);
-    _imp->loadingPluginID.clear();
+    tls->loadingPluginID.clear();
 
     return desc;
 } // OfxHost::getPluginContextAndDescribe
@@ -758,20 +773,6 @@ getOFXCacheDirPath()
     return ofxCachePath;
 }
 
-///Return the xml cache file used after Natron 2 RC2
-static QString
-getCacheFilePath()
-{
-    QString ofxCachePath = getOFXCacheDirPath() + QLatin1Char('/');
-    QString ofxCacheFilePath = ofxCachePath + QString::fromUtf8("OFXCache_") +
-                               QString::fromUtf8(NATRON_VERSION_STRING) + QString::fromUtf8("_") +
-                               QString::fromUtf8(NATRON_DEVELOPMENT_STATUS) + QString::fromUtf8("_") +
-                               QString::number(NATRON_BUILD_NUMBER) + QString::fromUtf8(".xml");
-
-    return ofxCacheFilePath;
-}
-
-
 static void
 getPluginShortcuts(const OFX::Host::ImageEffect::Descriptor& desc, std::list<PluginActionShortcut>* shortcuts)
 {
@@ -841,6 +842,274 @@ getPluginShortcuts(const OFX::Host::ImageEffect::Descriptor& desc, std::list<Plu
     }
 }
 
+///Return the index of the OpenFX plug-ins, from which they are registered at startup
+static QString
+getPluginIndexFilePath()
+{
+    QString ofxCachePath = getOFXCacheDirPath() + QLatin1Char('/');
+    QString indexFilePath = ofxCachePath + QString::fromUtf8("OFXPluginIndex_") +
+                            QString::fromUtf8(NATRON_VERSION_STRING) + QString::fromUtf8("_") +
+                            QString::fromUtf8(NATRON_DEVELOPMENT_STATUS) + QString::fromUtf8("_") +
+                            QString::number(NATRON_BUILD_NUMBER) + QString::fromUtf8(".bin");
+
+    return indexFilePath;
+}
+
+/**
+ * @brief Extracts from the OpenFX plug-in descriptor everything needed to register it in the application.
+ **/
+static void
+makePluginIndexEntry(OFX::Host::ImageEffect::ImageEffectPlugin* p,
+                     OfxPluginIndex::PluginEntry* entry)
+{
+    std::string openfxId = p->getIdentifier();
+    const std::string & grouping = p->getDescriptor().getPluginGrouping();
+    const std::string & bundlePath = p->getBinary()->getBundlePath();
+    std::string pluginLabel = OfxEffectInstance::makePluginLabel( p->getDescriptor().getShortLabel(),
+                                                                  p->getDescriptor().getLabel(),
+                                                                  p->getDescriptor().getLongLabel() );
+    QStringList groups = OfxEffectInstance::makePluginGrouping(p->getIdentifier(),
+                                                               p->getVersionMajor(), p->getVersionMinor(),
+                                                               pluginLabel, grouping);
+    for (int i = 0; i < groups.size(); ++i) {
+        groups[i] = groups[i].trimmed();
+    }
+
+    const std::string resourcesPathStr(bundlePath + "/Contents/Resources/");
+    QString resourcesPath = QString::fromUtf8( resourcesPathStr.c_str() );
+    QString iconFileName;
+    std::string pngIcon;
+    try {
+        // kOfxPropIcon is normally only defined for parameter desctriptors
+        // (see <http://openfx.sourceforge.net/Documentation/1.3/ofxProgrammingReference.html#ParameterProperties>)
+        // but let's assume it may also be defained on the plugin descriptor.
+        pngIcon = p->getDescriptor().getProps().getStringProperty(kOfxPropIcon, 1); // dimension 1 is PNG icon
+    } catch (OFX::Host::Property::Exception) {
+    }
+
+    if ( pngIcon.empty() ) {
+        // no icon defined by kOfxPropIcon, use the default value
+        pngIcon = openfxId + ".png";
+    }
+    iconFileName.append(resourcesPath);
+    iconFileName.append( QString::fromUtf8( pngIcon.c_str() ) );
+    QString groupIconFilename;
+    if (groups.size() > 0) {
+        groupIconFilename = resourcesPath;
+        // the plugin grouping has no descriptor, just try the default filename.
+        groupIconFilename.append(groups[0]);
+        groupIconFilename.append( QString::fromUtf8(".png") );
+    } else {
+        //Use default Misc group when the plug-in doesn't belong to a group
+        groups.push_back( QString::fromUtf8(PLUGIN_GROUP_DEFAULT) );
+    }
+    QStringList groupIcons;
+    groupIcons << groupIconFilename;
+    for (int i = 1; i < groups.size(); ++i) {
+        QString groupIconPath = resourcesPath;
+        for (int j = 0; j <= i; ++j) {
+            groupIconPath += groups[j];
+            if (j < i) {
+                groupIconPath += QLatin1Char('/');
+            } else {
+                groupIconPath.append( QString::fromUtf8(".png") );
+            }
+        }
+        groupIcons << groupIconPath;
+    }
+
+    const std::set<std::string> & contexts = p->getContexts();
+    entry->pluginID = QString::fromUtf8( openfxId.c_str() );
+    entry->pluginLabel = QString::fromUtf8( pluginLabel.c_str() );
+    entry->resourcesPath = resourcesPath;
+    entry->iconFilePath = iconFileName;
+    entry->groupIconFilePath = groupIcons;
+    entry->grouping = groups;
+    entry->majorVersion = p->getVersionMajor();
+    entry->minorVersion = p->getVersionMinor();
+    entry->isReader = contexts.find(kOfxImageEffectContextReader) != contexts.end();
+    entry->isWriter = contexts.find(kOfxImageEffectContextWriter) != contexts.end();
+    entry->isDeprecated = p->getDescriptor().isDeprecated();
+    entry->isInternalOnly = openfxId == PLUGINID_OFX_ROTO;
+    entry->renderThreadUnsafe = p->getDescriptor().getRenderThreadSafety() == kOfxImageEffectRenderUnsafe;
+
+    entry->openglRenderSupport = ePluginOpenGLRenderSupportNone;
+    {
+        const std::string& str = p->getDescriptor().getProps().getStringProperty(kOfxImageEffectPropOpenGLRenderSupported);
+        if (str == "false") {
+            entry->openglRenderSupport = ePluginOpenGLRenderSupportNone;
+        } else if (str == "needed") {
+            entry->openglRenderSupport = ePluginOpenGLRenderSupportNeeded;
+        } else if (str == "true") {
+            entry->openglRenderSupport = ePluginOpenGLRenderSupportYes;
+        }
+    }
+
+    getPluginShortcuts(p->getDescriptor(), &entry->shortcuts);
+
+    ///if this plugin's descriptor has the kTuttleOfxImageEffectPropSupportedExtensions property,
+    ///use it to fill the readersMap and writersMap
+    int formatsCount = p->getDescriptor().getProps().getDimension(kTuttleOfxImageEffectPropSupportedExtensions);
+    entry->formats.resize(formatsCount);
+    for (int k = 0; k < formatsCount; ++k) {
+        entry->formats[k] = p->getDescriptor().getProps().getStringProperty(kTuttleOfxImageEffectPropSupportedExtensions, k);
+        std::transform(entry->formats[k].begin(), entry->formats[k].end(), entry->formats[k].begin(), ::tolower);
+    }
+
+    entry->evaluation = p->getDescriptor().getProps().getDoubleProperty(kTuttleOfxImageEffectPropEvaluation);
+} // makePluginIndexEntry
+
+/**
+ * @brief Registers the plug-in in the application. If p is NULL, the given bundle binary is loaded
+ * by OfxHost::loadDeferredOFXPlugin() when the plug-in is first used.
+ **/
+static void
+registerOFXPlugin(const OfxPluginIndex::PluginEntry& entry,
+                  OFX::Host::ImageEffect::ImageEffectPlugin* p,
+                  const QString& binaryFilePath,
+                  const QString& bundlePath,
+                  IOPluginsMap* readersMap,
+                  IOPluginsMap* writersMap)
+{
+    Plugin* natronPlugin = appPTR->registerPlugin( entry.resourcesPath,
+                                                   entry.grouping,
+                                                   entry.pluginID,
+                                                   entry.pluginLabel,
+                                                   entry.iconFilePath,
+                                                   entry.groupIconFilePath,
+                                                   entry.isReader,
+                                                   entry.isWriter,
+                                                   new LibraryBinary(LibraryBinary::eLibraryTypeBuiltin),
+                                                   entry.renderThreadUnsafe,
+                                                   entry.majorVersion, entry.minorVersion, entry.isDeprecated );
+    if (entry.isInternalOnly) {
+        natronPlugin->setForInternalUseOnly(true);
+    }
+
+    natronPlugin->setOpenGLRenderSupport(entry.openglRenderSupport);
+
+    if (p) {
+        natronPlugin->setOfxPlugin(p);
+    } else {
+        natronPlugin->setOfxPluginDeferred( binaryFilePath.toStdString(), bundlePath.toStdString() );
+    }
+
+    natronPlugin->setShorcuts(entry.shortcuts);
+
+    const std::string openfxId = entry.pluginID.toStdString();
+    if (!entry.isDeprecated && entry.isReader && !entry.formats.empty() && readersMap) {
+        ///we're safe to assume that this plugin is a reader
+        for (std::size_t k = 0; k < entry.formats.size(); ++k) {
+            IOPluginSetForFormat& evalForFormat = (*readersMap)[entry.formats[k]];
+            evalForFormat.insert( IOPluginEvaluation(openfxId, entry.evaluation) );
+        }
+    } else if (!entry.isDeprecated && entry.isWriter && !entry.formats.empty() && writersMap) {
+        ///we're safe to assume that this plugin is a writer.
+        for (std::size_t k = 0; k < entry.formats.size(); ++k) {
+            IOPluginSetForFormat& evalForFormat = (*writersMap)[entry.formats[k]];
+            evalForFormat.insert( IOPluginEvaluation(openfxId, entry.evaluation) );
+        }
+    }
+} // registerOFXPlugin
+
+/**
+ * @brief Appends to changedBundles the OpenFX bundles found in the given directory and its sub-directories that are not
+ * in the given index or whose binary changed since it was built, and the other bundles to upToDateBundles if it is not NULL.
+ * If index is NULL, all the bundles are appended to changedBundles.
+ * Symbolic links to directories are followed, as the OpenFX host does, but each directory is only visited once:
+ * visitedDirs holds the canonical paths of the directories visited so far, so that a symbolic link loop terminates.
+ **/
+static void
+findBundles(const QString& dirPath,
+            const OfxPluginIndex* index,
+            std::set<QString>* visitedDirs,
+            QStringList* upToDateBundles,
+            QStringList* changedBundles)
+{
+    const QString canonicalPath = QFileInfo(dirPath).canonicalFilePath();
+
+    if ( canonicalPath.isEmpty() || !visitedDirs->insert(canonicalPath).second ) {
+        // Does not exist, or already visited
+        return;
+    }
+
+    QDir dir(dirPath);
+    QStringList subDirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+
+    for (QStringList::const_iterator it = subDirs.begin(); it != subDirs.end(); ++it) {
+        QString subDirPath = dir.absoluteFilePath(*it);
+        if ( !it->endsWith( QString::fromUtf8(".ofx.bundle") ) ) {
+            findBundles(subDirPath, index, visitedDirs, upToDateBundles, changedBundles);
+            continue;
+        }
+        if ( !visitedDirs->insert( QFileInfo(subDirPath).canonicalFilePath() ).second ) {
+            // The same bundle reached through a symbolic link
+            continue;
+        }
+        if ( index && index->isBundleUpToDate(subDirPath) ) {
+            if (upToDateBundles) {
+                upToDateBundles->push_back(subDirPath);
+            }
+        } else {
+            changedBundles->push_back(subDirPath);
+        }
+    }
+}
+
+/**
+ * @brief Returns the name of the directory of an OpenFX bundle holding the binary for this platform,
+ * as chosen by the OpenFX host support library.
+ **/
+static QString
+getBundleArchitectureDirName()
+{
+#if defined(__APPLE__)
+    return QString::fromUtf8("MacOS");
+#elif defined(_WIN32)
+    return QString::fromUtf8(sizeof(void*) == 8 ? "Win64" : "Win32");
+#elif defined(__FreeBSD__)
+    return QString::fromUtf8(sizeof(void*) == 8 ? "FreeBSD-x86-64" : "FreeBSD-x86");
+#else
+    return QString::fromUtf8(sizeof(void*) == 8 ? "Linux-x86-64" : "Linux-x86");
+#endif
+}
+
+/**
+ * @brief Returns the binary the OpenFX host loads for the given bundle: <name>.ofx.bundle/Contents/<architecture>/<name>.ofx
+ **/
+static QString
+getBundleBinaryFilePath(const QString& bundlePath)
+{
+    QString bundleName = QFileInfo(bundlePath).fileName();
+
+    bundleName.chop( (int)std::strlen(".bundle") );
+
+    return bundlePath + QString::fromUtf8("/Contents/") + getBundleArchitectureDirName() + QLatin1Char('/') + bundleName;
+}
+
+/**
+ * @brief Returns true if a plug-in of the given bundle was flagged as not thread-safe (kOfxImageEffectRenderUnsafe)
+ * when the index was built: such a plug-in is not trusted to be described concurrently with other plug-ins either.
+ **/
+static bool
+isBundleThreadUnsafe(const OfxPluginIndex& index,
+                     const QString& bundlePath)
+{
+    const OfxPluginIndex::BundlesMap& bundles = index.getBundles();
+    OfxPluginIndex::BundlesMap::const_iterator found = bundles.find( QDir::cleanPath( QFileInfo(bundlePath).absoluteFilePath() ) );
+
+    if ( found == bundles.end() ) {
+        return false;
+    }
+    for (std::list<OfxPluginIndex::PluginEntry>::const_iterator it = found->second.plugins.begin(); it != found->second.plugins.end(); ++it) {
+        if (it->renderThreadUnsafe) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 static inline
 QDebug operator<<(QDebug dbg, const std::list<std::string> &l)
 {
@@ -866,9 +1135,6 @@ OfxHost::loadOFXPlugins(IOPluginsMap* readersMap,
     }
     OFX::Host::PluginCache* pluginCache = OFX::Host::PluginCache::getPluginCache();
     assert(pluginCache);
-    /// set the version label in the global cache
-    pluginCache->setCacheVersion(NATRON_APPLICATION_NAME "OFXCachev1");
-
     /// register the image effect cache with the global plugin cache
     _imp->imageEffectPluginCache->registerInCache( *pluginCache );
 
@@ -902,215 +1168,203 @@ OfxHost::loadOFXPlugins(IOPluginsMap* readersMap,
         // ignore
     }
 
-    // The cache location depends on the OS.
-    // On OSX, it will be ~/Library/Caches/<organization>/<application>/OFXLoadCache/
-    //on Linux ~/.cache/<organization>/<application>/OFXLoadCache/
-    //on windows: C:\Users\<username>\App Data\Local\<organization>\<application>\Caches\OFXLoadCache
-    QString ofxCacheFilePath = getCacheFilePath();
-    qDebug() << "Load OFX Plugins: reading cache file" << ofxCacheFilePath;
-
-    {
-        FStreamsSupport::ifstream ifs;
-        FStreamsSupport::open( &ifs, ofxCacheFilePath.toStdString() );
-        if (!ifs) {
-            qDebug() << "Load OFX Plugins: cannot open cache file" << ofxCacheFilePath;
-        } else {
-            try {
-                pluginCache->readCache(ifs);
-                qDebug() << "Load OFX Plugins: reading cache file... done!";
-            } catch (const std::exception& e) {
-                qDebug() << "Load OFX Plugins: reading cache file... failed!";
-                appPTR->writeToErrorLog_mt_safe( QLatin1String("OpenFX"), QDateTime::currentDateTime(),
-                                                 tr("Failure to read OpenFX plug-ins cache: %1").arg( QString::fromUtf8( e.what() ) ) );
+    // The plug-ins are registered from the plug-ins index: the binary of a bundle is only loaded and described by
+    // loadDeferredOFXPlugin() when one of its plug-ins is first used.
+    const std::list<std::string>& pluginPath = pluginCache->getPluginPath();
+    QString pluginIndexFilePath = getPluginIndexFilePath();
+    OfxPluginIndex previousIndex;
+    const bool previousIndexRead = previousIndex.read(pluginIndexFilePath);
+    if ( previousIndexRead && previousIndex.isUpToDate(pluginPath) ) {
+        qDebug() << "Load OFX Plugins: registering plugins from index file" << pluginIndexFilePath;
+        const OfxPluginIndex::BundlesMap& bundles = previousIndex.getBundles();
+        for (OfxPluginIndex::BundlesMap::const_iterator it = bundles.begin(); it != bundles.end(); ++it) {
+            for (std::list<OfxPluginIndex::PluginEntry>::const_iterator it2 = it->second.plugins.begin(); it2 != it->second.plugins.end(); ++it2) {
+                registerOFXPlugin(*it2, 0, it->second.binaryFilePath, it->second.bundlePath, readersMap, writersMap);
             }
         }
-    }
-    
-    qDebug() << "Load OFX Plugins: plugin path is" << pluginCache->getPluginPath();
-    qDebug() << "Load OFX Plugins: scan plugins...";
-    pluginCache->scanPluginFiles();
-    qDebug() << "Load OFX Plugins: scan plugins... done!";
-    _imp->loadingPluginID.clear(); // finished loading plugins
+        qDebug() << "Load OFX Plugins... deferred!";
 
-    if ( pluginCache->dirty() ) {
-        // write the cache NOW (it won't change anyway)
-        qDebug() << "Load OFX Plugins: writing cache file" << ofxCacheFilePath;
-        /// flush out the current cache
-        writeOFXCache();
-        qDebug() << "Load OFX Plugins: writing cache file... done!";
+        return;
     }
 
-    /*Filling node name list and plugin grouping*/
-    typedef std::map<OFX::Host::ImageEffect::MajorPlugin, OFX::Host::ImageEffect::ImageEffectPlugin *> PMap;
-    const PMap& ofxPlugins =
-        _imp->imageEffectPluginCache->getPluginsByIDMajor();
+    // There is no index yet, or some bundles were added, removed or updated since it was written. The bundles that did not
+    // change are registered from the index and loaded on first use, and only the others are loaded and described now.
+    qDebug() << "Load OFX Plugins: updating index file" << pluginIndexFilePath;
+    QStringList upToDateBundles, changedBundles;
+    std::set<QString> visitedDirs;
+    for (std::list<std::string>::const_iterator it = pluginPath.begin(); it != pluginPath.end(); ++it) {
+        findBundles(QString::fromUtf8( it->c_str() ), previousIndexRead ? &previousIndex : 0, &visitedDirs, &upToDateBundles, &changedBundles);
+    }
 
+    OfxPluginIndex index;
+    index.setPluginPath(pluginPath);
 
-    for (PMap::const_iterator it = ofxPlugins.begin();
-         it != ofxPlugins.end(); ++it) {
-        OFX::Host::ImageEffect::ImageEffectPlugin* p = it->second;
-        assert(p);
-        if (p->getContexts().size() == 0) {
-            continue;
-        }
-        assert( p->getBinary() );
-        if ( !p->getBinary() ) {
+    for (QStringList::const_iterator it = upToDateBundles.begin(); it != upToDateBundles.end(); ++it) {
+        const OfxPluginIndex::BundleEntry* bundle = previousIndex.findUpToDateBundle(*it);
+        assert(bundle);
+        if (!bundle) {
             continue;
         }
-
-        std::string openfxId = p->getIdentifier();
-        const std::string & grouping = p->getDescriptor().getPluginGrouping();
-        const std::string & bundlePath = p->getBinary()->getBundlePath();
-        std::string pluginLabel = OfxEffectInstance::makePluginLabel( p->getDescriptor().getShortLabel(),
-                                                                      p->getDescriptor().getLabel(),
-                                                                      p->getDescriptor().getLongLabel() );
-        QStringList groups = OfxEffectInstance::makePluginGrouping(p->getIdentifier(),
-                                                                   p->getVersionMajor(), p->getVersionMinor(),
-                                                                   pluginLabel, grouping);
-        for (int i = 0; i < groups.size(); ++i) {
-            groups[i] = groups[i].trimmed();
-        }
-
-        const std::string resourcesPathStr(bundlePath + "/Contents/Resources/");
-        QString resourcesPath = QString::fromUtf8( resourcesPathStr.c_str() );
-        QString iconFileName;
-        std::string pngIcon;
-        try {
-            // kOfxPropIcon is normally only defined for parameter desctriptors
-            // (see <http://openfx.sourceforge.net/Documentation/1.3/ofxProgrammingReference.html#ParameterProperties>)
-            // but let's assume it may also be defained on the plugin descriptor.
-            pngIcon = p->getDescriptor().getProps().getStringProperty(kOfxPropIcon, 1); // dimension 1 is PNG icon
-        } catch (OFX::Host::Property::Exception) {
+        for (std::list<OfxPluginIndex::PluginEntry>::const_iterator it2 = bundle->plugins.begin(); it2 != bundle->plugins.end(); ++it2) {
+            registerOFXPlugin(*it2, 0, bundle->binaryFilePath, bundle->bundlePath, readersMap, writersMap);
+            index.addPlugin(bundle->binaryFilePath.toStdString(), bundle->bundlePath.toStdString(), *it2);
         }
+    }
 
-        if ( pngIcon.empty() ) {
-            // no icon defined by kOfxPropIcon, use the default value
-            pngIcon = openfxId + ".png";
+    // The bundles are loaded and described concurrently, each one by a single thread, since the descriptions of the plug-ins
+    // are independent. The bundles of which a plug-in was flagged as not thread-safe are described serially afterwards.
+    std::vector<IndexedBundleLoad> loads;
+    {
+        QMutexLocker k(&_imp->deferredPluginsLoadMutex);
+        for (QStringList::const_iterator it = changedBundles.begin(); it != changedBundles.end(); ++it) {
+            const QString binaryFilePath = getBundleBinaryFilePath(*it);
+            if ( !QFile::exists(binaryFilePath) ) {
+                continue;
+            }
+            _imp->deferredBinariesLoaded.insert( binaryFilePath.toStdString() );
+            IndexedBundleLoad load;
+            load.binaryFilePath = binaryFilePath.toStdString();
+            load.bundlePath = it->toStdString();
+            load.describeSerially = previousIndexRead && isBundleThreadUnsafe(previousIndex, *it);
+            loads.push_back(load);
         }
-        iconFileName.append(resourcesPath);
-        iconFileName.append( QString::fromUtf8( pngIcon.c_str() ) );
-        QString groupIconFilename;
-        if (groups.size() > 0) {
-            groupIconFilename = resourcesPath;
-            // the plugin grouping has no descriptor, just try the default filename.
-            groupIconFilename.append(groups[0]);
-            groupIconFilename.append( QString::fromUtf8(".png") );
-        } else {
-            //Use default Misc group when the plug-in doesn't belong to a group
-            groups.push_back( QString::fromUtf8(PLUGIN_GROUP_DEFAULT) );
+    }
+    if ( !loads.empty() ) {
+        qDebug() << "Load OFX Plugins: describing" << loads.size() << "plugin bundles";
+        std::vector<IndexedBundleLoad*> loadPtrs;
+        for (std::vector<IndexedBundleLoad>::iterator it = loads.begin(); it != loads.end(); ++it) {
+            loadPtrs.push_back(&*it);
         }
-        QStringList groupIcons;
-        groupIcons << groupIconFilename;
-        for (int i = 1; i < groups.size(); ++i) {
-            QString groupIconPath = resourcesPath;
-            for (int j = 0; j <= i; ++j) {
-                groupIconPath += groups[j];
-                if (j < i) {
-                    groupIconPath += QLatin1Char('/');
-                } else {
-                    groupIconPath.append( QString::fromUtf8(".png") );
-                }
+        QtConcurrent::blockingMap( loadPtrs, boost::bind(&OfxHost::loadIndexedBundleConcurrently, this, _1, QThread::currentThread()) );
+        for (std::vector<IndexedBundleLoad>::iterator it = loads.begin(); it != loads.end(); ++it) {
+            if (it->describeSerially) {
+                loadOFXPluginBinary(it->binaryFilePath, it->bundlePath, &it->plugins);
             }
-            groupIcons << groupIconPath;
-        }
-
-        const std::set<std::string> & contexts = p->getContexts();
-        std::set<std::string>::const_iterator foundReader = contexts.find(kOfxImageEffectContextReader);
-        std::set<std::string>::const_iterator foundWriter = contexts.find(kOfxImageEffectContextWriter);
-        const bool isDeprecated = p->getDescriptor().isDeprecated();
-        Plugin* natronPlugin = appPTR->registerPlugin( resourcesPath,
-                                                       groups,
-                                                       QString::fromUtf8( openfxId.c_str() ),
-                                                       QString::fromUtf8( pluginLabel.c_str() ),
-                                                       iconFileName,
-                                                       groupIcons,
-                                                       foundReader != contexts.end(),
-                                                       foundWriter != contexts.end(),
-                                                       new LibraryBinary(LibraryBinary::eLibraryTypeBuiltin),
-                                                       p->getDescriptor().getRenderThreadSafety() == kOfxImageEffectRenderUnsafe,
-                                                       p->getVersionMajor(), p->getVersionMinor(), isDeprecated );
-        bool isInternalOnly = openfxId == PLUGINID_OFX_ROTO;
-        if (isInternalOnly) {
-            natronPlugin->setForInternalUseOnly(true);
         }
+    }
 
-        PluginOpenGLRenderSupport glSupport = ePluginOpenGLRenderSupportNone;
-        {
-            const std::string& str = p->getDescriptor().getProps().getStringProperty(kOfxImageEffectPropOpenGLRenderSupported);
-            if (str == "false") {
-                glSupport = ePluginOpenGLRenderSupportNone;
-            } else if (str == "needed") {
-                glSupport = ePluginOpenGLRenderSupportNeeded;
-            } else if (str == "true") {
-                glSupport = ePluginOpenGLRenderSupportYes;
+    // Register the plug-ins in the order of the search path, whatever the order in which the bundles were described
+    for (std::vector<IndexedBundleLoad>::const_iterator it = loads.begin(); it != loads.end(); ++it) {
+        for (std::list<OFX::Host::ImageEffect::ImageEffectPlugin*>::const_iterator it2 = it->plugins.begin(); it2 != it->plugins.end(); ++it2) {
+            OFX::Host::ImageEffect::ImageEffectPlugin* p = *it2;
+            if (p->getContexts().size() == 0) {
+                continue;
             }
+            OfxPluginIndex::PluginEntry entry;
+            makePluginIndexEntry(p, &entry);
+            registerOFXPlugin(entry, p, QString(), QString(), readersMap, writersMap);
+            index.addPlugin(it->binaryFilePath, it->bundlePath, entry);
         }
-        natronPlugin->setOpenGLRenderSupport(glSupport);
+    }
 
-        natronPlugin->setOfxPlugin(p);
+    QDir().mkpath( getOFXCacheDirPath() );
+    if ( !index.write(pluginIndexFilePath) ) {
+        qDebug() << "Load OFX Plugins: writing index file... failed!";
+    }
+    qDebug() << "Load OFX Plugins... done!";
+} // loadOFXPlugins
 
-        std::list<PluginActionShortcut> shortcuts;
-        getPluginShortcuts(p->getDescriptor(), &shortcuts);
-        natronPlugin->setShorcuts(shortcuts);
-
-        ///if this plugin's descriptor has the kTuttleOfxImageEffectPropSupportedExtensions property,
-        ///use it to fill the readersMap and writersMap
-        int formatsCount = p->getDescriptor().getProps().getDimension(kTuttleOfxImageEffectPropSupportedExtensions);
-        std::vector<std::string> formats(formatsCount);
-        for (int k = 0; k < formatsCount; ++k) {
-            formats[k] = p->getDescriptor().getProps().getStringProperty(kTuttleOfxImageEffectPropSupportedExtensions, k);
-            std::transform(formats[k].begin(), formats[k].end(), formats[k].begin(), ::tolower);
-        }
+void
+OfxHost::loadIndexedBundleConcurrently(IndexedBundleLoad* load,
+                                       QThread* callingThread)
+{
+    if (load->describeSerially) {
+        return;
+    }
+    loadOFXPluginBinary(load->binaryFilePath, load->bundlePath, &load->plugins);
+
+    // The threads of the pool do not keep the data of the plug-ins they described
+    if ( QThread::currentThread() != callingThread ) {
+        appPTR->getAppTLS()->cleanupTLSForThread();
+    }
+}
 
-        double evaluation = p->getDescriptor().getProps().getDoubleProperty(kTuttleOfxImageEffectPropEvaluation);
+void
+OfxHost::loadOFXPluginBinary(const std::string& binaryFilePath,
+                             const std::string& bundlePath,
+                             std::list<OFX::Host::ImageEffect::ImageEffectPlugin*>* plugins)
+{
+    OFX::Host::PluginCache* pluginCache = OFX::Host::PluginCache::getPluginCache();
+    assert(pluginCache);
 
+    // Same as what the OpenFX plug-ins cache does for a binary it finds while scanning the search path:
+    // the binary is loaded to create its plug-ins, then each plug-in is loaded and described.
+    // Only the load and describe actions run concurrently with other binaries.
+    OFX::Host::PluginBinary* binary = 0;
+    {
+        QMutexLocker k(&_imp->pluginCacheMutex);
+        try {
+            binary = new OFX::Host::PluginBinary(binaryFilePath, bundlePath, pluginCache);
+        } catch (const std::exception& e) {
+            appPTR->writeToErrorLog_mt_safe( QLatin1String("OpenFX"), QDateTime::currentDateTime(),
+                                             tr("Failure to load the OpenFX plug-in binary %1: %2").arg( QString::fromUtf8( binaryFilePath.c_str() ) ).arg( QString::fromUtf8( e.what() ) ) );
 
-        if (!isDeprecated && ( foundReader != contexts.end() ) && (formatsCount > 0) && readersMap) {
-            ///we're safe to assume that this plugin is a reader
-            for (std::size_t k = 0; k < formats.size(); ++k) {
-                IOPluginSetForFormat& evalForFormat = (*readersMap)[formats[k]];
-                evalForFormat.insert( IOPluginEvaluation(openfxId, evaluation) );
-            }
-        } else if (!isDeprecated && ( foundWriter != contexts.end() ) && (formatsCount > 0) && writersMap) {
-            ///we're safe to assume that this plugin is a writer.
-            for (std::size_t k = 0; k < formats.size(); ++k) {
-                IOPluginSetForFormat& evalForFormat = (*writersMap)[formats[k]];
-                evalForFormat.insert( IOPluginEvaluation(openfxId, evaluation) );
+            return;
+        }
+        _imp->ownedBinaries.push_back(binary);
+    }
+
+    for (int i = 0; i < binary->getNPlugins(); ++i) {
+        OFX::Host::Plugin& plug = binary->getPlugin(i);
+        OFX::Host::APICache::PluginAPICacheI& api = plug.getApiHandler();
+        try {
+            api.loadFromPlugin(&plug);
+        } catch (const std::exception& e) {
+            appPTR->writeToErrorLog_mt_safe( QLatin1String("OpenFX"), QDateTime::currentDateTime(),
+                                             tr("Failure to describe the OpenFX plug-in %1: %2").arg( QString::fromUtf8( plug.getIdentifier().c_str() ) ).arg( QString::fromUtf8( e.what() ) ) );
+            continue;
+        }
+        {
+            QMutexLocker k(&_imp->pluginCacheMutex);
+            std::string reason;
+            if ( !api.pluginSupported(&plug, reason) ) {
+                continue;
             }
+            api.confirmPlugin(&plug);
+        }
+        OFX::Host::ImageEffect::ImageEffectPlugin* p = dynamic_cast<OFX::Host::ImageEffect::ImageEffectPlugin*>(&plug);
+        if (p) {
+            plugins->push_back(p);
         }
     }
-    qDebug() << "Load OFX Plugins... done!";
-} // loadOFXPlugins
+    _imp->tlsData->getOrCreateTLSData()->loadingPluginID.clear(); // finished loading plugins
+} // OfxHost::loadOFXPluginBinary
 
 void
-OfxHost::writeOFXCache()
+OfxHost::loadDeferredOFXPlugin(const std::string& binaryFilePath,
+                               const std::string& bundlePath)
 {
-    /// and write a new cache, long version with everything in there
-    QString ofxCachePath = getOFXCacheDirPath();
-    QDir().mkpath(ofxCachePath);
-    QString ofxCacheFilePath = getCacheFilePath();
-
-    QTemporaryFile tmpf;
-    tmpf.open();
-    QString tmpFileName = tmpf.fileName();
-    tmpf.remove();
-
-    FStreamsSupport::ofstream ofile;
-    FStreamsSupport::open( &ofile, tmpFileName.toStdString() );
-    if (!ofile) {
+    QMutexLocker k(&_imp->deferredPluginsLoadMutex);
+
+    if ( !_imp->deferredBinariesLoaded.insert(binaryFilePath).second ) {
+        // Already loaded, or failed to load: the plug-ins that are still deferred cannot be loaded
         return;
     }
-    OFX::Host::PluginCache* pluginCache = OFX::Host::PluginCache::getPluginCache();
-    assert(pluginCache);
-    pluginCache->writePluginCache(ofile);
 
-    ofile.close();
-    if (QFile::exists(ofxCacheFilePath)) {
-        QFile::remove(ofxCacheFilePath);
+    qDebug() << "Load deferred OFX Plugins: loading" << binaryFilePath.c_str();
+    std::list<OFX::Host::ImageEffect::ImageEffectPlugin*> plugins;
+    loadOFXPluginBinary(binaryFilePath, bundlePath, &plugins);
+
+    // Attach the OpenFX plug-ins to the plug-ins registered from the index
+    for (std::list<OFX::Host::ImageEffect::ImageEffectPlugin*>::const_iterator it = plugins.begin(); it != plugins.end(); ++it) {
+        OFX::Host::ImageEffect::ImageEffectPlugin* p = *it;
+        if (p->getContexts().size() == 0) {
+            continue;
+        }
+        Plugin* natronPlugin = 0;
+        try {
+            natronPlugin = appPTR->getPluginBinary(QString::fromUtf8( p->getIdentifier().c_str() ), p->getVersionMajor(), p->getVersionMinor(), false);
+        } catch (const std::exception&) {
+            // The plug-in was not in the index, it is registered on the next launch
+            continue;
+        }
+        if ( natronPlugin && natronPlugin->isOfxPluginDeferred() &&
+             ( natronPlugin->getMajorVersion() == p->getVersionMajor() ) && ( natronPlugin->getMinorVersion() == p->getVersionMinor() ) ) {
+            natronPlugin->setOfxPlugin(p);
+        }
     }
-    QFile::copy(tmpFileName, ofxCacheFilePath);
-    QFile::remove(tmpFileName);
-}
+    qDebug() << "Load deferred OFX Plugins: loading" << binaryFilePath.c_str() << "... done!";
+} // OfxHost::loadDeferredOFXPlugin
 
 void
 OfxHost::clearPluginsLoadedCache()
@@ -1135,10 +1389,12 @@ OfxHost::loadingStatus(bool loading,
                        int versionMinor)
 {
     // set the pluginID in case the plug-in tries to fetch the hostname property
-    _imp->loadingPluginID = pluginId;
-    _imp->loadingPluginVersionMajor = versionMajor;
-    _imp->loadingPluginVersionMinor = versionMinor;
-    if (loading && appPTR) {
+    OfxHostDataTLSPtr tls = _imp->tlsData->getOrCreateTLSData();
+    tls->loadingPluginID = pluginId;
+    tls->loadingPluginVersionMajor = versionMajor;
+    tls->loadingPluginVersionMinor = versionMinor;
+    // bundles may be described by other threads at startup, only the main thread updates the loading status
+    if ( loading && appPTR && ( QThread::currentThread() == qApp->thread() ) ) {
         appPTR->setLoadingStatus( QString::fromUtf8("OpenFX: loading ") + QString::fromUtf8( pluginId.c_str() ) + QString::fromUtf8(" v") + QString::number(versionMajor) + QLatin1Char('.') + QString::number(versionMinor) );
 #     ifdef DEBUG
         qDebug() << QString::fromUtf8("OpenFX: loading ") + QString::fromUtf8( pluginId.c_str() ) + QString::fromUtf8(" v") + QString::number(versionMajor) + QLatin1Char('.') + QString::number(versionMinor);
@@ -1172,8 +1428,9 @@ OfxHost::newMemoryInstance(size_t nBytes)
     bool allocated = ret->alloc(nBytes);
 
     if ( ( (nBytes != 0) && !ret->getPtr() ) || !allocated ) {
-        Dialogs::errorDialog( tr("Out of memory").toStdString(),
-                              tr("Failed to allocate memory (%1).").arg( printAsRAM(nBytes) ).toStdString() );
+        // This may be called from render threads: do not block them with a dialog, the plug-in gets kOfxStatErrMemory
+        appPTR->writeToErrorLog_mt_safe( QLatin1String("OpenFX"), QDateTime::currentDateTime(),
+                                         tr("Out of memory: failed to allocate %1.").arg( printAsRAM(nBytes) ) );
     }
 
     return ret;
@@ -1513,6 +1770,24 @@ OfxHost::multiThreadIsSpawnedThread() const
     return !tls->threadIndexes.empty() && tls->threadIndexes.back() != -1;
 }
 
+void
+OfxHost::reportMutexContention(double timeWaited) const
+{
+    OfxHostDataTLSPtr tls = _imp->tlsData->getTLSData();
+
+    if ( !tls || !tls->lastEffectCallingMainEntry ) {
+        return;
+    }
+    OfxEffectInstancePtr effect = tls->lastEffectCallingMainEntry->getOfxEffectInstance();
+    if (!effect) {
+        return;
+    }
+    ParallelRenderArgsPtr frameArgs = effect->getParallelRenderArgsTLS();
+    if ( frameArgs && frameArgs->stats && frameArgs->stats->isInDepthProfilingEnabled() ) {
+        frameArgs->stats->addMutexContentionForNode(effect->getNode(), timeWaited);
+    }
+}
+
 // Create a mutex
 //  Creates a new mutex with lockCount locks on the mutex initially set.
 // http://openfx.sourceforge.net/Documentation/1.3/ofxProgrammingReference.html#OfxMultiThreadSuiteV1_mutexCreate
@@ -1526,17 +1801,11 @@ OfxHost::mutexCreate(OfxMutexHandle *mutex,
 
     // suite functions should not throw
     try {
-        QMutex* m = new QMutex(QMutex::Recursive);
+        OfxMutex* m = _imp->mutexPool.createMutex();
         for (int i = 0; i < lockCount; ++i) {
             m->lock();
         }
         *mutex = (OfxMutexHandle)(m);
-#ifdef MULTI_THREAD_SUITE_USES_THREAD_SAFE_MUTEX_ALLOCATION
-        {
-            QMutexLocker l(_pluginsMutexesLock);
-            _pluginsMutexes.push_back(m);
-        }
-#endif
 
         return kOfxStatOK;
     } catch (std::bad_alloc) {
@@ -1565,19 +1834,7 @@ OfxHost::mutexDestroy(const OfxMutexHandle mutex)
     }
     // suite functions should not throw
     try {
-#ifdef MULTI_THREAD_SUITE_USES_THREAD_SAFE_MUTEX_ALLOCATION
-        const QMutex* mutexqt = reinterpret_cast<const QMutex*>(mutex);
-        {
-            QMutexLocker l(_pluginsMutexesLock);
-            std::list<QMutex*>::iterator found = std::find(_pluginsMutexes.begin(), _pluginsMutexes.end(), mutexqt);
-            if ( found != _pluginsMutexes.end() ) {
-                delete *found;
-                _pluginsMutexes.erase(found);
-            }
-        }
-#else
-        delete reinterpret_cast<const QMutex*>(mutex);
-#endif
+        _imp->mutexPool.destroyMutex( reinterpret_cast<OfxMutex*>(mutex) );
 
         return kOfxStatOK;
     } catch (std::bad_alloc) {
@@ -1607,7 +1864,13 @@ OfxHost::mutexLock(const OfxMutexHandle mutex)
     }
     // suite functions should not throw
     try {
-        reinterpret_cast<QMutex*>(mutex)->lock();
+        OfxMutex* m = reinterpret_cast<OfxMutex*>(mutex);
+        if ( !m->tryLock() ) {
+            // Another thread holds the mutex
+            TimeLapse timer;
+            m->lock();
+            reportMutexContention( timer.getTimeElapsedReset() );
+        }
 
         return kOfxStatOK;
     } catch (std::bad_alloc) {
@@ -1636,7 +1899,11 @@ OfxHost::mutexUnLock(const OfxMutexHandle mutex)
     }
     // suite functions should not throw
     try {
-        reinterpret_cast<QMutex*>(mutex)->unlock();
+        if ( !reinterpret_cast<OfxMutex*>(mutex)->unlock() ) {
+            qDebug() << "mutexUnLock(): the mutex is not locked by this thread.";
+
+            return kOfxStatFailed;
+        }
 
         return kOfxStatOK;
     } catch (std::bad_alloc) {
@@ -1666,7 +1933,7 @@ OfxHost::mutexTryLock(const OfxMutexHandle mutex)
     }
     // suite functions should not throw
     try {
-        if ( reinterpret_cast<QMutex*>(mutex)->tryLock() ) {
+        if ( reinterpret_cast<OfxMutex*>(mutex)->tryLock() ) {
             return kOfxStatOK;
         } else {
             return kOfxStatFailed;
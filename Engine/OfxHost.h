@@ -28,6 +28,7 @@
 #include "Global/Macros.h"
 
 #include <list>
+#include <string>
 
 #if !defined(Q_MOC_RUN) && !defined(SBK_RUN)
 #include <boost/shared_ptr.hpp>
@@ -51,9 +52,6 @@ CLANG_DIAG_ON(unknown-pragmas)
 #include "Engine/EngineFwd.h"
 #include "Engine/Plugin.h"
 
-
-//#define MULTI_THREAD_SUITE_USES_THREAD_SAFE_MUTEX_ALLOCATION
-
 NATRON_NAMESPACE_ENTER
 
 struct OfxHostPrivate;
@@ -159,6 +157,13 @@ public:
     void loadOFXPlugins(IOPluginsMap* readersMap,
                         IOPluginsMap* writersMap);
 
+    /**
+     * @brief Loads the binary of a bundle whose plug-ins were registered from the plug-ins index by loadOFXPlugins(),
+     * describes its plug-ins and attaches them to the registered plug-ins. Only this bundle is loaded: the OpenFX
+     * plug-ins cache is not read and the search path is not scanned. Does nothing if the binary was already loaded.
+     **/
+    void loadDeferredOFXPlugin(const std::string& binaryFilePath, const std::string& bundlePath);
+
     void clearPluginsLoadedCache();
 
     void setThreadAsActionCaller(OfxImageEffectInstance* instance, bool actionCaller);
@@ -178,9 +183,17 @@ public:
         ///Stored as int, because we need -1; list because we need it recursive for the multiThread func
         std::list<int> threadIndexes;
 
+        ///ID of the plugin being loaded or described by this thread: bundles are described concurrently at startup
+        std::string loadingPluginID;
+        int loadingPluginVersionMajor;
+        int loadingPluginVersionMinor;
+
         OfxHostTLSData()
             : lastEffectCallingMainEntry(0)
             , threadIndexes()
+            , loadingPluginID()
+            , loadingPluginVersionMajor(0)
+            , loadingPluginVersionMinor(0)
         {
         }
     };
@@ -191,9 +204,33 @@ public:
 
 private:
 
-    /*Writes all plugins loaded and their descriptors to
-       the OFX plugin cache. (called by the destructor) */
-    void writeOFXCache();
+    /*A bundle loaded and described by loadOFXPlugins() to build its entries in the plugins index*/
+    struct IndexedBundleLoad
+    {
+        std::string binaryFilePath;
+        std::string bundlePath;
+
+        // True if the bundle must not be described concurrently with other bundles
+        bool describeSerially;
+        std::list<OFX::Host::ImageEffect::ImageEffectPlugin*> plugins;
+    };
+
+    /*Loads the bundle with loadOFXPluginBinary(), unless it must be described serially.
+       Called concurrently by the threads of the global thread pool and by callingThread.*/
+    void loadIndexedBundleConcurrently(IndexedBundleLoad* load, QThread* callingThread);
+
+    /*Loads a single bundle binary in the OFX host, without going through the OFX plugin cache,
+       and describes its plugins. The binary is owned by the host.
+       Several binaries may be loaded concurrently: only the steps that modify the OFX plugin cache are serialized.*/
+    void loadOFXPluginBinary(const std::string& binaryFilePath,
+                             const std::string& bundlePath,
+                             std::list<OFX::Host::ImageEffect::ImageEffectPlugin*>* plugins);
+
+#ifdef OFX_SUPPORTS_MULTITHREAD
+    /*Records in the render stats of the frame being rendered by the current thread, if any, that the plug-in
+       calling the multi-thread suite waited on one of its mutexes.*/
+    void reportMutexContention(double timeWaited) const;
+#endif
 
     // get the virutals for viewport size, pixel scale, background colour
     const std::string &getStringProperty(const std::string &name, int n) const OFX_EXCEPTION_SPEC OVERRIDE;
@@ -29,6 +29,7 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <algorithm> // max
 #include <locale>
 #include <stdexcept>
 #include <cstring> // for std::memcpy, std::memset, std::strcmp
@@ -37,6 +38,8 @@ CLANG_DIAG_OFF(deprecated)
 CLANG_DIAG_OFF(uninitialized)
 #include <QtCore/QDateTime>
 #include <QtCore/QDebug>
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
 CLANG_DIAG_ON(deprecated)
 CLANG_DIAG_ON(uninitialized)
 
@@ -64,8 +67,11 @@ CLANG_DIAG_ON(uninitialized)
 #include "Engine/OfxMemory.h"
 #include "Engine/OfxOverlayInteract.h"
 #include "Engine/OfxParamInstance.h"
+#include "Engine/ParallelRenderArgs.h"
 #include "Engine/Project.h"
+#include "Engine/RenderStats.h"
 #include "Engine/TimeLine.h"
+#include "Engine/Timer.h"
 #include "Engine/ViewIdx.h"
 #include "Engine/ViewerInstance.h"
 #ifdef DEBUG
@@ -125,6 +131,80 @@ OfxImageEffectInstance::~OfxImageEffectInstance()
 {
 }
 
+NATRON_NAMESPACE_ANONYMOUS_ENTER
+
+// The innermost action run by each thread
+struct CurrentActionCall
+{
+    OfxImageEffectInstance::ActionCall* call;
+
+    CurrentActionCall()
+        : call(0)
+    {
+    }
+};
+
+NATRON_NAMESPACE_ANONYMOUS_EXIT
+
+static QThreadStorage<CurrentActionCall> currentActionCall;
+
+const OfxImageEffectInstance::ActionCall*
+OfxImageEffectInstance::getCurrentActionCall()
+{
+    return currentActionCall.localData().call;
+}
+
+// Pushes an action on the stack of the current thread for its duration
+class ActionCall_RAII
+{
+    OfxImageEffectInstance::ActionCall _call;
+    CurrentActionCall& _current;
+
+public:
+
+    ActionCall_RAII(const OfxImageEffectInstance* self,
+                    const KnobValuesSnapshot* knobValues,
+                    double time,
+                    ViewIdx view,
+                    bool profiled)
+        : _call()
+        , _current( currentActionCall.localData() )
+    {
+        _call.instance = self;
+        _call.knobValues = knobValues;
+        _call.time = time;
+        _call.view = view;
+        _call.parent = _current.call;
+        // Time the action if the caller is timed, so that its own time excludes this one
+        _call.timed = profiled || (_call.parent && _call.parent->timed);
+        _call.childrenTime = 0.;
+        _current.call = &_call;
+    }
+
+    ~ActionCall_RAII()
+    {
+        _current.call = _call.parent;
+    }
+
+    bool isTimed() const
+    {
+        return _call.timed;
+    }
+
+    /**
+     * @brief Called when the action returned with the time spent in it, including the actions it called.
+     * Returns the time spent in the action itself.
+     **/
+    double setTimeSpent(double timeSpent)
+    {
+        if (_call.parent && _call.parent->timed) {
+            _call.parent->childrenTime += timeSpent;
+        }
+
+        return std::max(0., timeSpent - _call.childrenTime);
+    }
+};
+
 class ThreadIsActionCaller_RAII
 {
     OfxImageEffectInstance* _self;
@@ -154,7 +234,43 @@ OfxImageEffectInstance::mainEntry(const char *action,
 #endif
     ThreadIsActionCaller_RAII t(this);
 
-    return OFX::Host::ImageEffect::Instance::mainEntry(action, handle, inArgs, outArgs);
+    // The main thread mostly runs interact and instance changed actions: do not look for render arguments there,
+    // its parameter reads go through the knobs and its actions are not profiled
+    OfxEffectInstancePtr effect;
+    if ( QThread::currentThread() != qApp->thread() ) {
+        effect = _ofxEffectInstance.lock();
+    }
+
+    // Resolve the parameter values captured for the frame once, so that the parameters read them without locking
+    const KnobValuesSnapshot* knobValues = 0;
+    double time = 0.;
+    ViewIdx view(0);
+    if (effect) {
+        knobValues = effect->getKnobValuesSnapshotTLS(&time, &view);
+    }
+
+    // When the render is profiled, record the time spent in each action of the plug-in
+    RenderStatsPtr stats;
+    if (effect) {
+        ParallelRenderArgsPtr frameArgs = effect->getParallelRenderArgsTLS();
+        if ( frameArgs && frameArgs->stats && frameArgs->stats->isInDepthProfilingEnabled() ) {
+            stats = frameArgs->stats;
+        }
+    }
+    ActionCall_RAII call(this, knobValues, time, view, (bool)stats);
+    if ( !call.isTimed() ) {
+        return OFX::Host::ImageEffect::Instance::mainEntry(action, handle, inArgs, outArgs);
+    }
+
+    TimeLapse timer;
+    OfxStatus stat = OFX::Host::ImageEffect::Instance::mainEntry(action, handle, inArgs, outArgs);
+    double inclusiveTime = timer.getTimeSinceCreation();
+    double selfTime = call.setTimeSpent(inclusiveTime);
+    if (stats) {
+        stats->addActionCallForNode(effect->getNode(), action, selfTime, inclusiveTime);
+    }
+
+    return stat;
 }
 
 OfxStatus
@@ -1100,10 +1216,8 @@ OfxImageEffectInstance::newMemoryInstance(size_t nBytes)
     bool allocated = ret->alloc(nBytes);
 
     if ( ( (nBytes != 0) && !ret->getPtr() ) || !allocated ) {
-        Dialogs::errorDialog( tr("Out of memory").toStdString(),
-                              tr("%1 failed to allocate memory (%2).")
-                              .arg( QString::fromUtf8( getOfxEffectInstance()->getNode()->getLabel_mt_safe().c_str() ) )
-                              .arg( printAsRAM(nBytes) ).toStdString() );
+        // This is called from render threads: do not block them with a dialog, the plug-in gets kOfxStatErrMemory
+        effect->setPersistentMessage( eMessageTypeError, tr("Out of memory: failed to allocate %1.").arg( printAsRAM(nBytes) ).toStdString() );
     }
 
     return ret;
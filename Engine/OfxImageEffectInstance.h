@@ -48,6 +48,7 @@ CLANG_DIAG_ON(tautological-undefined-compare)
 CLANG_DIAG_ON(unknown-pragmas)
 
 #include "Global/GlobalDefines.h"
+#include "Engine/ViewIdx.h"
 #include "Engine/EngineFwd.h"
 
 
@@ -236,6 +237,34 @@ public:
         return _ofxEffectInstance.lock();
     }
 
+    /**
+     * @brief An action of a plug-in being run by a thread. Actions of other effects called from within the action,
+     * e.g. to fetch an input image, are pushed on top of it.
+     **/
+    struct ActionCall
+    {
+        const OfxImageEffectInstance* instance;
+
+        // The parameter values captured for the frame being rendered by the thread, resolved once when the action
+        // started, or NULL outside of a render
+        const KnobValuesSnapshot* knobValues;
+
+        // The current time and view of the render, only valid if knobValues is not NULL
+        double time;
+        ViewIdx view;
+
+        // True if the duration of the action is measured, either because the render is profiled or because the
+        // calling action is timed. childrenTime is the time spent in the actions it called on this thread.
+        bool timed;
+        double childrenTime;
+        ActionCall* parent;
+    };
+
+    /**
+     * @brief Returns the innermost action run by the current thread, or NULL if it runs no action.
+     **/
+    static const ActionCall* getCurrentActionCall() WARN_UNUSED_RETURN;
+
     /// to be called right away after populate() is called. It adds to their group all the params.
     /// This is done in a deferred manner as some params can sometimes not be defined in a good order.
     void addParamsToTheirParents();
@@ -0,0 +1,157 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "OfxMutex.h"
+
+#include <cassert>
+
+#include <QtCore/QThread>
+
+// The maximum number of destroyed mutexes kept for reuse
+#define NATRON_OFX_MUTEX_POOL_MAX_SIZE 1024
+
+NATRON_NAMESPACE_ENTER
+
+static inline void*
+currentThreadHandle()
+{
+    return (void*)QThread::currentThreadId();
+}
+
+OfxMutex::OfxMutex()
+    : _mutex()
+    , _owner(0)
+    , _lockCount(0)
+{
+}
+
+OfxMutex::~OfxMutex()
+{
+}
+
+void
+OfxMutex::lock()
+{
+    void* self = currentThreadHandle();
+
+    if ( (void*)_owner == self ) {
+        ++_lockCount;
+
+        return;
+    }
+    _mutex.lock();
+    _owner.fetchAndStoreRelaxed(self);
+    _lockCount = 1;
+}
+
+bool
+OfxMutex::tryLock()
+{
+    void* self = currentThreadHandle();
+
+    if ( (void*)_owner == self ) {
+        ++_lockCount;
+
+        return true;
+    }
+    if ( !_mutex.tryLock() ) {
+        return false;
+    }
+    _owner.fetchAndStoreRelaxed(self);
+    _lockCount = 1;
+
+    return true;
+}
+
+bool
+OfxMutex::unlock()
+{
+    if ( (void*)_owner != currentThreadHandle() ) {
+        return false;
+    }
+    assert(_lockCount > 0);
+    if (--_lockCount == 0) {
+        _owner.fetchAndStoreRelaxed(0);
+        _mutex.unlock();
+    }
+
+    return true;
+}
+
+bool
+OfxMutex::isLocked() const
+{
+    return (void*)_owner != 0;
+}
+
+OfxMutexPool::OfxMutexPool()
+    : _lock()
+    , _freeMutexes()
+{
+}
+
+OfxMutexPool::~OfxMutexPool()
+{
+    for (std::size_t i = 0; i < _freeMutexes.size(); ++i) {
+        delete _freeMutexes[i];
+    }
+}
+
+OfxMutex*
+OfxMutexPool::createMutex()
+{
+    {
+        QMutexLocker k(&_lock);
+        if ( !_freeMutexes.empty() ) {
+            OfxMutex* ret = _freeMutexes.back();
+            _freeMutexes.pop_back();
+
+            return ret;
+        }
+    }
+
+    return new OfxMutex;
+}
+
+void
+OfxMutexPool::destroyMutex(OfxMutex* mutex)
+{
+    // A mutex destroyed while locked is a plug-in bug, do not hand it to another plug-in
+    if ( mutex->isLocked() ) {
+        delete mutex;
+
+        return;
+    }
+    {
+        QMutexLocker k(&_lock);
+        if (_freeMutexes.size() < NATRON_OFX_MUTEX_POOL_MAX_SIZE) {
+            _freeMutexes.push_back(mutex);
+
+            return;
+        }
+    }
+    delete mutex;
+}
+
+NATRON_NAMESPACE_EXIT
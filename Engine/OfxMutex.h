@@ -0,0 +1,99 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef Natron_Engine_OfxMutex_h
+#define Natron_Engine_OfxMutex_h
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QAtomicPointer>
+
+#include "Engine/EngineFwd.h"
+
+NATRON_NAMESPACE_ENTER
+
+/**
+ * @brief The recursive mutex given to the plug-ins by the OpenFX multi-thread suite.
+ * It is made of a non-recursive QMutex, which Qt implements with a futex on Linux so that an uncontended
+ * lock is a single atomic operation, the owner thread and a lock count. This avoids the extra allocation
+ * and the internal lock of a recursive QMutex.
+ **/
+class OfxMutex
+{
+public:
+
+    OfxMutex();
+
+    ~OfxMutex();
+
+    void lock();
+
+    bool tryLock();
+
+    /**
+     * @brief Unlocks the mutex. Returns false if the mutex is not locked by the calling thread.
+     **/
+    bool unlock();
+
+    bool isLocked() const;
+
+private:
+
+    QMutex _mutex;
+
+    // The thread holding the mutex, NULL if it is unlocked
+    QAtomicPointer<void> _owner;
+
+    // Only accessed by the owner
+    int _lockCount;
+};
+
+/**
+ * @brief Recycles the mutexes destroyed by the plug-ins, so that plug-ins creating a mutex per render or per tile
+ * do not allocate one each time.
+ **/
+class OfxMutexPool
+{
+public:
+
+    OfxMutexPool();
+
+    ~OfxMutexPool();
+
+    OfxMutex* createMutex();
+
+    void destroyMutex(OfxMutex* mutex);
+
+private:
+
+    QMutex _lock;
+    std::vector<OfxMutex*> _freeMutexes;
+};
+
+NATRON_NAMESPACE_EXIT
+
+#endif // Natron_Engine_OfxMutex_h
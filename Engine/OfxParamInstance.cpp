@@ -58,6 +58,7 @@ GCC_DIAG_UNUSED_LOCAL_TYPEDEFS_ON
 #include "Engine/AppInstance.h"
 #include "Engine/ReadNode.h"
 #include "Engine/Node.h"
+#include "Engine/ParallelRenderArgs.h"
 #include "Engine/TLSHolder.h"
 #include "Engine/ViewIdx.h"
 #include "Engine/WriteNode.h"
@@ -80,6 +81,50 @@ struct OfxKeyFrames_compare
 
 typedef std::set<double, OfxKeyFrames_compare> OfxKeyFramesSet;
 
+/**
+ * @brief Returns the value of the knob at the current time. During a render, the value is read without locking from the
+ * parameter values captured when the render of the frame started, which the current action resolved once when it began.
+ **/
+template <typename T>
+static T
+getKnobValue(Knob<T>* knob,
+             int slot,
+             int dimension = 0)
+{
+    const OfxImageEffectInstance::ActionCall* action = OfxImageEffectInstance::getCurrentActionCall();
+
+    if (action && action->knobValues) {
+        T ret;
+        if ( action->knobValues->getValue(slot, knob, action->time, action->view, dimension, &ret) ) {
+            return ret;
+        }
+    }
+
+    return knob->getValue(dimension);
+}
+
+/**
+ * @brief Same as getKnobValue, at the given time. Values at another time than the frame being rendered are read from the knob.
+ **/
+template <typename T>
+static T
+getKnobValueAtTime(Knob<T>* knob,
+                   int slot,
+                   double time,
+                   int dimension = 0)
+{
+    const OfxImageEffectInstance::ActionCall* action = OfxImageEffectInstance::getCurrentActionCall();
+
+    if (action && action->knobValues) {
+        T ret;
+        if ( action->knobValues->getValue(slot, knob, time, action->view, dimension, &ret) ) {
+            return ret;
+        }
+    }
+
+    return knob->getValueAtTime(time, dimension);
+}
+
 static void
 getOfxKeyFrames(KnobI* knob,
                 OfxKeyFramesSet &keyframes,
@@ -335,6 +380,15 @@ OfxParamToKnob::getKnobHolder() const
     return effect;
 }
 
+void
+OfxParamToKnob::addKnobValuesSnapshotSlot(const OfxEffectInstancePtr& effect,
+                                          const KnobIPtr& knob)
+{
+    if (effect && knob) {
+        _knobValuesSlot = effect->addKnobValuesSnapshotSlot(knob);
+    }
+}
+
 void
 OfxParamToKnob::connectDynamicProperties()
 {
@@ -693,6 +747,7 @@ OfxIntegerInstance::OfxIntegerInstance(const OfxEffectInstancePtr& node,
     KnobIntPtr k = checkIfKnobExistsWithNameOrCreate<KnobInt>(descriptor.getName(), this, 1);
 
     _knob = k;
+    addKnobValuesSnapshotSlot(node, k);
     setRange();
     setDisplayRange();
 
@@ -710,7 +765,7 @@ OfxIntegerInstance::get(int & v)
 {
     KnobIntPtr knob = _knob.lock();
 
-    v = knob->getValue();
+    v = getKnobValue(knob.get(), getKnobValuesSlot());
 
     return kOfxStatOK;
 }
@@ -721,7 +776,7 @@ OfxIntegerInstance::get(OfxTime time,
 {
     KnobIntPtr knob = _knob.lock();
 
-    v = knob->getValueAtTime(time);
+    v = getKnobValueAtTime(knob.get(), getKnobValuesSlot(), time);
 
     return kOfxStatOK;
 }
@@ -932,6 +987,7 @@ OfxDoubleInstance::OfxDoubleInstance(const OfxEffectInstancePtr& node,
     KnobDoublePtr dblKnob = checkIfKnobExistsWithNameOrCreate<KnobDouble>(descriptor.getName(), this, 1);
 
     _knob = dblKnob;
+    addKnobValuesSnapshotSlot(node, dblKnob);
     setRange();
     setDisplayRange();
 
@@ -986,7 +1042,7 @@ OfxDoubleInstance::get(double & v)
 {
     KnobDoublePtr knob = _knob.lock();
 
-    v = knob->getValue();
+    v = getKnobValue(knob.get(), getKnobValuesSlot());
 
     return kOfxStatOK;
 }
@@ -997,7 +1053,7 @@ OfxDoubleInstance::get(OfxTime time,
 {
     KnobDoublePtr knob = _knob.lock();
 
-    v = knob->getValueAtTime(time);
+    v = getKnobValueAtTime(knob.get(), getKnobValuesSlot(), time);
 
     return kOfxStatOK;
 }
@@ -1236,6 +1292,7 @@ OfxBooleanInstance::OfxBooleanInstance(const OfxEffectInstancePtr& node,
     KnobBoolPtr b = checkIfKnobExistsWithNameOrCreate<KnobBool>(descriptor.getName(), this, 1);
 
     _knob = b;
+    addKnobValuesSnapshotSlot(node, b);
     int def = properties.getIntProperty(kOfxParamPropDefault);
     b->blockValueChanges();
     b->setDefaultValue( (bool)def, 0 );
@@ -1247,7 +1304,7 @@ OfxBooleanInstance::get(bool & b)
 {
     KnobBoolPtr knob = _knob.lock();
 
-    b = knob->getValue();
+    b = getKnobValue(knob.get(), getKnobValuesSlot());
 
     return kOfxStatOK;
 }
@@ -1258,7 +1315,7 @@ OfxBooleanInstance::get(OfxTime time,
 {
     assert( KnobBool::canAnimateStatic() );
     KnobBoolPtr knob = _knob.lock();
-    b = knob->getValueAtTime(time);
+    b = getKnobValueAtTime(knob.get(), getKnobValuesSlot(), time);
 
     return kOfxStatOK;
 }
@@ -1436,6 +1493,7 @@ OfxChoiceInstance::OfxChoiceInstance(const OfxEffectInstancePtr& node,
     KnobChoicePtr choice = checkIfKnobExistsWithNameOrCreate<KnobChoice>(descriptor.getName(), this, 1);
 
     _knob = choice;
+    addKnobValuesSnapshotSlot(node, choice);
 
 
     int dim = getProperties().getDimension(kOfxParamPropChoiceOption);
@@ -1479,7 +1537,7 @@ OfxChoiceInstance::get(int & v)
 {
     KnobChoicePtr knob = _knob.lock();
 
-    v = knob->getValue();
+    v = getKnobValue(knob.get(), getKnobValuesSlot());
 
     return kOfxStatOK;
 }
@@ -1490,7 +1548,7 @@ OfxChoiceInstance::get(OfxTime time,
 {
     assert( KnobChoice::canAnimateStatic() );
     KnobChoicePtr knob = _knob.lock();
-    v = knob->getValueAtTime(time);
+    v = getKnobValueAtTime(knob.get(), getKnobValuesSlot(), time);
 
     return kOfxStatOK;
 }
@@ -1739,6 +1797,7 @@ OfxRGBAInstance::OfxRGBAInstance(const OfxEffectInstancePtr& node,
     KnobColorPtr knob = checkIfKnobExistsWithNameOrCreate<KnobColor>(descriptor.getName(), this, 4);
 
     _knob = knob;
+    addKnobValuesSnapshotSlot(node, knob);
     setRange();
     setDisplayRange();
 
@@ -1769,10 +1828,10 @@ OfxRGBAInstance::get(double & r,
 {
     KnobColorPtr color = _knob.lock();
 
-    r = color->getValue(0);
-    g = color->getValue(1);
-    b = color->getValue(2);
-    a = color->getValue(3);
+    r = getKnobValue(color.get(), getKnobValuesSlot(), 0);
+    g = getKnobValue(color.get(), getKnobValuesSlot(), 1);
+    b = getKnobValue(color.get(), getKnobValuesSlot(), 2);
+    a = getKnobValue(color.get(), getKnobValuesSlot(), 3);
 
     return kOfxStatOK;
 }
@@ -1786,10 +1845,10 @@ OfxRGBAInstance::get(OfxTime time,
 {
     KnobColorPtr color = _knob.lock();
 
-    r = color->getValueAtTime( time, 0, ViewSpec::current() );
-    g = color->getValueAtTime( time, 1, ViewSpec::current() );
-    b = color->getValueAtTime( time, 2, ViewSpec::current() );
-    a = color->getValueAtTime( time, 3, ViewSpec::current() );
+    r = getKnobValueAtTime(color.get(), getKnobValuesSlot(), time, 0);
+    g = getKnobValueAtTime(color.get(), getKnobValuesSlot(), time, 1);
+    b = getKnobValueAtTime(color.get(), getKnobValuesSlot(), time, 2);
+    a = getKnobValueAtTime(color.get(), getKnobValuesSlot(), time, 3);
 
     return kOfxStatOK;
 }
@@ -2056,6 +2115,7 @@ OfxRGBInstance::OfxRGBInstance(const OfxEffectInstancePtr& node,
     KnobColorPtr knob  = checkIfKnobExistsWithNameOrCreate<KnobColor>(descriptor.getName(), this, 3);
 
     _knob = knob;
+    addKnobValuesSnapshotSlot(node, knob);
     setRange();
     setDisplayRange();
 
@@ -2084,9 +2144,9 @@ OfxRGBInstance::get(double & r,
 {
     KnobColorPtr color = _knob.lock();
 
-    r = color->getValue(0);
-    g = color->getValue(1);
-    b = color->getValue(2);
+    r = getKnobValue(color.get(), getKnobValuesSlot(), 0);
+    g = getKnobValue(color.get(), getKnobValuesSlot(), 1);
+    b = getKnobValue(color.get(), getKnobValuesSlot(), 2);
 
     return kOfxStatOK;
 }
@@ -2099,9 +2159,9 @@ OfxRGBInstance::get(OfxTime time,
 {
     KnobColorPtr color = _knob.lock();
 
-    r = color->getValueAtTime(time, 0);
-    g = color->getValueAtTime(time, 1);
-    b = color->getValueAtTime(time, 2);
+    r = getKnobValueAtTime(color.get(), getKnobValuesSlot(), time, 0);
+    g = getKnobValueAtTime(color.get(), getKnobValuesSlot(), time, 1);
+    b = getKnobValueAtTime(color.get(), getKnobValuesSlot(), time, 2);
 
     return kOfxStatOK;
 }
@@ -2385,6 +2445,7 @@ OfxDouble2DInstance::OfxDouble2DInstance(const OfxEffectInstancePtr& node,
         dblKnob = checkIfKnobExistsWithNameOrCreate<KnobDouble>(paramName, this, knobDims);
     }
     _knob = dblKnob;
+    addKnobValuesSnapshotSlot(node, dblKnob);
     setRange();
     setDisplayRange();
 
@@ -2464,8 +2525,8 @@ OfxDouble2DInstance::get(double & x1,
 {
     KnobDoublePtr dblKnob = _knob.lock();
 
-    x1 = dblKnob->getValue(_startIndex);
-    x2 = dblKnob->getValue(_startIndex + 1);
+    x1 = getKnobValue(dblKnob.get(), getKnobValuesSlot(), _startIndex);
+    x2 = getKnobValue(dblKnob.get(), getKnobValuesSlot(), _startIndex + 1);
 
     return kOfxStatOK;
 }
@@ -2477,8 +2538,8 @@ OfxDouble2DInstance::get(OfxTime time,
 {
     KnobDoublePtr dblKnob = _knob.lock();
 
-    x1 = dblKnob->getValueAtTime(time, _startIndex);
-    x2 = dblKnob->getValueAtTime(time, _startIndex + 1);
+    x1 = getKnobValueAtTime(dblKnob.get(), getKnobValuesSlot(), time, _startIndex);
+    x2 = getKnobValueAtTime(dblKnob.get(), getKnobValuesSlot(), time, _startIndex + 1);
 
     return kOfxStatOK;
 }
@@ -2758,6 +2819,7 @@ OfxInteger2DInstance::OfxInteger2DInstance(const OfxEffectInstancePtr& node,
         iKnob = checkIfKnobExistsWithNameOrCreate<KnobInt>(paramName, this, knobDims);
     }
     _knob = iKnob;
+    addKnobValuesSnapshotSlot(node, iKnob);
     setRange();
     setDisplayRange();
 
@@ -2788,8 +2850,8 @@ OfxInteger2DInstance::get(int & x1,
 {
     KnobIntPtr iKnob = _knob.lock();
 
-    x1 = iKnob->getValue(_startIndex);
-    x2 = iKnob->getValue(_startIndex + 1);
+    x1 = getKnobValue(iKnob.get(), getKnobValuesSlot(), _startIndex);
+    x2 = getKnobValue(iKnob.get(), getKnobValuesSlot(), _startIndex + 1);
 
     return kOfxStatOK;
 }
@@ -2801,8 +2863,8 @@ OfxInteger2DInstance::get(OfxTime time,
 {
     KnobIntPtr iKnob = _knob.lock();
 
-    x1 = iKnob->getValueAtTime(time, _startIndex);
-    x2 = iKnob->getValueAtTime(time, _startIndex + 1);
+    x1 = getKnobValueAtTime(iKnob.get(), getKnobValuesSlot(), time, _startIndex);
+    x2 = getKnobValueAtTime(iKnob.get(), getKnobValuesSlot(), time, _startIndex + 1);
 
     return kOfxStatOK;
 }
@@ -3043,6 +3105,7 @@ OfxDouble3DInstance::OfxDouble3DInstance(const OfxEffectInstancePtr& node,
         knob = checkIfKnobExistsWithNameOrCreate<KnobDouble>(paramName, this, knobDims);
     }
     _knob = knob;
+    addKnobValuesSnapshotSlot(node, knob);
     setRange();
     setDisplayRange();
 
@@ -3081,9 +3144,9 @@ OfxDouble3DInstance::get(double & x1,
 {
     KnobDoublePtr knob = _knob.lock();
 
-    x1 = knob->getValue(0 + _startIndex);
-    x2 = knob->getValue(1 + _startIndex);
-    x3 = knob->getValue(2 + _startIndex);
+    x1 = getKnobValue(knob.get(), getKnobValuesSlot(), 0 + _startIndex);
+    x2 = getKnobValue(knob.get(), getKnobValuesSlot(), 1 + _startIndex);
+    x3 = getKnobValue(knob.get(), getKnobValuesSlot(), 2 + _startIndex);
 
     return kOfxStatOK;
 }
@@ -3096,9 +3159,9 @@ OfxDouble3DInstance::get(OfxTime time,
 {
     KnobDoublePtr knob = _knob.lock();
 
-    x1 = knob->getValueAtTime(time, 0 + _startIndex);
-    x2 = knob->getValueAtTime(time, 1 + _startIndex);
-    x3 = knob->getValueAtTime(time, 2 + _startIndex);
+    x1 = getKnobValueAtTime(knob.get(), getKnobValuesSlot(), time, 0 + _startIndex);
+    x2 = getKnobValueAtTime(knob.get(), getKnobValuesSlot(), time, 1 + _startIndex);
+    x3 = getKnobValueAtTime(knob.get(), getKnobValuesSlot(), time, 2 + _startIndex);
 
     return kOfxStatOK;
 }
@@ -3358,6 +3421,7 @@ OfxInteger3DInstance::OfxInteger3DInstance(const OfxEffectInstancePtr&node,
     KnobIntPtr knob = checkIfKnobExistsWithNameOrCreate<KnobInt>(descriptor.getName(), this, dims);
 
     _knob = knob;
+    addKnobValuesSnapshotSlot(node, knob);
     setRange();
     setDisplayRange();
 
@@ -3388,9 +3452,9 @@ OfxInteger3DInstance::get(int & x1,
 {
     KnobIntPtr knob = _knob.lock();
 
-    x1 = knob->getValue(0);
-    x2 = knob->getValue(1);
-    x3 = knob->getValue(2);
+    x1 = getKnobValue(knob.get(), getKnobValuesSlot(), 0);
+    x2 = getKnobValue(knob.get(), getKnobValuesSlot(), 1);
+    x3 = getKnobValue(knob.get(), getKnobValuesSlot(), 2);
 
     return kOfxStatOK;
 }
@@ -3403,9 +3467,9 @@ OfxInteger3DInstance::get(OfxTime time,
 {
     KnobIntPtr knob = _knob.lock();
 
-    x1 = knob->getValueAtTime(time, 0);
-    x2 = knob->getValueAtTime(time, 1);
-    x3 = knob->getValueAtTime(time, 2);
+    x1 = getKnobValueAtTime(knob.get(), getKnobValuesSlot(), time, 0);
+    x2 = getKnobValueAtTime(knob.get(), getKnobValuesSlot(), time, 1);
+    x3 = getKnobValueAtTime(knob.get(), getKnobValuesSlot(), time, 2);
 
     return kOfxStatOK;
 }
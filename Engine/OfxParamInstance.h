@@ -95,6 +95,7 @@ class OfxParamToKnob
     mutable QMutex dynamicPropModifiedMutex;
     int _dynamicPropModified;
     EffectInstanceWPtr _effect;
+    int _knobValuesSlot;
 
 public:
 
@@ -103,6 +104,7 @@ public:
         : dynamicPropModifiedMutex()
         , _dynamicPropModified(0)
         , _effect(effect)
+        , _knobValuesSlot(-1)
     {
     }
 
@@ -122,6 +124,14 @@ public:
 
     EffectInstancePtr getKnobHolder() const;
 
+    /**
+     * @brief Returns the slot of the knob in the parameter values captured when a frame render starts, or -1 if they are not captured.
+     **/
+    int getKnobValuesSlot() const
+    {
+        return _knobValuesSlot;
+    }
+
     void connectDynamicProperties();
 
     //these are per ofxparam thread-local data
@@ -190,6 +200,12 @@ public Q_SLOTS:
     void onInViewportLabelChanged();
 protected:
 
+    /**
+     * @brief Captures the values of the knob with the other parameter values of the effect when a frame render starts.
+     * Called by the numeric parameters once their knob is created.
+     **/
+    void addKnobValuesSnapshotSlot(const OfxEffectInstancePtr& effect, const KnobIPtr& knob);
+
     void setDynamicPropertyModified(bool dynamicPropModified)
     {
         QMutexLocker k(&dynamicPropModifiedMutex);
@@ -0,0 +1,581 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "OfxPluginIndex.h"
+
+#include <cstdio> // rename
+#include <cstring> // memcpy
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+#include <QtCore/QSaveFile>
+#else
+#include <QtCore/QTemporaryFile>
+#endif
+
+// Bump the version when the layout of the index file changes.
+// The magic number is written in native byte order: an index written on a host with another
+// byte order is rejected.
+#define NATRON_OFX_PLUGIN_INDEX_MAGIC 0x4e4f5049 // "NOPI"
+#define NATRON_OFX_PLUGIN_INDEX_VERSION 2
+
+NATRON_NAMESPACE_ENTER
+
+/*
+   Layout of the index file, all integers in native byte order, strings as their UTF-8 size (quint32)
+   followed by their UTF-8 bytes:
+
+   header:     magic (quint32), version (quint32)
+               number of search paths (quint32), search paths (strings)
+               number of directories (quint32), directories (string path, qint64 modification time)
+               number of bundles (quint32)
+   bundle:     record size (quint32, including this field)
+               bundle path (string), binary path (string), binary modification time (qint64), binary size (qint64)
+               number of plug-ins (quint32)
+   plug-in:    ID, label, resources path, icon path (strings)
+               group icons, grouping (quint32 count then strings)
+               major, minor (qint32), isReader, isWriter, isDeprecated, isInternalOnly, renderThreadUnsafe (quint8)
+               OpenGL support (qint32)
+               number of shortcuts (quint32), shortcuts (action ID, action label (strings), modifiers, key (qint32))
+               number of formats (quint32), formats (strings)
+               evaluation (double)
+ */
+
+namespace {
+class IndexWriter
+{
+    QByteArray _buffer;
+
+public:
+
+    IndexWriter()
+        : _buffer()
+    {
+    }
+
+    const QByteArray& buffer() const
+    {
+        return _buffer;
+    }
+
+    int size() const
+    {
+        return _buffer.size();
+    }
+
+    template <typename T>
+    void write(T value)
+    {
+        _buffer.append( (const char*)&value, sizeof(T) );
+    }
+
+    template <typename T>
+    void writeAt(int offset, T value)
+    {
+        std::memcpy(_buffer.data() + offset, &value, sizeof(T) );
+    }
+
+    void writeString(const QString& str)
+    {
+        writeBytes( str.toUtf8() );
+    }
+
+    void writeString(const std::string& str)
+    {
+        write<quint32>( (quint32)str.size() );
+        _buffer.append( str.c_str(), (int)str.size() );
+    }
+
+    void writeBytes(const QByteArray& bytes)
+    {
+        write<quint32>( (quint32)bytes.size() );
+        _buffer.append(bytes);
+    }
+
+    void writeStringList(const QStringList& list)
+    {
+        write<quint32>( (quint32)list.size() );
+        for (int i = 0; i < list.size(); ++i) {
+            writeString(list[i]);
+        }
+    }
+};
+
+// Reads the index in place, every read is bounds-checked
+class IndexReader
+{
+    const uchar* _data;
+    std::size_t _size;
+    std::size_t _pos;
+    bool _ok;
+
+public:
+
+    IndexReader(const uchar* data,
+                std::size_t size)
+        : _data(data)
+        , _size(size)
+        , _pos(0)
+        , _ok(data != 0)
+    {
+    }
+
+    bool ok() const
+    {
+        return _ok;
+    }
+
+    std::size_t pos() const
+    {
+        return _pos;
+    }
+
+    template <typename T>
+    T read()
+    {
+        T value = T();
+
+        if ( !_ok || (_size - _pos < sizeof(T)) ) {
+            _ok = false;
+
+            return value;
+        }
+        std::memcpy(&value, _data + _pos, sizeof(T) );
+        _pos += sizeof(T);
+
+        return value;
+    }
+
+    const char* readRaw(quint32* size)
+    {
+        *size = read<quint32>();
+        if ( !_ok || (_size - _pos < *size) ) {
+            _ok = false;
+            *size = 0;
+
+            return 0;
+        }
+        const char* ret = (const char*)_data + _pos;
+        _pos += *size;
+
+        return ret;
+    }
+
+    QString readString()
+    {
+        quint32 size;
+        const char* str = readRaw(&size);
+
+        return str ? QString::fromUtf8(str, (int)size) : QString();
+    }
+
+    std::string readStdString()
+    {
+        quint32 size;
+        const char* str = readRaw(&size);
+
+        return str ? std::string(str, size) : std::string();
+    }
+
+    QStringList readStringList()
+    {
+        QStringList ret;
+        quint32 n = read<quint32>();
+
+        for (quint32 i = 0; i < n && _ok; ++i) {
+            ret.push_back( readString() );
+        }
+
+        return ret;
+    }
+};
+}
+
+static qint64
+getModificationTime(const QFileInfo& info)
+{
+    if ( !info.exists() ) {
+        return -1;
+    }
+
+    return info.lastModified().toMSecsSinceEpoch();
+}
+
+OfxPluginIndex::PluginEntry::PluginEntry()
+    : pluginID()
+    , pluginLabel()
+    , resourcesPath()
+    , iconFilePath()
+    , groupIconFilePath()
+    , grouping()
+    , majorVersion(0)
+    , minorVersion(0)
+    , isReader(false)
+    , isWriter(false)
+    , isDeprecated(false)
+    , isInternalOnly(false)
+    , renderThreadUnsafe(false)
+    , openglRenderSupport(ePluginOpenGLRenderSupportNone)
+    , shortcuts()
+    , formats()
+    , evaluation(0.)
+{
+}
+
+OfxPluginIndex::BundleEntry::BundleEntry()
+    : bundlePath()
+    , binaryFilePath()
+    , binaryModificationTime(-1)
+    , binarySize(0)
+    , plugins()
+{
+}
+
+OfxPluginIndex::OfxPluginIndex()
+    : _pluginPath()
+    , _directories()
+    , _bundles()
+{
+}
+
+OfxPluginIndex::~OfxPluginIndex()
+{
+}
+
+void
+OfxPluginIndex::setPluginPath(const std::list<std::string>& pluginPath)
+{
+    _pluginPath.clear();
+    for (std::list<std::string>::const_iterator it = pluginPath.begin(); it != pluginPath.end(); ++it) {
+        QString path = QDir::cleanPath( QString::fromUtf8( it->c_str() ) );
+        _pluginPath.push_back(path);
+        // Stamp the search path itself, so that a bundle added at its root invalidates the index
+        _directories[path] = getModificationTime( QFileInfo(path) );
+    }
+}
+
+void
+OfxPluginIndex::addPlugin(const std::string& binaryFilePath,
+                          const std::string& bundlePath,
+                          const PluginEntry& plugin)
+{
+    QFileInfo bundleInfo( QString::fromUtf8( bundlePath.c_str() ) );
+    QString bundleKey = QDir::cleanPath( bundleInfo.absoluteFilePath() );
+    BundlesMap::iterator found = _bundles.find(bundleKey);
+
+    if ( found != _bundles.end() ) {
+        found->second.plugins.push_back(plugin);
+
+        return;
+    }
+
+    BundleEntry& bundle = _bundles[bundleKey];
+    QFileInfo binaryInfo( QString::fromUtf8( binaryFilePath.c_str() ) );
+    bundle.bundlePath = bundleKey;
+    bundle.binaryFilePath = binaryInfo.absoluteFilePath();
+    bundle.binaryModificationTime = getModificationTime(binaryInfo);
+    bundle.binarySize = (qint64)binaryInfo.size();
+    bundle.plugins.push_back(plugin);
+
+    // Stamp the directories containing the bundle, up to the search path, so that adding or removing
+    // a bundle next to this one invalidates the index
+    QDir dir = bundleInfo.absoluteDir();
+    for (;;) {
+        QString dirPath = QDir::cleanPath( dir.absolutePath() );
+        if ( _directories.find(dirPath) != _directories.end() ) {
+            // Already stamped, as are its parents
+            break;
+        }
+        _directories[dirPath] = getModificationTime( QFileInfo(dirPath) );
+        if ( _pluginPath.contains(dirPath) || !dir.cdUp() ) {
+            break;
+        }
+    }
+}
+
+static bool
+isBundleEntryUpToDate(const OfxPluginIndex::BundleEntry& bundle)
+{
+    QFileInfo info(bundle.binaryFilePath);
+
+    return ( getModificationTime(info) == bundle.binaryModificationTime ) && ( (qint64)info.size() == bundle.binarySize );
+}
+
+bool
+OfxPluginIndex::isUpToDate(const std::list<std::string>& pluginPath) const
+{
+    if ( _bundles.empty() || ( (int)pluginPath.size() != _pluginPath.size() ) ) {
+        return false;
+    }
+    int i = 0;
+    for (std::list<std::string>::const_iterator it = pluginPath.begin(); it != pluginPath.end(); ++it, ++i) {
+        if ( QDir::cleanPath( QString::fromUtf8( it->c_str() ) ) != _pluginPath[i] ) {
+            return false;
+        }
+    }
+    for (std::map<QString, qint64>::const_iterator it = _directories.begin(); it != _directories.end(); ++it) {
+        if ( getModificationTime( QFileInfo(it->first) ) != it->second ) {
+            return false;
+        }
+    }
+    for (BundlesMap::const_iterator it = _bundles.begin(); it != _bundles.end(); ++it) {
+        if ( !isBundleEntryUpToDate(it->second) ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+OfxPluginIndex::isBundleUpToDate(const QString& bundlePath) const
+{
+    return findUpToDateBundle(bundlePath) != 0;
+}
+
+const OfxPluginIndex::BundleEntry*
+OfxPluginIndex::findUpToDateBundle(const QString& bundlePath) const
+{
+    BundlesMap::const_iterator found = _bundles.find( QDir::cleanPath( QFileInfo(bundlePath).absoluteFilePath() ) );
+
+    if ( ( found == _bundles.end() ) || !isBundleEntryUpToDate(found->second) ) {
+        return 0;
+    }
+
+    return &found->second;
+}
+
+static void
+readPluginEntry(IndexReader& reader,
+                OfxPluginIndex::PluginEntry* p)
+{
+    p->pluginID = reader.readString();
+    p->pluginLabel = reader.readString();
+    p->resourcesPath = reader.readString();
+    p->iconFilePath = reader.readString();
+    p->groupIconFilePath = reader.readStringList();
+    p->grouping = reader.readStringList();
+    p->majorVersion = reader.read<qint32>();
+    p->minorVersion = reader.read<qint32>();
+    p->isReader = reader.read<quint8>() != 0;
+    p->isWriter = reader.read<quint8>() != 0;
+    p->isDeprecated = reader.read<quint8>() != 0;
+    p->isInternalOnly = reader.read<quint8>() != 0;
+    p->renderThreadUnsafe = reader.read<quint8>() != 0;
+    p->openglRenderSupport = (PluginOpenGLRenderSupport)reader.read<qint32>();
+
+    quint32 nShortcuts = reader.read<quint32>();
+    for (quint32 i = 0; i < nShortcuts && reader.ok(); ++i) {
+        std::string actionID = reader.readStdString();
+        std::string actionLabel = reader.readStdString();
+        qint32 modifiers = reader.read<qint32>();
+        qint32 key = reader.read<qint32>();
+        p->shortcuts.push_back( PluginActionShortcut( actionID, actionLabel, (Key)key, KeyboardModifiers( QFlag(modifiers) ) ) );
+    }
+
+    quint32 nFormats = reader.read<quint32>();
+    for (quint32 i = 0; i < nFormats && reader.ok(); ++i) {
+        p->formats.push_back( reader.readStdString() );
+    }
+    p->evaluation = reader.read<double>();
+}
+
+static void
+writePluginEntry(const OfxPluginIndex::PluginEntry& p,
+                 IndexWriter& writer)
+{
+    writer.writeString(p.pluginID);
+    writer.writeString(p.pluginLabel);
+    writer.writeString(p.resourcesPath);
+    writer.writeString(p.iconFilePath);
+    writer.writeStringList(p.groupIconFilePath);
+    writer.writeStringList(p.grouping);
+    writer.write<qint32>(p.majorVersion);
+    writer.write<qint32>(p.minorVersion);
+    writer.write<quint8>(p.isReader);
+    writer.write<quint8>(p.isWriter);
+    writer.write<quint8>(p.isDeprecated);
+    writer.write<quint8>(p.isInternalOnly);
+    writer.write<quint8>(p.renderThreadUnsafe);
+    writer.write<qint32>( (qint32)p.openglRenderSupport );
+
+    writer.write<quint32>( (quint32)p.shortcuts.size() );
+    for (std::list<PluginActionShortcut>::const_iterator it = p.shortcuts.begin(); it != p.shortcuts.end(); ++it) {
+        writer.writeString(it->actionID);
+        writer.writeString(it->actionLabel);
+        writer.write<qint32>( (qint32)it->modifiers );
+        writer.write<qint32>( (qint32)it->key );
+    }
+
+    writer.write<quint32>( (quint32)p.formats.size() );
+    for (std::vector<std::string>::const_iterator it = p.formats.begin(); it != p.formats.end(); ++it) {
+        writer.writeString(*it);
+    }
+    writer.write<double>(p.evaluation);
+}
+
+bool
+OfxPluginIndex::read(const QString& filePath)
+{
+    _pluginPath.clear();
+    _directories.clear();
+    _bundles.clear();
+
+    QFile file(filePath);
+    if ( !file.open(QIODevice::ReadOnly) ) {
+        return false;
+    }
+    const qint64 fileSize = file.size();
+    uchar* data = fileSize > 0 ? file.map(0, fileSize) : 0;
+    if (!data) {
+        return false;
+    }
+
+    IndexReader reader(data, (std::size_t)fileSize);
+    if ( (reader.read<quint32>() != NATRON_OFX_PLUGIN_INDEX_MAGIC) || (reader.read<quint32>() != NATRON_OFX_PLUGIN_INDEX_VERSION) ) {
+        file.unmap(data);
+
+        return false;
+    }
+
+    _pluginPath = reader.readStringList();
+
+    quint32 nDirectories = reader.read<quint32>();
+    for (quint32 i = 0; i < nDirectories && reader.ok(); ++i) {
+        QString path = reader.readString();
+        _directories[path] = reader.read<qint64>();
+    }
+
+    quint32 nBundles = reader.read<quint32>();
+    for (quint32 i = 0; i < nBundles && reader.ok(); ++i) {
+        const std::size_t recordStart = reader.pos();
+        const quint32 recordSize = reader.read<quint32>();
+        BundleEntry bundle;
+        bundle.bundlePath = reader.readString();
+        bundle.binaryFilePath = reader.readString();
+        bundle.binaryModificationTime = reader.read<qint64>();
+        bundle.binarySize = reader.read<qint64>();
+        quint32 nPlugins = reader.read<quint32>();
+        for (quint32 j = 0; j < nPlugins && reader.ok(); ++j) {
+            PluginEntry p;
+            readPluginEntry(reader, &p);
+            bundle.plugins.push_back(p);
+        }
+        if ( reader.ok() && (reader.pos() != recordStart + recordSize) ) {
+            // The record does not match its size, the file is corrupted
+            break;
+        }
+        _bundles[bundle.bundlePath] = bundle;
+    }
+
+    const bool ok = reader.ok() && ( _bundles.size() == nBundles );
+    file.unmap(data);
+    if (!ok) {
+        _bundles.clear();
+    }
+
+    return ok;
+} // OfxPluginIndex::read
+
+bool
+OfxPluginIndex::write(const QString& filePath) const
+{
+    IndexWriter writer;
+
+    writer.write<quint32>(NATRON_OFX_PLUGIN_INDEX_MAGIC);
+    writer.write<quint32>(NATRON_OFX_PLUGIN_INDEX_VERSION);
+    writer.writeStringList(_pluginPath);
+
+    writer.write<quint32>( (quint32)_directories.size() );
+    for (std::map<QString, qint64>::const_iterator it = _directories.begin(); it != _directories.end(); ++it) {
+        writer.writeString(it->first);
+        writer.write<qint64>(it->second);
+    }
+
+    writer.write<quint32>( (quint32)_bundles.size() );
+    for (BundlesMap::const_iterator it = _bundles.begin(); it != _bundles.end(); ++it) {
+        const int recordStart = writer.size();
+        writer.write<quint32>(0); // record size, set below
+        writer.writeString(it->second.bundlePath);
+        writer.writeString(it->second.binaryFilePath);
+        writer.write<qint64>(it->second.binaryModificationTime);
+        writer.write<qint64>(it->second.binarySize);
+        writer.write<quint32>( (quint32)it->second.plugins.size() );
+        for (std::list<PluginEntry>::const_iterator it2 = it->second.plugins.begin(); it2 != it->second.plugins.end(); ++it2) {
+            writePluginEntry(*it2, writer);
+        }
+        writer.writeAt<quint32>( recordStart, (quint32)(writer.size() - recordStart) );
+    }
+
+    // Write to a temporary file first so that a concurrent launch never reads a partial index
+#if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+    QSaveFile file(filePath);
+    if ( !file.open(QIODevice::WriteOnly) ) {
+        return false;
+    }
+    if ( file.write( writer.buffer() ) != writer.size() ) {
+        file.cancelWriting();
+
+        return false;
+    }
+
+    // Atomically replaces the index
+    return file.commit();
+#else
+    // A unique temporary file in the same directory, so that concurrent launches do not write to the same file
+    QTemporaryFile file( filePath + QString::fromUtf8(".XXXXXX") );
+    file.setAutoRemove(false);
+    if ( !file.open() ) {
+        return false;
+    }
+    const QString tmpFilePath = file.fileName();
+    if ( ( file.write( writer.buffer() ) != writer.size() ) || !file.flush() ) {
+        file.close();
+        QFile::remove(tmpFilePath);
+
+        return false;
+    }
+    file.close();
+
+    // rename() atomically replaces the index on POSIX systems. QFile::rename() does not overwrite an existing file,
+    // so it is only used where rename() fails if the destination exists.
+    if ( std::rename( QFile::encodeName(tmpFilePath).constData(), QFile::encodeName(filePath).constData() ) == 0 ) {
+        return true;
+    }
+    QFile::remove(filePath);
+    if ( !QFile::rename(tmpFilePath, filePath) ) {
+        QFile::remove(tmpFilePath);
+
+        return false;
+    }
+
+    return true;
+#endif
+} // OfxPluginIndex::write
+
+NATRON_NAMESPACE_EXIT
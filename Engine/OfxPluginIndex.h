@@ -0,0 +1,152 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef Natron_Engine_OfxPluginIndex_h
+#define Natron_Engine_OfxPluginIndex_h
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "Global/Enums.h"
+#include "Engine/PluginActionShortcut.h"
+#include "Engine/EngineFwd.h"
+
+NATRON_NAMESPACE_ENTER
+
+/**
+ * @brief A compact binary index of the OpenFX plug-ins found in the plug-ins search path.
+ * It holds everything needed to register the plug-ins in the application, and the binary of each bundle,
+ * so that the plug-ins are registered from it at startup, and the OpenFX host only loads and describes the
+ * bundle of a plug-in when the plug-in is first used.
+ * The index stores the modification time of the plug-in binaries and of the directories containing the
+ * bundles, so that adding, removing or updating a plug-in invalidates it.
+ *
+ * The file is a versioned binary layout in native byte order, read in place from a memory mapping.
+ * Each bundle is a self-sized record holding its own modification stamps, so that a reader can validate
+ * and skip bundles independently.
+ **/
+class OfxPluginIndex
+{
+public:
+
+    // The registration data of a plug-in, see AppManager::registerPlugin
+    struct PluginEntry
+    {
+        QString pluginID;
+        QString pluginLabel;
+        QString resourcesPath;
+        QString iconFilePath;
+        QStringList groupIconFilePath;
+        QStringList grouping;
+        int majorVersion;
+        int minorVersion;
+        bool isReader;
+        bool isWriter;
+        bool isDeprecated;
+        bool isInternalOnly;
+        bool renderThreadUnsafe;
+        PluginOpenGLRenderSupport openglRenderSupport;
+        std::list<PluginActionShortcut> shortcuts;
+
+        // The file extensions supported by a reader or writer, lower case
+        std::vector<std::string> formats;
+        double evaluation;
+
+        PluginEntry();
+    };
+
+    // A plug-in bundle and the plug-ins of its binary
+    struct BundleEntry
+    {
+        QString bundlePath;
+        QString binaryFilePath;
+        qint64 binaryModificationTime; // in ms since epoch, -1 if missing
+        qint64 binarySize;
+        std::list<PluginEntry> plugins;
+
+        BundleEntry();
+    };
+
+    typedef std::map<QString, BundleEntry> BundlesMap;
+
+    OfxPluginIndex();
+
+    ~OfxPluginIndex();
+
+    /**
+     * @brief Set the plug-ins search path the index is built from
+     **/
+    void setPluginPath(const std::list<std::string>& pluginPath);
+
+    /**
+     * @brief Adds a plug-in of the given binary. The first plug-in of a bundle stamps the binary and the directories
+     * containing the bundle, up to the search path.
+     **/
+    void addPlugin(const std::string& binaryFilePath, const std::string& bundlePath, const PluginEntry& plugin);
+
+    const BundlesMap& getBundles() const
+    {
+        return _bundles;
+    }
+
+    /**
+     * @brief Returns true if the index was built from the given search path and none of the stamped
+     * files and directories changed since.
+     **/
+    bool isUpToDate(const std::list<std::string>& pluginPath) const;
+
+    /**
+     * @brief Returns true if the given bundle is in the index and its binary did not change since the index was built
+     **/
+    bool isBundleUpToDate(const QString& bundlePath) const;
+
+    /**
+     * @brief Returns the given bundle if it is in the index and its binary did not change since the index was built,
+     * NULL otherwise.
+     **/
+    const BundleEntry* findUpToDateBundle(const QString& bundlePath) const;
+
+    bool read(const QString& filePath);
+
+    bool write(const QString& filePath) const;
+
+private:
+
+    QStringList _pluginPath;
+
+    // Modification times (in ms since epoch, -1 if missing) of the directories containing the bundles
+    std::map<QString, qint64> _directories;
+    BundlesMap _bundles;
+};
+
+NATRON_NAMESPACE_EXIT
+
+#endif // Natron_Engine_OfxPluginIndex_h
@@ -130,6 +130,7 @@ public:
                                                double gamma,
                                                double offset,
                                                int lut,
+                                               bool displayChannelsInShader,
                                                bool recenterViewer,
                                                const Point& viewportCenter,
                                                bool isPartialRect) = 0;
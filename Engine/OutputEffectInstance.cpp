@@ -505,6 +505,20 @@ OutputEffectInstance::reportStats(int time,
         ofile << "Nb cache hit: " << nbCacheMiss << std::endl;
         ofile << "Nb cache miss: " << nbCacheMiss << std::endl;
         ofile << "Nb cache hit requiring mipmap downscaling: " << nbCacheHitButDownscaled << std::endl;
+        int nbMutexContentions;
+        double mutexWaitTime;
+        it->second.getMutexContentions(&nbMutexContentions, &mutexWaitTime);
+        ofile << "Nb OpenFX mutex contentions: " << nbMutexContentions << " (" << Timer::printAsTime(mutexWaitTime, false).toStdString() << " waiting)" << std::endl;
+
+        const ActionCallStatsMap & actionCalls = it->second.getActionCalls();
+        ofile << "OpenFX actions: " << actionCalls.size() << std::endl;
+        for (ActionCallStatsMap::const_iterator it2 = actionCalls.begin(); it2 != actionCalls.end(); ++it2) {
+            ofile << it2->first << ": " << it2->second.getNumberOfCalls() << " call(s), total = " << Timer::printAsTime(it2->second.getTotalTimeSpent(), false).toStdString()
+                  << ", median = " << Timer::printAsTime(it2->second.getPercentile(0.5), false).toStdString()
+                  << ", 90th percentile = " << Timer::printAsTime(it2->second.getPercentile(0.9), false).toStdString()
+                  << ", max = " << Timer::printAsTime(it2->second.getPercentile(1.), false).toStdString()
+                  << ", total including nested actions = " << Timer::printAsTime(it2->second.getTotalInclusiveTimeSpent(), false).toStdString() << std::endl;
+        }
 
         const std::set<std::string> & planes = it->second.getPlanesRendered();
         ofile << "Plane(s) rendered: ";
@@ -29,6 +29,7 @@
 #include <list>
 #include <algorithm> // min, max
 #include <cassert>
+#include <cstdlib> // abs
 #include <stdexcept>
 #include <sstream> // stringstream
 
@@ -90,6 +91,9 @@
 
 #define NATRON_SCHEDULER_ABORT_AFTER_X_UNSUCCESSFUL_ITERATIONS 5000
 
+// Stop waiting for the pre-buffered frames after this time (in seconds), e.g. if a frame cannot be rendered
+#define NATRON_SCHEDULER_PREBUFFER_TIMEOUT_SECONDS 10.
+
 NATRON_NAMESPACE_ENTER
 
 
@@ -171,6 +175,29 @@ public:
 
 typedef boost::shared_ptr<OutputSchedulerThreadExecMTArgs> OutputSchedulerThreadExecMTArgsPtr;
 
+class ReadAheadStartArgs
+    : public GenericThreadStartArgs
+{
+public:
+
+    // The frames to decode, in the order they will be rendered
+    std::vector<int> frames;
+    std::vector<ViewIdx> views;
+    unsigned int mipMapLevel;
+
+    ReadAheadStartArgs()
+        : GenericThreadStartArgs()
+        , frames()
+        , views()
+        , mipMapLevel(0)
+    {
+    }
+
+    virtual ~ReadAheadStartArgs() {}
+};
+
+typedef boost::shared_ptr<ReadAheadStartArgs> ReadAheadStartArgsPtr;
+
 #ifndef NATRON_PLAYBACK_USES_THREAD_POOL
 static bool
 isBufferFull(int nbBufferedElement,
@@ -242,6 +269,12 @@ struct OutputSchedulerThreadPrivate
     QMutex bufferedOutputMutex;
     int lastBufferedOutputSize;
 
+    // Decodes the frames of the Read nodes upstream ahead of the render threads
+    boost::scoped_ptr<ReadAheadThread> readAheadThread;
+
+    // Parent of all frame renders of the ongoing sequential render, created in startRender()
+    mutable QMutex sequenceAbortInfoMutex;
+    AbortableRenderInfoPtr sequenceAbortInfo;
 
     OutputSchedulerThreadPrivate(RenderEngine* engine,
                                  const OutputEffectInstancePtr& effect,
@@ -281,6 +314,9 @@ struct OutputSchedulerThreadPrivate
 #endif
         , bufferedOutputMutex()
         , lastBufferedOutputSize(0)
+        , readAheadThread( new ReadAheadThread(effect) )
+        , sequenceAbortInfoMutex()
+        , sequenceAbortInfo()
     {
     }
 
@@ -336,6 +372,30 @@ struct OutputSchedulerThreadPrivate
 
     typedef std::set<ViewUniqueIDPair, ViewUniqueIDPairCompareLess> ViewUniqueIDSet;
 
+    bool hasBufferedFrame(int time) const
+    {
+        ///Private, shouldn't lock
+        assert( !bufMutex.tryLock() );
+
+        BufferedFrameKey key;
+        key.time = time;
+
+        return buf.find(key) != buf.end();
+    }
+
+    int getNbBufferedTimes() const
+    {
+        ///Private, shouldn't lock
+        assert( !bufMutex.tryLock() );
+
+        int nbTimes = 0;
+        for (FrameBuffer::const_iterator it = buf.begin(); it != buf.end(); it = buf.upper_bound(it->first)) {
+            ++nbTimes;
+        }
+
+        return nbTimes;
+    }
+
     void getFromBufferAndErase(double time,
                                BufferedFrames& frames)
     {
@@ -544,6 +604,7 @@ OutputSchedulerThread::OutputSchedulerThread(RenderEngine* engine,
     , _imp( new OutputSchedulerThreadPrivate(engine, effect, mode) )
 {
     QObject::connect( &_imp->timer, SIGNAL(fpsChanged(double,double)), _imp->engine, SIGNAL(fpsChanged(double,double)) );
+    QObject::connect( &_imp->timer, SIGNAL(playbackStatsChanged(int,double,double)), _imp->engine, SIGNAL(playbackStatsChanged(int,double,double)) );
 
 
 #ifdef NATRON_SCHEDULER_SPAWN_THREADS_WITH_TIMER
@@ -561,6 +622,10 @@ OutputSchedulerThread::~OutputSchedulerThread()
 
     ///Make sure they are all gone, there will be a deadlock here if that's not the case.
     _imp->waitForRenderThreadsToQuit();
+
+    if ( _imp->readAheadThread->quitThread(false) ) {
+        _imp->readAheadThread->waitForThreadToQuit_enforce_blocking();
+    }
 }
 
 bool
@@ -733,6 +798,64 @@ OutputSchedulerThread::pushFramesToRenderInternal(int startingFrame,
     _imp->framesToRenderNotEmptyCond.wakeAll();
 }
 
+void
+OutputSchedulerThread::pushFramesToReadAhead(int nThreads)
+{
+    // QMutexLocker l(&_imp->framesToRenderMutex); already locked (check below)
+    assert( !_imp->framesToRenderMutex.tryLock() );
+
+    int nFramesToDecode = appPTR->getCurrentSettings()->getNumberOfReadAheadFrames();
+    if (nFramesToDecode <= 0) {
+        return;
+    }
+
+    OutputSchedulerThreadStartArgsPtr runArgs = _imp->runArgs.lock();
+    assert(runArgs);
+    if (runArgs->firstFrame == runArgs->lastFrame) {
+        return;
+    }
+
+    ReadAheadStartArgsPtr readAheadArgs = boost::make_shared<ReadAheadStartArgs>();
+
+    ///The first nThreads frames in the queue are going to be picked right away by the render threads
+    ///and will not benefit from being decoded ahead.
+    int i = 0;
+    for (std::list<int>::const_iterator it = _imp->framesToRender.begin(); it != _imp->framesToRender.end(); ++it, ++i) {
+        if (i < nThreads) {
+            continue;
+        }
+        if ( (int)readAheadArgs->frames.size() >= nFramesToDecode ) {
+            break;
+        }
+        readAheadArgs->frames.push_back(*it);
+    }
+
+    ///When rendering in order, the queue only holds a few frames, continue after the last frame pushed
+    if ( ( (int)readAheadArgs->frames.size() < nFramesToDecode ) && (getSchedulingPolicy() == eSchedulingPolicyOrdered) ) {
+        PlaybackModeEnum pMode = _imp->engine->getPlaybackMode();
+        RenderDirectionEnum direction = runArgs->pushTimelineDirection;
+        int frame = _imp->lastFramePushedIndex;
+        while ( (int)readAheadArgs->frames.size() < nFramesToDecode ) {
+            if ( !OutputSchedulerThreadPrivate::getNextFrameInSequence(pMode, direction, frame,
+                                                                       runArgs->firstFrame, runArgs->lastFrame, runArgs->frameStep, &frame, &direction) ) {
+                break;
+            }
+            if ( std::find(readAheadArgs->frames.begin(), readAheadArgs->frames.end(), frame) != readAheadArgs->frames.end() ) {
+                ///We looped over the whole range
+                break;
+            }
+            readAheadArgs->frames.push_back(frame);
+        }
+    }
+
+    if ( readAheadArgs->frames.empty() ) {
+        return;
+    }
+    readAheadArgs->views = runArgs->viewsToRender;
+    readAheadArgs->mipMapLevel = getReadAheadMipMapLevel();
+    _imp->readAheadThread->startTask(readAheadArgs);
+} // OutputSchedulerThread::pushFramesToReadAhead
+
 void
 OutputSchedulerThread::pushAllFrameRange()
 {
@@ -808,12 +931,14 @@ OutputSchedulerThread::pickFrameToRender(RenderThreadTask* thread,
                                          bool* enableRenderStats,
                                          std::vector<ViewIdx>* viewsToRender)
 {
+    int nThreads;
     ///Flag the thread as inactive
     {
         QMutexLocker l(&_imp->renderThreadsMutex);
         RenderThreads::iterator found = _imp->getRunnableIterator(thread);
         assert( found != _imp->renderThreads.end() );
         found->active = false;
+        nThreads = (int)_imp->renderThreads.size();
 
         ///Wake up the scheduler if it is waiting for all threads do be inactive
         _imp->allRenderThreadsInactiveCond.wakeOne();
@@ -840,6 +965,8 @@ OutputSchedulerThread::pickFrameToRender(RenderThreadTask* thread,
             _imp->framesToRender.pop_front();
 
             gotFrame = true;
+
+            pushFramesToReadAhead(nThreads);
         }
     }
 
@@ -1035,6 +1162,21 @@ OutputSchedulerThread::startRender()
     // Start measuring
     _imp->renderTimer.reset(new TimeLapse);
 
+    {
+        AbortableRenderInfoPtr sequenceAbortInfo = AbortableRenderInfo::create(true, 0);
+        QMutexLocker k(&_imp->sequenceAbortInfoMutex);
+        _imp->sequenceAbortInfo = sequenceAbortInfo;
+
+        // An abort requested before the swap only cancelled the previous token: carry it over.
+        // An abort requested after this check calls onAbortRequested() which cancels the new token.
+        if ( isBeingAborted() ) {
+            sequenceAbortInfo->setAborted();
+        }
+    }
+
+    // Current frame renders are not useful anymore
+    _imp->engine->abortCurrentFrameRenders();
+
     ///We will push frame to renders starting at startingFrame.
     ///They will be in the range determined by firstFrame-lastFrame
     int startingFrame;
@@ -1133,6 +1275,58 @@ OutputSchedulerThread::startRender()
 #endif
 } // OutputSchedulerThread::startRender
 
+void
+OutputSchedulerThread::waitForPreBufferedFrames(const OutputSchedulerThreadStartArgsPtr& args)
+{
+    if ( !isFPSRegulationNeeded() ) {
+        return;
+    }
+
+    // Never wait for more frames than the sequence has or than the buffer may hold
+    int nFrames = appPTR->getCurrentSettings()->getNumberOfPlaybackPreBufferedFrames();
+    int frameStep = std::max( 1, std::abs(args->frameStep) );
+    nFrames = std::min( nFrames, (args->lastFrame - args->firstFrame) / frameStep + 1 );
+#ifndef NATRON_PLAYBACK_USES_THREAD_POOL
+    nFrames = std::min( nFrames, appPTR->getHardwareIdealThreadCount() * 3 );
+#endif
+
+    if (nFrames > 1) {
+        TimeLapse timeWaited;
+        for (;;) {
+            ThreadStateEnum state = resolveState();
+            if ( (state == eThreadStateAborted) || (state == eThreadStateStopped) ) {
+                break;
+            }
+            {
+                QMutexLocker l(&_imp->renderFinishedMutex);
+                if (_imp->renderFinished) {
+                    break;
+                }
+            }
+            if (timeWaited.getTimeSinceCreation() > NATRON_SCHEDULER_PREBUFFER_TIMEOUT_SECONDS) {
+                break;
+            }
+
+#ifndef NATRON_PLAYBACK_USES_THREAD_POOL
+            // Render threads are only given a few frames ahead by startRender(), keep them busy
+            int newNThreads, lastNThreads;
+            adjustNumberOfThreads(&newNThreads, &lastNThreads);
+            pushFramesToRender(newNThreads);
+#endif
+
+            QMutexLocker l(&_imp->bufMutex);
+            if (_imp->getNbBufferedTimes() >= nFrames) {
+                break;
+            }
+            // Woken up by appendToBuffer(...)
+            _imp->bufEmptyCondition.wait(&_imp->bufMutex, 50);
+        }
+    }
+
+    // The playback cadence starts now
+    _imp->timer.resetTiming();
+} // OutputSchedulerThread::waitForPreBufferedFrames
+
 void
 OutputSchedulerThread::stopRender()
 {
@@ -1160,6 +1354,9 @@ OutputSchedulerThread::stopRender()
 #endif
     _imp->waitForRenderThreadsToQuit();
 
+    ///Frames decoded ahead are no longer needed
+    _imp->readAheadThread->abortThreadedTask(false);
+
     ///If the output effect is sequential (only WriteFFMPEG for now)
     EffectInstancePtr effect = _imp->outputEffect.lock();
     WriteNode* isWriteNode = dynamic_cast<WriteNode*>( effect.get() );
@@ -1192,6 +1389,8 @@ OutputSchedulerThread::stopRender()
     bool wasAborted = isBeingAborted();
 
 
+    _imp->engine->renewCurrentFrameRendersAbortInfo();
+
     ///Notify everyone that the render is finished
     _imp->engine->s_renderFinished(wasAborted ? 1 : 0);
 
@@ -1227,6 +1426,7 @@ OutputSchedulerThread::threadLoopOnce(const GenericThreadStartArgsPtr &inArgs)
     int nbIterationsWithoutProcessing = 0;
 
     startRender();
+    waitForPreBufferedFrames(args);
 
     for (;; ) {
         ///When set to true, we don't sleep in the bufEmptyCondition but in the startCondition instead, indicating
@@ -1376,7 +1576,18 @@ OutputSchedulerThread::threadLoopOnce(const GenericThreadStartArgsPtr &inArgs)
                 }
             } // if (!renderFinished) {
 
-            if (_imp->timer.playState == ePlayStateRunning) {
+            // Frame pacing: if we are late by more than one frame and the next frame is already rendered,
+            // drop this frame instead of displaying it late so that the playback keeps the desired cadence
+            bool dropFrame = false;
+            if ( !renderFinished && (nextFrameToRender != expectedTimeToRender) && (_imp->timer.playState == ePlayStateRunning) &&
+                 appPTR->getCurrentSettings()->isPlaybackFrameDropEnabled() && _imp->timer.isNextFrameLate() ) {
+                QMutexLocker l(&_imp->bufMutex);
+                dropFrame = _imp->hasBufferedFrame(nextFrameToRender);
+            }
+
+            if (dropFrame) {
+                _imp->timer.dropNextFrame();
+            } else if (_imp->timer.playState == ePlayStateRunning) {
                 _imp->timer.waitUntilNextFrameIsDue(); // timer synchronizing with the requested fps
             }
 
@@ -1388,7 +1599,11 @@ OutputSchedulerThread::threadLoopOnce(const GenericThreadStartArgsPtr &inArgs)
                 break;
             }
 
-            if (_imp->mode == eProcessFrameBySchedulerThread) {
+            if (dropFrame) {
+#ifdef TRACE_SCHEDULER
+                qDebug() << "Scheduler Thread: dropping late frame " << expectedTimeToRender;
+#endif
+            } else if (_imp->mode == eProcessFrameBySchedulerThread) {
                 processFrame(framesToRender->frames);
             } else {
                 requestExecutionOnMainThread(framesToRender);
@@ -1457,9 +1672,25 @@ OutputSchedulerThread::threadLoopOnce(const GenericThreadStartArgsPtr &inArgs)
     return state;
 } // OutputSchedulerThread::threadLoopOnce
 
+AbortableRenderInfoPtr
+OutputSchedulerThread::getSequentialRenderAbortInfo() const
+{
+    QMutexLocker k(&_imp->sequenceAbortInfoMutex);
+
+    return _imp->sequenceAbortInfo;
+}
+
 void
 OutputSchedulerThread::onAbortRequested(bool /*keepOldestRender*/)
 {
+    // Cancel at once all frame renders of the sequence, including those that did not register their thread yet
+    {
+        QMutexLocker k(&_imp->sequenceAbortInfoMutex);
+        if (_imp->sequenceAbortInfo) {
+            _imp->sequenceAbortInfo->setAborted();
+        }
+    }
+
     ///We make sure the render-threads don't wait for the main-thread to process a frame
     ///This function (abortRendering) was probably called from a user event that was posted earlier in the
     ///event-loop, we just flag that the next event that will process the frame should NOT process it by
@@ -1809,6 +2040,24 @@ OutputSchedulerThread::getDesiredFPS() const
     return _imp->timer.getDesiredFrameRate();
 }
 
+double
+OutputSchedulerThread::getActualFPS() const
+{
+    return _imp->timer.getActualFrameRate();
+}
+
+int
+OutputSchedulerThread::getDroppedFrames() const
+{
+    return _imp->timer.getDroppedFrames();
+}
+
+double
+OutputSchedulerThread::getFrameLatencyPercentile(double percentile) const
+{
+    return _imp->timer.getFrameLatencyPercentile(percentile);
+}
+
 void
 OutputSchedulerThread::getLastRunArgs(RenderDirectionEnum* direction,
                                       std::vector<ViewIdx>* viewsToRender) const
@@ -2318,6 +2567,11 @@ private:
 
 
                 AbortableRenderInfoPtr abortInfo = AbortableRenderInfo::create(true, 0);
+                abortInfo->setPriority(eRenderPriorityBackground);
+                AbortableRenderInfoPtr sequenceAbortInfo = _imp->scheduler->getSequentialRenderAbortInfo();
+                if (sequenceAbortInfo) {
+                    abortInfo->setParentRender(sequenceAbortInfo);
+                }
                 if (isAbortableThread) {
                     isAbortableThread->setAbortInfo(isRenderDueToRenderInteraction, abortInfo, activeInputToRender);
                 }
@@ -2441,9 +2695,14 @@ DefaultScheduler::processFrame(const BufferedFrames& frames)
     const double par = effect->getAspectRatio(-1);
     const bool isRenderDueToRenderInteraction = false;
     const bool isSequentialRender = true;
+    AbortableRenderInfoPtr sequenceAbortInfo = getSequentialRenderAbortInfo();
 
     for (BufferedFrames::const_iterator it = frames.begin(); it != frames.end(); ++it) {
         AbortableRenderInfoPtr abortInfo = AbortableRenderInfo::create(true, 0);
+        abortInfo->setPriority(eRenderPriorityBackground);
+        if (sequenceAbortInfo) {
+            abortInfo->setParentRender(sequenceAbortInfo);
+        }
 
         setAbortInfo(isRenderDueToRenderInteraction, abortInfo, effect);
 
@@ -2842,6 +3101,14 @@ private:
         bool clearTexture[2] = { false, false };
         BufferableObjectPtrList toAppend;
 
+        // If this frame was already played with the same viewer settings, display the textures held by the flipbook cache
+        // without going through the render tree nor the viewer cache
+        if ( viewer->getFlipbookFrame(time, view, viewerHash, &toAppend) ) {
+            _imp->scheduler->appendToBuffer(time, view, stats, toAppend);
+
+            return;
+        }
+
         for (int i = 0; i < 2; ++i) {
             args[i] = boost::make_shared<ViewerArgs>();
             status[i] = viewer->getRenderViewerArgsAndCheckCache_public( time, true, view, i, viewerHash, true, NodePtr(), stats, args[i].get() );
@@ -2905,6 +3172,7 @@ private:
                     args[i].reset();
                 }
             }
+            viewer->insertFlipbookFrame(time, view, viewerHash, toAppend);
         }
         _imp->scheduler->appendToBuffer(time, view, stats, toAppend);
     } // renderFrame
@@ -2955,6 +3223,19 @@ ViewerDisplayScheduler::getLastRenderedTime() const
     return _viewer.lock()->getLastRenderedTime();
 }
 
+unsigned int
+ViewerDisplayScheduler::getReadAheadMipMapLevel() const
+{
+    ///Decode at the level the viewer will render at, see ViewerInstance::setupMinimalUpdateViewerParams
+    ViewerInstancePtr viewer = _viewer.lock();
+
+    if ( !viewer || viewer->isFullFrameProcessingEnabled() ) {
+        return 0;
+    }
+
+    return (unsigned int)std::max( viewer->getMipMapLevel(), viewer->getMipMapLevelFromZoomFactor() );
+}
+
 ////////////////////////// RenderEngine
 
 struct RenderEnginePrivate
@@ -2985,6 +3266,10 @@ struct RenderEnginePrivate
      */
     std::list<RefreshRequest> refreshQueue;
 
+    // Parent of all current frame renders, aborted while a sequential render is running
+    mutable QMutex currentFrameAbortInfoMutex;
+    AbortableRenderInfoPtr currentFrameAbortInfo;
+
     RenderEnginePrivate(const OutputEffectInstancePtr& output)
         : schedulerCreationLock()
         , scheduler(0)
@@ -2995,6 +3280,8 @@ struct RenderEnginePrivate
         , pbMode(ePlaybackModeLoop)
         , currentFrameScheduler(0)
         , refreshQueue()
+        , currentFrameAbortInfoMutex()
+        , currentFrameAbortInfo( AbortableRenderInfo::create(true, 0) )
     {
     }
 };
@@ -3348,6 +3635,37 @@ RenderEngine::isDoingSequentialRender() const
     return _imp->scheduler ? _imp->scheduler->isWorking() : false;
 }
 
+AbortableRenderInfoPtr
+RenderEngine::getSequentialRenderAbortInfo() const
+{
+    return _imp->scheduler ? _imp->scheduler->getSequentialRenderAbortInfo() : AbortableRenderInfoPtr();
+}
+
+AbortableRenderInfoPtr
+RenderEngine::getCurrentFrameRendersAbortInfo() const
+{
+    QMutexLocker k(&_imp->currentFrameAbortInfoMutex);
+
+    return _imp->currentFrameAbortInfo;
+}
+
+void
+RenderEngine::abortCurrentFrameRenders()
+{
+    QMutexLocker k(&_imp->currentFrameAbortInfoMutex);
+
+    _imp->currentFrameAbortInfo->setAborted();
+}
+
+void
+RenderEngine::renewCurrentFrameRendersAbortInfo()
+{
+    AbortableRenderInfoPtr abortInfo = AbortableRenderInfo::create(true, 0);
+    QMutexLocker k(&_imp->currentFrameAbortInfoMutex);
+
+    _imp->currentFrameAbortInfo = abortInfo;
+}
+
 void
 RenderEngine::setPlaybackMode(int mode)
 {
@@ -3382,6 +3700,24 @@ RenderEngine::getDesiredFPS() const
     return _imp->scheduler ? _imp->scheduler->getDesiredFPS() : 24;
 }
 
+double
+RenderEngine::getActualFPS() const
+{
+    return _imp->scheduler ? _imp->scheduler->getActualFPS() : 0.;
+}
+
+int
+RenderEngine::getDroppedFrames() const
+{
+    return _imp->scheduler ? _imp->scheduler->getDroppedFrames() : 0;
+}
+
+double
+RenderEngine::getFrameLatencyPercentile(double percentile) const
+{
+    return _imp->scheduler ? _imp->scheduler->getFrameLatencyPercentile(percentile) : 0.;
+}
+
 void
 RenderEngine::notifyFrameProduced(const BufferableObjectPtrList& frames,
                                   const RenderStatsPtr& stats,
@@ -3415,6 +3751,10 @@ public:
     ViewerArgsPtr args[2];
     bool isRotoNeatRender;
 
+    // The draft rendered and displayed before args when doing progressive refinement
+    ViewerCurrentFrameRequestSchedulerStartArgsPtr coarseRequest;
+    ViewerArgsPtr coarseArgs[2];
+
     CurrentFrameFunctorArgs()
         : GenericThreadStartArgs()
         , view(0)
@@ -3429,6 +3769,8 @@ public:
         , strokeItem()
         , args()
         , isRotoNeatRender(false)
+        , coarseRequest()
+        , coarseArgs()
     {
     }
 
@@ -3455,6 +3797,8 @@ public:
         , strokeItem(strokeItem)
         , args()
         , isRotoNeatRender(isRotoNeatRender)
+        , coarseRequest()
+        , coarseArgs()
     {
         if (isRotoPaintRequest && isRotoNeatRender) {
             isRotoPaintRequest->getRotoContext()->setIsDoingNeatRender(true);
@@ -3539,6 +3883,23 @@ struct ViewerCurrentFrameRequestSchedulerPrivate
         }
     }
 
+    ViewerCurrentFrameRequestSchedulerStartArgsPtr createRequest()
+    {
+        // Identify this render request with an age
+        ViewerCurrentFrameRequestSchedulerStartArgsPtr request = boost::make_shared<ViewerCurrentFrameRequestSchedulerStartArgs>();
+
+        request->age = ageCounter;
+
+        // If we reached the max amount of age, reset to 0... should never happen anyway
+        if ( ageCounter >= std::numeric_limits<U64>::max() ) {
+            ageCounter = 0;
+        } else {
+            ++ageCounter;
+        }
+
+        return request;
+    }
+
     void notifyFrameProduced(const BufferableObjectPtrList& frames,
                              const RenderStatsPtr& stats,
                              U64 age)
@@ -3579,6 +3940,40 @@ public:
                                                                boost_adaptbx::floating_point::exception_trapping::invalid |
                                                                boost_adaptbx::floating_point::exception_trapping::overflow);
 #endif
+        if (_args->coarseRequest) {
+            // Progressive refinement: display the draft first, then skip the full resolution render
+            // if another frame was requested meanwhile, e.g. the user is scrubbing the timeline
+            renderPass(_args->coarseArgs, _args->coarseRequest, RenderStatsPtr());
+
+            bool hasMoreRecentRequest = false;
+            for (int i = 0; i < 2; ++i) {
+                if ( _args->args[i] && _args->args[i]->params && _args->args[i]->params->abortInfo &&
+                     _args->viewer->hasMoreRecentRenderRequest( i, _args->args[i]->params->abortInfo->getRenderAge() ) ) {
+                    hasMoreRecentRequest = true;
+                }
+            }
+            if (hasMoreRecentRequest) {
+                for (int i = 0; i < 2; ++i) {
+                    _args->args[i].reset();
+                }
+            }
+        }
+
+        renderPass(_args->args, _args->request, _args->stats);
+
+        ///This thread is done, clean-up its TLS
+        appPTR->getAppTLS()->cleanupTLSForThread();
+
+
+        _args->scheduler->removeRunnableTask(this);
+    } // run
+
+private:
+
+    void renderPass(ViewerArgsPtr args[2],
+                    const ViewerCurrentFrameRequestSchedulerStartArgsPtr& request,
+                    const RenderStatsPtr& stats)
+    {
         ///The viewer always uses the scheduler thread to regulate the output rate, @see ViewerInstance::renderViewer_internal
         ///it calls appendToBuffer by itself
         ViewerInstance::ViewerRenderRetCode stat = ViewerInstance::eViewerRenderRetCodeFail;
@@ -3587,9 +3982,9 @@ public:
         try {
             if (!_args->isRotoPaintRequest || _args->isRotoNeatRender) {
                 stat = _args->viewer->renderViewer(_args->view, QThread::currentThread() == qApp->thread(), false, _args->viewerHash, _args->canAbort,
-                                                   NodePtr(), true, _args->args, _args->request, _args->stats);
+                                                   NodePtr(), true, args, request, stats);
             } else {
-                stat = _args->viewer->getViewerArgsAndRenderViewer(_args->time, _args->canAbort, _args->view, _args->viewerHash, _args->isRotoPaintRequest, _args->strokeItem.lock(), _args->stats, &_args->args[0], &_args->args[1]);
+                stat = _args->viewer->getViewerArgsAndRenderViewer(_args->time, _args->canAbort, _args->view, _args->viewerHash, _args->isRotoPaintRequest, _args->strokeItem.lock(), stats, &args[0], &args[1]);
             }
         } catch (...) {
             stat = ViewerInstance::eViewerRenderRetCodeFail;
@@ -3602,15 +3997,15 @@ public:
             ret.clear();
         } else {
             for (int i = 0; i < 2; ++i) {
-                if (_args->args[i] && _args->args[i]->params) {
-                    if (_args->args[i]->params->tiles.size() > 0) {
-                        ret.push_back(_args->args[i]->params);
+                if (args[i] && args[i]->params) {
+                    if (args[i]->params->tiles.size() > 0) {
+                        ret.push_back(args[i]->params);
                     }
                 }
             }
         }
 
-        if (_args->request) {
+        if (request) {
 #ifdef DEBUG
             for (BufferableObjectPtrList::iterator it = ret.begin(); it != ret.end(); ++it) {
                 UpdateViewerParams* isParams = dynamic_cast<UpdateViewerParams*>( it->get() );
@@ -3621,18 +4016,12 @@ public:
                 }
             }
 #endif
-            _args->scheduler->notifyFrameProduced(ret, _args->stats, _args->request->age);
+            _args->scheduler->notifyFrameProduced(ret, stats, request->age);
         } else {
             assert( QThread::currentThread() == qApp->thread() );
-            _args->scheduler->processProducedFrame(_args->stats, ret);
+            _args->scheduler->processProducedFrame(stats, ret);
         }
-
-        ///This thread is done, clean-up its TLS
-        appPTR->getAppTLS()->cleanupTLSForThread();
-
-
-        _args->scheduler->removeRunnableTask(this);
-    } // run
+    } // renderPass
 };
 
 
@@ -3886,11 +4275,32 @@ ViewerCurrentFrameRequestScheduler::renderCurrentFrame(bool enableRenderStats,
         rotoUse1Thread = true;
     }
 
+    // Progressive refinement: when the frame is not cached, first render and display a draft at the auto-proxy level,
+    // then the full resolution. Not needed when scrubbing with auto-proxy enabled: renders are already at the auto-proxy level.
+    const bool progressiveRefinement = canAbort && !rotoPaintNode && !isTracking &&
+                                       ( appPTR->getCurrentSettings()->getNumberOfThreads() != -1 ) &&
+                                       appPTR->getCurrentSettings()->isProgressiveViewerRefinementEnabled() &&
+                                       ( !_imp->viewer->getApp()->isDraftRenderEnabled() || !appPTR->getCurrentSettings()->isAutoProxyEnabled() );
+    ViewerArgsPtr coarseArgs[2];
+    bool hasCoarsePass = false;
+
     ViewerArgsPtr args[2];
     if (!rotoPaintNode || isRotoNeatRender) {
         bool clearTexture[2] = {false, false};
 
         for (int i = 0; i < 2; ++i) {
+            if (progressiveRefinement) {
+                // Request it before the full resolution render so that it is the older of the two
+                coarseArgs[i] = boost::make_shared<ViewerArgs>();
+                coarseArgs[i]->isProgressiveCoarsePass = true;
+                ViewerInstance::ViewerRenderRetCode coarseStatus = _imp->viewer->getRenderViewerArgsAndCheckCache_public( frame, false, view, i, viewerHash, canAbort, rotoPaintNode, RenderStatsPtr(), coarseArgs[i].get() );
+                if ( (coarseStatus != ViewerInstance::eViewerRenderRetCodeRender) || !coarseArgs[i]->params ||
+                     ( coarseArgs[i]->mipMapLevelWithDraft == coarseArgs[i]->mipmapLevelWithoutDraft ) ) {
+                    // No coarser level than the full resolution render
+                    coarseArgs[i].reset();
+                }
+            }
+
             args[i] = boost::make_shared<ViewerArgs>();
             status[i] = _imp->viewer->getRenderViewerArgsAndCheckCache_public( frame, false, view, i, viewerHash, canAbort, rotoPaintNode, stats, args[i].get() );
 
@@ -3948,6 +4358,23 @@ ViewerCurrentFrameRequestScheduler::renderCurrentFrame(bool enableRenderStats,
                 args[i].reset();
             }
         }
+
+        for (int i = 0; i < 2; ++i) {
+            if (!coarseArgs[i]) {
+                continue;
+            }
+            if ( !args[i] || !args[i]->params || (status[i] != ViewerInstance::eViewerRenderRetCodeRender) ) {
+                // The full resolution texture is cached or there is nothing to render
+                coarseArgs[i].reset();
+            } else if ( ( coarseArgs[i]->params->nbCachedTile > 0 ) && ( coarseArgs[i]->params->nbCachedTile == (int)coarseArgs[i]->params->tiles.size() ) ) {
+                // The draft is cached, display it right away
+                _imp->viewer->aboutToUpdateTextures();
+                _imp->viewer->updateViewer(coarseArgs[i]->params);
+                coarseArgs[i].reset();
+            } else {
+                hasCoarsePass = true;
+            }
+        }
         if ( (!args[0] && !args[1]) ||
              ( !args[0] && ( status[0] == ViewerInstance::eViewerRenderRetCodeRender) && args[1] && ( status[1] == ViewerInstance::eViewerRenderRetCodeFail) ) ||
              ( !args[1] && ( status[1] == ViewerInstance::eViewerRenderRetCodeRender) && args[0] && ( status[0] == ViewerInstance::eViewerRenderRetCodeFail) ) ) {
@@ -3981,22 +4408,23 @@ ViewerCurrentFrameRequestScheduler::renderCurrentFrame(bool enableRenderStats,
 #endif
     functorArgs->args[0] = args[0];
     functorArgs->args[1] = args[1];
+    if (hasCoarsePass) {
+        functorArgs->coarseArgs[0] = coarseArgs[0];
+        functorArgs->coarseArgs[1] = coarseArgs[1];
+    }
 
     if (appPTR->getCurrentSettings()->getNumberOfThreads() == -1) {
         RenderCurrentFrameFunctorRunnable task(functorArgs);
         task.run();
     } else {
-        // Identify this render request with an age
-        ViewerCurrentFrameRequestSchedulerStartArgsPtr request = boost::make_shared<ViewerCurrentFrameRequestSchedulerStartArgs>();
-        request->age = _imp->ageCounter;
-
-        // If we reached the max amount of age, reset to 0... should never happen anyway
-        if ( _imp->ageCounter >= std::numeric_limits<U64>::max() ) {
-            _imp->ageCounter = 0;
-        } else {
-            ++_imp->ageCounter;
+        // The draft is produced first, the scheduler thread processes requests in order
+        if (hasCoarsePass) {
+            ViewerCurrentFrameRequestSchedulerStartArgsPtr coarseRequest = _imp->createRequest();
+            startTask(coarseRequest);
+            functorArgs->coarseRequest = coarseRequest;
         }
 
+        ViewerCurrentFrameRequestSchedulerStartArgsPtr request = _imp->createRequest();
         startTask(request);
         functorArgs->request = request;
 
@@ -4014,7 +4442,8 @@ ViewerCurrentFrameRequestScheduler::renderCurrentFrame(bool enableRenderStats,
         } else {
             RenderCurrentFrameFunctorRunnable* task = new RenderCurrentFrameFunctorRunnable(functorArgs);
             _imp->appendRunnableTask(task);
-            _imp->threadPool->start(task);
+            // Go ahead of the tasks queued by renders of lower priority
+            _imp->threadPool->start(task, (int)eRenderPriorityInteractive);
         }
     }
 } // ViewerCurrentFrameRequestScheduler::renderCurrentFrame
@@ -4041,6 +4470,360 @@ ViewerCurrentFrameRequestRendererBackup::threadLoopOnce(const GenericThreadStart
     return eThreadStateActive;
 }
 
+////////////////////////// ReadAheadThread
+
+struct ReadAheadThreadPrivate
+{
+    /**
+     * @brief A frame that a Read node produces for the render of a frame of the output
+     **/
+    struct ReaderFrame
+    {
+        NodePtr reader;
+        double time;
+        ViewIdx view;
+
+        // The region the render asks to the Read node, in canonical coordinates, and the level it renders it at
+        RectD roi;
+        unsigned int mipMapLevel;
+    };
+
+    OutputEffectInstanceWPtr output;
+
+    // Protects currentAbortInfo and decodedFrames
+    QMutex lock;
+
+    // The abort info of the frame being decoded, so that an abort request interrupts the decoding right away
+    AbortableRenderInfoPtr currentAbortInfo;
+
+    // Frames already decoded since the render started
+    std::set<int> decodedFrames;
+
+    ReadAheadThreadPrivate(const OutputEffectInstancePtr& output)
+        : output(output)
+        , lock()
+        , currentAbortInfo()
+        , decodedFrames()
+    {
+    }
+
+    /**
+     * @brief Returns a new abort info for the decoding of a frame of the output, cancelled along with the sequential render
+     **/
+    AbortableRenderInfoPtr createAbortInfo();
+
+    void clearAbortInfo();
+
+    /**
+     * @brief Runs the request pass of the output at the given time/view and appends to readerFrames the frames
+     * that the Read nodes upstream produce for it, at the time, region and mipmap level the render will ask them.
+     * @returns false if the request pass failed
+     **/
+    bool getReaderFramesNeeded(int time,
+                               ViewIdx view,
+                               unsigned int mipMapLevel,
+                               const AbortableRenderInfoPtr& abortInfo,
+                               std::list<ReaderFrame>* readerFrames);
+
+    /**
+     * @brief Renders the given frame of a Read node so that the resulting image lands in the cache
+     * @returns false if the decoding failed or was aborted
+     **/
+    bool decodeFrame(const ReaderFrame& frame, const AbortableRenderInfoPtr& abortInfo);
+};
+
+AbortableRenderInfoPtr
+ReadAheadThreadPrivate::createAbortInfo()
+{
+    AbortableRenderInfoPtr abortInfo = AbortableRenderInfo::create(true, 0);
+
+    abortInfo->setPriority(eRenderPriorityBackground);
+    {
+        // Decoding ahead is part of the sequential render, cancel it along with it
+        OutputEffectInstancePtr outputEffect = output.lock();
+        RenderEnginePtr engine = outputEffect ? outputEffect->getRenderEngine() : RenderEnginePtr();
+        AbortableRenderInfoPtr sequenceAbortInfo = engine ? engine->getSequentialRenderAbortInfo() : AbortableRenderInfoPtr();
+        if (sequenceAbortInfo) {
+            abortInfo->setParentRender(sequenceAbortInfo);
+        }
+    }
+    QMutexLocker k(&lock);
+    currentAbortInfo = abortInfo;
+
+    return abortInfo;
+}
+
+void
+ReadAheadThreadPrivate::clearAbortInfo()
+{
+    QMutexLocker k(&lock);
+
+    currentAbortInfo.reset();
+}
+
+bool
+ReadAheadThreadPrivate::getReaderFramesNeeded(int time,
+                                              ViewIdx view,
+                                              unsigned int mipMapLevel,
+                                              const AbortableRenderInfoPtr& abortInfo,
+                                              std::list<ReaderFrame>* readerFrames)
+{
+    OutputEffectInstancePtr outputEffect = output.lock();
+
+    if (!outputEffect) {
+        return false;
+    }
+    NodePtr treeRoot = outputEffect->getNode();
+
+    AbortableThread* isAbortableThread = dynamic_cast<AbortableThread*>( QThread::currentThread() );
+    if (isAbortableThread) {
+        isAbortableThread->setAbortInfo(false, abortInfo, outputEffect);
+    }
+
+    FrameRequestMap request;
+    StatusEnum stat = eStatusFailed;
+    {
+        ///Same tree root and arguments as the render of the frame itself, so that the request pass is the one the render will make
+        ParallelRenderArgsSetter frameRenderArgs(time,
+                                                 view,
+                                                 false, // isRenderUserInteraction
+                                                 true, // isSequential
+                                                 abortInfo,
+                                                 treeRoot,
+                                                 0, // texture index
+                                                 outputEffect->getApp()->getTimeLine().get(),
+                                                 NodePtr(),
+                                                 false, // isAnalysis
+                                                 false, // draftMode
+                                                 RenderStatsPtr() );
+
+        RenderScale scale( Image::getScaleFromMipMapLevel(mipMapLevel) );
+        RectD rod;
+        bool isProjectFormat;
+        stat = outputEffect->getRegionOfDefinition_public(outputEffect->getHash(), time, scale, view, &rod, &isProjectFormat);
+        if ( (stat != eStatusFailed) && !rod.isNull() ) {
+            ///The viewer only renders the part of the image that is visible
+            RectD roi = rod;
+            ViewerInstance* isViewer = dynamic_cast<ViewerInstance*>( outputEffect.get() );
+            OpenGLViewerI* uiContext = isViewer ? isViewer->getUiContext() : 0;
+            if (uiContext) {
+                double par = outputEffect->getAspectRatio(-1);
+                RectI visibleWindow = uiContext->getExactImageRectangleDisplayed(0, rod, par, mipMapLevel);
+                visibleWindow.toCanonical(mipMapLevel, par, rod, &roi);
+            }
+            if ( roi.intersect(rod, &roi) ) {
+                stat = EffectInstance::computeRequestPass(time, view, mipMapLevel, roi, treeRoot, request);
+            }
+        }
+    }
+
+    if (isAbortableThread) {
+        isAbortableThread->clearAbortInfo();
+    }
+    if (stat == eStatusFailed) {
+        return false;
+    }
+
+    for (FrameRequestMap::const_iterator it = request.begin(); it != request.end(); ++it) {
+        EffectInstancePtr effect = it->first->getEffectInstance();
+        if ( !effect || !effect->isReader() || it->first->isNodeDisabled() ) {
+            continue;
+        }
+        ///The Read node renders at scale 1 if it does not support render scale
+        unsigned int readerMipMapLevel = Image::getLevelFromScale(it->second->mappedScale.x);
+        for (NodeFrameViewRequestData::const_iterator itFrame = it->second->frames.begin(); itFrame != it->second->frames.end(); ++itFrame) {
+            const FrameViewRequest& frameRequest = itFrame->second;
+            RectD readerRoI;
+            if ( frameRequest.globalData.isIdentity ||
+                 !frameRequest.finalData.finalRoi.intersect(frameRequest.globalData.rod, &readerRoI) ) {
+                continue;
+            }
+            ReaderFrame frame;
+            frame.reader = it->first;
+            frame.time = itFrame->first.time;
+            frame.view = itFrame->first.view;
+            frame.roi = readerRoI;
+            frame.mipMapLevel = readerMipMapLevel;
+            readerFrames->push_back(frame);
+        }
+    }
+
+    return true;
+} // ReadAheadThreadPrivate::getReaderFramesNeeded
+
+bool
+ReadAheadThreadPrivate::decodeFrame(const ReaderFrame& frame,
+                                    const AbortableRenderInfoPtr& abortInfo)
+{
+    EffectInstancePtr effect = frame.reader->getEffectInstance();
+    OutputEffectInstancePtr outputEffect = output.lock();
+
+    if (!effect || !outputEffect) {
+        return false;
+    }
+
+    std::list<ImagePlaneDesc> components;
+    {
+        ImagePlaneDesc plane, pairedPlane;
+        effect->getMetadataComponents(-1, &plane, &pairedPlane);
+        if (plane.getNumComponents() > 0) {
+            components.push_back(plane);
+        }
+    }
+    if ( components.empty() ) {
+        return false;
+    }
+    ImageBitDepthEnum imageDepth = effect->getBitDepth(-1);
+    RenderScale scale( Image::getScaleFromMipMapLevel(frame.mipMapLevel) );
+    RectI renderWindow;
+    frame.roi.toPixelEnclosing(scale, effect->getAspectRatio(-1), &renderWindow);
+
+    AbortableThread* isAbortableThread = dynamic_cast<AbortableThread*>( QThread::currentThread() );
+    if (isAbortableThread) {
+        isAbortableThread->setAbortInfo(false, abortInfo, effect);
+    }
+
+    EffectInstance::RenderRoIRetCode retCode = EffectInstance::eRenderRoIRetCodeFailed;
+    {
+        ///The reader is the root of the render: since it is flagged as an analysis the image it produces is always cached
+        ParallelRenderArgsSetter frameRenderArgs(frame.time,
+                                                 frame.view,
+                                                 false, // isRenderUserInteraction
+                                                 true, // isSequential
+                                                 abortInfo,
+                                                 frame.reader, // treeRoot
+                                                 0, // texture index
+                                                 outputEffect->getApp()->getTimeLine().get(),
+                                                 NodePtr(),
+                                                 true, // isAnalysis
+                                                 false, // draftMode
+                                                 RenderStatsPtr() );
+        RectD rod;
+        bool isProjectFormat;
+        StatusEnum stat = effect->getRegionOfDefinition_public(effect->getHash(), frame.time, scale, frame.view, &rod, &isProjectFormat);
+        if (stat != eStatusFailed) {
+            FrameRequestMap request;
+            stat = EffectInstance::computeRequestPass(frame.time, frame.view, frame.mipMapLevel, frame.roi, frame.reader, request);
+            frameRenderArgs.updateNodesRequest(request);
+        }
+
+        if (stat != eStatusFailed) {
+            RenderingFlagSetter flagIsRendering(frame.reader);
+            std::map<ImagePlaneDesc, ImagePtr> planes;
+            boost::scoped_ptr<EffectInstance::RenderRoIArgs> renderArgs( new EffectInstance::RenderRoIArgs(frame.time,
+                                                                                                           scale,
+                                                                                                           frame.mipMapLevel,
+                                                                                                           frame.view,
+                                                                                                           false, // byPassCache
+                                                                                                           renderWindow,
+                                                                                                           rod,
+                                                                                                           components,
+                                                                                                           imageDepth,
+                                                                                                           false, // calledFromGetImage
+                                                                                                           effect.get(),
+                                                                                                           eStorageModeRAM,
+                                                                                                           frame.time) );
+            retCode = effect->renderRoI(*renderArgs, &planes);
+        }
+    }
+
+    if (isAbortableThread) {
+        isAbortableThread->clearAbortInfo();
+    }
+
+    return retCode == EffectInstance::eRenderRoIRetCodeOk;
+} // ReadAheadThreadPrivate::decodeFrame
+
+ReadAheadThread::ReadAheadThread(const OutputEffectInstancePtr& output)
+    : GenericSchedulerThread()
+    , _imp( new ReadAheadThreadPrivate(output) )
+{
+    setThreadName("ReadAheadThread");
+}
+
+ReadAheadThread::~ReadAheadThread()
+{
+}
+
+void
+ReadAheadThread::onAbortRequested(bool /*keepOldestRender*/)
+{
+    QMutexLocker k(&_imp->lock);
+
+    if (_imp->currentAbortInfo) {
+        _imp->currentAbortInfo->setAborted();
+    }
+    ///The next render may be at a different location or with a different graph
+    _imp->decodedFrames.clear();
+}
+
+GenericSchedulerThread::ThreadStateEnum
+ReadAheadThread::threadLoopOnce(const GenericThreadStartArgsPtr& inArgs)
+{
+    ReadAheadStartArgsPtr args = boost::dynamic_pointer_cast<ReadAheadStartArgs>(inArgs);
+
+    assert(args);
+
+    OutputEffectInstancePtr output = _imp->output.lock();
+    if (!output) {
+        return eThreadStateActive;
+    }
+
+    ///Never compete with the render threads, decoding ahead only uses idle CPU time
+    if ( priority() != QThread::LowestPriority ) {
+        setPriority(QThread::LowestPriority);
+    }
+
+    ThreadStateEnum state = eThreadStateActive;
+    for (std::vector<int>::const_iterator it = args->frames.begin(); it != args->frames.end(); ++it) {
+        {
+            QMutexLocker k(&_imp->lock);
+            if ( _imp->decodedFrames.find(*it) != _imp->decodedFrames.end() ) {
+                continue;
+            }
+        }
+
+        bool allDecoded = true;
+        for (std::vector<ViewIdx>::const_iterator itView = args->views.begin(); itView != args->views.end(); ++itView) {
+            state = resolveState();
+            if ( (state == eThreadStateAborted) || (state == eThreadStateStopped) ) {
+                appPTR->getAppTLS()->cleanupTLSForThread();
+
+                return state;
+            }
+
+            ///The Read nodes may be asked other frames or a region at another scale than the frame of the output (retimes, transforms...)
+            AbortableRenderInfoPtr abortInfo = _imp->createAbortInfo();
+            std::list<ReadAheadThreadPrivate::ReaderFrame> readerFrames;
+            if ( !_imp->getReaderFramesNeeded(*it, *itView, args->mipMapLevel, abortInfo, &readerFrames) ) {
+                allDecoded = false;
+            }
+            for (std::list<ReadAheadThreadPrivate::ReaderFrame>::const_iterator itReader = readerFrames.begin(); itReader != readerFrames.end(); ++itReader) {
+                state = resolveState();
+                if ( (state == eThreadStateAborted) || (state == eThreadStateStopped) ) {
+                    _imp->clearAbortInfo();
+                    appPTR->getAppTLS()->cleanupTLSForThread();
+
+                    return state;
+                }
+                if ( !_imp->decodeFrame(*itReader, abortInfo) ) {
+                    allDecoded = false;
+                }
+            }
+            _imp->clearAbortInfo();
+        }
+
+        if (allDecoded) {
+            QMutexLocker k(&_imp->lock);
+            _imp->decodedFrames.insert(*it);
+        }
+    }
+
+    appPTR->getAppTLS()->cleanupTLSForThread();
+
+    return state;
+} // ReadAheadThread::threadLoopOnce
+
 NATRON_NAMESPACE_EXIT
 
 NATRON_NAMESPACE_USING
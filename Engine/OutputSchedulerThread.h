@@ -286,6 +286,12 @@ public:
 
     void getLastRunArgs(RenderDirectionEnum* direction, std::vector<ViewIdx>* viewsToRender) const;
 
+    /**
+     * @brief Returns the cancellation token of the ongoing sequential render. All frame renders issued by this scheduler
+     * use it as parent render so that they are all aborted at once when the sequential render is aborted.
+     **/
+    AbortableRenderInfoPtr getSequentialRenderAbortInfo() const;
+
     /**
      * @brief Returns the current number of render threads
      **/
@@ -319,6 +325,21 @@ public:
      **/
     double getDesiredFPS() const;
 
+    /**
+     * @brief Returns the frame-rate achieved by the last playback
+     **/
+    double getActualFPS() const;
+
+    /**
+     * @brief Returns the number of frames dropped since the playback started
+     **/
+    int getDroppedFrames() const;
+
+    /**
+     * @brief Returns the latency in seconds of the recently displayed frames at the given percentile (in [0, 100])
+     **/
+    double getFrameLatencyPercentile(double percentile) const;
+
     void runCallbackWithVariables(const QString& callback);
 
 private Q_SLOTS:
@@ -407,6 +428,12 @@ protected:
      **/
     virtual void onRenderStopped(bool /*aborted*/) {}
 
+    /**
+     * @brief Returns the mipmap level at which the Read nodes upstream should decode frames ahead of the render.
+     * Writers always render at scale 1.
+     **/
+    virtual unsigned int getReadAheadMipMapLevel() const { return 0; }
+
     RenderEngine* getEngine() const;
 
 private:
@@ -429,6 +456,12 @@ private:
 
     void startRender();
 
+    /**
+     * @brief Wait until the number of frames to pre-buffer set in the preferences are rendered
+     * before displaying the first frame of a playback.
+     **/
+    void waitForPreBufferedFrames(const OutputSchedulerThreadStartArgsPtr& args);
+
     void stopRender();
 
 
@@ -447,6 +480,12 @@ private:
 
     void pushFramesToRenderInternal(int startingFrame, int nThreads);
 
+    /**
+     * @brief Asks the read-ahead thread to decode the frames that will be rendered once the nThreads render threads
+     * are done with the frames they are currently processing.
+     **/
+    void pushFramesToReadAhead(int nThreads);
+
     void pushAllFrameRange();
 
     /**
@@ -539,6 +578,7 @@ private:
 
     virtual int getLastRenderedTime() const OVERRIDE FINAL WARN_UNUSED_RETURN;
     virtual void onRenderStopped(bool aborted) OVERRIDE FINAL;
+    virtual unsigned int getReadAheadMipMapLevel() const OVERRIDE FINAL WARN_UNUSED_RETURN;
     ViewerInstanceWPtr _viewer;
 };
 
@@ -622,6 +662,38 @@ private:
     virtual ThreadStateEnum threadLoopOnce(const GenericThreadStartArgsPtr& inArgs) OVERRIDE FINAL WARN_UNUSED_RETURN;
 };
 
+/**
+ * @brief Low priority thread used by the OutputSchedulerThread during playback and frame range renders to decode the frames
+ * of the Read nodes upstream of the output ahead of the frames being rendered, so that they are already in the cache
+ * when the render threads need them.
+ **/
+struct ReadAheadThreadPrivate;
+class ReadAheadThread
+    : public GenericSchedulerThread
+{
+public:
+
+    ReadAheadThread(const OutputEffectInstancePtr& output);
+
+    virtual ~ReadAheadThread();
+
+private:
+
+    /**
+     * @brief Only the most recent window of frames is relevant, older requests are obsolete
+     **/
+    virtual TaskQueueBehaviorEnum tasksQueueBehaviour() const OVERRIDE FINAL
+    {
+        return eTaskQueueBehaviorSkipToMostRecent;
+    }
+
+    virtual void onAbortRequested(bool keepOldestRender) OVERRIDE FINAL;
+
+    virtual ThreadStateEnum threadLoopOnce(const GenericThreadStartArgsPtr& inArgs) OVERRIDE FINAL WARN_UNUSED_RETURN;
+
+    boost::scoped_ptr<ReadAheadThreadPrivate> _imp;
+};
+
 
 /**
  * @brief This class manages multiple OutputThreadScheduler so that each render request gets processed as soon as possible.
@@ -692,6 +764,14 @@ public:
      **/
     double getDesiredFPS() const;
 
+    /**
+     * @brief Returns the playback statistics of the internal scheduler
+     * @see OutputSchedulerThread::getActualFPS, getDroppedFrames, getFrameLatencyPercentile
+     **/
+    double getActualFPS() const;
+    int getDroppedFrames() const;
+    double getFrameLatencyPercentile(double percentile) const;
+
     /**
      * @brief Quit all processing, making sure all threads are finished, this is not blocking
      **/
@@ -764,6 +844,18 @@ public:
      **/
     bool isDoingSequentialRender() const;
 
+    /**
+     * @brief Returns the cancellation token of the ongoing sequential render, or NULL if none was started yet.
+     **/
+    AbortableRenderInfoPtr getSequentialRenderAbortInfo() const;
+
+    /**
+     * @brief Returns the cancellation token that current frame renders of this engine use as parent render.
+     * It is aborted when a sequential render starts, since there is no point refreshing the current frame during playback,
+     * and renewed when the sequential render stops.
+     **/
+    AbortableRenderInfoPtr getCurrentFrameRendersAbortInfo() const;
+
 public Q_SLOTS:
 
     void abortRendering_non_blocking()
@@ -797,6 +889,12 @@ Q_SIGNALS:
      **/
     void fpsChanged(double actualFps, double desiredFps);
 
+    /**
+     * @brief Emitted along with fpsChanged with the number of frames dropped since the playback started
+     * and the median and 95th percentile of the latency (in seconds) of the recently displayed frames.
+     **/
+    void playbackStatsChanged(int droppedFrames, double latencyMedian, double latency95);
+
     /**
      * @brief Emitted after a frame is rendered.
      * This will not be emitted after calling renderCurrentFrame
@@ -851,6 +949,12 @@ private:
 
     void s_renderStarted(bool forward) { Q_EMIT renderStarted(forward); }
 
+    /**
+     * @brief Called by the scheduler when a sequential render starts/stops to abort/renew the current frame renders token.
+     **/
+    void abortCurrentFrameRenders();
+    void renewCurrentFrameRendersAbortInfo();
+
     void s_renderFinished(int retCode) { Q_EMIT renderFinished(retCode); }
 
     void s_refreshAllKnobs() { Q_EMIT refreshAllKnobs(); }
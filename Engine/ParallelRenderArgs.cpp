@@ -24,26 +24,207 @@
 
 #include "ParallelRenderArgs.h"
 
+#include <algorithm> // min, max
 #include <cassert>
+#include <list>
+#include <set>
 #include <stdexcept>
+#include <vector>
 
 #include <boost/scoped_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtConcurrentRun> // QtCore on Qt4, QtConcurrent on Qt5
 
 #include "Engine/AbortableRenderInfo.h"
+#include "Engine/AppInstance.h"
 #include "Engine/AppManager.h"
 #include "Engine/Settings.h"
 #include "Engine/EffectInstance.h"
+#include "Engine/EffectInstancePrivate.h"
 #include "Engine/Image.h"
+#include "Engine/Knob.h"
 #include "Engine/Node.h"
 #include "Engine/NodeGroup.h"
 #include "Engine/GPUContextPool.h"
 #include "Engine/OSGLContext.h"
 #include "Engine/RotoContext.h"
 #include "Engine/RotoDrawableItem.h"
+#include "Engine/TLSHolder.h"
 #include "Engine/ViewIdx.h"
 
 NATRON_NAMESPACE_ENTER
 
+NATRON_NAMESPACE_ANONYMOUS_ENTER
+
+// An input branch to pre-render in EffectInstance::treeRecurseFunctor
+struct PreRenderInputBranch
+{
+    EffectInstancePtr inputEffect;
+    const FrameRangesMap* frames;
+    RectD roi;
+
+    // Set if the roi must be retrieved from the request pass
+    ParallelRenderArgsPtr frameArgs;
+    const std::list<ImagePlaneDesc>* compsNeeded;
+    ImageList* inputImagesList;
+    EffectInstance::NotifyInputNRenderingStarted_RAIIPtr inputNIsRendering_RAII;
+};
+
+// Arguments shared by all input branches
+struct PreRenderInputArgs
+{
+    EffectInstancePtr effect;
+    double time;
+    unsigned int originalMipMapLevel;
+    StorageModeEnum renderStorageMode;
+    bool useScaleOneInputs;
+    bool byPassCache;
+};
+
+NATRON_NAMESPACE_ANONYMOUS_EXIT
+
+static EffectInstance::RenderRoIRetCode
+preRenderInputBranch(const PreRenderInputBranch& branch,
+                     const PreRenderInputArgs& args)
+{
+    if ( !branch.compsNeeded || branch.compsNeeded->empty() ) {
+        return EffectInstance::eRenderRoIRetCodeOk;
+    }
+
+    const double inputPar = branch.inputEffect->getAspectRatio(-1);
+    RectD roi = branch.roi;
+
+    ///For all views requested in input
+    for (FrameRangesMap::const_iterator viewIt = branch.frames->begin(); viewIt != branch.frames->end(); ++viewIt) {
+        ///For all frames in this view
+        for (U32 range = 0; range < viewIt->second.size(); ++range) {
+            int nbFramesPreFetched = 0;
+
+            // if the range bounds are not ints, the fetched images will probably anywhere within this range - no need to pre-render
+            if ( (viewIt->second[range].min != (int)viewIt->second[range].min) ||
+                 ( viewIt->second[range].max != (int)viewIt->second[range].max) ) {
+                continue;
+            }
+            for (double f = viewIt->second[range].min;
+                 f <= viewIt->second[range].max  && nbFramesPreFetched < NATRON_MAX_FRAMES_NEEDED_PRE_FETCHING;
+                 f += 1.) {
+                RenderScale scaleOne(1.);
+                RenderScale scale( Image::getScaleFromMipMapLevel(args.originalMipMapLevel) );
+
+                ///Render the input image with the bit depth of its preference
+                ImageBitDepthEnum inputPrefDepth = branch.inputEffect->getBitDepth(-1);
+
+                if (branch.frameArgs) {
+                    branch.frameArgs->request->getFrameViewCanonicalRoI(f, viewIt->first, &roi);
+                }
+
+                RectI inputRoIPixelCoords;
+                const unsigned int upstreamMipMapLevel = args.useScaleOneInputs ? 0 : args.originalMipMapLevel;
+                const RenderScale & upstreamScale = args.useScaleOneInputs ? scaleOne : scale;
+                roi.toPixelEnclosing(upstreamMipMapLevel, inputPar, &inputRoIPixelCoords);
+
+                std::map<ImagePlaneDesc, ImagePtr> inputImgs;
+                {
+                    boost::scoped_ptr<EffectInstance::RenderRoIArgs> renderArgs;
+                    renderArgs.reset( new EffectInstance::RenderRoIArgs( f, //< time
+                                                                         upstreamScale, //< scale
+                                                                         upstreamMipMapLevel, //< mipmapLevel (redundant with the scale)
+                                                                         viewIt->first, //< view
+                                                                         args.byPassCache,
+                                                                         inputRoIPixelCoords, //< roi in pixel coordinates
+                                                                         RectD(), // < did we precompute any RoD to speed-up the call ?
+                                                                         *branch.compsNeeded, //< requested comps
+                                                                         inputPrefDepth,
+                                                                         false,
+                                                                         args.effect.get(),
+                                                                         args.renderStorageMode /*returnStorage*/,
+                                                                         args.time /*callerRenderTime*/) );
+
+                    EffectInstance::RenderRoIRetCode ret;
+                    ret = branch.inputEffect->renderRoI(*renderArgs, &inputImgs); //< requested bitdepth
+                    if (ret != EffectInstance::eRenderRoIRetCodeOk) {
+                        return ret;
+                    }
+                }
+                for (std::map<ImagePlaneDesc, ImagePtr>::iterator it3 = inputImgs.begin(); it3 != inputImgs.end(); ++it3) {
+                    if (branch.inputImagesList && it3->second) {
+                        branch.inputImagesList->push_back(it3->second);
+                    }
+                }
+
+                if ( args.effect->aborted() ) {
+                    return EffectInstance::eRenderRoIRetCodeAborted;
+                }
+
+                if ( !inputImgs.empty() ) {
+                    ++nbFramesPreFetched;
+                }
+            } // for all frames
+        } // for all ranges
+    } // for all views
+
+    return EffectInstance::eRenderRoIRetCodeOk;
+} // preRenderInputBranch
+
+static EffectInstance::RenderRoIRetCode
+preRenderInputBranchInThread(const PreRenderInputBranch* branch,
+                             const PreRenderInputArgs* args,
+                             QThread* callingThread)
+{
+    QThread* curThread = QThread::currentThread();
+
+    // The branch may be run by the calling thread if it waits for it before a thread of the pool picked it up
+    const bool isSpawnedThread = callingThread != curThread;
+
+    if (isSpawnedThread) {
+        ///The render of the branch needs the TLS of the caller thread
+        appPTR->getAppTLS()->copyTLS(callingThread, curThread);
+    }
+
+    EffectInstance::RenderRoIRetCode ret;
+    try {
+        ret = preRenderInputBranch(*branch, *args);
+    } catch (const std::exception& e) {
+        // The exception cannot reach the caller from this thread: report it on the input like a failed action
+        // and fail the render of the caller with the status, as a branch rendered on the calling thread would.
+        if ( !branch->inputEffect->hasPersistentMessage() ) { // plugin may already have set a message
+            branch->inputEffect->setPersistentMessage( eMessageTypeError, e.what() );
+        }
+        ret = EffectInstance::eRenderRoIRetCodeFailed;
+    }
+
+    if (isSpawnedThread) {
+        appPTR->getAppTLS()->cleanupTLSForThread();
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Returns how many input branches may be pre-rendered concurrently by threads of the global thread pool,
+ * given the number of threads settings and the threads of the pool that are currently idle.
+ **/
+static int
+getNumberOfThreadsForConcurrentInputs(StorageModeEnum renderStorageMode,
+                                      int nBranches)
+{
+    if ( (nBranches <= 0) || (renderStorageMode == eStorageModeGLTex) ) {
+        // OpenGL renders must remain on the thread that has the OpenGL context attached
+        return 0;
+    }
+    int nbThreads = appPTR->getCurrentSettings()->getNumberOfThreads();
+    if ( (nbThreads == -1) || (nbThreads == 1) || ( (nbThreads == 0) && (appPTR->getHardwareIdealThreadCount() == 1) ) ) {
+        return 0;
+    }
+    QThreadPool* tp = QThreadPool::globalInstance();
+    int nThreadsAvailable = tp->maxThreadCount() - tp->activeThreadCount();
+
+    return std::max( 0, std::min(nThreadsAvailable, nBranches) );
+}
+
 EffectInstance::RenderRoIRetCode
 EffectInstance::treeRecurseFunctor(bool isRenderFunctor,
                                    const NodePtr& node,
@@ -131,6 +312,9 @@ EffectInstance::treeRecurseFunctor(bool isRenderFunctor,
         }
     }
 
+    // Input branches to pre-render in the render functor
+    std::list<PreRenderInputBranch> branchesToRender;
+
     for (PreRenderFrames::const_iterator it = framesToRender.begin(); it != framesToRender.end(); ++it) {
         const EffectInstancePtr& inputEffect = it->first;
         NodePtr inputNode = inputEffect->getNode();
@@ -196,111 +380,100 @@ EffectInstance::treeRecurseFunctor(bool isRenderFunctor,
             }
         }
 
+        if (isRenderFunctor) {
+            ///The input branch is pre-rendered below, possibly concurrently with the other input branches
+            assert(it->second.first != -1); //< see getInputNumber
+            PreRenderInputBranch branch;
+            branch.inputEffect = inputEffect;
+            branch.frames = &it->second.second;
+            branch.roi = roi;
+            branch.frameArgs = roiIsInRequestPass ? frameArgs : ParallelRenderArgsPtr();
+            branch.compsNeeded = compsNeeded;
+            branch.inputImagesList = inputImagesList;
+            branch.inputNIsRendering_RAII.reset( new EffectInstance::NotifyInputNRenderingStarted_RAII(node.get(), inputNb) );
+            branchesToRender.push_back(branch);
+            continue;
+        }
 
-        const double inputPar = inputEffect->getAspectRatio(-1);
+        ///For all views requested in input
+        for (FrameRangesMap::const_iterator viewIt = it->second.second.begin(); viewIt != it->second.second.end(); ++viewIt) {
+            ///For all frames in this view
+            for (U32 range = 0; range < viewIt->second.size(); ++range) {
+                // if the range bounds are not ints, the fetched images will probably anywhere within this range - no need to pre-render
+                if ( (viewIt->second[range].min == (int)viewIt->second[range].min) &&
+                     ( viewIt->second[range].max == (int)viewIt->second[range].max) ) {
+                    for (double f = viewIt->second[range].min;
+                         f <= viewIt->second[range].max;
+                         f += 1.) {
+                        StatusEnum stat = EffectInstance::getInputsRoIsFunctor(useTransforms,
+                                                                               f,
+                                                                               viewIt->first,
+                                                                               originalMipMapLevel,
+                                                                               inputNode,
+                                                                               node,
+                                                                               treeRoot,
+                                                                               roi,
+                                                                               *requests);
+
+                        if (stat == eStatusFailed) {
+                            return EffectInstance::eRenderRoIRetCodeFailed;
+                        }
+
+                        ///Do not count frames pre-fetched in RoI functor mode, it is harmless and may
+                        ///limit calculations that will be done later on anyway.
+                    } // for all frames
+                }
+            } // for all ranges
+        } // for all views
+    } // for all inputs
 
+    if ( branchesToRender.empty() ) {
+        return EffectInstance::eRenderRoIRetCodeOk;
+    }
 
-        {
-            ///Notify the node that we're going to render something with the input
-            EffectInstance::NotifyInputNRenderingStarted_RAIIPtr inputNIsRendering_RAII;
-            if (isRenderFunctor) {
-                assert(it->second.first != -1); //< see getInputNumber
-                inputNIsRendering_RAII.reset( new EffectInstance::NotifyInputNRenderingStarted_RAII(node.get(), inputNb) );
-            }
+    PreRenderInputArgs renderArgs;
+    renderArgs.effect = effect;
+    renderArgs.time = time;
+    renderArgs.originalMipMapLevel = originalMipMapLevel;
+    renderArgs.renderStorageMode = renderStorageMode;
+    renderArgs.useScaleOneInputs = useScaleOneInputs;
+    renderArgs.byPassCache = byPassCache;
+
+    ///Dispatch independent input branches to the thread pool, within the limits of the global thread budget.
+    ///The calling thread renders the remaining branches itself.
+    std::vector<QFuture<EffectInstance::RenderRoIRetCode> > futures;
+    std::list<const PreRenderInputBranch*> branchesOnThisThread;
+    int nThreadsAvailable = getNumberOfThreadsForConcurrentInputs(renderStorageMode, (int)branchesToRender.size() - 1);
+    QThread* currentThread = QThread::currentThread();
+    for (std::list<PreRenderInputBranch>::const_iterator it = branchesToRender.begin(); it != branchesToRender.end(); ++it) {
+        // Render the first branch on this thread so it does not wait idle
+        bool canRenderConcurrently = ( it != branchesToRender.begin() ) && ( (int)futures.size() < nThreadsAvailable ) &&
+                                     ( it->inputEffect->getNode()->getCurrentRenderThreadSafety() != eRenderSafetyUnsafe );
+        if (canRenderConcurrently) {
+            futures.push_back( QtConcurrent::run(preRenderInputBranchInThread, &(*it), &renderArgs, currentThread) );
+        } else {
+            branchesOnThisThread.push_back(&(*it));
+        }
+    }
 
-            ///For all views requested in input
-            for (FrameRangesMap::const_iterator viewIt = it->second.second.begin(); viewIt != it->second.second.end(); ++viewIt) {
-                ///For all frames in this view
-                for (U32 range = 0; range < viewIt->second.size(); ++range) {
-                    int nbFramesPreFetched = 0;
-
-                    // if the range bounds are not ints, the fetched images will probably anywhere within this range - no need to pre-render
-                    if ( (viewIt->second[range].min == (int)viewIt->second[range].min) &&
-                         ( viewIt->second[range].max == (int)viewIt->second[range].max) ) {
-                        for (double f = viewIt->second[range].min;
-                             f <= viewIt->second[range].max  && nbFramesPreFetched < NATRON_MAX_FRAMES_NEEDED_PRE_FETCHING;
-                             f += 1.) {
-                            if (!isRenderFunctor) {
-                                StatusEnum stat = EffectInstance::getInputsRoIsFunctor(useTransforms,
-                                                                                       f,
-                                                                                       viewIt->first,
-                                                                                       originalMipMapLevel,
-                                                                                       inputNode,
-                                                                                       node,
-                                                                                       treeRoot,
-                                                                                       roi,
-                                                                                       *requests);
-
-                                if (stat == eStatusFailed) {
-                                    return EffectInstance::eRenderRoIRetCodeFailed;
-                                }
-
-                                ///Do not count frames pre-fetched in RoI functor mode, it is harmless and may
-                                ///limit calculations that will be done later on anyway.
-                            } else {
-                                RenderScale scaleOne(1.);
-                                RenderScale scale( Image::getScaleFromMipMapLevel(originalMipMapLevel) );
-
-                                ///Render the input image with the bit depth of its preference
-                                ImageBitDepthEnum inputPrefDepth = inputEffect->getBitDepth(-1);
-
-                                if ( compsNeeded->empty() ) {
-                                    continue;
-                                }
-
-                                if (roiIsInRequestPass) {
-                                    frameArgs->request->getFrameViewCanonicalRoI(f, viewIt->first, &roi);
-                                }
-
-                                RectI inputRoIPixelCoords;
-                                const unsigned int upstreamMipMapLevel = useScaleOneInputs ? 0 : originalMipMapLevel;
-                                const RenderScale & upstreamScale = useScaleOneInputs ? scaleOne : scale;
-                                roi.toPixelEnclosing(upstreamMipMapLevel, inputPar, &inputRoIPixelCoords);
-
-                                std::map<ImagePlaneDesc, ImagePtr> inputImgs;
-                                {
-                                    boost::scoped_ptr<EffectInstance::RenderRoIArgs> renderArgs;
-                                    renderArgs.reset( new EffectInstance::RenderRoIArgs( f, //< time
-                                                                                         upstreamScale, //< scale
-                                                                                         upstreamMipMapLevel, //< mipmapLevel (redundant with the scale)
-                                                                                         viewIt->first, //< view
-                                                                                         byPassCache,
-                                                                                         inputRoIPixelCoords, //< roi in pixel coordinates
-                                                                                         RectD(), // < did we precompute any RoD to speed-up the call ?
-                                                                                         *compsNeeded, //< requested comps
-                                                                                         inputPrefDepth,
-                                                                                         false,
-                                                                                         effect.get(),
-                                                                                         renderStorageMode /*returnStorage*/,
-                                                                                         time /*callerRenderTime*/) );
-
-                                    EffectInstance::RenderRoIRetCode ret;
-                                    ret = inputEffect->renderRoI(*renderArgs, &inputImgs); //< requested bitdepth
-                                    if (ret != EffectInstance::eRenderRoIRetCodeOk) {
-                                        return ret;
-                                    }
-                                }
-                                for (std::map<ImagePlaneDesc, ImagePtr>::iterator it3 = inputImgs.begin(); it3 != inputImgs.end(); ++it3) {
-                                    if (inputImagesList && it3->second) {
-                                        inputImagesList->push_back(it3->second);
-                                    }
-                                }
-
-                                if ( effect->aborted() ) {
-                                    return EffectInstance::eRenderRoIRetCodeAborted;
-                                }
-
-                                if ( !inputImgs.empty() ) {
-                                    ++nbFramesPreFetched;
-                                }
-                            } // if (!isRenderFunctor) {
-                        } // for all frames
-                    }
-                } // for all ranges
-            } // for all views
-        } // EffectInstance::NotifyInputNRenderingStarted_RAII
-    } // for all inputs
-    return EffectInstance::eRenderRoIRetCodeOk;
+    EffectInstance::RenderRoIRetCode ret = EffectInstance::eRenderRoIRetCodeOk;
+    for (std::list<const PreRenderInputBranch*>::const_iterator it = branchesOnThisThread.begin(); it != branchesOnThisThread.end(); ++it) {
+        ret = preRenderInputBranch(**it, renderArgs);
+        if (ret != EffectInstance::eRenderRoIRetCodeOk) {
+            break;
+        }
+    }
+
+    // Wait for the other branches, even if this thread failed, since they reference data on this stack
+    for (std::size_t i = 0; i < futures.size(); ++i) {
+        futures[i].waitForFinished();
+        EffectInstance::RenderRoIRetCode branchRet = futures[i].result();
+        if ( (ret == EffectInstance::eRenderRoIRetCodeOk) && (branchRet != EffectInstance::eRenderRoIRetCodeOk) ) {
+            ret = branchRet;
+        }
+    }
+
+    return ret;
 } // EffectInstance::treeRecurseFunctor
 
 StatusEnum
@@ -533,6 +706,42 @@ EffectInstance::getInputsRoIsFunctor(bool useTransforms,
     return eStatusOK;
 } // EffectInstance::getInputsRoIsFunctor
 
+/**
+ * @brief Returns true if the request pass can be re-used for other frames: it only references the given time and
+ * none of the nodes it renders is frame varying, animated or painted. Otherwise it is only re-used for the same time.
+ **/
+static bool
+isRenderPlanTimeInvariant(const FrameRequestMap& request,
+                          double time)
+{
+    for (FrameRequestMap::const_iterator it = request.begin(); it != request.end(); ++it) {
+        EffectInstancePtr effect = it->first->getEffectInstance();
+        if ( !effect || effect->isFrameVarying() || effect->getHasAnimation() || it->first->getRotoContext() ) {
+            return false;
+        }
+        for (NodeFrameViewRequestData::const_iterator it2 = it->second->frames.begin(); it2 != it->second->frames.end(); ++it2) {
+            if (it2->first.time != time) {
+                return false;
+            }
+            const FrameViewRequestGlobalData& data = it2->second.globalData;
+            if ( data.isIdentity && (data.inputIdentityTime != time) ) {
+                return false;
+            }
+            for (FramesNeededMap::const_iterator it3 = data.frameViewsNeeded.begin(); it3 != data.frameViewsNeeded.end(); ++it3) {
+                for (FrameRangesMap::const_iterator it4 = it3->second.begin(); it4 != it3->second.end(); ++it4) {
+                    for (std::size_t i = 0; i < it4->second.size(); ++i) {
+                        if ( (it4->second[i].min != time) || (it4->second[i].max != time) ) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
 StatusEnum
 EffectInstance::computeRequestPass(double time,
                                    ViewIdx view,
@@ -542,6 +751,22 @@ EffectInstance::computeRequestPass(double time,
                                    FrameRequestMap& request)
 {
     bool doTransforms = appPTR->getCurrentSettings()->isTransformConcatenationEnabled();
+
+    // Re-use the plan computed for a previous render of this tree if nothing changed upstream
+    EffectInstancePtr rootEffect = treeRoot->getEffectInstance();
+    // While the user is painting, the results of the RotoPaint node change without any hash change
+    bool isDrawing = false;
+    {
+        NodePtr rotoPaintNode;
+        RotoStrokeItemPtr curStroke;
+        treeRoot->getApp()->getActiveRotoDrawingStroke(&rotoPaintNode, &curStroke, &isDrawing);
+    }
+    const bool usePlanCache = !isDrawing;
+    const U64 rootHash = rootEffect->getRenderHash();
+    if ( usePlanCache && rootEffect->_imp->renderPlanCache->getPlan(rootHash, time, view, mipMapLevel, renderWindow, doTransforms, &request) ) {
+        return eStatusOK;
+    }
+
     StatusEnum stat = getInputsRoIsFunctor(doTransforms,
                                            time,
                                            view,
@@ -556,6 +781,12 @@ EffectInstance::computeRequestPass(double time,
         return stat;
     }
 
+    if (usePlanCache) {
+        // Plans of time varying trees (e.g: with a Reader) are keyed on the time in addition to the hash
+        const bool isTimeInvariant = isRenderPlanTimeInvariant(request, time);
+        rootEffect->_imp->renderPlanCache->setPlan(rootHash, time, view, mipMapLevel, renderWindow, doTransforms, isTimeInvariant, request);
+    }
+
     //For all frame/view pair and for each node, compute the final roi as being the bounding box of all successive requests
     /*for (FrameRequestMap::iterator it = request.begin(); it != request.end(); ++it) {
         for (NodeFrameViewRequestData::iterator it2 = it->second->frames.begin(); it2 != it->second->frames.end(); ++it2) {
@@ -699,6 +930,7 @@ ParallelRenderArgsSetter::ParallelRenderArgsSetter(double time,
                                                    bool draftMode,
                                                    const RenderStatsPtr& stats)
     :  argsMap()
+    , nodes()
 {
     assert(treeRoot);
 
@@ -774,6 +1006,22 @@ ParallelRenderArgsSetter::ParallelRenderArgsSetter(double time,
              isGrp->setParallelRenderArgs(time, view, isRenderUserInteraction, isSequential, canAbort,  renderAge, treeRoot, request, textureIndex, timeline, activeRotoPaintNode, isAnalysis, draftMode,stats);
            }*/
     }
+} // ParallelRenderArgsSetter::ParallelRenderArgsSetter
+
+/**
+ * @brief Captures the parameter values of the effect of a node that takes part in the render of the frame, once all the
+ * nodes know the frame being rendered, since expressions may read parameters of other nodes. Plug-ins may change their own
+ * parameters during an analysis, in which case the values are read from the knobs.
+ **/
+static void
+captureKnobValuesForRender(const EffectInstancePtr& effect)
+{
+    ParallelRenderArgsPtr frameArgs = effect->getParallelRenderArgsTLS();
+
+    if ( !frameArgs || frameArgs->isAnalysis || frameArgs->knobValues ) {
+        return;
+    }
+    frameArgs->knobValues = effect->captureKnobValues(frameArgs->time, frameArgs->view);
 }
 
 void
@@ -783,7 +1031,9 @@ ParallelRenderArgsSetter::updateNodesRequest(const FrameRequestMap& request)
         {
             FrameRequestMap::const_iterator foundRequest = request.find(*it);
             if ( foundRequest != request.end() ) {
-                (*it)->getEffectInstance()->setNodeRequestThreadLocal(foundRequest->second);
+                EffectInstancePtr effect = (*it)->getEffectInstance();
+                effect->setNodeRequestThreadLocal(foundRequest->second);
+                captureKnobValuesForRender(effect);
             }
         }
 
@@ -796,7 +1046,9 @@ ParallelRenderArgsSetter::updateNodesRequest(const FrameRequestMap& request)
         for (NodesList::iterator it2 = rotoPaintNodes.begin(); it2 != rotoPaintNodes.end(); ++it2) {
             FrameRequestMap::const_iterator foundRequest = request.find(*it2);
             if ( foundRequest != request.end() ) {
-                (*it2)->getEffectInstance()->setNodeRequestThreadLocal(foundRequest->second);
+                EffectInstancePtr effect = (*it2)->getEffectInstance();
+                effect->setNodeRequestThreadLocal(foundRequest->second);
+                captureKnobValuesForRender(effect);
             }
         }
 
@@ -808,7 +1060,9 @@ ParallelRenderArgsSetter::updateNodesRequest(const FrameRequestMap& request)
             for (NodesList::iterator it2 = children.begin(); it2 != children.end(); ++it2) {
                 FrameRequestMap::const_iterator foundRequest = request.find(*it2);
                 if ( foundRequest != request.end() ) {
-                    (*it2)->getEffectInstance()->setNodeRequestThreadLocal(foundRequest->second);
+                    EffectInstancePtr effect = (*it2)->getEffectInstance();
+                    effect->setNodeRequestThreadLocal(foundRequest->second);
+                    captureKnobValuesForRender(effect);
                 }
             }
         }
@@ -817,6 +1071,7 @@ ParallelRenderArgsSetter::updateNodesRequest(const FrameRequestMap& request)
 
 ParallelRenderArgsSetter::ParallelRenderArgsSetter(const boost::shared_ptr<std::map<NodePtr, ParallelRenderArgsPtr> >& args)
     : argsMap(args)
+    , nodes()
 {
     // Ensure this thread gets an OpenGL context for the render of the frame
     OSGLContextPtr glContext;
@@ -883,6 +1138,7 @@ ParallelRenderArgs::ParallelRenderArgs()
     , visitsCount(0)
     , rotoPaintNodes()
     , stats()
+    , knobValues()
     , openGLContext()
     , textureIndex(0)
     , currentThreadSafety(eRenderSafetyInstanceSafe)
@@ -897,6 +1153,40 @@ ParallelRenderArgs::ParallelRenderArgs()
 {
 }
 
+KnobValuesSnapshot::KnobValuesSnapshot(const std::vector<KnobIPtr>& knobs,
+                                       double time,
+                                       ViewIdx view)
+    : _time(time)
+    , _view(view)
+    , _slots( knobs.size() )
+    , _values()
+{
+    for (std::size_t i = 0; i < knobs.size(); ++i) {
+        Slot& slot = _slots[i];
+        slot.knob = knobs[i].get();
+        slot.offset = _values.size();
+        slot.nDims = 0;
+
+        KnobIntBase* isInt = dynamic_cast<KnobIntBase*>( knobs[i].get() );
+        KnobBoolBase* isBool = dynamic_cast<KnobBoolBase*>( knobs[i].get() );
+        KnobDoubleBase* isDouble = dynamic_cast<KnobDoubleBase*>( knobs[i].get() );
+        if (!isInt && !isBool && !isDouble) {
+            continue;
+        }
+        slot.nDims = knobs[i]->getDimension();
+        // Read the values the same way the plug-in would, so that animation, expressions and links are taken into account
+        for (int d = 0; d < slot.nDims; ++d) {
+            if (isInt) {
+                _values.push_back( isInt->getValueAtTime(time, d, view) );
+            } else if (isBool) {
+                _values.push_back( isBool->getValueAtTime(time, d, view) ? 1. : 0. );
+            } else {
+                _values.push_back( isDouble->getValueAtTime(time, d, view) );
+            }
+        }
+    }
+}
+
 bool
 ParallelRenderArgs::isCurrentFrameRenderNotAbortable() const
 {
@@ -30,6 +30,8 @@
 #include <set>
 #include <map>
 #include <list>
+#include <vector>
+#include <cstddef>
 
 #if !defined(Q_MOC_RUN) && !defined(SBK_RUN)
 #include <boost/shared_ptr.hpp>
@@ -68,6 +70,64 @@ typedef boost::shared_ptr<InputMatrixMap> InputMatrixMapPtr;
 
 class NodeFrameRequest;
 
+/**
+ * @brief The values of the numeric parameters of an effect at the time and view of a frame render, captured once
+ * when the render of the frame starts. The snapshot is never modified once built, so that all the threads rendering
+ * the frame can read it without locking.
+ * The parameters are indexed by a slot, which the effect gives to each parameter when it is created, so that
+ * reading a value is an array access.
+ **/
+class KnobValuesSnapshot
+{
+public:
+
+    /**
+     * @brief Captures the values of the given knobs at the given time and view. The slot of a knob is its index in knobs,
+     * and NULL knobs are not captured.
+     **/
+    KnobValuesSnapshot(const std::vector<KnobIPtr>& knobs,
+                       double time,
+                       ViewIdx view);
+
+    /**
+     * @brief Returns true and sets value if the given knob dimension was captured in the given slot at the given time and view.
+     **/
+    template <typename T>
+    bool getValue(int slot,
+                  const KnobI* knob,
+                  double time,
+                  ViewIdx view,
+                  int dimension,
+                  T* value) const
+    {
+        if ( (time != _time) || (view != _view) || (slot < 0) || ( slot >= (int)_slots.size() ) ) {
+            return false;
+        }
+        const Slot& s = _slots[slot];
+        if ( (s.knob != knob) || (dimension < 0) || (dimension >= s.nDims) ) {
+            return false;
+        }
+        *value = (T)_values[s.offset + dimension];
+
+        return true;
+    }
+
+private:
+
+    // The offset of the first dimension of a knob in _values and its number of captured dimensions
+    struct Slot
+    {
+        const KnobI* knob;
+        std::size_t offset;
+        int nDims;
+    };
+
+    double _time;
+    ViewIdx _view;
+    std::vector<Slot> _slots;
+    std::vector<double> _values;
+};
+
 /**
  * @brief Thread-local arguments given to render a frame by the tree.
  * This is different than the RenderArgs because it is not local to a
@@ -117,6 +177,9 @@ public:
     ///Various stats local to the render of a frame
     RenderStatsPtr stats;
 
+    ///The values of the parameters at the time and view of the frame, if they were captured when the render started
+    KnobValuesSnapshotPtr knobValues;
+
     ///The OpenGL context to use for the render of this frame
     OSGLContextWPtr openGLContext;
 
@@ -42,6 +42,7 @@ NATRON_NAMESPACE_ENTER
 Plugin::~Plugin()
 {
     delete _lock;
+    delete _ofxPluginLock;
     delete _binary;
 }
 
@@ -244,15 +245,54 @@ Plugin::getPythonModuleNameAndPath(QString* moduleName,
 void
 Plugin::setOfxPlugin(OFX::Host::ImageEffect::ImageEffectPlugin* p)
 {
+    QMutexLocker k(_ofxPluginLock);
+
     _ofxPlugin = p;
+    if (p) {
+        _ofxPluginDeferred = false;
+    }
 }
 
 OFX::Host::ImageEffect::ImageEffectPlugin*
 Plugin::getOfxPlugin() const
 {
+    std::string binaryFilePath, bundlePath;
+    {
+        QMutexLocker k(_ofxPluginLock);
+        if (_ofxPlugin || !_ofxPluginDeferred) {
+            return _ofxPlugin;
+        }
+        binaryFilePath = _ofxBinaryFilePath;
+        bundlePath = _ofxBundlePath;
+    }
+
+    // Do not hold the lock while loading: the OpenFX host attaches the loaded plug-ins with setOfxPlugin()
+    appPTR->loadDeferredOFXPlugin(binaryFilePath, bundlePath);
+
+    QMutexLocker k(_ofxPluginLock);
+
     return _ofxPlugin;
 }
 
+void
+Plugin::setOfxPluginDeferred(const std::string& binaryFilePath,
+                             const std::string& bundlePath)
+{
+    QMutexLocker k(_ofxPluginLock);
+
+    _ofxPluginDeferred = true;
+    _ofxBinaryFilePath = binaryFilePath;
+    _ofxBundlePath = bundlePath;
+}
+
+bool
+Plugin::isOfxPluginDeferred() const
+{
+    QMutexLocker k(_ofxPluginLock);
+
+    return _ofxPluginDeferred;
+}
+
 OFX::Host::ImageEffect::Descriptor*
 Plugin::getOfxDesc(ContextEnum* ctx) const
 {
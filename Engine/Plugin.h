@@ -31,6 +31,7 @@
 #include <set>
 #include <map>
 #include <list>
+#include <string>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 
@@ -195,6 +196,16 @@ class Plugin
 
     PluginOpenGLRenderSupport _openglRenderSupport;
 
+    // True if the plug-in was registered from the OpenFX plug-ins index: the OpenFX plug-in is loaded on first use
+    bool _ofxPluginDeferred;
+
+    // The bundle binary to load on first use when the OpenFX plug-in is deferred
+    std::string _ofxBinaryFilePath;
+    std::string _ofxBundlePath;
+
+    // Protects _ofxPlugin and _ofxPluginDeferred, which are set by the thread loading the bundle on first use
+    QMutex* _ofxPluginLock;
+
 public:
 
     Plugin()
@@ -224,6 +235,10 @@ public:
         , _multiThreadingEnabled(true)
         , _openglActivated(true)
         , _openglRenderSupport(ePluginOpenGLRenderSupportNone)
+        , _ofxPluginDeferred(false)
+        , _ofxBinaryFilePath()
+        , _ofxBundlePath()
+        , _ofxPluginLock( new QMutex() )
     {
     }
 
@@ -266,6 +281,10 @@ public:
         , _multiThreadingEnabled(true)
         , _openglActivated(true)
         , _openglRenderSupport(ePluginOpenGLRenderSupportNone)
+        , _ofxPluginDeferred(false)
+        , _ofxBinaryFilePath()
+        , _ofxBundlePath()
+        , _ofxPluginLock( new QMutex() )
     {
         if ( _resourcesPath.isEmpty() ) {
             _resourcesPath = QLatin1String(":/Resources/");
@@ -352,7 +371,18 @@ public:
 
     void setOfxPlugin(OFX::Host::ImageEffect::ImageEffectPlugin* p);
 
+    /**
+     * @brief Returns the OpenFX plug-in. If the plug-in was registered from the OpenFX plug-ins index,
+     * this loads and describes its bundle in the OpenFX host on the first call.
+     **/
     OFX::Host::ImageEffect::ImageEffectPlugin* getOfxPlugin() const;
+
+    /**
+     * @brief Defers the loading of the OpenFX plug-in to the first call to getOfxPlugin(), which loads the given bundle binary.
+     **/
+    void setOfxPluginDeferred(const std::string& binaryFilePath, const std::string& bundlePath);
+
+    bool isOfxPluginDeferred() const;
     OFX::Host::ImageEffect::Descriptor* getOfxDesc(ContextEnum* ctx) const;
 
     void setOfxDesc(OFX::Host::ImageEffect::Descriptor* desc, ContextEnum ctx);
@@ -26,20 +26,25 @@
 
 #include <vector>
 #include <cassert>
+#include <cstdlib> // malloc, free
+#include <new> // std::bad_alloc
 #include <stdexcept>
 
 CLANG_DIAG_OFF(deprecated)
 #include <QtCore/QMutex>
 CLANG_DIAG_ON(deprecated)
+#include "Engine/AppManager.h"
 #include "Engine/EffectInstance.h"
-#include "Engine/CacheEntry.h"
+#include "Engine/PluginMemoryPool.h"
 
 NATRON_NAMESPACE_ENTER
 
 struct PluginMemory::Implementation
 {
     Implementation(const EffectInstancePtr& effect_)
-        : data()
+        : data(0)
+        , size(0)
+        , capacity(0)
         , locked(0)
         , mutex()
         , effect(effect_)
@@ -47,11 +52,30 @@ struct PluginMemory::Implementation
     {
     }
 
-    RamBuffer<char> data;
+    // The buffer comes from the PluginMemoryPool and may be larger than the size requested by the plug-in
+    char* data;
+    std::size_t size;
+    std::size_t capacity;
     int locked;
     QMutex mutex;
     EffectInstanceWPtr effect;
     bool unregisterOnExit;
+
+    void releaseData()
+    {
+        if (!data) {
+            return;
+        }
+        PluginMemoryPool* pool = appPTR->getPluginMemoryPool();
+        if (pool) {
+            pool->release(data, capacity);
+        } else {
+            free(data);
+        }
+        data = 0;
+        size = 0;
+        capacity = 0;
+    }
 };
 
 PluginMemory::PluginMemory(const EffectInstancePtr& effect)
@@ -61,6 +85,7 @@ PluginMemory::PluginMemory(const EffectInstancePtr& effect)
 
 PluginMemory::~PluginMemory()
 {
+    _imp->releaseData();
     if (_imp->unregisterOnExit) {
         EffectInstancePtr e = _imp->effect.lock();
 
@@ -85,10 +110,28 @@ PluginMemory::alloc(size_t nBytes)
     if (_imp->locked) {
         return false;
     } else {
-        _imp->data.resize(nBytes);
         EffectInstancePtr e = _imp->effect.lock();
+        if ( e && (_imp->size > 0) ) {
+            e->unregisterPluginMemory(_imp->size);
+        }
+        _imp->releaseData();
+        if (nBytes == 0) {
+            return true;
+        }
+        PluginMemoryPool* pool = appPTR->getPluginMemoryPool();
+        if (pool) {
+            _imp->data = (char*)pool->allocate(nBytes, &_imp->capacity);
+        } else {
+            _imp->data = (char*)malloc(nBytes);
+            _imp->capacity = nBytes;
+        }
+        if (!_imp->data) {
+            _imp->capacity = 0;
+            throw std::bad_alloc();
+        }
+        _imp->size = nBytes;
         if (e) {
-            e->registerPluginMemory( _imp->data.size() );
+            e->registerPluginMemory(_imp->size);
         }
 
         return true;
@@ -101,10 +144,10 @@ PluginMemory::freeMem()
     QMutexLocker l(&_imp->mutex);
     EffectInstancePtr e = _imp->effect.lock();
 
-    if (e) {
-        e->unregisterPluginMemory( _imp->data.size() );
+    if ( e && (_imp->size > 0) ) {
+        e->unregisterPluginMemory(_imp->size);
     }
-    _imp->data.clear();
+    _imp->releaseData();
     _imp->locked = 0;
 }
 
@@ -113,9 +156,9 @@ PluginMemory::getPtr()
 {
     QMutexLocker l(&_imp->mutex);
 
-    assert( _imp->data.size() == 0 || ( _imp->data.size() > 0 && _imp->data.getData() ) );
+    assert( _imp->size == 0 || _imp->data );
 
-    return (void*)( _imp->data.getData() );
+    return (void*)_imp->data;
 }
 
 void
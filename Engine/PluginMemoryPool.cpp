@@ -0,0 +1,232 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "PluginMemoryPool.h"
+
+#include <map>
+#include <cstdlib> // malloc, free
+#include <cassert>
+
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+
+#include "Engine/AppManager.h"
+
+// Buffers smaller than this are not worth pooling
+#define NATRON_PLUGIN_MEMORY_POOL_MIN_SIZE (64 * 1024)
+
+// Sizes are rounded up to a multiple of this so that buffers of close sizes can be reused
+#define NATRON_PLUGIN_MEMORY_POOL_GRANULARITY 4096
+
+// A buffer is reused for a request if it is at most this much larger
+#define NATRON_PLUGIN_MEMORY_POOL_MAX_WASTE 1.25
+
+// The maximum amount of memory kept for reuse, as a fraction of the maximum size of the node cache
+#define NATRON_PLUGIN_MEMORY_POOL_MAX_CACHE_FRACTION 0.1
+
+// The maximum number of candidates looked at for a buffer released by the calling thread
+#define NATRON_PLUGIN_MEMORY_POOL_MAX_CANDIDATES 16
+
+NATRON_NAMESPACE_ENTER
+
+namespace {
+struct PooledBuffer
+{
+    void* ptr;
+
+    // The thread that released the buffer
+    Qt::HANDLE thread;
+};
+
+// Keyed by capacity
+typedef std::multimap<std::size_t, PooledBuffer> PooledBuffersMap;
+}
+
+struct PluginMemoryPool::Implementation
+{
+    mutable QMutex lock;
+    PooledBuffersMap buffers;
+    std::size_t retainedSize;
+
+    Implementation()
+        : lock()
+        , buffers()
+        , retainedSize(0)
+    {
+    }
+
+    // Frees all the buffers and returns the amount of memory freed. The lock must be held.
+    std::size_t clearInternal()
+    {
+        std::size_t freed = retainedSize;
+
+        for (PooledBuffersMap::iterator it = buffers.begin(); it != buffers.end(); ++it) {
+            free(it->second.ptr);
+        }
+        buffers.clear();
+        retainedSize = 0;
+
+        return freed;
+    }
+};
+
+PluginMemoryPool::PluginMemoryPool()
+    : _imp( new Implementation() )
+{
+}
+
+PluginMemoryPool::~PluginMemoryPool()
+{
+    clear();
+}
+
+void*
+PluginMemoryPool::allocate(std::size_t nBytes,
+                           std::size_t* capacity)
+{
+    if (nBytes < NATRON_PLUGIN_MEMORY_POOL_MIN_SIZE) {
+        *capacity = nBytes;
+
+        return nBytes == 0 ? 0 : malloc(nBytes);
+    }
+
+    std::size_t roundedSize = ( (nBytes + NATRON_PLUGIN_MEMORY_POOL_GRANULARITY - 1) / NATRON_PLUGIN_MEMORY_POOL_GRANULARITY ) * NATRON_PLUGIN_MEMORY_POOL_GRANULARITY;
+    std::size_t maxSize = (std::size_t)(roundedSize * NATRON_PLUGIN_MEMORY_POOL_MAX_WASTE);
+    {
+        QMutexLocker k(&_imp->lock);
+        PooledBuffersMap::iterator first = _imp->buffers.lower_bound(roundedSize);
+        PooledBuffersMap::iterator last = _imp->buffers.upper_bound(maxSize);
+        if (first != last) {
+            // Prefer a buffer released by this thread, its pages are more likely to be close to it
+            Qt::HANDLE self = QThread::currentThreadId();
+            PooledBuffersMap::iterator found = first;
+            int i = 0;
+            for (PooledBuffersMap::iterator it = first; it != last && i < NATRON_PLUGIN_MEMORY_POOL_MAX_CANDIDATES; ++it, ++i) {
+                if (it->second.thread == self) {
+                    found = it;
+                    break;
+                }
+            }
+            void* ret = found->second.ptr;
+            *capacity = found->first;
+            _imp->retainedSize -= found->first;
+            _imp->buffers.erase(found);
+            k.unlock();
+
+            // The buffer no longer counts in the node cache
+            appPTR->registerMemoryInNodeCache(*capacity, 0);
+
+            return ret;
+        }
+    }
+
+    void* ret = malloc(roundedSize);
+    if (!ret) {
+        // Give the memory kept for reuse back to the system and retry
+        clear();
+        ret = malloc(roundedSize);
+    }
+    *capacity = ret ? roundedSize : 0;
+
+    return ret;
+} // PluginMemoryPool::allocate
+
+void
+PluginMemoryPool::release(void* ptr,
+                          std::size_t capacity)
+{
+    if (!ptr) {
+        return;
+    }
+    if (capacity < NATRON_PLUGIN_MEMORY_POOL_MIN_SIZE) {
+        free(ptr);
+
+        return;
+    }
+
+    std::size_t cacheSize, cacheMaxSize;
+    appPTR->getNodeCacheMemoryUsage(&cacheSize, &cacheMaxSize);
+    bool retained = false;
+    if (cacheSize + capacity <= cacheMaxSize) {
+        QMutexLocker k(&_imp->lock);
+        if (_imp->retainedSize + capacity <= cacheMaxSize * NATRON_PLUGIN_MEMORY_POOL_MAX_CACHE_FRACTION) {
+            PooledBuffer buffer;
+            buffer.ptr = ptr;
+            buffer.thread = QThread::currentThreadId();
+            _imp->buffers.insert( std::make_pair(capacity, buffer) );
+            _imp->retainedSize += capacity;
+            retained = true;
+        }
+    }
+    if (retained) {
+        appPTR->registerMemoryInNodeCache(0, capacity);
+    } else {
+        free(ptr);
+    }
+}
+
+void
+PluginMemoryPool::clear()
+{
+    std::size_t freed;
+    {
+        QMutexLocker k(&_imp->lock);
+        freed = _imp->clearInternal();
+    }
+    if (freed > 0) {
+        appPTR->registerMemoryInNodeCache(freed, 0);
+    }
+}
+
+std::size_t
+PluginMemoryPool::trim(std::size_t nBytes)
+{
+    std::size_t freed = 0;
+    {
+        QMutexLocker k(&_imp->lock);
+        while ( freed < nBytes && !_imp->buffers.empty() ) {
+            PooledBuffersMap::iterator largest = _imp->buffers.end();
+            --largest;
+            free(largest->second.ptr);
+            freed += largest->first;
+            _imp->retainedSize -= largest->first;
+            _imp->buffers.erase(largest);
+        }
+    }
+    if (freed > 0) {
+        appPTR->registerMemoryInNodeCache(freed, 0);
+    }
+
+    return freed;
+}
+
+std::size_t
+PluginMemoryPool::getRetainedSize() const
+{
+    QMutexLocker k(&_imp->lock);
+
+    return _imp->retainedSize;
+}
+
+NATRON_NAMESPACE_EXIT
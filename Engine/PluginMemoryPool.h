@@ -0,0 +1,88 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef Natron_Engine_PluginMemoryPool_h
+#define Natron_Engine_PluginMemoryPool_h
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#include <cstddef>
+#if !defined(Q_MOC_RUN) && !defined(SBK_RUN)
+#include <boost/scoped_ptr.hpp>
+#endif
+
+#include "Engine/EngineFwd.h"
+
+NATRON_NAMESPACE_ENTER
+
+/**
+ * @brief Keeps the scratch buffers freed by the plug-ins to hand them back to the next allocation of a close size,
+ * so that plug-ins allocating large temporaries for each render or each tile do not go through the system allocator
+ * each time. A buffer released by a thread is preferably handed back to the same thread.
+ * The buffers kept for reuse are accounted in the size of the node cache, so that they count against the cache memory
+ * budget, the pool never keeps more than what the node cache has room for, and the node cache trims the pool before
+ * evicting images.
+ **/
+class PluginMemoryPool
+{
+public:
+
+    PluginMemoryPool();
+
+    ~PluginMemoryPool();
+
+    /**
+     * @brief Returns a buffer of at least nBytes bytes and sets capacity to its actual size.
+     * Returns NULL if the allocation failed.
+     **/
+    void* allocate(std::size_t nBytes, std::size_t* capacity);
+
+    /**
+     * @brief Releases a buffer returned by allocate, with the capacity it was returned with. The buffer is kept for reuse
+     * if the pool has room for it, otherwise it is freed.
+     **/
+    void release(void* ptr, std::size_t capacity);
+
+    /**
+     * @brief Frees all the buffers kept for reuse
+     **/
+    void clear();
+
+    /**
+     * @brief Frees buffers kept for reuse, the largest first, until at least nBytes bytes were freed or the pool is empty.
+     * Returns the amount of memory freed.
+     **/
+    std::size_t trim(std::size_t nBytes);
+
+    std::size_t getRetainedSize() const;
+
+private:
+
+    struct Implementation;
+    boost::scoped_ptr<Implementation> _imp;
+};
+
+NATRON_NAMESPACE_EXIT
+
+#endif // Natron_Engine_PluginMemoryPool_h
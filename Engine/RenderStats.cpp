@@ -25,6 +25,7 @@
 #include "RenderStats.h"
 
 #include <bitset>
+#include <algorithm> // nth_element
 #include <cassert>
 #include <stdexcept>
 
@@ -37,6 +38,54 @@
 
 NATRON_NAMESPACE_ENTER
 
+ActionCallStats::ActionCallStats()
+    : _callTimes()
+    , _totalTimeSpent(0)
+    , _totalInclusiveTimeSpent(0)
+{
+}
+
+void
+ActionCallStats::addCall(double selfTime,
+                         double inclusiveTime)
+{
+    _callTimes.push_back(selfTime);
+    _totalTimeSpent += selfTime;
+    _totalInclusiveTimeSpent += inclusiveTime;
+}
+
+int
+ActionCallStats::getNumberOfCalls() const
+{
+    return (int)_callTimes.size();
+}
+
+double
+ActionCallStats::getTotalTimeSpent() const
+{
+    return _totalTimeSpent;
+}
+
+double
+ActionCallStats::getTotalInclusiveTimeSpent() const
+{
+    return _totalInclusiveTimeSpent;
+}
+
+double
+ActionCallStats::getPercentile(double fraction) const
+{
+    if ( _callTimes.empty() ) {
+        return 0.;
+    }
+    fraction = std::max( 0., std::min(1., fraction) );
+    std::vector<double> times = _callTimes;
+    std::vector<double>::iterator nth = times.begin() + (std::size_t)( fraction * (times.size() - 1) + 0.5 );
+    std::nth_element(times.begin(), nth, times.end());
+
+    return *nth;
+}
+
 struct NodeRenderStatsPrivate
 {
     //The accumulated time spent in the EffectInstance::renderHandler function
@@ -65,6 +114,13 @@ struct NodeRenderStatsPrivate
     int nbCacheHit;
     int nbCacheHitButDownscaledImages;
 
+    //Number of times the plug-in waited on one of its OpenFX mutexes and the accumulated time spent waiting
+    int nbMutexContentions;
+    double mutexWaitTime;
+
+    //The calls to the plug-in actions, by action name
+    ActionCallStatsMap actionCalls;
+
     //Is tile support enabled for this render
     bool tileSupportEnabled;
 
@@ -88,6 +144,9 @@ struct NodeRenderStatsPrivate
         , nbCacheMisses(0)
         , nbCacheHit(0)
         , nbCacheHitButDownscaledImages(0)
+        , nbMutexContentions(0)
+        , mutexWaitTime(0)
+        , actionCalls()
         , tileSupportEnabled(false)
         , renderScaleSupportEnabled(false)
         , channelsEnabled()
@@ -127,6 +186,9 @@ NodeRenderStats::operator=(const NodeRenderStats& other)
     _imp->nbCacheMisses = other._imp->nbCacheMisses;
     _imp->nbCacheHit = other._imp->nbCacheHit;
     _imp->nbCacheHitButDownscaledImages = other._imp->nbCacheHitButDownscaledImages;
+    _imp->nbMutexContentions = other._imp->nbMutexContentions;
+    _imp->mutexWaitTime = other._imp->mutexWaitTime;
+    _imp->actionCalls = other._imp->actionCalls;
     _imp->tileSupportEnabled = other._imp->tileSupportEnabled;
     _imp->renderScaleSupportEnabled = other._imp->renderScaleSupportEnabled;
     for (int i = 0; i < 4; ++i) {
@@ -253,6 +315,35 @@ NodeRenderStats::getCacheAccessInfos(int* nbCacheMisses,
     *nbCacheHitButDownscaledImages = _imp->nbCacheHitButDownscaledImages;
 }
 
+void
+NodeRenderStats::addMutexContention(double timeWaited)
+{
+    ++_imp->nbMutexContentions;
+    _imp->mutexWaitTime += timeWaited;
+}
+
+void
+NodeRenderStats::getMutexContentions(int* nbContentions,
+                                     double* timeWaited) const
+{
+    *nbContentions = _imp->nbMutexContentions;
+    *timeWaited = _imp->mutexWaitTime;
+}
+
+void
+NodeRenderStats::addActionCall(const std::string& action,
+                               double selfTime,
+                               double inclusiveTime)
+{
+    _imp->actionCalls[action].addCall(selfTime, inclusiveTime);
+}
+
+const ActionCallStatsMap&
+NodeRenderStats::getActionCalls() const
+{
+    return _imp->actionCalls;
+}
+
 void
 NodeRenderStats::setTilesSupported(bool tilesSupported)
 {
@@ -414,6 +505,32 @@ RenderStats::addCacheInfosForNode(const NodePtr& node,
     stats.addCacheAccessInfo(isCacheMiss, hasDownscaled);
 }
 
+void
+RenderStats::addMutexContentionForNode(const NodePtr& node,
+                                       double timeWaited)
+{
+    QMutexLocker k(&_imp->lock);
+
+    assert(_imp->doNodesProfiling);
+
+    NodeRenderStats& stats = _imp->findOrCreateNodeStats(node);
+    stats.addMutexContention(timeWaited);
+}
+
+void
+RenderStats::addActionCallForNode(const NodePtr& node,
+                                  const std::string& action,
+                                  double selfTime,
+                                  double inclusiveTime)
+{
+    QMutexLocker k(&_imp->lock);
+
+    assert(_imp->doNodesProfiling);
+
+    NodeRenderStats& stats = _imp->findOrCreateNodeStats(node);
+    stats.addActionCall(action, selfTime, inclusiveTime);
+}
+
 void
 RenderStats::addRenderInfosForNode(const NodePtr& node,
                                    const NodePtr& identity,
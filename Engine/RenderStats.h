@@ -31,6 +31,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 #include <bitset>
 
 #if !defined(Q_MOC_RUN) && !defined(SBK_RUN)
@@ -47,6 +48,39 @@
 
 NATRON_NAMESPACE_ENTER
 
+/**
+ * @brief The calls made to one action of a plug-in. The time of a call is the time spent in the action itself, excluding
+ * the actions it triggered on other nodes from the same thread, which is counted separately as the inclusive time.
+ * Not MT-safe: MT-safety is handled by RenderStats.
+ **/
+class ActionCallStats
+{
+public:
+
+    ActionCallStats();
+
+    void addCall(double selfTime, double inclusiveTime);
+
+    int getNumberOfCalls() const;
+
+    double getTotalTimeSpent() const;
+
+    double getTotalInclusiveTimeSpent() const;
+
+    /**
+     * @brief Returns the time under which the given fraction (between 0 and 1) of the calls completed
+     **/
+    double getPercentile(double fraction) const;
+
+private:
+
+    std::vector<double> _callTimes;
+    double _totalTimeSpent;
+    double _totalInclusiveTimeSpent;
+};
+
+typedef std::map<std::string, ActionCallStats> ActionCallStatsMap;
+
 /**
  * @brief Holds render infos for one frame for one node. Not MT-safe: MT-safety is handled by RenderStats.
  **/
@@ -87,6 +121,14 @@ public:
     void addCacheAccessInfo(bool isCacheMiss, bool hasDownscaled);
     void getCacheAccessInfos(int* nbCacheMisses, int* nbCacheHits, int* nbCacheHitButDownscaledImages) const;
 
+    void addMutexContention(double timeWaited);
+
+    void getMutexContentions(int* nbContentions, double* timeWaited) const;
+
+    void addActionCall(const std::string& action, double selfTime, double inclusiveTime);
+
+    const ActionCallStatsMap& getActionCalls() const;
+
     void setTilesSupported(bool tilesSupported);
     bool isTilesSupportEnabled() const;
 
@@ -136,6 +178,21 @@ public:
                               bool isCacheMiss,
                               bool hasDownscaled);
 
+    /**
+     * @brief Called when the plug-in of the node had to wait on one of its own OpenFX mutexes held by another thread
+     **/
+    void addMutexContentionForNode(const NodePtr& node,
+                                   double timeWaited);
+
+    /**
+     * @brief Called when an OpenFX action of the plug-in of the node returned, with the time spent in the action itself
+     * and the time including the actions it called on other nodes
+     **/
+    void addActionCallForNode(const NodePtr& node,
+                              const std::string& action,
+                              double selfTime,
+                              double inclusiveTime);
+
     void addRenderInfosForNode(const NodePtr& node,
                                const NodePtr& identity,
                                const std::string& plane,
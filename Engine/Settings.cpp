@@ -302,6 +302,16 @@ Settings::initializeKnobsThreading()
     _threadingPage->addKnob(_numberOfParallelRenders);
 #endif
 
+    _readAheadFrames = AppManager::createKnob<KnobInt>( this, tr("Frames decoded ahead during playback") );
+    _readAheadFrames->setHintToolTip( tr("During playback and when rendering a frame range, the Read nodes upstream of the output "
+                                         "decode up to this number of frames ahead of the frames being rendered, using a low priority thread. "
+                                         "The decoded images are kept in the cache so that the render of these frames does not have to wait "
+                                         "for the file to be read. A value of 0 disables this feature.") );
+    _readAheadFrames->setName("readAheadFrames");
+    _readAheadFrames->setMinimum(0);
+    _readAheadFrames->disableSlider();
+    _threadingPage->addKnob(_readAheadFrames);
+
     _useThreadPool = AppManager::createKnob<KnobBool>( this, tr("Effects use the thread-pool") );
     _useThreadPool->setName("useThreadPool");
     _useThreadPool->setHintToolTip( tr("When checked, all effects will use a global thread-pool to do their processing instead of launching "
@@ -1070,6 +1080,15 @@ Settings::initializeKnobsViewers()
 
     _viewersTab->addKnob(_powerOf2Tiling);
 
+    _compressViewerCacheTiles = AppManager::createKnob<KnobBool>( this, tr("Compress 32-bit viewer cache tiles") );
+    _compressViewerCacheTiles->setName("compressViewerCacheTiles");
+    _compressViewerCacheTiles->setHintToolTip( tr("When checked and the viewer textures are 32-bit floating-point, the textures "
+                                                  "are stored in the playback cache as 16-bit half-floats and expanded back to "
+                                                  "32-bit when displayed. This is visually lossless and doubles the number "
+                                                  "of frames the playback cache can hold, in RAM and on disk. "
+                                                  "Changing this clears the playback cache.") );
+    _viewersTab->addKnob(_compressViewerCacheTiles);
+
     _checkerboardTileSize = AppManager::createKnob<KnobInt>( this, tr("Checkerboard tile size (pixels)") );
     _checkerboardTileSize->setName("checkerboardTileSize");
     _checkerboardTileSize->setMinimum(1);
@@ -1113,6 +1132,43 @@ Settings::initializeKnobsViewers()
 
     _viewersTab->addKnob(_autoProxyLevel);
 
+    _progressiveViewerRefinement = AppManager::createKnob<KnobBool>( this, tr("Progressive refinement") );
+    _progressiveViewerRefinement->setName("progressiveViewerRefinement");
+    _progressiveViewerRefinement->setHintToolTip( tr("When checked, a frame that is not cached is first rendered and displayed in draft mode at "
+                                                     "the level indicated by the auto-proxy parameter, then at full resolution. "
+                                                     "The full resolution render is skipped if another frame is requested meanwhile, "
+                                                     "e.g. while scrubbing the timeline.") );
+    _viewersTab->addKnob(_progressiveViewerRefinement);
+
+    _playbackDropFrames = AppManager::createKnob<KnobBool>( this, tr("Drop late frames during playback") );
+    _playbackDropFrames->setName("playbackDropFrames");
+    _playbackDropFrames->setHintToolTip( tr("When checked, if the playback falls behind the desired frame-rate by more than one frame "
+                                            "and the next frame is already rendered, the late frame is skipped so that the playback "
+                                            "keeps the desired cadence. When unchecked, all frames are displayed and the playback "
+                                            "slows down instead.") );
+    _viewersTab->addKnob(_playbackDropFrames);
+
+    _playbackPreBufferedFrames = AppManager::createKnob<KnobInt>( this, tr("Frames pre-buffered before playback") );
+    _playbackPreBufferedFrames->setName("playbackPreBufferedFrames");
+    _playbackPreBufferedFrames->setHintToolTip( tr("The number of frames that must be rendered before the viewer starts displaying "
+                                                   "a playback. Higher values give a smoother playback at the expense of a longer "
+                                                   "delay before it starts. This is limited by the number of frames the playback "
+                                                   "may render ahead, which depends on the number of CPU cores.") );
+    _playbackPreBufferedFrames->setMinimum(0);
+    _playbackPreBufferedFrames->disableSlider();
+    _viewersTab->addKnob(_playbackPreBufferedFrames);
+
+    _viewerFlipbookCacheSize = AppManager::createKnob<KnobInt>( this, tr("Flipbook cache size (MiB)") );
+    _viewerFlipbookCacheSize->setName("viewerFlipbookCacheSize");
+    _viewerFlipbookCacheSize->setHintToolTip( tr("The amount of RAM (in MiB) each viewer may use to keep the display-ready textures "
+                                                 "of the frames it played back. When a frame range is played again with the same "
+                                                 "viewer settings, the frames are displayed from this memory without rendering "
+                                                 "nor looking up the viewer cache, so that looping playback stays at the desired "
+                                                 "frame-rate. The oldest frames are released first. 0 disables the flipbook cache.") );
+    _viewerFlipbookCacheSize->setMinimum(0);
+    _viewerFlipbookCacheSize->disableSlider();
+    _viewersTab->addKnob(_viewerFlipbookCacheSize);
+
     _maximumNodeViewerUIOpened = AppManager::createKnob<KnobInt>( this, tr("Max. opened node viewer interface") );
     _maximumNodeViewerUIOpened->setName("maxNodeUiOpened");
     _maximumNodeViewerUIOpened->setMinimum(1);
@@ -1444,6 +1500,7 @@ Settings::setDefaultValues()
 #ifndef NATRON_PLAYBACK_USES_THREAD_POOL
     _numberOfParallelRenders->setDefaultValue(0, 0);
 #endif
+    _readAheadFrames->setDefaultValue(4);
     _useThreadPool->setDefaultValue(true);
     _nThreadsPerEffect->setDefaultValue(0);
     _renderInSeparateProcess->setDefaultValue(false, 0);
@@ -1506,6 +1563,7 @@ Settings::setDefaultValues()
     // Viewer
     _texturesMode->setDefaultValue(0, 0);
     _powerOf2Tiling->setDefaultValue(8, 0);
+    _compressViewerCacheTiles->setDefaultValue(false);
     _checkerboardTileSize->setDefaultValue(5);
     _checkerboardColor1->setDefaultValue(0.5, 0);
     _checkerboardColor1->setDefaultValue(0.5, 1);
@@ -1518,6 +1576,10 @@ Settings::setDefaultValues()
     _autoWipe->setDefaultValue(true);
     _autoProxyWhenScrubbingTimeline->setDefaultValue(true);
     _autoProxyLevel->setDefaultValue(1);
+    _progressiveViewerRefinement->setDefaultValue(true);
+    _playbackDropFrames->setDefaultValue(false);
+    _playbackPreBufferedFrames->setDefaultValue(0);
+    _viewerFlipbookCacheSize->setDefaultValue(0);
     _maximumNodeViewerUIOpened->setDefaultValue(2);
     _viewerKeys->setDefaultValue(true);
 
@@ -2099,6 +2161,9 @@ Settings::restoreSettings(bool useDefault)
         if (_texturesMode) {
             _texturesMode->setSecret(true);
         }
+        if (_compressViewerCacheTiles) {
+            _compressViewerCacheTiles->setSecret(true);
+        }
     }
 
     _settingsExisted = false;
@@ -2306,10 +2371,12 @@ Settings::onKnobValueChanged(KnobI* k,
         appPTR->onViewerTileCacheSizeChanged();
     } else if ( k == _texturesMode.get() &&  !_restoringSettings) {
          appPTR->onViewerTileCacheSizeChanged();
+    } else if ( k == _compressViewerCacheTiles.get() && !_restoringSettings) {
+        appPTR->onViewerTileCacheSizeChanged();
     } else if ( ( k == _hideOptionalInputsAutomatically.get() ) && !_restoringSettings && (reason == eValueChangedReasonUserEdited) ) {
         appPTR->toggleAutoHideGraphInputs();
-    } else if ( k == _autoProxyWhenScrubbingTimeline.get() ) {
-        _autoProxyLevel->setSecret( !_autoProxyWhenScrubbingTimeline->getValue() );
+    } else if ( ( k == _autoProxyWhenScrubbingTimeline.get() ) || ( k == _progressiveViewerRefinement.get() ) ) {
+        _autoProxyLevel->setSecret( !_autoProxyWhenScrubbingTimeline->getValue() && !_progressiveViewerRefinement->getValue() );
     } else if ( !_restoringSettings &&
                 ( ( k == _sunkenColor.get() ) ||
                   ( k == _baseColor.get() ) ||
@@ -2407,6 +2474,12 @@ Settings::getViewerTilesPowerOf2() const
     return _powerOf2Tiling->getValue();
 }
 
+bool
+Settings::isViewerCacheTilesCompressionEnabled() const
+{
+    return _compressViewerCacheTiles->getValue();
+}
+
 int
 Settings::getCheckerboardTileSize() const
 {
@@ -2455,6 +2528,30 @@ Settings::getAutoProxyMipMapLevel() const
     return (unsigned int)_autoProxyLevel->getValue() + 1;
 }
 
+bool
+Settings::isProgressiveViewerRefinementEnabled() const
+{
+    return _progressiveViewerRefinement->getValue();
+}
+
+bool
+Settings::isPlaybackFrameDropEnabled() const
+{
+    return _playbackDropFrames->getValue();
+}
+
+int
+Settings::getNumberOfPlaybackPreBufferedFrames() const
+{
+    return _playbackPreBufferedFrames->getValue();
+}
+
+U64
+Settings::getViewerFlipbookCacheSize() const
+{
+    return (U64)_viewerFlipbookCacheSize->getValue() * 1024ULL * 1024ULL;
+}
+
 int
 Settings::getMaxOpenedNodesViewerContext() const
 {
@@ -3054,6 +3151,12 @@ Settings::setNumberOfParallelRenders(int nb)
 #endif
 }
 
+int
+Settings::getNumberOfReadAheadFrames() const
+{
+    return _readAheadFrames->getValue();
+}
+
 bool
 Settings::areRGBPixelComponentsSupported() const
 {
@@ -122,6 +122,8 @@ public:
 
     void setNumberOfParallelRenders(int nb);
 
+    int getNumberOfReadAheadFrames() const;
+
     int getNumberOfThreadsPerEffect() const;
 
     bool useGlobalThreadPool() const;
@@ -241,12 +243,23 @@ public:
     // "Viewers" pane
     ImageBitDepthEnum getViewersBitDepth() const;
     int getViewerTilesPowerOf2() const;
+
+    // Returns true if 32-bit viewer textures are stored as half-floats in the viewer cache
+    bool isViewerCacheTilesCompressionEnabled() const;
     int getCheckerboardTileSize() const;
     void getCheckerboardColor1(double* r, double* g, double* b, double* a) const;
     void getCheckerboardColor2(double* r, double* g, double* b, double* a) const;
     bool isAutoWipeEnabled() const;
     bool isAutoProxyEnabled() const;
     unsigned int getAutoProxyMipMapLevel() const;
+    bool isProgressiveViewerRefinementEnabled() const;
+
+    bool isPlaybackFrameDropEnabled() const;
+
+    int getNumberOfPlaybackPreBufferedFrames() const;
+
+    // Returns the size in bytes of the RAM a viewer may use for its flipbook cache, 0 if disabled
+    U64 getViewerFlipbookCacheSize() const;
     int getMaxOpenedNodesViewerContext() const;
     bool isViewerKeysEnabled() const;
     ///////////////////////////////////////////////////////
@@ -433,6 +446,7 @@ private:
     KnobPagePtr _threadingPage;
     KnobIntPtr _numberOfThreads;
     KnobIntPtr _numberOfParallelRenders;
+    KnobIntPtr _readAheadFrames;
     KnobBoolPtr _useThreadPool;
     KnobIntPtr _nThreadsPerEffect;
     KnobBoolPtr _renderInSeparateProcess;
@@ -519,12 +533,17 @@ private:
     KnobPagePtr _viewersTab;
     KnobChoicePtr _texturesMode;
     KnobIntPtr _powerOf2Tiling;
+    KnobBoolPtr _compressViewerCacheTiles;
     KnobIntPtr _checkerboardTileSize;
     KnobColorPtr _checkerboardColor1;
     KnobColorPtr _checkerboardColor2;
     KnobBoolPtr _autoWipe;
     KnobBoolPtr _autoProxyWhenScrubbingTimeline;
     KnobChoicePtr _autoProxyLevel;
+    KnobBoolPtr _progressiveViewerRefinement;
+    KnobBoolPtr _playbackDropFrames;
+    KnobIntPtr _playbackPreBufferedFrames;
+    KnobIntPtr _viewerFlipbookCacheSize;
     KnobIntPtr _maximumNodeViewerUIOpened;
     KnobBoolPtr _viewerKeys;
 
@@ -120,7 +120,7 @@ void
 AppTLS::cleanupTLSForThread()
 {
     QThread* curThread = QThread::currentThread();
-    AbortableThread* isAbortableThread = dynamic_cast<AbortableThread*>(curThread);
+    AbortableThread* isAbortableThread = AbortableThread::getCurrentAbortableThread();
 
     if (isAbortableThread) {
         isAbortableThread->clearAbortInfo();
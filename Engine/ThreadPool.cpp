@@ -31,12 +31,31 @@
 #include <QtCore/QMutex>
 #include <QtCore/QThread>
 #include <QtCore/QThreadPool>
+#include <QtCore/QThreadStorage>
 
 #include "Engine/AbortableRenderInfo.h"
 #include "Engine/Node.h"
 
 NATRON_NAMESPACE_ENTER
 
+NATRON_NAMESPACE_ANONYMOUS_ENTER
+
+// Caches for each thread the result of the dynamic_cast of QThread::currentThread() to AbortableThread
+struct CurrentAbortableThread
+{
+    AbortableThread* thread;
+    bool resolved;
+
+    CurrentAbortableThread()
+        : thread(0)
+        , resolved(false)
+    {
+    }
+};
+
+NATRON_NAMESPACE_ANONYMOUS_EXIT
+
+static QThreadStorage<CurrentAbortableThread> currentAbortableThread;
 
 struct AbortableThreadPrivate
 {
@@ -47,6 +66,15 @@ struct AbortableThreadPrivate
     AbortableRenderInfoWPtr abortInfo;
     EffectInstanceWPtr treeRoot;
     bool abortInfoValid;
+
+    // Incremented each time the abort info above changes
+    QAtomicInt abortInfoGeneration;
+
+    // Copy of the abort info used by getCancellationToken(), only accessed from the thread itself
+    int cachedAbortInfoGeneration;
+    bool cachedAbortInfoValid;
+    bool cachedIsRenderResponseToUserInteraction;
+    AbortableRenderInfoPtr cachedAbortInfo;
     std::string currentActionName;
     NodeWPtr currentActionNode;
 
@@ -58,6 +86,11 @@ struct AbortableThreadPrivate
         , abortInfo()
         , treeRoot()
         , abortInfoValid(false)
+        , abortInfoGeneration()
+        , cachedAbortInfoGeneration(-1)
+        , cachedAbortInfoValid(false)
+        , cachedIsRenderResponseToUserInteraction(false)
+        , cachedAbortInfo()
         , currentActionName()
         , currentActionNode()
     {
@@ -73,6 +106,19 @@ AbortableThread::~AbortableThread()
 {
 }
 
+AbortableThread*
+AbortableThread::getCurrentAbortableThread()
+{
+    CurrentAbortableThread& current = currentAbortableThread.localData();
+
+    if (!current.resolved) {
+        current.thread = dynamic_cast<AbortableThread*>( QThread::currentThread() );
+        current.resolved = true;
+    }
+
+    return current.thread;
+}
+
 void
 AbortableThread::setThreadName(const std::string& threadName)
 {
@@ -133,6 +179,7 @@ AbortableThread::setAbortInfo(bool isRenderResponseToUserInteraction,
         _imp->abortInfo = abortInfo;
         _imp->treeRoot = treeRoot;
         _imp->abortInfoValid = true;
+        _imp->abortInfoGeneration.ref();
     }
     if (abortInfo) {
         abortInfo->registerThreadForRender(this);
@@ -149,6 +196,13 @@ AbortableThread::clearAbortInfo()
         _imp->abortInfo.reset();
         _imp->treeRoot.reset();
         _imp->abortInfoValid = false;
+        _imp->abortInfoGeneration.ref();
+    }
+
+    if (QThread::currentThread() == _imp->thread) {
+        // Do not hold the render alive until the next call to getCancellationToken()
+        _imp->cachedAbortInfo.reset();
+        _imp->cachedAbortInfoValid = false;
     }
 
     if (abortInfo) {
@@ -173,6 +227,29 @@ AbortableThread::getAbortInfo(bool* isRenderResponseToUserInteraction,
     return true;
 }
 
+bool
+AbortableThread::getCancellationToken(bool* isRenderResponseToUserInteraction,
+                                      const AbortableRenderInfo** token)
+{
+    assert(QThread::currentThread() == _imp->thread);
+
+    if ( (int)_imp->abortInfoGeneration != _imp->cachedAbortInfoGeneration ) {
+        QMutexLocker k(&_imp->abortInfoMutex);
+        _imp->cachedAbortInfoGeneration = (int)_imp->abortInfoGeneration;
+        _imp->cachedAbortInfoValid = _imp->abortInfoValid;
+        _imp->cachedIsRenderResponseToUserInteraction = _imp->isRenderResponseToUserInteraction;
+        _imp->cachedAbortInfo = _imp->abortInfo.lock();
+    }
+
+    if (!_imp->cachedAbortInfoValid) {
+        return false;
+    }
+    *isRenderResponseToUserInteraction = _imp->cachedIsRenderResponseToUserInteraction;
+    *token = _imp->cachedAbortInfo.get();
+
+    return true;
+}
+
 // We patched Qt to be able to derive QThreadPool to control the threads that are spawned to improve performances
 // of the EffectInstance::aborted() function
 #ifdef QT_CUSTOM_THREADPOOL
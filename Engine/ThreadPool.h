@@ -52,6 +52,12 @@ public:
 
     virtual ~AbortableThread();
 
+    /**
+     * @brief Returns the AbortableThread corresponding to the calling thread, or NULL if the calling thread is not
+     * an AbortableThread. The lookup is cached per thread so this is much cheaper than a dynamic_cast on QThread::currentThread().
+     **/
+    static AbortableThread* getCurrentAbortableThread();
+
     /**
      * @brief Set the informations related to a specific render so we know if it was aborted or not in getAbortInfo()
      **/
@@ -72,6 +78,15 @@ public:
                       AbortableRenderInfoPtr* abortInfo,
                       EffectInstancePtr* treeRoot) const;
 
+    /**
+     * @brief Same as getAbortInfo() except that it only returns the cancellation token of the render ongoing on this thread.
+     * The lock protecting the abort info is only taken when the abort info changed since the last call, making this suitable
+     * for hot paths such as EffectInstance::aborted().
+     * This must only be called from the thread itself. The returned token remains valid until the abort info of this thread changes.
+     **/
+    bool getCancellationToken(bool* isRenderResponseToUserInteraction,
+                              const AbortableRenderInfo** token);
+
     // For debug purposes, so that the debugger can display the thread name
     void setThreadName(const std::string& threadName);
 
@@ -107,8 +122,7 @@ private:
 
 #define REPORT_CURRENT_THREAD_ACTION(actionName, node) \
     { \
-        QThread* thread = QThread::currentThread(); \
-        AbortableThread* isAbortable = dynamic_cast<AbortableThread*>(thread); \
+        AbortableThread* isAbortable = AbortableThread::getCurrentAbortableThread(); \
         if (isAbortable) {  \
             isAbortable->setCurrentActionInfos(actionName, node); \
         } \
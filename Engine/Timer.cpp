@@ -28,6 +28,7 @@
 #include <time.h>
 #include <cmath>
 #include <cassert>
+#include <algorithm> // nth_element
 #include <stdexcept>
 
 #include <QtCore/QMutex>
@@ -37,6 +38,9 @@
 
 #define NATRON_FPS_REFRESH_RATE_SECONDS 1.5
 
+// Number of displayed frames over which the latency percentiles are computed
+#define NATRON_FRAME_LATENCY_SAMPLES 240
+
 NATRON_NAMESPACE_ENTER
 
 #if defined(__NATRON_WIN32__) && !defined(__NATRON_MINGW__)
@@ -130,6 +134,9 @@ Timer::Timer ()
     _timingError (0),
     _framesSinceLastFpsFrame (0),
     _actualFrameRate (0),
+    _droppedFrames (0),
+    _latencies(),
+    _latencyIndex (0),
     _mutex()
 {
     gettimeofday (&_lastFrameTime, 0);
@@ -149,10 +156,7 @@ Timer::waitUntilNextFrameIsDue ()
         // variables and return without waiting.
         //
 
-        gettimeofday (&_lastFrameTime, 0);
-        _timingError = 0;
-        _lastFpsFrameTime = _lastFrameTime;
-        _framesSinceLastFpsFrame = 0;
+        resetTiming();
 
         return;
     }
@@ -177,6 +181,18 @@ Timer::waitUntilNextFrameIsDue ()
     }
     double timeToSleep = spf - timeSinceLastFrame - _timingError;
 
+    // The frame is displayed late by the time we cannot sleep
+    {
+        QMutexLocker l(&_mutex);
+        double latency = timeToSleep < 0 ? -timeToSleep : 0.;
+        if (_latencies.size() < NATRON_FRAME_LATENCY_SAMPLES) {
+            _latencies.push_back(latency);
+        } else {
+            _latencies[_latencyIndex] = latency;
+        }
+        _latencyIndex = (_latencyIndex + 1) % NATRON_FRAME_LATENCY_SAMPLES;
+    }
+
     #ifdef _WIN32
 
     if (timeToSleep > 0) {
@@ -230,6 +246,8 @@ Timer::waitUntilNextFrameIsDue ()
         double actualFrameRate = _framesSinceLastFpsFrame / t;
         double curActualFrameRate;
         double desiredFrameRate;
+        int droppedFrames;
+        double latencyMedian, latency95;
         {
             QMutexLocker l(&_mutex);
             if (actualFrameRate != _actualFrameRate) {
@@ -237,8 +255,12 @@ Timer::waitUntilNextFrameIsDue ()
             }
             desiredFrameRate = 1.f / _spf;
             curActualFrameRate = _actualFrameRate;
+            droppedFrames = _droppedFrames;
+            latencyMedian = getFrameLatencyPercentile_locked(50.);
+            latency95 = getFrameLatencyPercentile_locked(95.);
         }
         Q_EMIT fpsChanged(curActualFrameRate, desiredFrameRate);
+        Q_EMIT playbackStatsChanged(droppedFrames, latencyMedian, latency95);
 
         _framesSinceLastFpsFrame = 0;
     }
@@ -259,6 +281,85 @@ Timer::getActualFrameRate() const
     return _actualFrameRate;
 }
 
+void
+Timer::resetTiming()
+{
+    gettimeofday (&_lastFrameTime, 0);
+    _timingError = 0;
+    _lastFpsFrameTime = _lastFrameTime;
+    _framesSinceLastFpsFrame = 0;
+
+    QMutexLocker l(&_mutex);
+    _droppedFrames = 0;
+    _latencies.clear();
+    _latencyIndex = 0;
+}
+
+bool
+Timer::isNextFrameLate() const
+{
+    double spf;
+    {
+        QMutexLocker l(&_mutex);
+        spf = _spf;
+    }
+    timeval now;
+    gettimeofday (&now, 0);
+
+    double timeSinceLastFrame =  now.tv_sec  - _lastFrameTime.tv_sec +
+                                (now.tv_usec - _lastFrameTime.tv_usec) * 1e-6f;
+
+    // Same computation as the time to sleep in waitUntilNextFrameIsDue()
+    return spf - timeSinceLastFrame - _timingError <= -spf;
+}
+
+void
+Timer::dropNextFrame()
+{
+    double spf;
+    {
+        QMutexLocker l(&_mutex);
+        spf = _spf;
+        ++_droppedFrames;
+    }
+
+    // Move the last frame time by one frame duration, as if the dropped frame was displayed on time
+    long usec = _lastFrameTime.tv_usec + (long)(spf * 1e6);
+    _lastFrameTime.tv_sec += usec / 1000000;
+    _lastFrameTime.tv_usec = usec % 1000000;
+}
+
+int
+Timer::getDroppedFrames() const
+{
+    QMutexLocker l(&_mutex);
+
+    return _droppedFrames;
+}
+
+double
+Timer::getFrameLatencyPercentile(double percentile) const
+{
+    QMutexLocker l(&_mutex);
+
+    return getFrameLatencyPercentile_locked(percentile);
+}
+
+double
+Timer::getFrameLatencyPercentile_locked(double percentile) const
+{
+    assert( !_mutex.tryLock() );
+    if ( _latencies.empty() ) {
+        return 0.;
+    }
+    percentile = std::max( 0., std::min(100., percentile) );
+    std::vector<double> sorted = _latencies;
+    std::size_t n = (std::size_t)std::floor( percentile / 100. * (sorted.size() - 1) + 0.5 );
+    std::nth_element( sorted.begin(), sorted.begin() + n, sorted.end() );
+
+    return sorted[n];
+}
+
 void
 Timer::setDesiredFrameRate (double fps)
 {
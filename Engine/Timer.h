@@ -40,6 +40,8 @@
 #endif
 
 
+#include <vector>
+
 #include <QtCore/QString>
 #include <QtCore/QObject>
 #include <QtCore/QMutex>
@@ -97,6 +99,37 @@ public:
 
     double getActualFrameRate() const;
 
+    //--------------------------------------------------------
+    // Frame pacing: the display thread may skip a frame that
+    // is due since more than one frame duration instead of
+    // displaying it late, so that the playback keeps the
+    // desired cadence.
+    // The statistics are reset by resetTiming().
+    //--------------------------------------------------------
+
+    /**
+     * @brief Reset all timing state variables, e.g. when the playback starts
+     **/
+    void resetTiming();
+
+    /**
+     * @brief Returns true if the next frame should have been displayed more than one frame duration ago
+     **/
+    bool isNextFrameLate() const;
+
+    /**
+     * @brief Skip the next frame: it is not displayed but the cadence is kept as if it were
+     **/
+    void dropNextFrame();
+
+    int getDroppedFrames() const;
+
+    /**
+     * @brief Returns the latency of the recently displayed frames at the given percentile (in [0, 100]),
+     * i.e the time in seconds elapsed between the moment each frame was due and the moment it was displayed.
+     **/
+    double getFrameLatencyPercentile(double percentile) const;
+
     //-------------------
     // Current play state
     //-------------------
@@ -108,8 +141,12 @@ Q_SIGNALS:
 
     void fpsChanged(double actualfps, double desiredfps);
 
+    void playbackStatsChanged(int droppedFrames, double latencyMedian, double latency95);
+
 private:
 
+    double getFrameLatencyPercentile_locked(double percentile) const;
+
     double _spf;                 // desired frame rate,
     // in seconds per frame
     timeval _lastFrameTime;         // time when we displayed the
@@ -118,7 +155,10 @@ private:
     timeval _lastFpsFrameTime;      // state to keep track of the
     int _framesSinceLastFpsFrame;       // actual frame rate, averaged
     double _actualFrameRate;         // over several frames
-    mutable QMutex _mutex; //< protects _spf and _actualFrameRate
+    int _droppedFrames;              // frames skipped by dropNextFrame()
+    std::vector<double> _latencies;  // latency of the last displayed frames
+    std::size_t _latencyIndex;       // next sample to overwrite in _latencies
+    mutable QMutex _mutex; //< protects _spf, _actualFrameRate and the frame pacing statistics
 };
 
 
@@ -59,10 +59,16 @@ public:
         bool isCached;
         unsigned char* ramBuffer; // a pointer to the RAM buffer held either by the cached frame or allocated by malloc()
         std::size_t bytesCount; // number of bytes in the texture
+        // If the cached frame is compressed, the texture is expanded in this buffer and ramBuffer points to it
+        boost::shared_ptr<unsigned char> decompressedBuffer;
+        // The range of the values converted in the texture, computed by the conversion when the auto-contrast is enabled
+        bool autoContrastRangeSet;
+        double autoContrastMin, autoContrastMax;
 
 
         CachedTile()
-            : rect(), rectRounded(), cachedData(), isCached(false), ramBuffer(0), bytesCount(0) {}
+            : rect(), rectRounded(), cachedData(), isCached(false), ramBuffer(0), bytesCount(0), decompressedBuffer()
+            , autoContrastRangeSet(false), autoContrastMin(0.), autoContrastMax(0.) {}
     };
 
     UpdateViewerParams()
@@ -72,6 +78,7 @@ public:
         , view(0)
         , srcPremult(eImagePremultiplicationOpaque)
         , depth()
+        , displayChannelsInShader(false)
         , gain(1.)
         , gamma(1.)
         , offset(0.)
@@ -83,6 +90,7 @@ public:
         , tiles()
         , tileSize(0)
         , nbCachedTile(0)
+        , flipbookBuffer()
         , colorImage()
         , rod()
         , pixelAspectRatio(1.)
@@ -98,8 +106,9 @@ public:
     virtual ~UpdateViewerParams()
     {
         if (mustFreeRamBuffer) {
-            assert(tiles.size() == 1);
-            free(tiles.front().ramBuffer);
+            for (std::list<CachedTile>::iterator it = tiles.begin(); it != tiles.end(); ++it) {
+                free(it->ramBuffer);
+            }
         }
     }
 
@@ -114,12 +123,13 @@ public:
         return ret;
     }
 
-    bool mustFreeRamBuffer; // set to true when !cachedFrame, in this case we have only 1 tile
+    bool mustFreeRamBuffer; // set to true when !cachedFrame, in this case the tiles buffers were allocated by malloc()
     int textureIndex; // The texture index (for input A or B)
     int time; // the frame
     ViewIdx view; // the view
     ImagePremultiplicationEnum srcPremult; // the image premult
     ImageBitDepthEnum depth; // bitdepth of the texture
+    bool displayChannelsInShader; // the texture holds the unconverted layer, the display channels are selected by the viewer shader
     double gain; // viewer gain
     double gamma; // viewer gamma
     double offset; // viewer offset
@@ -132,6 +142,10 @@ public:
     int tileSize;
     int nbCachedTile;
 
+    // If set, the tiles ramBuffer point into this buffer owned by the viewer flipbook cache.
+    // Hold it so that it is not released before the end of updateViewer()
+    boost::shared_ptr<unsigned char> flipbookBuffer;
+
     // The image which was used to make the texture
     ImagePtr colorImage;
 
@@ -0,0 +1,297 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "ViewerFlipbookCache.h"
+
+#include <map>
+#include <list>
+#include <cstdlib> // malloc, free
+#include <cstring> // memcpy
+#include <cassert>
+#include <stdexcept>
+
+#include <boost/make_shared.hpp>
+
+#include <QtCore/QMutex>
+
+#include "Engine/UpdateViewerParams.h"
+
+NATRON_NAMESPACE_ENTER
+
+namespace {
+struct FlipbookFrameKey
+{
+    int time;
+    ViewIdx view;
+
+    bool operator<(const FlipbookFrameKey& other) const
+    {
+        if (time != other.time) {
+            return time < other.time;
+        }
+
+        return view < other.view;
+    }
+};
+
+struct FlipbookFrame
+{
+    // The textures of the frame, their tiles point into buffer
+    std::list<UpdateViewerParamsPtr> params;
+    boost::shared_ptr<unsigned char> buffer;
+    std::size_t size;
+};
+
+typedef std::map<FlipbookFrameKey, FlipbookFrame> FlipbookFrameMap;
+}
+
+struct ViewerFlipbookCache::Implementation
+{
+    mutable QMutex lock;
+    FlipbookFrameMap frames;
+
+    // The frames in the order they were inserted, the front is released first
+    std::list<FlipbookFrameKey> insertionOrder;
+    std::size_t size;
+
+    // The state of the viewer the stored frames were rendered with
+    DisplayState state;
+
+    Implementation()
+        : lock()
+        , frames()
+        , insertionOrder()
+        , size(0)
+        , state()
+    {
+    }
+
+    void clear()
+    {
+        frames.clear();
+        insertionOrder.clear();
+        size = 0;
+    }
+};
+
+ViewerFlipbookCache::DisplayState::DisplayState()
+    : viewerHash(0)
+    , compositingOperator(eViewerCompositingOperatorNone)
+    , zoomFactor(1.)
+    , mipMapLevel(0)
+    , fullFrameProcessing(false)
+    , draftMode(false)
+    , depth(eImageBitDepthByte)
+    , gain(1.)
+    , gamma(1.)
+    , lut(eViewerColorSpaceSRGB)
+    , layer()
+    , alphaLayer()
+    , alphaChannelName()
+{
+    for (int i = 0; i < 2; ++i) {
+        activeInputs[i] = -1;
+        channels[i] = eDisplayChannelsRGB;
+    }
+}
+
+bool
+ViewerFlipbookCache::DisplayState::operator==(const DisplayState& other) const
+{
+    return viewerHash == other.viewerHash &&
+           activeInputs[0] == other.activeInputs[0] &&
+           activeInputs[1] == other.activeInputs[1] &&
+           compositingOperator == other.compositingOperator &&
+           zoomFactor == other.zoomFactor &&
+           mipMapLevel == other.mipMapLevel &&
+           fullFrameProcessing == other.fullFrameProcessing &&
+           draftMode == other.draftMode &&
+           depth == other.depth &&
+           gain == other.gain &&
+           gamma == other.gamma &&
+           lut == other.lut &&
+           channels[0] == other.channels[0] &&
+           channels[1] == other.channels[1] &&
+           layer == other.layer &&
+           alphaLayer == other.alphaLayer &&
+           alphaChannelName == other.alphaChannelName;
+}
+
+ViewerFlipbookCache::ViewerFlipbookCache()
+    : _imp( new Implementation() )
+{
+}
+
+ViewerFlipbookCache::~ViewerFlipbookCache()
+{
+}
+
+bool
+ViewerFlipbookCache::getFrame(int time,
+                              ViewIdx view,
+                              const DisplayState& state,
+                              BufferableObjectPtrList* frames) const
+{
+    QMutexLocker k(&_imp->lock);
+
+    if ( _imp->frames.empty() || (state != _imp->state) ) {
+        return false;
+    }
+
+    FlipbookFrameKey key;
+    key.time = time;
+    key.view = view;
+    FlipbookFrameMap::const_iterator found = _imp->frames.find(key);
+    if ( found == _imp->frames.end() ) {
+        return false;
+    }
+
+    for (std::list<UpdateViewerParamsPtr>::const_iterator it = found->second.params.begin(); it != found->second.params.end(); ++it) {
+        // Copy the stored params: the caller sets its own render age and the copy does not own the buffer
+        UpdateViewerParamsPtr params = boost::make_shared<UpdateViewerParams>(**it);
+        params->flipbookBuffer = found->second.buffer;
+        frames->push_back(params);
+    }
+
+    return true;
+}
+
+void
+ViewerFlipbookCache::insertFrame(int time,
+                                 ViewIdx view,
+                                 const DisplayState& state,
+                                 const BufferableObjectPtrList& frames,
+                                 std::size_t maximumSize)
+{
+    if ( frames.empty() ) {
+        return;
+    }
+
+    // Only store complete frames
+    std::size_t frameSize = 0;
+    for (BufferableObjectPtrList::const_iterator it = frames.begin(); it != frames.end(); ++it) {
+        UpdateViewerParams* params = dynamic_cast<UpdateViewerParams*>( it->get() );
+        if ( !params || params->isViewerPaused || params->isPartialRect || params->tiles.empty() ) {
+            return;
+        }
+        // Make sure the frame was produced with the state it will be looked-up with
+        if ( (params->gain != state.gain) || (params->gamma != state.gamma) || (params->lut != state.lut) ||
+             (params->depth != state.depth) || !(params->layer == state.layer) ) {
+            return;
+        }
+        for (std::list<UpdateViewerParams::CachedTile>::const_iterator it2 = params->tiles.begin(); it2 != params->tiles.end(); ++it2) {
+            if (!it2->ramBuffer) {
+                return;
+            }
+            frameSize += it2->bytesCount;
+        }
+    }
+
+    if ( (frameSize == 0) || (frameSize > maximumSize) ) {
+        return;
+    }
+
+    FlipbookFrameKey key;
+    key.time = time;
+    key.view = view;
+
+    {
+        QMutexLocker k(&_imp->lock);
+        if (state != _imp->state) {
+            // The viewer state changed, the stored frames can no longer be displayed
+            _imp->clear();
+            _imp->state = state;
+        } else if ( _imp->frames.find(key) != _imp->frames.end() ) {
+            return;
+        }
+    }
+
+    // Copy the textures outside of the lock
+    FlipbookFrame frame;
+    frame.size = frameSize;
+    frame.buffer.reset( (unsigned char*)malloc(frameSize), free );
+    if (!frame.buffer) {
+        return;
+    }
+
+    unsigned char* dst = frame.buffer.get();
+    for (BufferableObjectPtrList::const_iterator it = frames.begin(); it != frames.end(); ++it) {
+        const UpdateViewerParams* params = dynamic_cast<const UpdateViewerParams*>( it->get() );
+        assert(params);
+        UpdateViewerParamsPtr stored = boost::make_shared<UpdateViewerParams>(*params);
+        stored->mustFreeRamBuffer = false;
+        stored->nbCachedTile = (int)stored->tiles.size();
+        stored->abortInfo.reset();
+        // Do not keep the full image alive, the flipbook only holds the textures
+        stored->colorImage.reset();
+        for (std::list<UpdateViewerParams::CachedTile>::iterator it2 = stored->tiles.begin(); it2 != stored->tiles.end(); ++it2) {
+            std::memcpy(dst, it2->ramBuffer, it2->bytesCount);
+            it2->ramBuffer = dst;
+            it2->cachedData.reset();
+            it2->decompressedBuffer.reset();
+            it2->isCached = true;
+            dst += it2->bytesCount;
+        }
+        frame.params.push_back(stored);
+    }
+
+    QMutexLocker k(&_imp->lock);
+    if ( (state != _imp->state) || ( _imp->frames.find(key) != _imp->frames.end() ) ) {
+        // Another thread changed the cache meanwhile
+        return;
+    }
+
+    // Release the oldest frames
+    while ( !_imp->insertionOrder.empty() && (_imp->size + frameSize > maximumSize) ) {
+        FlipbookFrameMap::iterator found = _imp->frames.find( _imp->insertionOrder.front() );
+        assert( found != _imp->frames.end() );
+        if ( found != _imp->frames.end() ) {
+            _imp->size -= found->second.size;
+            _imp->frames.erase(found);
+        }
+        _imp->insertionOrder.pop_front();
+    }
+
+    _imp->frames.insert( std::make_pair(key, frame) );
+    _imp->insertionOrder.push_back(key);
+    _imp->size += frameSize;
+} // ViewerFlipbookCache::insertFrame
+
+void
+ViewerFlipbookCache::clear()
+{
+    QMutexLocker k(&_imp->lock);
+
+    _imp->clear();
+}
+
+bool
+ViewerFlipbookCache::isEmpty() const
+{
+    QMutexLocker k(&_imp->lock);
+
+    return _imp->frames.empty();
+}
+
+NATRON_NAMESPACE_EXIT
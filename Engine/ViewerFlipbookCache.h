@@ -0,0 +1,118 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef Natron_Engine_ViewerFlipbookCache_h
+#define Natron_Engine_ViewerFlipbookCache_h
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#include <string>
+#include <cstddef>
+
+#if !defined(Q_MOC_RUN) && !defined(SBK_RUN)
+#include <boost/scoped_ptr.hpp>
+#endif
+
+#include "Global/Enums.h"
+#include "Global/GlobalDefines.h"
+
+#include "Engine/BufferableObject.h"
+#include "Engine/ImagePlaneDesc.h"
+#include "Engine/ViewIdx.h"
+#include "Engine/EngineFwd.h"
+
+NATRON_NAMESPACE_ENTER
+
+/**
+ * @brief A RAM-only cache of the display-ready textures of the frames played back by a viewer.
+ * Each frame is stored in a single contiguous buffer, ready to be uploaded to the GPU, so that
+ * looping over a range that was already played does not go through the render tree, the viewer
+ * cache nor the texture conversion.
+ * The oldest frames are released first when the cache grows over its maximum size.
+ **/
+class ViewerFlipbookCache
+{
+public:
+
+    /**
+     * @brief The state of the viewer the textures depend on. A frame is only returned by the cache
+     * if it was stored with the same state.
+     **/
+    struct DisplayState
+    {
+        U64 viewerHash;
+        int activeInputs[2];
+        ViewerCompositingOperatorEnum compositingOperator;
+        double zoomFactor;
+        unsigned int mipMapLevel;
+        bool fullFrameProcessing;
+        bool draftMode;
+        ImageBitDepthEnum depth;
+        double gain;
+        double gamma;
+        ViewerColorSpaceEnum lut;
+        DisplayChannelsEnum channels[2];
+        ImagePlaneDesc layer;
+        ImagePlaneDesc alphaLayer;
+        std::string alphaChannelName;
+
+        DisplayState();
+
+        bool operator==(const DisplayState& other) const;
+
+        bool operator!=(const DisplayState& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    ViewerFlipbookCache();
+
+    ~ViewerFlipbookCache();
+
+    /**
+     * @brief Returns true if the textures of the given frame were stored with the given state, in which case
+     * they are appended to frames. The returned UpdateViewerParams share the buffer held by the cache.
+     **/
+    bool getFrame(int time, ViewIdx view, const DisplayState& state, BufferableObjectPtrList* frames) const;
+
+    /**
+     * @brief Stores a copy of the textures of the given frame, as produced for the viewer with the given state.
+     * Frames stored with another state are released. Nothing is stored if one of the textures is incomplete.
+     **/
+    void insertFrame(int time, ViewIdx view, const DisplayState& state, const BufferableObjectPtrList& frames, std::size_t maximumSize);
+
+    void clear();
+
+    bool isEmpty() const;
+
+private:
+
+    struct Implementation;
+    boost::scoped_ptr<Implementation> _imp;
+};
+
+NATRON_NAMESPACE_EXIT
+
+#endif // Natron_Engine_ViewerFlipbookCache_h
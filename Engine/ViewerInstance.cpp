@@ -30,6 +30,18 @@
 #include <cassert>
 #include <cstring> // for std::memcpy
 #include <cfloat> // DBL_MAX
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <emmintrin.h> // SSE2
+#define NATRON_VIEWER_SCALE_TO_TEXTURE_SSE2
+#if defined(__GNUC__) && !defined(__SSE2__)
+// The SSE2 kernels are built even if the rest of the file is not, they are only called if the CPU supports SSE2
+#define NATRON_VIEWER_SSE2_TARGET __attribute__( ( target("sse2") ) )
+#else
+#define NATRON_VIEWER_SSE2_TARGET
+#endif
+#endif
 
 #include <boost/shared_ptr.hpp>
 #include <boost/scoped_ptr.hpp>
@@ -79,6 +91,9 @@ CLANG_DIAG_ON(deprecated)
 
 #define NATRON_TIME_ELASPED_BEFORE_PROGRESS_REPORT 4. //!< do not display the progress report if estimated total time is less than this (in seconds)
 
+// The size (in pixels) of the tiles for which the auto-contrast statistics are computed and kept
+#define NATRON_AUTO_CONTRAST_TILE_SIZE 256
+
 NATRON_NAMESPACE_ENTER
 
 using std::make_pair;
@@ -111,15 +126,24 @@ static void scaleToTexture8bits(const RectI& roi,
                                 U32* output);
 static void scaleToTexture32bits(const RectI& roi,
                                  const RenderViewerArgs & args,
-                                 const UpdateViewerParams::CachedTile& tile,
+                                 UpdateViewerParams::CachedTile& tile,
                                  float *output);
 static MinMaxVal findAutoContrastVminVmax(const ImagePtr inputImage,
                                                          DisplayChannelsEnum channels,
                                                          const RectI & rect);
+static DisplayChannelsEnum getAutoContrastRangeChannels(bool displayChannelsInShader,
+                                                        DisplayChannelsEnum channels);
+static void accumulateAutoContrastRange(const float* rgba,
+                                        int width,
+                                        DisplayChannelsEnum channels,
+                                        MinMaxVal* range);
+static void setAutoContrastFromTextures(DisplayChannelsEnum rangeChannels,
+                                        const std::list<UpdateViewerParams::CachedTile>& convertedTiles,
+                                        UpdateViewerParams* params);
 static void renderFunctor(const RectI& roi,
                           const RenderViewerArgs & args,
                           ViewerInstance* viewer,
-                          UpdateViewerParams::CachedTile tile);
+                          UpdateViewerParams::CachedTile& tile);
 
 /**
  *@brief Actually converting to ARGB... but it is called BGRA by
@@ -180,6 +204,7 @@ ViewerInstance::ViewerInstance(NodePtr node)
     QObject::connect( this, SIGNAL(disconnectTextureRequest(int,bool)), this, SLOT(executeDisconnectTextureRequestOnMainThread(int,bool)) );
     QObject::connect( _imp.get(), SIGNAL(mustRedrawViewer()), this, SLOT(redrawViewer()) );
     QObject::connect( this, SIGNAL(s_callRedrawOnMainThread()), this, SLOT(redrawViewer()) );
+    QObject::connect( _imp.get(), SIGNAL(mustUpdateViewerTiles(BufferableObjectPtrList)), _imp.get(), SLOT(updateViewerTiles(BufferableObjectPtrList)) );
 }
 
 ViewerInstance::~ViewerInstance()
@@ -250,6 +275,7 @@ ViewerInstance::clearLastRenderedImage()
         _imp->lastRenderParams[0].reset();
         _imp->lastRenderParams[1].reset();
     }
+    _imp->flipbook.clear();
 }
 
 void
@@ -446,7 +472,7 @@ ViewerInstance::getViewerArgsAndRenderViewer(SequenceTime time,
             break;
         }
 
-        AbortableRenderInfoPtr abortInfo = _imp->createNewRenderRequest(i, canAbort);
+        AbortableRenderInfoPtr abortInfo = _imp->createNewRenderRequest(i, false, canAbort);
 
 
         /*FrameRequestMap request;
@@ -745,6 +771,37 @@ checkTreeCanRender(Node* node)
     return ret;
 }
 
+/**
+ * @brief Returns the bit depth with which a texture of the given depth is stored in the viewer cache:
+ * 32-bit floating point textures are stored as half-floats if the viewer cache tiles are compressed.
+ **/
+static ImageBitDepthEnum
+getTextureCacheBitDepth(ImageBitDepthEnum textureDepth)
+{
+    if ( (textureDepth == eImageBitDepthFloat) && appPTR->getCurrentSettings()->isViewerCacheTilesCompressionEnabled() ) {
+        return eImageBitDepthHalf;
+    }
+
+    return textureDepth;
+}
+
+/**
+ * @brief Expands the compressed texture held by the cache entry of the tile to a buffer owned by the tile.
+ **/
+static bool
+decompressCachedTile(UpdateViewerParams::CachedTile* tile)
+{
+    assert( tile->cachedData && tile->cachedData->isCompressed() );
+    tile->decompressedBuffer.reset( (unsigned char*)malloc(tile->bytesCount), free );
+    if (!tile->decompressedBuffer) {
+        return false;
+    }
+    tile->cachedData->decompress( (float*)tile->decompressedBuffer.get() );
+    tile->ramBuffer = tile->decompressedBuffer.get();
+
+    return true;
+}
+
 static unsigned char*
 getTexPixel(int x,
             int y,
@@ -819,7 +876,8 @@ ViewerInstance::getRenderViewerArgsAndCheckCache_public(SequenceTime time,
                                                         const RenderStatsPtr& stats,
                                                         ViewerArgs* outArgs)
 {
-    AbortableRenderInfoPtr abortInfo = _imp->createNewRenderRequest(textureIndex, canAbort);
+    AbortableRenderInfoPtr abortInfo = _imp->createNewRenderRequest(textureIndex, isSequential, canAbort);
+    abortInfo->setPriority(isSequential ? eRenderPriorityPlayback : eRenderPriorityInteractive);
     ViewerRenderRetCode stat = getRenderViewerArgsAndCheckCache(time, isSequential, view, textureIndex, viewerHash, rotoPaintNode, abortInfo, stats, outArgs);
 
     if ( (stat == eViewerRenderRetCodeFail) || (stat == eViewerRenderRetCodeBlack) ) {
@@ -829,6 +887,107 @@ ViewerInstance::getRenderViewerArgsAndCheckCache_public(SequenceTime time,
     return stat;
 }
 
+bool
+ViewerInstance::ViewerInstancePrivate::getFlipbookDisplayState(U64 viewerHash,
+                                                               ViewerFlipbookCache::DisplayState* state) const
+{
+    if (!uiContext) {
+        return false;
+    }
+    if ( instance->isViewerPaused(0) || instance->isViewerPaused(1) || uiContext->isUserRegionOfInterestEnabled() ) {
+        return false;
+    }
+
+    state->viewerHash = viewerHash;
+    instance->getActiveInputs(state->activeInputs[0], state->activeInputs[1]);
+    state->compositingOperator = uiContext->getCompositingOperator();
+    state->zoomFactor = uiContext->getZoomFactor();
+    state->fullFrameProcessing = instance->isFullFrameProcessingEnabled();
+    state->draftMode = instance->getApp()->isDraftRenderEnabled();
+    state->depth = uiContext->getBitDepth();
+
+    QMutexLocker k(&viewerParamsMutex);
+    // Auto-contrast and partial updates are never read from the viewer cache either
+    if (viewerParamsAutoContrast || isDoingPartialUpdates) {
+        return false;
+    }
+    state->mipMapLevel = viewerMipMapLevel;
+    state->gain = viewerParamsGain;
+    state->gamma = viewerParamsGamma;
+    state->lut = viewerParamsLut;
+    state->channels[0] = viewerParamsChannels[0];
+    state->channels[1] = viewerParamsChannels[1];
+    state->layer = viewerParamsLayer;
+    state->alphaLayer = viewerParamsAlphaLayer;
+    state->alphaChannelName = viewerParamsAlphaChannelName;
+
+    return true;
+}
+
+bool
+ViewerInstance::getFlipbookFrame(SequenceTime time,
+                                 ViewIdx view,
+                                 U64 viewerHash,
+                                 BufferableObjectPtrList* frames)
+{
+    if ( (appPTR->getCurrentSettings()->getViewerFlipbookCacheSize() == 0) || _imp->flipbook.isEmpty() ) {
+        return false;
+    }
+
+    ViewerFlipbookCache::DisplayState state;
+    if ( !_imp->getFlipbookDisplayState(viewerHash, &state) ) {
+        return false;
+    }
+
+    BufferableObjectPtrList storedFrames;
+    if ( !_imp->flipbook.getFrame(time, view, state, &storedFrames) ) {
+        return false;
+    }
+
+    for (BufferableObjectPtrList::iterator it = storedFrames.begin(); it != storedFrames.end(); ++it) {
+        UpdateViewerParamsPtr params = boost::dynamic_pointer_cast<UpdateViewerParams>(*it);
+        assert(params);
+
+        // The viewport may have been panned since the frame was stored
+        std::vector<RectI> tiles, tilesRounded;
+        int tileSize;
+        RectI roiNotRoundedToTileSize;
+        RectI roi = _imp->uiContext->getImageRectangleDisplayedRoundedToTileSize(params->textureIndex, params->rod, params->pixelAspectRatio, params->mipMapLevel, &tiles, &tilesRounded, &tileSize, &roiNotRoundedToTileSize);
+        if ( (roi != params->roi) || (roiNotRoundedToTileSize != params->roiNotRoundedToTileSize) ) {
+            return false;
+        }
+
+        params->abortInfo = _imp->createNewRenderRequest(params->textureIndex, true, true);
+        params->abortInfo->setPriority(eRenderPriorityPlayback);
+    }
+    frames->insert( frames->end(), storedFrames.begin(), storedFrames.end() );
+
+    return true;
+} // ViewerInstance::getFlipbookFrame
+
+void
+ViewerInstance::insertFlipbookFrame(SequenceTime time,
+                                    ViewIdx view,
+                                    U64 viewerHash,
+                                    const BufferableObjectPtrList& frames)
+{
+    U64 maximumSize = appPTR->getCurrentSettings()->getViewerFlipbookCacheSize();
+
+    if (maximumSize == 0) {
+        if ( !_imp->flipbook.isEmpty() ) {
+            _imp->flipbook.clear();
+        }
+
+        return;
+    }
+
+    ViewerFlipbookCache::DisplayState state;
+    if ( !_imp->getFlipbookDisplayState(viewerHash, &state) ) {
+        return;
+    }
+    _imp->flipbook.insertFrame(time, view, state, frames, (std::size_t)maximumSize);
+}
+
 void
 ViewerInstance::setupMinimalUpdateViewerParams(const SequenceTime time,
                                                const ViewIdx view,
@@ -867,10 +1026,11 @@ ViewerInstance::setupMinimalUpdateViewerParams(const SequenceTime time,
     }
     outArgs->mipMapLevelWithDraft = outArgs->mipmapLevelWithoutDraft;
 
-    outArgs->draftModeEnabled = getApp()->isDraftRenderEnabled();
+    // The coarse pass of a progressive render is a draft render at the auto-proxy level
+    outArgs->draftModeEnabled = getApp()->isDraftRenderEnabled() || outArgs->isProgressiveCoarsePass;
 
     // If draft mode is enabled, compute the mipmap level according to the auto-proxy setting in the preferences
-    if ( outArgs->draftModeEnabled && appPTR->getCurrentSettings()->isAutoProxyEnabled() ) {
+    if ( outArgs->draftModeEnabled && ( appPTR->getCurrentSettings()->isAutoProxyEnabled() || outArgs->isProgressiveCoarsePass ) ) {
         unsigned int autoProxyLevel = appPTR->getCurrentSettings()->getAutoProxyMipMapLevel();
         if (zoomFactor > 1) {
             //Decrease draft mode at each inverse mipmaplevel level taken
@@ -942,6 +1102,7 @@ ViewerInstance::setupMinimalUpdateViewerParams(const SequenceTime time,
         outArgs->params->alphaLayer = _imp->viewerParamsAlphaLayer;
         outArgs->params->alphaChannelName = _imp->viewerParamsAlphaChannelName;
         outArgs->isDoingPartialUpdates = _imp->isDoingPartialUpdates;
+        outArgs->params->displayChannelsInShader = _imp->canApplyDisplayChannelsInShader(outArgs->params->depth, outArgs->channels);
     }
 
     // Fill the gamma LUT if it has never been filled yet
@@ -1083,14 +1244,14 @@ ViewerInstance::getViewerRoIAndTexture(const RectD& rod,
                          outArgs->params->gain,
                          outArgs->params->gamma,
                          outArgs->params->lut,
-                         (int)outArgs->params->depth,
-                         outArgs->channels,
+                         (int)getTextureCacheBitDepth(outArgs->params->depth),
+                         outArgs->params->displayChannelsInShader ? eDisplayChannelsRGB : outArgs->channels,
                          outArgs->params->view,
                          it->rect,
                          mipmapLevel,
                          inputToRenderName,
                          outArgs->params->layer,
-                         outArgs->params->alphaLayer.getPlaneID() + outArgs->params->alphaChannelName,
+                         outArgs->params->displayChannelsInShader ? std::string() : outArgs->params->alphaLayer.getPlaneID() + outArgs->params->alphaChannelName,
                          outArgs->params->depth == eImageBitDepthFloat,
                          isDraftMode);
             std::list<FrameEntryPtr> entries;
@@ -1141,12 +1302,28 @@ ViewerInstance::getViewerRoIAndTexture(const RectD& rod,
 
                 // The data will be valid as long as the cachedFrame shared pointer use_count is gt 1
                 it->cachedData = foundCachedEntry;
+                if ( foundCachedEntry->isCompressed() ) {
+                    if ( !decompressCachedTile(&*it) ) {
+                        // Render the tile instead
+                        it->cachedData.reset();
+                        continue;
+                    }
+                } else {
+                    it->ramBuffer = foundCachedEntry->data();
+                }
                 it->isCached = true;
-                it->ramBuffer = foundCachedEntry->data();
                 assert(it->ramBuffer);
                 ++outArgs->params->nbCachedTile;
             }
         }
+
+        // Nothing will be converted, the auto-contrast is given by the range kept on the cached textures
+        if ( outArgs->autoContrast && (outArgs->params->depth == eImageBitDepthFloat) &&
+             ( outArgs->params->nbCachedTile == (int)outArgs->params->tiles.size() ) ) {
+            setAutoContrastFromTextures(getAutoContrastRangeChannels(outArgs->params->displayChannelsInShader, outArgs->channels),
+                                        std::list<UpdateViewerParams::CachedTile>(),
+                                        outArgs->params.get());
+        }
     }
 
 
@@ -1160,9 +1337,11 @@ ViewerInstance::getRoDAndLookupCache(const bool useOnlyRoDCache,
                                      const RenderStatsPtr& stats,
                                      ViewerArgs* outArgs)
 {
-    // We never use the texture cache when the user RoI is enabled or while painting or when auto-contrast is on, otherwise we would have
+    // We never use the texture cache when the user RoI is enabled or while painting, otherwise we would have
     // zillions of textures in the cache, each a few pixels different.
-    const bool useTextureCache = !outArgs->userRoIEnabled && !outArgs->autoContrast && !rotoPaintNode.get() && !outArgs->isDoingPartialUpdates;
+    // With auto-contrast, only the floating point textures, to which the shader applies the gain and offset, can be cached.
+    const bool useTextureCache = !outArgs->userRoIEnabled && ( !outArgs->autoContrast || (outArgs->params->depth == eImageBitDepthFloat) ) &&
+                                 !rotoPaintNode.get() && !outArgs->isDoingPartialUpdates;
 
     // If it's eSupportsMaybe and mipMapLevel!=0, don't forget to update
     // this after the first call to getRegionOfDefinition().
@@ -1298,6 +1477,60 @@ ViewerInstance::getRenderViewerArgsAndCheckCache(SequenceTime time,
     return getRoDAndLookupCache(true, viewerHash, rotoPaintNode, stats, outArgs);
 }
 
+static void
+getColorAndAlphaImages(const std::map<ImagePlaneDesc, ImagePtr>& planes,
+                       const ViewerArgs& inArgs,
+                       ImagePtr* colorImage,
+                       ImagePtr* alphaImage)
+{
+    //Either we have 2 planes (alpha mask and color image) or we have a single plane (color image)
+    if (planes.size() == 2) {
+        std::map<ImagePlaneDesc, ImagePtr>::const_iterator foundColorLayer = planes.find(inArgs.params->layer);
+        if ( foundColorLayer != planes.end() ) {
+            *colorImage = foundColorLayer->second;
+        }
+        std::map<ImagePlaneDesc, ImagePtr>::const_iterator foundAlphaLayer = planes.find(inArgs.params->alphaLayer);
+        if ( foundAlphaLayer != planes.end() ) {
+            *alphaImage = foundAlphaLayer->second;
+        }
+    } else {
+        //only 1 plane, figure out if the alpha layer is the same as the color layer
+        if (inArgs.params->alphaLayer == inArgs.params->layer) {
+            if (inArgs.channels == eDisplayChannelsMatte) {
+                *alphaImage = *colorImage = planes.begin()->second;
+            } else {
+                *colorImage = planes.begin()->second;
+            }
+        } else {
+            *colorImage = planes.begin()->second;
+        }
+    }
+}
+
+/**
+ * @brief Copies in the given tile the texture converted by renderTilesCenterOut() for the same tile, if any.
+ **/
+static bool
+copyTileConvertedAhead(const BufferableObjectPtrList& convertedTiles,
+                       const UpdateViewerParams::CachedTile& tile)
+{
+    for (BufferableObjectPtrList::const_iterator it = convertedTiles.begin(); it != convertedTiles.end(); ++it) {
+        const UpdateViewerParams* params = dynamic_cast<const UpdateViewerParams*>( it->get() );
+        if (!params) {
+            continue;
+        }
+        for (std::list<UpdateViewerParams::CachedTile>::const_iterator it2 = params->tiles.begin(); it2 != params->tiles.end(); ++it2) {
+            if ( it2->ramBuffer && (it2->rect == tile.rect) && (it2->bytesCount == tile.bytesCount) ) {
+                std::memcpy(tile.ramBuffer, it2->ramBuffer, tile.bytesCount);
+
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 ViewerInstance::ViewerRenderRetCode
 ViewerInstance::renderViewer_internal(ViewIdx view,
                                       bool singleThreaded,
@@ -1384,7 +1617,8 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
      * 3) Single frame non-abortable render: the canAbort flag is set to false and the isSequentialRender flag is set to false.
      */
 
-    const bool useTextureCache = !inArgs.forceRender && !inArgs.userRoIEnabled && !inArgs.autoContrast && rotoPaintNode.get() == 0 && !inArgs.isDoingPartialUpdates;
+    const bool useTextureCache = !inArgs.forceRender && !inArgs.userRoIEnabled && ( !inArgs.autoContrast || (inArgs.params->depth == eImageBitDepthFloat) ) &&
+                                 rotoPaintNode.get() == 0 && !inArgs.isDoingPartialUpdates;
     RectI roi = inArgs.params->roi;
 
     // We might already have some tiles cached, get their bounding box to see if it is less than the actual RoI
@@ -1422,11 +1656,11 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
     EffectInstance::NotifyRenderingStarted_RAII renderingNotifier( getNode().get() );
 
 
+    FrameRequestMap requestPassData;
     if (useTLS) {
         RectD canonicalRoi;
         roi.toCanonical(inArgs.params->mipMapLevel, inArgs.params->pixelAspectRatio, inArgs.params->rod, &canonicalRoi);
 
-        FrameRequestMap requestPassData;
         StatusEnum stat = EffectInstance::computeRequestPass(inArgs.params->time, view, inArgs.params->mipMapLevel, canonicalRoi, getNode(), requestPassData);
         if (stat == eStatusFailed) {
             return eViewerRenderRetCodeFail;
@@ -1526,6 +1760,23 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
         stats->setGlobalRenderInfosForNode(getNode(), inArgs.params->rod, inArgs.params->srcPremult, channelsRendered, true, true, inArgs.params->mipMapLevel);
     }
 
+    // On single frame renders, render the tiles from the center of the viewport outwards and display them
+    // as soon as they are ready. The remaining of the frame is then rendered below.
+    // The textures of the tiles converted ahead are copied to the cache instead of being converted again,
+    // unless auto-contrast changes the gain afterwards.
+    // A forced render bypasses the cache, which the rings rely on to not render the same tiles again.
+    // With auto-contrast the gain depends on the whole frame, the rings would be displayed with the wrong one.
+    BufferableObjectPtrList centerOutTiles;
+    if ( useTLS && useTextureCache && !inArgs.autoContrast && !isSequentialRender && !inArgs.isProgressiveCoarsePass && !inArgs.forceRender ) {
+        ViewerRenderRetCode retCode = renderTilesCenterOut(view, singleThreaded, frameArgs.get(), roi, requestedComponents, imageDepth, alphaChannelIndex, inArgs, &centerOutTiles);
+
+        // The rings rendered with the request pass of their own area: restore the one of the whole RoI
+        frameArgs->updateNodesRequest(requestPassData);
+        if (retCode != eViewerRenderRetCodeRender) {
+            return retCode;
+        }
+    }
+
 #pragma message WARN("Implement Viewer so it accepts OpenGL Textures in input")
     BufferableObjectPtrList partialUpdateObjects;
     for (std::size_t rectIndex = 0; rectIndex < splitRoi.size(); ++rectIndex) {
@@ -1559,27 +1810,7 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
             //Either rendering failed or we have 2 planes (alpha mask and color image) or we have a single plane (color image)
             assert(planes.size() == 0 || planes.size() <= 2);
             if ( !planes.empty() && (retCode == EffectInstance::eRenderRoIRetCodeOk) ) {
-                if (planes.size() == 2) {
-                    std::map<ImagePlaneDesc, ImagePtr>::iterator foundColorLayer = planes.find(inArgs.params->layer);
-                    if ( foundColorLayer != planes.end() ) {
-                        colorImage = foundColorLayer->second;
-                    }
-                    std::map<ImagePlaneDesc, ImagePtr>::iterator foundAlphaLayer = planes.find(inArgs.params->alphaLayer);
-                    if ( foundAlphaLayer != planes.end() ) {
-                        alphaImage = foundAlphaLayer->second;
-                    }
-                } else {
-                    //only 1 plane, figure out if the alpha layer is the same as the color layer
-                    if (inArgs.params->alphaLayer == inArgs.params->layer) {
-                        if (inArgs.channels == eDisplayChannelsMatte) {
-                            alphaImage = colorImage = planes.begin()->second;
-                        } else {
-                            colorImage = planes.begin()->second;
-                        }
-                    } else {
-                        colorImage = planes.begin()->second;
-                    }
-                }
+                getColorAndAlphaImages(planes, inArgs, &colorImage, &alphaImage);
                 assert(colorImage);
                 inArgs.params->colorImage = colorImage;
             }
@@ -1784,14 +2015,14 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
                                  inArgs.params->gain,
                                  inArgs.params->gamma,
                                  inArgs.params->lut,
-                                 (int)inArgs.params->depth,
-                                 inArgs.channels,
+                                 (int)getTextureCacheBitDepth(inArgs.params->depth),
+                                 inArgs.params->displayChannelsInShader ? eDisplayChannelsRGB : inArgs.channels,
                                  inArgs.params->view,
                                  it->rect,
                                  inArgs.params->mipMapLevel,
                                  inputToRenderName,
                                  inArgs.params->layer,
-                                 inArgs.params->alphaLayer.getPlaneID() + inArgs.params->alphaChannelName,
+                                 inArgs.params->displayChannelsInShader ? std::string() : inArgs.params->alphaLayer.getPlaneID() + inArgs.params->alphaChannelName,
                                  inArgs.params->depth == eImageBitDepthFloat,
                                  inArgs.draftModeEnabled);
 
@@ -1813,7 +2044,13 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
                     } else {
                         // If the tile is cached and we got it that means rendering is done
                         entryLocker.lock(it->cachedData);
-                        it->ramBuffer = it->cachedData->data();
+                        if ( it->cachedData->isCompressed() ) {
+                            if ( !decompressCachedTile(&*it) ) {
+                                return eViewerRenderRetCodeFail;
+                            }
+                        } else {
+                            it->ramBuffer = it->cachedData->data();
+                        }
                         it->isCached = true;
                         continue;
                     }
@@ -1825,9 +2062,27 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
                     ///Since it is used during the whole function scope it is guaranteed not to be freed before
                     ///The viewer is actually done with it.
                     /// @see Cache::clearInMemoryPortion and Cache::clearDiskPortion and LRUHashTable::evict
-                    it->ramBuffer = it->cachedData->data();
+                    if ( it->cachedData->isCompressed() ) {
+                        // Convert to a 32-bit buffer, the entry is compressed from it once the conversion is done
+                        it->decompressedBuffer.reset( (unsigned char*)malloc(it->bytesCount), free );
+                        it->ramBuffer = it->decompressedBuffer.get();
+                        if (!it->ramBuffer) {
+                            // Do not leave an empty entry in the cache
+                            appPTR->removeFromViewerCache(it->cachedData);
+
+                            return eViewerRenderRetCodeFail;
+                        }
+                    } else {
+                        it->ramBuffer = it->cachedData->data();
+                    }
                     assert(it->ramBuffer);
-                    unCachedTiles.push_back(*it);
+                    if ( !inArgs.autoContrast && copyTileConvertedAhead(centerOutTiles, *it) ) {
+                        if (it->decompressedBuffer) {
+                            it->cachedData->compress( (const float*)it->ramBuffer );
+                        }
+                    } else {
+                        unCachedTiles.push_back(*it);
+                    }
                 } // !it->isCached
 
                 if (it->cachedData) {
@@ -1852,6 +2107,17 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
             viewerRenderTimeRecorder = boost::make_shared<TimeLapse>();
         }
 
+        // When the display channels are selected by the viewer shader, the texture holds the layer unconverted
+        const bool displayChannelsInShader = inArgs.params->displayChannelsInShader;
+        const DisplayChannelsEnum textureChannels = displayChannelsInShader ? eDisplayChannelsRGB : inArgs.channels;
+        const ImagePtr matteImage = displayChannelsInShader ? ImagePtr() : alphaImage;
+        const int textureAlphaChannelIndex = displayChannelsInShader ? -1 : alphaChannelIndex;
+
+        // The gain and offset of floating point textures are applied by the shader: their auto-contrast range is
+        // computed while converting them. 8-bit textures have the gain baked in, the image must be scanned first.
+        const bool autoContrastFromTextures = inArgs.autoContrast && !inArgs.isDoingPartialUpdates && (updateParams->depth == eImageBitDepthFloat);
+        const DisplayChannelsEnum autoContrastChannels = getAutoContrastRangeChannels(displayChannelsInShader, inArgs.channels);
+
         std::size_t tileRowElements = inArgs.params->tileSize;
         // Internally the buffer is interpreted as U32 when 8bit, so we do not multiply it by 4 for RGBA
         if (updateParams->depth == eImageBitDepthFloat) {
@@ -1859,11 +2125,11 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
         }
 
         if (singleThreaded) {
-            if (inArgs.autoContrast && !inArgs.isDoingPartialUpdates) {
+            if (inArgs.autoContrast && !inArgs.isDoingPartialUpdates && !autoContrastFromTextures) {
                 double vmin, vmax;
-                MinMaxVal vMinMax = findAutoContrastVminVmax(colorImage, inArgs.channels, viewerRenderRoI);
-                vmin = vMinMax.min;
-                vmax = vMinMax.max;
+                // The image is modified in place while painting, its statistics cannot be kept
+                _imp->findAutoContrastVminVmaxFromTiles(updateParams->textureIndex, colorImage, inArgs.channels, viewerRenderRoI,
+                                                        !rotoPaintNode, false, &vmin, &vmax);
 
                 ///if vmax - vmin is greater than 1 the gain will be really small and we won't see
                 ///anything in the image
@@ -1875,8 +2141,8 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
             }
 
             const RenderViewerArgs args(colorImage,
-                                        alphaImage,
-                                        inArgs.channels,
+                                        matteImage,
+                                        textureChannels,
                                         updateParams->srcPremult,
                                         updateParams->depth,
                                         updateParams->gain,
@@ -1884,9 +2150,11 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
                                         updateParams->offset,
                                         lutFromColorspace(srcColorSpace),
                                         lutFromColorspace(updateParams->lut),
-                                        alphaChannelIndex,
+                                        textureAlphaChannelIndex,
                                         viewerRenderRoiOnly,
-                                        tileRowElements);
+                                        tileRowElements,
+                                        autoContrastFromTextures,
+                                        autoContrastChannels);
             QReadLocker k(&_imp->gammaLookupMutex);
             for (std::list<UpdateViewerParams::CachedTile>::iterator it = unCachedTiles.begin(); it != unCachedTiles.end(); ++it) {
                 renderFunctor(viewerRenderRoI,
@@ -1902,32 +2170,11 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
 
 
             ///if autoContrast is enabled, find out the vmin/vmax before rendering and mapping against new values
-            if (inArgs.autoContrast && !inArgs.isDoingPartialUpdates) {
-                double vmin = std::numeric_limits<double>::infinity();
-                double vmax = -std::numeric_limits<double>::infinity();
-
-                if (runInCurrentThread) {
-                    MinMaxVal vMinMax = findAutoContrastVminVmax(colorImage, inArgs.channels, viewerRenderRoI);
-                    vmin = vMinMax.min;
-                    vmax = vMinMax.max;
-                } else {
-                    std::vector<RectI> splitRects = viewerRenderRoI.splitIntoSmallerRects( appPTR->getMaxThreadCount() );
-                    QFuture<MinMaxVal> future = QtConcurrent::mapped( splitRects,
-                                                                                       boost::bind(findAutoContrastVminVmax,
-                                                                                                   colorImage,
-                                                                                                   inArgs.channels,
-                                                                                                   _1) );
-                    future.waitForFinished();
-                    QList<MinMaxVal> results = future.results();
-                    Q_FOREACH (const MinMaxVal &vMinMax, results) {
-                        if (vMinMax.min < vmin) {
-                            vmin = vMinMax.min;
-                        }
-                        if (vMinMax.max > vmax) {
-                            vmax = vMinMax.max;
-                        }
-                    }
-                } // runInCurrentThread
+            if (inArgs.autoContrast && !inArgs.isDoingPartialUpdates && !autoContrastFromTextures) {
+                double vmin, vmax;
+                // The image is modified in place while painting, its statistics cannot be kept
+                _imp->findAutoContrastVminVmaxFromTiles(updateParams->textureIndex, colorImage, inArgs.channels, viewerRenderRoI,
+                                                        !rotoPaintNode, !runInCurrentThread, &vmin, &vmax);
 
                 if (vmax == vmin) {
                     vmin = vmax - 1.;
@@ -1943,8 +2190,8 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
             }
 
             const RenderViewerArgs args(colorImage,
-                                        alphaImage,
-                                        inArgs.channels,
+                                        matteImage,
+                                        textureChannels,
                                         updateParams->srcPremult,
                                         updateParams->depth,
                                         updateParams->gain,
@@ -1952,9 +2199,11 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
                                         updateParams->offset,
                                         lutFromColorspace(srcColorSpace),
                                         lutFromColorspace(updateParams->lut),
-                                        alphaChannelIndex,
+                                        textureAlphaChannelIndex,
                                         viewerRenderRoiOnly,
-                                        tileRowElements);
+                                        tileRowElements,
+                                        autoContrastFromTextures,
+                                        autoContrastChannels);
 
             if (runInCurrentThread) {
                 QReadLocker k(&_imp->gammaLookupMutex);
@@ -1977,6 +2226,20 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
             }
         } // if (singleThreaded)
 
+        // Store the converted textures in the compressed cache entries, these are still locked by entryLocker
+        for (std::list<UpdateViewerParams::CachedTile>::iterator it = unCachedTiles.begin(); it != unCachedTiles.end(); ++it) {
+            if (it->cachedData && it->decompressedBuffer) {
+                it->cachedData->compress( (const float*)it->ramBuffer );
+            }
+            if (it->cachedData && it->autoContrastRangeSet) {
+                it->cachedData->setAutoContrastRange(autoContrastChannels, it->autoContrastMin, it->autoContrastMax);
+            }
+        }
+
+        if (autoContrastFromTextures) {
+            setAutoContrastFromTextures(autoContrastChannels, unCachedTiles, updateParams.get());
+        }
+
 
         if ( colorImage && stats && stats->isInDepthProfilingEnabled() ) {
             stats->addRenderInfosForNode( getNode(), NodePtr(), colorImage->getComponents().getChannelsLabel(), viewerRenderRoI, viewerRenderTimeRecorder->getTimeSinceCreation() );
@@ -1997,6 +2260,199 @@ ViewerInstance::renderViewer_internal(ViewIdx view,
     return eViewerRenderRetCodeRender;
 } // renderViewer_internal
 
+// If the tiles around the center of the viewport took less than this time (in seconds) to render,
+// the remaining of the frame will be ready soon enough: do not display it ring by ring
+#define NATRON_VIEWER_CENTER_OUT_MIN_RENDER_TIME 0.1
+
+ViewerInstance::ViewerRenderRetCode
+ViewerInstance::renderTilesCenterOut(ViewIdx view,
+                                     bool singleThreaded,
+                                     ParallelRenderArgsSetter* frameArgs,
+                                     const RectI& roi,
+                                     const std::list<ImagePlaneDesc>& requestedComponents,
+                                     ImageBitDepthEnum imageDepth,
+                                     int alphaChannelIndex,
+                                     ViewerArgs& inArgs,
+                                     BufferableObjectPtrList* convertedTiles)
+{
+    const int tileSize = inArgs.params->tileSize;
+    int nbUnCachedTiles = 0;
+
+    for (std::list<UpdateViewerParams::CachedTile>::const_iterator it = inArgs.params->tiles.begin(); it != inArgs.params->tiles.end(); ++it) {
+        if (!it->ramBuffer) {
+            ++nbUnCachedTiles;
+        }
+    }
+    if ( (tileSize <= 0) || (nbUnCachedTiles <= 1) ) {
+        return eViewerRenderRetCodeRender;
+    }
+
+    // Start from the tile under the center of the viewport, clamped to the area to render
+    const RectI& visibleRoI = inArgs.params->roiNotRoundedToTileSize;
+    int centerX = (visibleRoI.x1 + visibleRoI.x2) / 2;
+    int centerY = (visibleRoI.y1 + visibleRoI.y2) / 2;
+    centerX = std::max( roi.x1, std::min(roi.x2 - 1, centerX) );
+    centerY = std::max( roi.y1, std::min(roi.y2 - 1, centerY) );
+    const int centerTileX = (int)std::floor( (double)centerX / tileSize ) * tileSize;
+    const int centerTileY = (int)std::floor( (double)centerY / tileSize ) * tileSize;
+
+    // When the display channels are selected by the viewer shader, the texture holds the layer unconverted
+    const bool displayChannelsInShader = inArgs.params->displayChannelsInShader;
+    const DisplayChannelsEnum textureChannels = displayChannelsInShader ? eDisplayChannelsRGB : inArgs.channels;
+    const int textureAlphaChannelIndex = displayChannelsInShader ? -1 : alphaChannelIndex;
+    std::size_t tileRowElements = tileSize;
+    // Internally the buffer is interpreted as U32 when 8bit, so we do not multiply it by 4 for RGBA
+    if (inArgs.params->depth == eImageBitDepthFloat) {
+        tileRowElements *= 4;
+    }
+
+    const U64 renderAge = inArgs.params->abortInfo->getRenderAge();
+    TimeLapse timer;
+    RectI renderedRect;
+    bool renderedRectSet = false;
+
+    // Each pass doubles the number of tiles rendered on each side of the center tile. Each pass runs under the
+    // request pass of its own area, so that the upstream nodes are asked for what the ring needs only, and the
+    // images of the tree are cached, hence each pass only renders what the previous passes did not.
+    for (int radius = 1;; radius *= 2) {
+        const RectI ringBounds(centerTileX - radius * tileSize, centerTileY - radius * tileSize,
+                               centerTileX + (radius + 1) * tileSize, centerTileY + (radius + 1) * tileSize);
+        RectI ringRect;
+        if ( !ringBounds.intersect(roi, &ringRect) || ringRect.contains(roi) ) {
+            // The last ring is the full RoI: it is rendered by the caller
+            break;
+        }
+
+        {
+            RectD canonicalRingRect;
+            ringRect.toCanonical(inArgs.params->mipMapLevel, inArgs.params->pixelAspectRatio, inArgs.params->rod, &canonicalRingRect);
+            FrameRequestMap ringRequestPassData;
+            StatusEnum stat = EffectInstance::computeRequestPass(inArgs.params->time, view, inArgs.params->mipMapLevel, canonicalRingRect, getNode(), ringRequestPassData);
+            if (stat == eStatusFailed) {
+                // Let the full render report the failure
+                break;
+            }
+            frameArgs->updateNodesRequest(ringRequestPassData);
+        }
+
+        ImagePtr colorImage, alphaImage;
+        try {
+            std::map<ImagePlaneDesc, ImagePtr> planes;
+            EffectInstance::RenderRoIRetCode retCode;
+            {
+                boost::scoped_ptr<EffectInstance::RenderRoIArgs> renderArgs;
+                renderArgs.reset( new EffectInstance::RenderRoIArgs(inArgs.params->time,
+                                                                    Image::getScaleFromMipMapLevel(inArgs.params->mipMapLevel),
+                                                                    inArgs.params->mipMapLevel,
+                                                                    view,
+                                                                    false /*byPassCache*/,
+                                                                    ringRect,
+                                                                    inArgs.params->rod,
+                                                                    requestedComponents,
+                                                                    imageDepth,
+                                                                    false /*calledFromGetImage*/,
+                                                                    this,
+                                                                    eStorageModeRAM /*returnStorage*/,
+                                                                    inArgs.params->time) );
+                retCode = inArgs.activeInputToRender->renderRoI(*renderArgs, &planes);
+            }
+            if ( !planes.empty() && (retCode == EffectInstance::eRenderRoIRetCodeOk) ) {
+                getColorAndAlphaImages(planes, inArgs, &colorImage, &alphaImage);
+            }
+        } catch (...) {
+            if ( inArgs.activeInputToRender->aborted() ) {
+                return eViewerRenderRetCodeRedraw;
+            }
+            throw;
+        }
+
+        // Let the full render report failures and black images
+        if (!colorImage) {
+            break;
+        }
+        if ( ( (inArgs.channels == eDisplayChannelsA) && ( (alphaChannelIndex < 0) || ( alphaChannelIndex >= (int)colorImage->getComponentsCount() ) ) ) ||
+             ( ( inArgs.channels == eDisplayChannelsMatte) && ( !alphaImage || ( alphaChannelIndex < 0) || ( alphaChannelIndex >= (int)alphaImage->getComponentsCount() ) ) ) ) {
+            break;
+        }
+        const ImagePtr matteImage = displayChannelsInShader ? ImagePtr() : alphaImage;
+
+        // Convert the tiles of the ring in buffers that are freed once displayed: the cached textures are
+        // filled by the full render.
+        UpdateViewerParamsPtr ringParams = boost::make_shared<UpdateViewerParams>(*inArgs.params);
+        ringParams->tiles.clear();
+        ringParams->nbCachedTile = 0;
+        ringParams->mustFreeRamBuffer = true;
+        ringParams->colorImage = colorImage;
+        for (std::list<UpdateViewerParams::CachedTile>::const_iterator it = inArgs.params->tiles.begin(); it != inArgs.params->tiles.end(); ++it) {
+            if ( it->ramBuffer || !ringRect.contains(it->rect) || ( renderedRectSet && renderedRect.contains(it->rect) ) ) {
+                continue;
+            }
+            UpdateViewerParams::CachedTile tile;
+            tile.rect = it->rect;
+            tile.rectRounded = it->rectRounded;
+            tile.bytesCount = it->bytesCount;
+            tile.ramBuffer = (unsigned char*)malloc(tile.bytesCount);
+            if (tile.ramBuffer) {
+                ringParams->tiles.push_back(tile);
+            }
+        }
+        renderedRect = ringRect;
+        renderedRectSet = true;
+
+        if ( !ringParams->tiles.empty() ) {
+            RectI viewerRenderRoI;
+            ringRect.intersect(colorImage->getBounds(), &viewerRenderRoI);
+            ViewerColorSpaceEnum srcColorSpace = getApp()->getDefaultColorSpaceForBitDepth( colorImage->getBitDepth() );
+            const RenderViewerArgs args(colorImage,
+                                        matteImage,
+                                        textureChannels,
+                                        ringParams->srcPremult,
+                                        ringParams->depth,
+                                        ringParams->gain,
+                                        ringParams->gamma,
+                                        ringParams->offset,
+                                        lutFromColorspace(srcColorSpace),
+                                        lutFromColorspace(ringParams->lut),
+                                        textureAlphaChannelIndex,
+                                        false /*renderOnlyRoI*/,
+                                        tileRowElements,
+                                        false /*computeAutoContrastRange*/,
+                                        inArgs.channels);
+            {
+                QReadLocker k(&_imp->gammaLookupMutex);
+                if (singleThreaded) {
+                    for (std::list<UpdateViewerParams::CachedTile>::iterator it = ringParams->tiles.begin(); it != ringParams->tiles.end(); ++it) {
+                        renderFunctor(viewerRenderRoI, args, this, *it);
+                    }
+                } else {
+                    QtConcurrent::map( ringParams->tiles,
+                                       boost::bind(&renderFunctor,
+                                                   viewerRenderRoI,
+                                                   args,
+                                                   this,
+                                                   _1) ).waitForFinished();
+                }
+            }
+
+            BufferableObjectPtrList tiles;
+            tiles.push_back(ringParams);
+            _imp->updateViewerTilesOnMainThread(tiles);
+            // The buffers are freed when the last reference to ringParams is released
+            convertedTiles->push_back(ringParams);
+        }
+
+        if ( (radius == 1) && (timer.getTimeSinceCreation() < NATRON_VIEWER_CENTER_OUT_MIN_RENDER_TIME) ) {
+            break;
+        }
+        // Do not spend more time on this frame than needed if the user already requested another one
+        if ( inArgs.activeInputToRender->aborted() || _imp->hasMoreRecentRenderRequest(inArgs.params->textureIndex, renderAge) ) {
+            break;
+        }
+    }
+
+    return eViewerRenderRetCodeRender;
+} // ViewerInstance::renderTilesCenterOut
+
 void
 ViewerInstance::aboutToUpdateTextures()
 {
@@ -2031,7 +2487,7 @@ void
 renderFunctor(const RectI& roi,
               const RenderViewerArgs & args,
               ViewerInstance* viewer,
-              UpdateViewerParams::CachedTile tile)
+              UpdateViewerParams::CachedTile& tile)
 {
     if ( (args.bitDepth == eImageBitDepthFloat) ) {
         // image is stored as linear, the OpenGL shader with do gamma/sRGB/Rec709 decompression, as well as gain and offset
@@ -2160,6 +2616,214 @@ findAutoContrastVminVmax(const ImagePtr inputImage,
     }
 } // findAutoContrastVminVmax
 
+DisplayChannelsEnum
+getAutoContrastRangeChannels(bool displayChannelsInShader,
+                             DisplayChannelsEnum channels)
+{
+    // Unless the shader selects the channels, the texture already holds the displayed channel in r, g and b
+    if ( displayChannelsInShader || (channels == eDisplayChannelsMatte) ) {
+        return channels;
+    }
+
+    return eDisplayChannelsRGB;
+}
+
+void
+accumulateAutoContrastRange(const float* rgba,
+                            int width,
+                            DisplayChannelsEnum channels,
+                            MinMaxVal* range)
+{
+    for (int x = 0; x < width; ++x, rgba += 4) {
+        double mini, maxi;
+        switch (channels) {
+        case eDisplayChannelsRGB:
+            mini = std::min(std::min(rgba[0], rgba[1]), rgba[2]);
+            maxi = std::max(std::max(rgba[0], rgba[1]), rgba[2]);
+            break;
+        case eDisplayChannelsY:
+            mini = 0.299 * rgba[0] + 0.587 * rgba[1] + 0.114 * rgba[2];
+            maxi = mini;
+            break;
+        case eDisplayChannelsR:
+            mini = maxi = rgba[0];
+            break;
+        case eDisplayChannelsG:
+            mini = maxi = rgba[1];
+            break;
+        case eDisplayChannelsB:
+            mini = maxi = rgba[2];
+            break;
+        case eDisplayChannelsA:
+            mini = maxi = rgba[3];
+            break;
+        default:
+            mini = maxi = 0.;
+            break;
+        }
+        if (mini < range->min) {
+            range->min = mini;
+        }
+        if (maxi > range->max) {
+            range->max = maxi;
+        }
+    }
+} // accumulateAutoContrastRange
+
+void
+setAutoContrastFromTextures(DisplayChannelsEnum rangeChannels,
+                            const std::list<UpdateViewerParams::CachedTile>& convertedTiles,
+                            UpdateViewerParams* params)
+{
+    MinMaxVal range;
+
+    // The range of the tiles converted by this render was computed by the conversion kernels
+    for (std::list<UpdateViewerParams::CachedTile>::const_iterator it = convertedTiles.begin(); it != convertedTiles.end(); ++it) {
+        if (it->autoContrastRangeSet) {
+            range.min = std::min(range.min, it->autoContrastMin);
+            range.max = std::max(range.max, it->autoContrastMax);
+        }
+    }
+
+    // The range of the cached tiles was kept on their cache entry when they were converted
+    for (std::list<UpdateViewerParams::CachedTile>::iterator it = params->tiles.begin(); it != params->tiles.end(); ++it) {
+        if (!it->isCached || !it->ramBuffer) {
+            continue;
+        }
+        double vmin, vmax;
+        if ( !it->cachedData || !it->cachedData->getAutoContrastRange(rangeChannels, &vmin, &vmax) ) {
+            // The texture was cached while the auto-contrast was off: read it once and remember its range
+            MinMaxVal tileRange;
+            const std::size_t rowElements = params->tileSize * 4;
+            const float* row = (const float*)it->ramBuffer + (it->rect.y1 - it->rectRounded.y1) * rowElements + (it->rect.x1 - it->rectRounded.x1) * 4;
+            for (int y = it->rect.y1; y < it->rect.y2; ++y, row += rowElements) {
+                accumulateAutoContrastRange(row, it->rect.width(), rangeChannels, &tileRange);
+            }
+            vmin = tileRange.min;
+            vmax = tileRange.max;
+            if (it->cachedData) {
+                it->cachedData->setAutoContrastRange(rangeChannels, vmin, vmax);
+            }
+        }
+        range.min = std::min(range.min, vmin);
+        range.max = std::max(range.max, vmax);
+    }
+
+    if (range.min > range.max) {
+        // Nothing was converted
+        return;
+    }
+    double vmin = range.min;
+    double vmax = range.max;
+    if (vmax == vmin) {
+        vmin = vmax - 1.;
+    }
+    if (vmax <= 0) {
+        params->gain = 0;
+        params->offset = 0;
+    } else {
+        params->gain = 1 / (vmax - vmin);
+        params->offset =  -vmin / (vmax - vmin);
+    }
+} // setAutoContrastFromTextures
+
+void
+ViewerInstance::ViewerInstancePrivate::findAutoContrastVminVmaxFromTiles(int textureIndex,
+                                                                         const ImagePtr& image,
+                                                                         DisplayChannelsEnum channels,
+                                                                         const RectI& roi,
+                                                                         bool useCachedStats,
+                                                                         bool multiThreaded,
+                                                                         double* vmin,
+                                                                         double* vmax)
+{
+    *vmin = std::numeric_limits<double>::infinity();
+    *vmax = -std::numeric_limits<double>::infinity();
+    if ( !image || roi.isNull() ) {
+        return;
+    }
+
+    // Split the RoI along a fixed grid so that the same tiles are found when the viewport moves
+    const int tileSize = NATRON_AUTO_CONTRAST_TILE_SIZE;
+    const int tx1 = (int)std::floor( (double)roi.x1 / tileSize );
+    const int ty1 = (int)std::floor( (double)roi.y1 / tileSize );
+    const int tx2 = (int)std::ceil( (double)roi.x2 / tileSize );
+    const int ty2 = (int)std::ceil( (double)roi.y2 / tileSize );
+
+    std::vector<std::pair<int, int> > toComputeIndices;
+    std::vector<RectI> toComputeRects;
+    {
+        QMutexLocker k(&autoContrastStatsMutex);
+        AutoContrastTileStats& stats = autoContrastStats[textureIndex];
+        if ( !useCachedStats || (stats.image.lock() != image) || (stats.channels != channels) ) {
+            stats.image = image;
+            stats.channels = channels;
+            stats.tiles.clear();
+        }
+        for (int ty = ty1; ty < ty2; ++ty) {
+            for (int tx = tx1; tx < tx2; ++tx) {
+                RectI tileRect(tx * tileSize, ty * tileSize, (tx + 1) * tileSize, (ty + 1) * tileSize);
+                if ( !tileRect.intersect(roi, &tileRect) ) {
+                    continue;
+                }
+                std::pair<int, int> index(tx, ty);
+                std::map<std::pair<int, int>, AutoContrastTileStats::Tile>::const_iterator found = stats.tiles.find(index);
+                if ( ( found != stats.tiles.end() ) && (found->second.rect == tileRect) ) {
+                    *vmin = std::min(*vmin, found->second.vmin);
+                    *vmax = std::max(*vmax, found->second.vmax);
+                } else {
+                    toComputeIndices.push_back(index);
+                    toComputeRects.push_back(tileRect);
+                }
+            }
+        }
+    }
+
+    if ( toComputeRects.empty() ) {
+        return;
+    }
+
+    std::vector<MinMaxVal> results;
+    if ( multiThreaded && (toComputeRects.size() > 1) ) {
+        QFuture<MinMaxVal> future = QtConcurrent::mapped( toComputeRects,
+                                                          boost::bind(findAutoContrastVminVmax,
+                                                                      image,
+                                                                      channels,
+                                                                      _1) );
+        future.waitForFinished();
+        QList<MinMaxVal> futureResults = future.results();
+        results.assign( futureResults.begin(), futureResults.end() );
+    } else {
+        results.reserve( toComputeRects.size() );
+        for (std::vector<RectI>::const_iterator it = toComputeRects.begin(); it != toComputeRects.end(); ++it) {
+            results.push_back( findAutoContrastVminVmax(image, channels, *it) );
+        }
+    }
+    assert( results.size() == toComputeRects.size() );
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        *vmin = std::min(*vmin, results[i].min);
+        *vmax = std::max(*vmax, results[i].max);
+    }
+
+    if (!useCachedStats) {
+        return;
+    }
+
+    QMutexLocker k(&autoContrastStatsMutex);
+    AutoContrastTileStats& stats = autoContrastStats[textureIndex];
+    if ( (stats.image.lock() != image) || (stats.channels != channels) ) {
+        // Another render displayed a different image meanwhile
+        return;
+    }
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        AutoContrastTileStats::Tile& tile = stats.tiles[toComputeIndices[i]];
+        tile.rect = toComputeRects[i];
+        tile.vmin = results[i].min;
+        tile.vmax = results[i].max;
+    }
+} // ViewerInstance::ViewerInstancePrivate::findAutoContrastVminVmaxFromTiles
+
 template <typename PIX, int maxValue, bool opaque, bool applyMatte, int rOffset, int gOffset, int bOffset>
 void
 scaleToTexture8bits_generic(const RectI& roi,
@@ -2523,6 +3187,365 @@ scaleToTexture8bitsForDepth(const RectI& roi,
     }
 }
 
+#ifdef NATRON_VIEWER_SCALE_TO_TEXTURE_SSE2
+
+/**
+ * @brief Returns true if the CPU running the application supports SSE2, which is checked once.
+ **/
+static bool
+cpuSupportsSSE2()
+{
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && (_M_IX86_FP >= 2) )
+    return true;
+#elif defined(__GNUC__)
+    static const bool supported = ( __builtin_cpu_init(), __builtin_cpu_supports("sse2") != 0 );
+
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Returns true if the vectorized versions of scaleToTexture8bits/scaleToTexture32bits can handle the given arguments.
+ * They cover the common case during playback: a float RGBA image displayed in RGB or luminance, without matte overlay
+ * nor input color-space. Everything else goes through the generic templated versions.
+ **/
+static bool
+canScaleToTextureSSE2(const RenderViewerArgs & args)
+{
+    if ( !cpuSupportsSSE2() ) {
+        return false;
+    }
+    if ( (args.inputImage->getBitDepth() != eImageBitDepthFloat) || (args.inputImage->getComponents().getNumComponents() != 4) ) {
+        return false;
+    }
+    if ( (args.channels != eDisplayChannelsRGB) && (args.channels != eDisplayChannelsY) && (args.channels != eDisplayChannelsMatte) ) {
+        return false;
+    }
+    if ( args.matteImage && (args.alphaChannelIndex >= 0) ) {
+        return false;
+    }
+
+    return !args.srcColorSpace;
+}
+
+// Same as Color::floatToInt<256>, NaNs are mapped to 0
+static inline NATRON_VIEWER_SSE2_TARGET __m128i
+floatToInt256_sse2(__m128 v)
+{
+    v = _mm_min_ps( _mm_max_ps( v, _mm_setzero_ps() ), _mm_set1_ps(1.f) );
+
+    return _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( v, _mm_set1_ps(255.f) ), _mm_set1_ps(0.5f) ) );
+}
+
+// Same as ViewerInstancePrivate::lookupGammaLut, for 4 values. SSE2 has no gather instruction: only the look-ups are done one lane at a time.
+static inline NATRON_VIEWER_SSE2_TARGET __m128
+applyGammaLut_sse2(__m128 v,
+                   const float* gammaLut)
+{
+    v = _mm_min_ps( _mm_max_ps( v, _mm_setzero_ps() ), _mm_set1_ps(1.f) );
+    const __m128 pos = _mm_mul_ps( v, _mm_set1_ps( (float)GAMMA_LUT_NB_VALUES ) );
+    const __m128i index = _mm_cvttps_epi32( _mm_min_ps( pos, _mm_set1_ps( (float)(GAMMA_LUT_NB_VALUES - 1) ) ) );
+    const __m128 alpha = _mm_sub_ps( pos, _mm_cvtepi32_ps(index) );
+    int indexes[4];
+
+    _mm_storeu_si128( (__m128i*)indexes, index );
+    const __m128 a = _mm_setr_ps(gammaLut[indexes[0]], gammaLut[indexes[1]], gammaLut[indexes[2]], gammaLut[indexes[3]]);
+    const __m128 b = _mm_setr_ps(gammaLut[indexes[0] + 1], gammaLut[indexes[1] + 1], gammaLut[indexes[2] + 1], gammaLut[indexes[3] + 1]);
+
+    return _mm_add_ps( a, _mm_mul_ps( _mm_sub_ps(b, a), alpha ) );
+}
+
+// Same as Lut::toColorSpaceUint8xxFromLinearFloatFast, for 4 values: the table is indexed by the 16 high bits of the float
+static inline NATRON_VIEWER_SSE2_TARGET __m128i
+toColorSpaceUint8xx_sse2(const float* values,
+                         const unsigned short* table)
+{
+    const __m128i hipart = _mm_srli_epi32( _mm_castps_si128( _mm_loadu_ps(values) ), 16 );
+    int indexes[4];
+
+    _mm_storeu_si128( (__m128i*)indexes, hipart );
+
+    return _mm_setr_epi32(table[indexes[0]], table[indexes[1]], table[indexes[2]], table[indexes[3]]);
+}
+
+// 4x4 Bayer matrix used for the ordered dither of the display color-space quantization
+static const unsigned short kOrderedDither4x4[4][4] = {
+    { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 }
+};
+
+// The dither threshold of a pixel, in the fractional part of a 0-0xff00 value
+static inline unsigned
+orderedDitherThreshold(int x,
+                       int y)
+{
+    return kOrderedDither4x4[y & 3][x & 3] * 16 + 8;
+}
+
+/**
+ * @brief Vectorized scaleToTexture8bits_generic, see canScaleToTextureSSE2().
+ * Each row is first converted to planar linear RGBA floats 4 pixels at a time (gain, offset, gamma, luminance), then quantized to BGRA.
+ * The quantization with a display color-space uses an ordered dither instead of the error diffusion of the generic version,
+ * which is inherently sequential.
+ **/
+static NATRON_VIEWER_SSE2_TARGET void
+scaleToTexture8bits_sse2(const RectI& roi,
+                         const RenderViewerArgs & args,
+                         ViewerInstance* viewer,
+                         const UpdateViewerParams::CachedTile& tile,
+                         U32* tileBuffer)
+{
+    const bool luminance = (args.channels == eDisplayChannelsY);
+    const bool opaque = (args.srcPremult == eImagePremultiplicationOpaque);
+    const bool applyGamma = (args.gamma != 1.);
+    Image::ReadAccess acc = Image::ReadAccess( args.inputImage.get() );
+
+    if ( (args.renderOnlyRoI && !tile.rect.contains(roi)) || (!args.renderOnlyRoI && !roi.contains(tile.rect)) ) {
+        return;
+    }
+    assert(tile.rect.x2 > tile.rect.x1);
+    assert(args.gamma > 0);
+
+    int dstRowElements;
+    U32* dst_pixels;
+    if (args.renderOnlyRoI) {
+        dstRowElements = tile.rect.width();
+        dst_pixels = tileBuffer + (roi.y1 - tile.rect.y1) * dstRowElements + (roi.x1 - tile.rect.x1);
+    } else {
+        dstRowElements = args.tileRowElements;
+        dst_pixels = tileBuffer + (tile.rect.y1 - tile.rectRounded.y1) * args.tileRowElements + (tile.rect.x1 - tile.rectRounded.x1);
+    }
+
+    const int y1 = args.renderOnlyRoI ? roi.y1 : tile.rect.y1;
+    const int y2 = args.renderOnlyRoI ? roi.y2 : tile.rect.y2;
+    const int x1 = args.renderOnlyRoI ? roi.x1 : tile.rect.x1;
+    const int x2 = args.renderOnlyRoI ? roi.x2 : tile.rect.x2;
+    const int width = x2 - x1;
+    const float* src_pixels = (const float*)acc.pixelAt(x1, y1);
+    const int srcRowElements = (int)args.inputImage->getRowElements();
+
+    // Planar R, G, B, A of the current row
+    std::vector<float> rowBuffer(width * 4);
+    float* R = &rowBuffer[0];
+    float* G = R + width;
+    float* B = G + width;
+    float* A = B + width;
+
+    // Used in place of the source when the tile is outside of the image
+    std::vector<float> blackRow;
+    if (!src_pixels) {
+        blackRow.resize(width * 4, 0.f);
+    }
+
+    const __m128 gain = _mm_set1_ps( (float)args.gain );
+    const __m128 offset = _mm_set1_ps( (float)args.offset );
+    const __m128 lumR = _mm_set1_ps(0.299f);
+    const __m128 lumG = _mm_set1_ps(0.587f);
+    const __m128 lumB = _mm_set1_ps(0.114f);
+    const float* gammaLut = applyGamma ? viewer->getGammaLut() : 0;
+    const unsigned short* colorSpaceTable = args.colorSpace ? args.colorSpace->getToColorSpaceUint8xxTable() : 0;
+
+    for (int y = y1; y < y2;
+         ++y,
+         dst_pixels += dstRowElements) {
+        const float* src = src_pixels ? src_pixels : &blackRow[0];
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            __m128 r = _mm_loadu_ps(src + x * 4);
+            __m128 g = _mm_loadu_ps(src + x * 4 + 4);
+            __m128 b = _mm_loadu_ps(src + x * 4 + 8);
+            __m128 a = _mm_loadu_ps(src + x * 4 + 12);
+            _MM_TRANSPOSE4_PS(r, g, b, a);
+
+            r = _mm_add_ps(_mm_mul_ps(r, gain), offset);
+            g = _mm_add_ps(_mm_mul_ps(g, gain), offset);
+            b = _mm_add_ps(_mm_mul_ps(b, gain), offset);
+            if (applyGamma) {
+                r = applyGammaLut_sse2(r, gammaLut);
+                g = applyGammaLut_sse2(g, gammaLut);
+                b = applyGammaLut_sse2(b, gammaLut);
+            }
+            if (luminance) {
+                r = _mm_add_ps( _mm_add_ps( _mm_mul_ps(r, lumR), _mm_mul_ps(g, lumG) ), _mm_mul_ps(b, lumB) );
+                g = r;
+                b = r;
+            }
+            _mm_storeu_ps(R + x, r);
+            _mm_storeu_ps(G + x, g);
+            _mm_storeu_ps(B + x, b);
+            _mm_storeu_ps(A + x, a);
+        }
+        for (; x < width; ++x) {
+            float r = src[x * 4] * (float)args.gain + (float)args.offset;
+            float g = src[x * 4 + 1] * (float)args.gain + (float)args.offset;
+            float b = src[x * 4 + 2] * (float)args.gain + (float)args.offset;
+            if (applyGamma) {
+                r = viewer->interpolateGammaLut(r);
+                g = viewer->interpolateGammaLut(g);
+                b = viewer->interpolateGammaLut(b);
+            }
+            if (luminance) {
+                r = 0.299f * r + 0.587f * g + 0.114f * b;
+                g = r;
+                b = r;
+            }
+            R[x] = r;
+            G[x] = g;
+            B[x] = b;
+            A[x] = src[x * 4 + 3];
+        }
+
+        if (!args.colorSpace) {
+            const __m128i opaqueAlpha = _mm_set1_epi32(255 << 24);
+            x = 0;
+            for (; x + 4 <= width; x += 4) {
+                __m128i uR = floatToInt256_sse2( _mm_loadu_ps(R + x) );
+                __m128i uG = floatToInt256_sse2( _mm_loadu_ps(G + x) );
+                __m128i uB = floatToInt256_sse2( _mm_loadu_ps(B + x) );
+                __m128i uA = opaque ? opaqueAlpha : _mm_slli_epi32(floatToInt256_sse2( _mm_loadu_ps(A + x) ), 24);
+                __m128i bgra = _mm_or_si128( _mm_or_si128( uA, _mm_slli_epi32(uR, 16) ), _mm_or_si128( _mm_slli_epi32(uG, 8), uB ) );
+                _mm_storeu_si128( (__m128i*)(dst_pixels + x), bgra );
+            }
+            for (; x < width; ++x) {
+                U8 uA = opaque ? 255 : Color::floatToInt<256>(A[x]);
+                dst_pixels[x] = toBGRA( Color::floatToInt<256>(R[x]), Color::floatToInt<256>(G[x]), Color::floatToInt<256>(B[x]), uA );
+            }
+        } else {
+            // Ordered dither: the threshold only depends on the position of the pixel, so that 4 pixels are quantized at once
+            const __m128i dither = _mm_setr_epi32( orderedDitherThreshold(x1, y), orderedDitherThreshold(x1 + 1, y),
+                                                   orderedDitherThreshold(x1 + 2, y), orderedDitherThreshold(x1 + 3, y) );
+            const __m128i opaqueAlpha = _mm_set1_epi32(255 << 24);
+            x = 0;
+            for (; x + 4 <= width; x += 4) {
+                // The table values are at most 0xff00, adding a threshold below 0x100 never overflows 8 bits
+                __m128i uR = _mm_srli_epi32( _mm_add_epi32(toColorSpaceUint8xx_sse2(R + x, colorSpaceTable), dither), 8 );
+                __m128i uG = _mm_srli_epi32( _mm_add_epi32(toColorSpaceUint8xx_sse2(G + x, colorSpaceTable), dither), 8 );
+                __m128i uB = _mm_srli_epi32( _mm_add_epi32(toColorSpaceUint8xx_sse2(B + x, colorSpaceTable), dither), 8 );
+                __m128i uA = opaque ? opaqueAlpha : _mm_slli_epi32(floatToInt256_sse2( _mm_loadu_ps(A + x) ), 24);
+                __m128i bgra = _mm_or_si128( _mm_or_si128( uA, _mm_slli_epi32(uR, 16) ), _mm_or_si128( _mm_slli_epi32(uG, 8), uB ) );
+                _mm_storeu_si128( (__m128i*)(dst_pixels + x), bgra );
+            }
+            for (; x < width; ++x) {
+                const unsigned threshold = orderedDitherThreshold(x1 + x, y);
+                U8 uR = (U8)( (args.colorSpace->toColorSpaceUint8xxFromLinearFloatFast(R[x]) + threshold) >> 8 );
+                U8 uG = (U8)( (args.colorSpace->toColorSpaceUint8xxFromLinearFloatFast(G[x]) + threshold) >> 8 );
+                U8 uB = (U8)( (args.colorSpace->toColorSpaceUint8xxFromLinearFloatFast(B[x]) + threshold) >> 8 );
+                U8 uA = opaque ? 255 : Color::floatToInt<256>(A[x]);
+                dst_pixels[x] = toBGRA(uR, uG, uB, uA);
+            }
+        }
+
+        if (src_pixels) {
+            src_pixels += srcRowElements;
+        }
+    }
+} // scaleToTexture8bits_sse2
+
+/**
+ * @brief Vectorized scaleToTexture32bitsGeneric, see canScaleToTextureSSE2().
+ **/
+static NATRON_VIEWER_SSE2_TARGET void
+scaleToTexture32bits_sse2(const RectI& roi,
+                          const RenderViewerArgs & args,
+                          UpdateViewerParams::CachedTile& tile,
+                          float *tileBuffer)
+{
+    const bool luminance = (args.channels == eDisplayChannelsY);
+    const bool opaque = (args.srcPremult == eImagePremultiplicationOpaque);
+    const int dstRowElements = args.renderOnlyRoI ? tile.rect.width() * 4 : args.tileRowElements;
+    Image::ReadAccess acc = Image::ReadAccess( args.inputImage.get() );
+
+    assert( (args.renderOnlyRoI && roi.x1 >= tile.rect.x1 && roi.x2 <= tile.rect.x2 && roi.y1 >= tile.rect.y1 && roi.y2 <= tile.rect.y2) || (!args.renderOnlyRoI && tile.rect.x1 >= roi.x1 && tile.rect.x2 <= roi.x2 && tile.rect.y1 >= roi.y1 && tile.rect.y2 <= roi.y2) );
+    assert(tile.rect.x2 > tile.rect.x1);
+
+    float* dst_pixels;
+    if (args.renderOnlyRoI) {
+        dst_pixels = tileBuffer + (roi.y1 - tile.rect.y1) * dstRowElements + (roi.x1 - tile.rect.x1) * 4;
+    } else {
+        dst_pixels = tileBuffer + (tile.rect.y1 - tile.rectRounded.y1) * dstRowElements + (tile.rect.x1 - tile.rectRounded.x1) * 4;
+    }
+
+    const int y1 = args.renderOnlyRoI ? roi.y1 : tile.rect.y1;
+    const int y2 = args.renderOnlyRoI ? roi.y2 : tile.rect.y2;
+    const int x1 = args.renderOnlyRoI ? roi.x1 : tile.rect.x1;
+    const int x2 = args.renderOnlyRoI ? roi.x2 : tile.rect.x2;
+    const int width = x2 - x1;
+    const float* src_pixels = (const float*)acc.pixelAt(x1, y1);
+    const int srcRowElements = (const int)args.inputImage->getRowElements();
+
+    const __m128 lumR = _mm_set1_ps(0.299f);
+    const __m128 lumG = _mm_set1_ps(0.587f);
+    const __m128 lumB = _mm_set1_ps(0.114f);
+    const __m128 one = _mm_set1_ps(1.f);
+    MinMaxVal range;
+
+    for (int y = y1; y < y2;
+         ++y,
+         dst_pixels += dstRowElements) {
+        if (!src_pixels) {
+            // Outside of the image: black, transparent unless the image is opaque
+            const __m128 black = _mm_set_ps(opaque ? 1.f : 0.f, 0.f, 0.f, 0.f);
+            for (int x = 0; x < width; ++x) {
+                _mm_storeu_ps(dst_pixels + x * 4, black);
+            }
+            continue;
+        }
+        if (!luminance && !opaque) {
+            // Nothing to convert: values are not clamped
+            std::memcpy( dst_pixels, src_pixels, width * 4 * sizeof(float) );
+        } else {
+            int x = 0;
+            for (; x + 4 <= width; x += 4) {
+                __m128 r = _mm_loadu_ps(src_pixels + x * 4);
+                __m128 g = _mm_loadu_ps(src_pixels + x * 4 + 4);
+                __m128 b = _mm_loadu_ps(src_pixels + x * 4 + 8);
+                __m128 a = _mm_loadu_ps(src_pixels + x * 4 + 12);
+                _MM_TRANSPOSE4_PS(r, g, b, a);
+                if (luminance) {
+                    r = _mm_add_ps( _mm_add_ps( _mm_mul_ps(r, lumR), _mm_mul_ps(g, lumG) ), _mm_mul_ps(b, lumB) );
+                    g = r;
+                    b = r;
+                }
+                if (opaque) {
+                    a = one;
+                }
+                _MM_TRANSPOSE4_PS(r, g, b, a);
+                _mm_storeu_ps(dst_pixels + x * 4, r);
+                _mm_storeu_ps(dst_pixels + x * 4 + 4, g);
+                _mm_storeu_ps(dst_pixels + x * 4 + 8, b);
+                _mm_storeu_ps(dst_pixels + x * 4 + 12, a);
+            }
+            for (; x < width; ++x) {
+                float r = src_pixels[x * 4];
+                float g = src_pixels[x * 4 + 1];
+                float b = src_pixels[x * 4 + 2];
+                if (luminance) {
+                    r = 0.299f * r + 0.587f * g + 0.114f * b;
+                    g = r;
+                    b = r;
+                }
+                dst_pixels[x * 4] = r;
+                dst_pixels[x * 4 + 1] = g;
+                dst_pixels[x * 4 + 2] = b;
+                dst_pixels[x * 4 + 3] = opaque ? 1.f : src_pixels[x * 4 + 3];
+            }
+        }
+        if (args.computeAutoContrastRange) {
+            // The row was just written, read it back while it is in the cache
+            accumulateAutoContrastRange(dst_pixels, width, args.autoContrastChannels, &range);
+        }
+        src_pixels += srcRowElements;
+    }
+    if (args.computeAutoContrastRange) {
+        tile.autoContrastRangeSet = true;
+        tile.autoContrastMin = range.min;
+        tile.autoContrastMax = range.max;
+    }
+} // scaleToTexture32bits_sse2
+
+#endif // NATRON_VIEWER_SCALE_TO_TEXTURE_SSE2
+
 void
 scaleToTexture8bits(const RectI& roi,
                     const RenderViewerArgs & args,
@@ -2531,6 +3554,14 @@ scaleToTexture8bits(const RectI& roi,
                     U32* output)
 {
     assert(output);
+
+#ifdef NATRON_VIEWER_SCALE_TO_TEXTURE_SSE2
+    if ( (args.gamma > 0) && canScaleToTextureSSE2(args) ) {
+        scaleToTexture8bits_sse2(roi, args, viewer, tile, output);
+
+        return;
+    }
+#endif
     switch ( args.inputImage->getBitDepth() ) {
     case eImageBitDepthFloat:
         scaleToTexture8bitsForDepth<float, 1>(roi, args, viewer, tile, output);
@@ -2555,6 +3586,12 @@ ViewerInstance::interpolateGammaLut(float value)
     return _imp->lookupGammaLut(value);
 }
 
+const float*
+ViewerInstance::getGammaLut() const
+{
+    return &_imp->gammaLookup[0];
+}
+
 void
 ViewerInstance::markAllOnGoingRendersAsAborted(bool keepOldestRender)
 {
@@ -2584,7 +3621,7 @@ void
 scaleToTexture32bitsGeneric(const RectI& roi,
                             const RenderViewerArgs & args,
                             int nComps,
-                            const UpdateViewerParams::CachedTile& tile,
+                            UpdateViewerParams::CachedTile& tile,
                             float *tileBuffer)
 {
     const size_t pixelSize = sizeof(PIX);
@@ -2613,6 +3650,7 @@ scaleToTexture32bitsGeneric(const RectI& roi,
     const int x2 = args.renderOnlyRoI ? roi.x2 : tile.rect.x2;
     const float* src_pixels = (const float*)acc.pixelAt(x1, y1);
     const int srcRowElements = (const int)args.inputImage->getRowElements();
+    MinMaxVal range;
 
     for (int y = y1; y < y2;
          ++y,
@@ -2744,16 +3782,25 @@ scaleToTexture32bitsGeneric(const RectI& roi,
             dst_pixels[x * 4 + 3] = a;
         }
         if (src_pixels) {
+            if (args.computeAutoContrastRange) {
+                // The row was just written, read it back while it is in the cache
+                accumulateAutoContrastRange(dst_pixels, x2 - x1, args.autoContrastChannels, &range);
+            }
             src_pixels += srcRowElements;
         }
     }
+    if (args.computeAutoContrastRange) {
+        tile.autoContrastRangeSet = true;
+        tile.autoContrastMin = range.min;
+        tile.autoContrastMax = range.max;
+    }
 } // scaleToTexture32bitsGeneric
 
 template <typename PIX, int maxValue, int nComps, bool opaque, bool applyMatte, int rOffset, int gOffset, int bOffset>
 void
 scaleToTexture32bitsInternal(const RectI& roi,
                              const RenderViewerArgs & args,
-                             const UpdateViewerParams::CachedTile& tile,
+                             UpdateViewerParams::CachedTile& tile,
                              float *output)
 {
     scaleToTexture32bitsGeneric<PIX, maxValue, opaque, applyMatte, rOffset, gOffset, bOffset>(roi, args, nComps, tile, output);
@@ -2763,7 +3810,7 @@ template <typename PIX, int maxValue, int nComps, bool opaque, int rOffset, int
 void
 scaleToTexture32bitsForMatte(const RectI& roi,
                              const RenderViewerArgs & args,
-                             const UpdateViewerParams::CachedTile& tile,
+                             UpdateViewerParams::CachedTile& tile,
                              float *output)
 {
     bool applyMatte = args.matteImage.get() && args.alphaChannelIndex >= 0;
@@ -2779,7 +3826,7 @@ template <typename PIX, int maxValue, bool opaque, int rOffset, int gOffset, int
 void
 scaleToTexture32bitsForDepthForComponents(const RectI& roi,
                                           const RenderViewerArgs & args,
-                                          const UpdateViewerParams::CachedTile& tile,
+                                          UpdateViewerParams::CachedTile& tile,
                                           float *output)
 {
     int nComps = args.inputImage->getComponents().getNumComponents();
@@ -2812,7 +3859,7 @@ template <typename PIX, int maxValue, bool opaque>
 void
 scaleToTexture32bitsForPremultForComponents(const RectI& roi,
                                             const RenderViewerArgs & args,
-                                            const UpdateViewerParams::CachedTile& tile,
+                                            UpdateViewerParams::CachedTile& tile,
                                             float *output)
 {
     switch (args.channels) {
@@ -2861,7 +3908,7 @@ template <typename PIX, int maxValue>
 void
 scaleToTexture32bitsForPremult(const RectI& roi,
                                const RenderViewerArgs & args,
-                               const UpdateViewerParams::CachedTile& tile,
+                               UpdateViewerParams::CachedTile& tile,
                                float *output)
 {
     switch (args.srcPremult) {
@@ -2879,11 +3926,19 @@ scaleToTexture32bitsForPremult(const RectI& roi,
 void
 scaleToTexture32bits(const RectI& roi,
                      const RenderViewerArgs & args,
-                     const UpdateViewerParams::CachedTile& tile,
+                     UpdateViewerParams::CachedTile& tile,
                      float *output)
 {
     assert(output);
 
+#ifdef NATRON_VIEWER_SCALE_TO_TEXTURE_SSE2
+    if ( canScaleToTextureSSE2(args) ) {
+        scaleToTexture32bits_sse2(roi, args, tile, output);
+
+        return;
+    }
+#endif
+
     switch ( args.inputImage->getBitDepth() ) {
     case eImageBitDepthFloat:
         scaleToTexture32bitsForPremult<float, 1>(roi, args, tile, output);
@@ -2966,7 +4021,8 @@ ViewerInstance::ViewerInstancePrivate::updateViewer(UpdateViewerParamsPtr params
         if (originalImage) {
             depth = originalImage->getBitDepth();
         } else {
-            assert(firstTile.cachedData);
+            // Frames replayed from the flipbook cache do not hold the original image
+            assert(firstTile.cachedData || params->flipbookBuffer);
             if (firstTile.cachedData) {
                 depth = (ImageBitDepthEnum)firstTile.cachedData->getKey().getBitDepth();
             } else {
@@ -2974,7 +4030,7 @@ ViewerInstance::ViewerInstancePrivate::updateViewer(UpdateViewerParamsPtr params
             }
         }
 
-        uiContext->endTransferBufferFromRAMToGPU(params->textureIndex, texture, originalImage, params->time, params->rod,  params->pixelAspectRatio, depth, params->mipMapLevel, params->srcPremult, params->gain, params->gamma, params->offset, params->lut, params->recenterViewport, params->viewportCenter, params->isPartialRect);
+        uiContext->endTransferBufferFromRAMToGPU(params->textureIndex, texture, originalImage, params->time, params->rod,  params->pixelAspectRatio, depth, params->mipMapLevel, params->srcPremult, params->gain, params->gamma, params->offset, params->lut, params->displayChannelsInShader, params->recenterViewport, params->viewportCenter, params->isPartialRect);
 
         if (!isDrawing) {
             uiContext->updateColorPicker(params->textureIndex);
@@ -2987,6 +4043,33 @@ ViewerInstance::ViewerInstancePrivate::updateViewer(UpdateViewerParamsPtr params
     //    updateViewerCond.wakeOne();
 } // ViewerInstance::ViewerInstancePrivate::updateViewer
 
+void
+ViewerInstance::ViewerInstancePrivate::updateViewerTiles(BufferableObjectPtrList tiles)
+{
+    // always running in the main thread
+    assert( qApp && qApp->thread() == QThread::currentThread() );
+
+    if (!uiContext) {
+        return;
+    }
+    bool updated = false;
+    for (BufferableObjectPtrList::const_iterator it = tiles.begin(); it != tiles.end(); ++it) {
+        UpdateViewerParamsPtr params = boost::dynamic_pointer_cast<UpdateViewerParams>(*it);
+        if ( !params || instance->isViewerPaused(params->textureIndex) ) {
+            continue;
+        }
+        // Never overwrite a more recent frame that was already displayed
+        if ( !checkAgeNoUpdate( params->textureIndex, params->abortInfo->getRenderAge() ) ) {
+            continue;
+        }
+        updateViewer(params);
+        updated = true;
+    }
+    if (updated) {
+        uiContext->redraw();
+    }
+}
+
 bool
 ViewerInstance::isInputOptional(int n) const
 {
@@ -3144,27 +4227,58 @@ ViewerInstance::setDisplayChannels(DisplayChannelsEnum channels,
     assert( qApp && qApp->thread() == QThread::currentThread() );
 
     bool changed = false;
+    bool redrawOnly = true;
     {
         QMutexLocker l(&_imp->viewerParamsMutex);
-        if (!bothInputs) {
-            if (_imp->viewerParamsChannels[0] != channels) {
-                _imp->viewerParamsChannels[0] = channels;
-                changed = true;
-            }
-        } else {
-            if (_imp->viewerParamsChannels[0] != channels) {
-                _imp->viewerParamsChannels[0] = channels;
-                changed = true;
-            }
-            if (_imp->viewerParamsChannels[1] != channels) {
-                _imp->viewerParamsChannels[1] = channels;
+        const ImageBitDepthEnum depth = _imp->uiContext ? _imp->uiContext->getBitDepth() : eImageBitDepthByte;
+        const int nInputs = bothInputs ? 2 : 1;
+        for (int i = 0; i < nInputs; ++i) {
+            if (_imp->viewerParamsChannels[i] != channels) {
+                // If the shader selects both the old and the new channels, the textures are left unchanged
+                if ( !_imp->canApplyDisplayChannelsInShader(depth, _imp->viewerParamsChannels[i]) ||
+                     !_imp->canApplyDisplayChannelsInShader(depth, channels) ) {
+                    redrawOnly = false;
+                }
+                _imp->viewerParamsChannels[i] = channels;
                 changed = true;
             }
         }
     }
     if ( changed && !getApp()->getProject()->isLoadingProject() ) {
-        renderCurrentFrame(true);
+        if (redrawOnly) {
+            _imp->uiContext->redraw();
+        } else {
+            renderCurrentFrame(true);
+        }
+    }
+}
+
+bool
+ViewerInstance::getDisplayChannelsForShader(int texIndex,
+                                            DisplayChannelsEnum* channels,
+                                            int* alphaChannelIndex) const
+{
+    // always running in the main thread
+    assert( qApp && qApp->thread() == QThread::currentThread() );
+    assert(_imp->uiContext);
+
+    QMutexLocker l(&_imp->viewerParamsMutex);
+    if ( !_imp->canApplyDisplayChannelsInShader(_imp->uiContext->getBitDepth(), _imp->viewerParamsChannels[texIndex]) ) {
+        return false;
+    }
+    *channels = _imp->viewerParamsChannels[texIndex];
+    *alphaChannelIndex = -1;
+    if ( (*channels == eDisplayChannelsA) || (*channels == eDisplayChannelsMatte) ) {
+        const std::vector<std::string>& layerChannels = _imp->viewerParamsAlphaLayer.getChannels();
+        for (std::size_t i = 0; i < layerChannels.size(); ++i) {
+            if (layerChannels[i] == _imp->viewerParamsAlphaChannelName) {
+                *alphaChannelIndex = (int)i;
+                break;
+            }
+        }
     }
+
+    return true;
 }
 
 void
@@ -3480,6 +4594,13 @@ ViewerInstance::isLatestRender(int textureIndex,
     return _imp->isLatestRender(textureIndex, renderAge);
 }
 
+bool
+ViewerInstance::hasMoreRecentRenderRequest(int textureIndex,
+                                           U64 renderAge) const
+{
+    return _imp->hasMoreRecentRenderRequest(textureIndex, renderAge);
+}
+
 void
 ViewerInstance::setPartialUpdateParams(const std::list<RectD>& rois,
                                        bool recenterViewer)
@@ -28,12 +28,14 @@
 #include "Global/Macros.h"
 
 #include <string>
+#include <list>
 
 #if !defined(Q_MOC_RUN) && !defined(SBK_RUN)
 #include <boost/shared_ptr.hpp>
 #include <boost/scoped_ptr.hpp>
 #endif
 
+#include "Engine/BufferableObject.h"
 #include "Engine/OutputEffectInstance.h"
 #include "Engine/ViewIdx.h"
 #include "Engine/EngineFwd.h"
@@ -60,6 +62,7 @@ public:
     bool userRoIEnabled;
     bool mustComputeRoDAndLookupCache;
     bool isDoingPartialUpdates;
+    bool isProgressiveCoarsePass; // set by the caller: render a draft at the auto-proxy level before the full resolution render
 };
 
 class ViewerInstance
@@ -125,6 +128,17 @@ public:
                                                                 const RenderStatsPtr& stats,
                                                                 ViewerArgs* outArgs);
 
+    /**
+     * @brief Returns true if the textures of the given frame are held by the flipbook cache for the current
+     * state of the viewer, in which case they are appended to frames and the frame does not need to be rendered.
+     **/
+    bool getFlipbookFrame(SequenceTime time, ViewIdx view, U64 viewerHash, BufferableObjectPtrList* frames);
+
+    /**
+     * @brief Stores the textures produced for the given frame during playback in the flipbook cache.
+     **/
+    void insertFlipbookFrame(SequenceTime time, ViewIdx view, U64 viewerHash, const BufferableObjectPtrList& frames);
+
 private:
     /**
      * @brief Look-up the cache and try to find a matching texture for the portion to render.
@@ -252,9 +266,20 @@ public:
 
     bool isLatestRender(int textureIndex, U64 renderAge) const;
 
+    /**
+     * @brief Returns true if another render of the given texture was requested after the render of the given age.
+     **/
+    bool hasMoreRecentRenderRequest(int textureIndex, U64 renderAge) const;
+
 
     void setDisplayChannels(DisplayChannelsEnum channels, bool bothInputs);
 
+    /**
+     * @brief Returns true if the current display channels of the given input are selected by the viewer shader,
+     * in which case channels and alphaChannelIndex (the index of the alpha channel in the layer, or -1) are set.
+     **/
+    bool getDisplayChannelsForShader(int texIndex, DisplayChannelsEnum* channels, int* alphaChannelIndex) const;
+
     void setActiveLayer(const ImagePlaneDesc& layer, bool doRender);
 
     void setAlphaChannel(const ImagePlaneDesc& layer, const std::string& channelName, bool doRender);
@@ -304,6 +329,11 @@ public:
 
     float interpolateGammaLut(float value);
 
+    /**
+     * @brief The GAMMA_LUT_NB_VALUES + 1 values of the table used by interpolateGammaLut()
+     **/
+    const float* getGammaLut() const;
+
     void markAllOnGoingRendersAsAborted(bool keepOldestRender);
 
     /**
@@ -431,6 +461,16 @@ private:
                                               const RenderStatsPtr& stats,
                                               ViewerArgs& inArgs) WARN_UNUSED_RETURN;
 
+    ViewerRenderRetCode renderTilesCenterOut(ViewIdx view,
+                                             bool singleThreaded,
+                                             ParallelRenderArgsSetter* frameArgs,
+                                             const RectI& roi,
+                                             const std::list<ImagePlaneDesc>& requestedComponents,
+                                             ImageBitDepthEnum imageDepth,
+                                             int alphaChannelIndex,
+                                             ViewerArgs& inArgs,
+                                             BufferableObjectPtrList* convertedTiles) WARN_UNUSED_RETURN;
+
     virtual void getRegionsOfInterest(double time,
                                      const RenderScale & scale,
                                      const RectD & outputRoD,   //!< the RoD of the effect, in canonical coordinates
@@ -49,6 +49,7 @@
 #include "Engine/Settings.h"
 #include "Engine/Image.h"
 #include "Engine/TextureRect.h"
+#include "Engine/ViewerFlipbookCache.h"
 #include "Engine/EngineFwd.h"
 
 #define GAMMA_LUT_NB_VALUES 1023
@@ -82,7 +83,9 @@ struct RenderViewerArgs
                      const Color::Lut* colorSpace_,
                      int alphaChannelIndex_,
                      bool renderOnlyRoI_,
-                     std::size_t tileRowElements_)
+                     std::size_t tileRowElements_,
+                     bool computeAutoContrastRange_,
+                     DisplayChannelsEnum autoContrastChannels_)
         : inputImage(inputImage_)
         , matteImage(matteImage_)
         , channels(channels_)
@@ -96,6 +99,8 @@ struct RenderViewerArgs
         , alphaChannelIndex(alphaChannelIndex_)
         , renderOnlyRoI(renderOnlyRoI_)
         , tileRowElements(tileRowElements_)
+        , computeAutoContrastRange(computeAutoContrastRange_)
+        , autoContrastChannels(autoContrastChannels_)
     {
     }
 
@@ -112,6 +117,32 @@ struct RenderViewerArgs
     int alphaChannelIndex;
     bool renderOnlyRoI;
     std::size_t tileRowElements;
+    bool computeAutoContrastRange; // the 32-bit conversion stores the range of the converted values in the tile
+    DisplayChannelsEnum autoContrastChannels; // the channels of the converted values the range is computed on
+};
+
+/**
+ * @brief The min/max values of the tiles of the image last displayed with auto-contrast. When the same image is
+ * displayed again (e.g: the viewport moved or the gamma changed) only the tiles that were not seen yet are scanned.
+ **/
+struct AutoContrastTileStats
+{
+    struct Tile
+    {
+        RectI rect; // the tile intersected with the RoI it was computed for
+        double vmin, vmax;
+    };
+
+    ImageWPtr image;
+    DisplayChannelsEnum channels;
+    std::map<std::pair<int, int>, Tile> tiles; // indexed by the position of the tile on the grid
+
+    AutoContrastTileStats()
+        : image()
+        , channels(eDisplayChannelsRGB)
+        , tiles()
+    {
+    }
 };
 
 struct ViewerInstance::ViewerInstancePrivate
@@ -147,6 +178,9 @@ public:
         , lastRenderParamsMutex()
         , lastRenderParams()
         , partialUpdateRects()
+        , flipbook()
+        , autoContrastStatsMutex()
+        , autoContrastStats()
         , viewportCenter()
         , viewportCenterSet(false)
         , isDoingPartialUpdates(false)
@@ -168,6 +202,11 @@ public:
         Q_EMIT mustRedrawViewer();
     }
 
+    void updateViewerTilesOnMainThread(const BufferableObjectPtrList& tiles)
+    {
+        Q_EMIT mustUpdateViewerTiles(tiles);
+    }
+
 public:
 
     virtual void lock(const FrameEntryPtr& entry) OVERRIDE FINAL
@@ -217,8 +256,11 @@ public:
     /**
      * @brief Returns the current render age of the viewer (a simple counter incrementing at each request).
      * The age is then incremented so the next call to getRenderAge will return the current value plus one.
+     * The request is made a child of the render engine's playback render (if isSequential) or of its current frame renders,
+     * so that it gets aborted along with them.
      **/
     AbortableRenderInfoPtr createNewRenderRequest(int texIndex,
+                                                  bool isSequential,
                                                   bool canAbort)
     {
         QMutexLocker k(&renderAgeMutex);
@@ -231,6 +273,13 @@ public:
         }
 
         AbortableRenderInfoPtr info = AbortableRenderInfo::create(canAbort, ret);
+        RenderEnginePtr engine = instance->getRenderEngine();
+        if (engine) {
+            AbortableRenderInfoPtr parent = isSequential ? engine->getSequentialRenderAbortInfo() : engine->getCurrentFrameRendersAbortInfo();
+            if (parent) {
+                info->setParentRender(parent);
+            }
+        }
 
         return info;
     }
@@ -247,6 +296,15 @@ public:
         return !currentRenderAges[texIndex].empty() && ( *currentRenderAges[texIndex].rbegin() )->getRenderAge() == age;
     }
 
+    bool hasMoreRecentRenderRequest(int texIndex,
+                                    U64 age) const
+    {
+        QMutexLocker k(&renderAgeMutex);
+
+        // renderAge is the age of the next request
+        return renderAge[texIndex] > age + 1;
+    }
+
     /**
      * @brief To be called to check if there we are the last requested render (true) or if there were
      * more recent requests (false).
@@ -314,6 +372,57 @@ public:
         return false;
     }
 
+    /**
+     * @brief Returns true if the given display channels can be selected by the viewer shader, in which case
+     * the texture holds the layer unconverted and does not depend on the display channels. This is only possible
+     * with floating point textures and when the alpha channel (if any) belongs to the displayed layer.
+     * Auto-contrast and partial updates still convert on the CPU.
+     * viewerParamsMutex should already be locked.
+     **/
+    bool canApplyDisplayChannelsInShader(ImageBitDepthEnum depth,
+                                         DisplayChannelsEnum channels) const
+    {
+        if ( (depth != eImageBitDepthFloat) || viewerParamsAutoContrast || isDoingPartialUpdates ) {
+            return false;
+        }
+        switch (channels) {
+        case eDisplayChannelsRGB:
+        case eDisplayChannelsR:
+        case eDisplayChannelsG:
+        case eDisplayChannelsB:
+        case eDisplayChannelsY:
+
+            return true;
+        case eDisplayChannelsA:
+        case eDisplayChannelsMatte:
+
+            return !viewerParamsAlphaChannelName.empty() && (viewerParamsAlphaLayer.getNumComponents() > 0) && (viewerParamsAlphaLayer == viewerParamsLayer);
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Fills the state of the viewer the flipbook textures depend on.
+     * Returns false if the flipbook cache cannot be used with the current viewer settings.
+     **/
+    bool getFlipbookDisplayState(U64 viewerHash,
+                                 ViewerFlipbookCache::DisplayState* state) const;
+
+    /**
+     * @brief Returns the min/max of the given image in the roi for auto-contrast. The roi is split along a fixed grid
+     * and the statistics of each tile are kept, so that only the tiles that were not computed yet for this image are scanned.
+     * If multiThreaded is true, the tiles are scanned in parallel.
+     **/
+    void findAutoContrastVminVmaxFromTiles(int textureIndex,
+                                           const ImagePtr& image,
+                                           DisplayChannelsEnum channels,
+                                           const RectI& roi,
+                                           bool useCachedStats,
+                                           bool multiThreaded,
+                                           double* vmin,
+                                           double* vmax);
+
     void fillGammaLut(double gamma)
     {
         // gammaLookupMutex should already be locked
@@ -357,10 +466,18 @@ public Q_SLOTS:
      **/
     void updateViewer(UpdateViewerParamsPtr params);
 
+    /**
+     * @brief Slot called internally by the renderViewer() function when a part of the tiles of a frame
+     * is ready to be displayed, before the whole frame is rendered. Do not call this yourself.
+     **/
+    void updateViewerTiles(BufferableObjectPtrList tiles);
+
 Q_SIGNALS:
 
     void mustRedrawViewer();
 
+    void mustUpdateViewerTiles(BufferableObjectPtrList tiles);
+
 public:
     const ViewerInstance* const instance;
     OpenGLViewerI* uiContext; // written in the main thread before render thread creation, accessed from render thread
@@ -407,6 +524,13 @@ public:
      */
     std::list<RectD> partialUpdateRects;
 
+    // The display-ready textures of the frames played back, @see ViewerFlipbookCache
+    ViewerFlipbookCache flipbook;
+
+    // The per-tile statistics of the image displayed with auto-contrast for each texture
+    mutable QMutex autoContrastStatsMutex;
+    AutoContrastTileStats autoContrastStats[2];
+
     /*
      * @brief If set, the viewport center will be updated to this point upon the next update of the texture, this is protected by
      * viewerParamsMutex
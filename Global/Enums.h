@@ -486,6 +486,15 @@ enum SchedulingPolicyEnum
     eSchedulingPolicyOrdered ///frames will be rendered in order
 };
 
+///The priority class of a render, the tiles of renders of higher priority go ahead of the ones of renders of lower priority in the thread pool queue
+enum RenderPriorityEnum
+{
+    eRenderPriorityBackground = 0, ///renders to disk, frames decoded ahead of playback
+    eRenderPriorityPreview, ///node previews
+    eRenderPriorityPlayback, ///viewer playback
+    eRenderPriorityInteractive ///viewer renders in response to user interaction
+};
+
 enum DisplayChannelsEnum
 {
     eDisplayChannelsRGB = 0,
@@ -8,8 +8,11 @@
     Profile: compatibility
     Extensions:
         GL_APPLE_vertex_array_object,
+        GL_ARB_buffer_storage,
         GL_ARB_framebuffer_object,
+        GL_ARB_map_buffer_range,
         GL_ARB_pixel_buffer_object,
+        GL_ARB_sync,
         GL_ARB_texture_float,
         GL_ARB_vertex_array_object,
         GL_ARB_vertex_buffer_object,
@@ -19,9 +22,9 @@
     Omit khrplatform: True
 
     Commandline:
-        --profile="compatibility" --api="gl=2.0" --generator="c-debug" --spec="gl" --omit-khrplatform --extensions="GL_APPLE_vertex_array_object,GL_ARB_framebuffer_object,GL_ARB_pixel_buffer_object,GL_ARB_texture_float,GL_ARB_vertex_array_object,GL_ARB_vertex_buffer_object,GL_EXT_framebuffer_object"
+        --profile="compatibility" --api="gl=2.0" --generator="c-debug" --spec="gl" --omit-khrplatform --extensions="GL_APPLE_vertex_array_object,GL_ARB_buffer_storage,GL_ARB_framebuffer_object,GL_ARB_map_buffer_range,GL_ARB_pixel_buffer_object,GL_ARB_sync,GL_ARB_texture_float,GL_ARB_vertex_array_object,GL_ARB_vertex_buffer_object,GL_EXT_framebuffer_object"
     Online:
-        http://glad.dav1d.de/#profile=compatibility&language=c-debug&specification=gl&loader=on&api=gl%3D2.0&extensions=GL_APPLE_vertex_array_object&extensions=GL_ARB_framebuffer_object&extensions=GL_ARB_pixel_buffer_object&extensions=GL_ARB_texture_float&extensions=GL_ARB_vertex_array_object&extensions=GL_ARB_vertex_buffer_object&extensions=GL_EXT_framebuffer_object
+        http://glad.dav1d.de/#profile=compatibility&language=c-debug&specification=gl&loader=on&api=gl%3D2.0&extensions=GL_APPLE_vertex_array_object&extensions=GL_ARB_buffer_storage&extensions=GL_ARB_framebuffer_object&extensions=GL_ARB_map_buffer_range&extensions=GL_ARB_pixel_buffer_object&extensions=GL_ARB_sync&extensions=GL_ARB_texture_float&extensions=GL_ARB_vertex_array_object&extensions=GL_ARB_vertex_buffer_object&extensions=GL_EXT_framebuffer_object
 */
 
 
@@ -3257,6 +3260,34 @@ GLAPI PFNGLVERTEXATTRIBPOINTERPROC glad_debug_glVertexAttribPointer;
 #define glVertexAttribPointer glad_debug_glVertexAttribPointer
 #endif
 #define GL_VERTEX_ARRAY_BINDING_APPLE 0x85B5
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#define GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT 0x00004000
+#define GL_BUFFER_IMMUTABLE_STORAGE 0x821F
+#define GL_BUFFER_STORAGE_FLAGS 0x8220
+#define GL_MAP_READ_BIT 0x0001
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#define GL_MAP_FLUSH_EXPLICIT_BIT 0x0010
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#define GL_MAX_SERVER_WAIT_TIMEOUT 0x9111
+#define GL_OBJECT_TYPE 0x9112
+#define GL_SYNC_CONDITION 0x9113
+#define GL_SYNC_STATUS 0x9114
+#define GL_SYNC_FLAGS 0x9115
+#define GL_SYNC_FENCE 0x9116
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_UNSIGNALED 0x9118
+#define GL_SIGNALED 0x9119
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFF
 #define GL_INVALID_FRAMEBUFFER_OPERATION 0x0506
 #define GL_FRAMEBUFFER_ATTACHMENT_COLOR_ENCODING 0x8210
 #define GL_FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE 0x8211
@@ -3457,6 +3488,14 @@ GLAPI PFNGLISVERTEXARRAYAPPLEPROC glad_glIsVertexArrayAPPLE;
 GLAPI PFNGLISVERTEXARRAYAPPLEPROC glad_debug_glIsVertexArrayAPPLE;
 #define glIsVertexArrayAPPLE glad_debug_glIsVertexArrayAPPLE
 #endif
+#ifndef GL_ARB_buffer_storage
+#define GL_ARB_buffer_storage 1
+GLAPI int GLAD_GL_ARB_buffer_storage;
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+GLAPI PFNGLBUFFERSTORAGEPROC glad_glBufferStorage;
+GLAPI PFNGLBUFFERSTORAGEPROC glad_debug_glBufferStorage;
+#define glBufferStorage glad_debug_glBufferStorage
+#endif
 #ifndef GL_ARB_framebuffer_object
 #define GL_ARB_framebuffer_object 1
 GLAPI int GLAD_GL_ARB_framebuffer_object;
@@ -3541,10 +3580,54 @@ GLAPI PFNGLFRAMEBUFFERTEXTURELAYERPROC glad_glFramebufferTextureLayer;
 GLAPI PFNGLFRAMEBUFFERTEXTURELAYERPROC glad_debug_glFramebufferTextureLayer;
 #define glFramebufferTextureLayer glad_debug_glFramebufferTextureLayer
 #endif
+#ifndef GL_ARB_map_buffer_range
+#define GL_ARB_map_buffer_range 1
+GLAPI int GLAD_GL_ARB_map_buffer_range;
+typedef void * (APIENTRYP PFNGLMAPBUFFERRANGEPROC)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+GLAPI PFNGLMAPBUFFERRANGEPROC glad_glMapBufferRange;
+GLAPI PFNGLMAPBUFFERRANGEPROC glad_debug_glMapBufferRange;
+#define glMapBufferRange glad_debug_glMapBufferRange
+typedef void (APIENTRYP PFNGLFLUSHMAPPEDBUFFERRANGEPROC)(GLenum target, GLintptr offset, GLsizeiptr length);
+GLAPI PFNGLFLUSHMAPPEDBUFFERRANGEPROC glad_glFlushMappedBufferRange;
+GLAPI PFNGLFLUSHMAPPEDBUFFERRANGEPROC glad_debug_glFlushMappedBufferRange;
+#define glFlushMappedBufferRange glad_debug_glFlushMappedBufferRange
+#endif
 #ifndef GL_ARB_pixel_buffer_object
 #define GL_ARB_pixel_buffer_object 1
 GLAPI int GLAD_GL_ARB_pixel_buffer_object;
 #endif
+#ifndef GL_ARB_sync
+#define GL_ARB_sync 1
+GLAPI int GLAD_GL_ARB_sync;
+typedef GLsync (APIENTRYP PFNGLFENCESYNCPROC)(GLenum condition, GLbitfield flags);
+GLAPI PFNGLFENCESYNCPROC glad_glFenceSync;
+GLAPI PFNGLFENCESYNCPROC glad_debug_glFenceSync;
+#define glFenceSync glad_debug_glFenceSync
+typedef GLboolean (APIENTRYP PFNGLISSYNCPROC)(GLsync sync);
+GLAPI PFNGLISSYNCPROC glad_glIsSync;
+GLAPI PFNGLISSYNCPROC glad_debug_glIsSync;
+#define glIsSync glad_debug_glIsSync
+typedef void (APIENTRYP PFNGLDELETESYNCPROC)(GLsync sync);
+GLAPI PFNGLDELETESYNCPROC glad_glDeleteSync;
+GLAPI PFNGLDELETESYNCPROC glad_debug_glDeleteSync;
+#define glDeleteSync glad_debug_glDeleteSync
+typedef GLenum (APIENTRYP PFNGLCLIENTWAITSYNCPROC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+GLAPI PFNGLCLIENTWAITSYNCPROC glad_glClientWaitSync;
+GLAPI PFNGLCLIENTWAITSYNCPROC glad_debug_glClientWaitSync;
+#define glClientWaitSync glad_debug_glClientWaitSync
+typedef void (APIENTRYP PFNGLWAITSYNCPROC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+GLAPI PFNGLWAITSYNCPROC glad_glWaitSync;
+GLAPI PFNGLWAITSYNCPROC glad_debug_glWaitSync;
+#define glWaitSync glad_debug_glWaitSync
+typedef void (APIENTRYP PFNGLGETINTEGER64VPROC)(GLenum pname, GLint64 *data);
+GLAPI PFNGLGETINTEGER64VPROC glad_glGetInteger64v;
+GLAPI PFNGLGETINTEGER64VPROC glad_debug_glGetInteger64v;
+#define glGetInteger64v glad_debug_glGetInteger64v
+typedef void (APIENTRYP PFNGLGETSYNCIVPROC)(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei *length, GLint *values);
+GLAPI PFNGLGETSYNCIVPROC glad_glGetSynciv;
+GLAPI PFNGLGETSYNCIVPROC glad_debug_glGetSynciv;
+#define glGetSynciv glad_debug_glGetSynciv
+#endif
 #ifndef GL_ARB_texture_float
 #define GL_ARB_texture_float 1
 GLAPI int GLAD_GL_ARB_texture_float;
@@ -8,8 +8,11 @@
     Profile: compatibility
     Extensions:
         GL_APPLE_vertex_array_object,
+        GL_ARB_buffer_storage,
         GL_ARB_framebuffer_object,
+        GL_ARB_map_buffer_range,
         GL_ARB_pixel_buffer_object,
+        GL_ARB_sync,
         GL_ARB_texture_float,
         GL_ARB_vertex_array_object,
         GL_ARB_vertex_buffer_object,
@@ -19,9 +22,9 @@
     Omit khrplatform: True
 
     Commandline:
-        --profile="compatibility" --api="gl=2.0" --generator="c-debug" --spec="gl" --omit-khrplatform --extensions="GL_APPLE_vertex_array_object,GL_ARB_framebuffer_object,GL_ARB_pixel_buffer_object,GL_ARB_texture_float,GL_ARB_vertex_array_object,GL_ARB_vertex_buffer_object,GL_EXT_framebuffer_object"
+        --profile="compatibility" --api="gl=2.0" --generator="c-debug" --spec="gl" --omit-khrplatform --extensions="GL_APPLE_vertex_array_object,GL_ARB_buffer_storage,GL_ARB_framebuffer_object,GL_ARB_map_buffer_range,GL_ARB_pixel_buffer_object,GL_ARB_sync,GL_ARB_texture_float,GL_ARB_vertex_array_object,GL_ARB_vertex_buffer_object,GL_EXT_framebuffer_object"
     Online:
-        http://glad.dav1d.de/#profile=compatibility&language=c-debug&specification=gl&loader=on&api=gl%3D2.0&extensions=GL_APPLE_vertex_array_object&extensions=GL_ARB_framebuffer_object&extensions=GL_ARB_pixel_buffer_object&extensions=GL_ARB_texture_float&extensions=GL_ARB_vertex_array_object&extensions=GL_ARB_vertex_buffer_object&extensions=GL_EXT_framebuffer_object
+        http://glad.dav1d.de/#profile=compatibility&language=c-debug&specification=gl&loader=on&api=gl%3D2.0&extensions=GL_APPLE_vertex_array_object&extensions=GL_ARB_buffer_storage&extensions=GL_ARB_framebuffer_object&extensions=GL_ARB_map_buffer_range&extensions=GL_ARB_pixel_buffer_object&extensions=GL_ARB_sync&extensions=GL_ARB_texture_float&extensions=GL_ARB_vertex_array_object&extensions=GL_ARB_vertex_buffer_object&extensions=GL_EXT_framebuffer_object
 */
 
 #include <stdio.h>
@@ -4661,6 +4664,93 @@ int GLAD_GL_ARB_vertex_array_object;
 int GLAD_GL_ARB_vertex_buffer_object;
 int GLAD_GL_ARB_pixel_buffer_object;
 int GLAD_GL_APPLE_vertex_array_object;
+int GLAD_GL_ARB_buffer_storage;
+int GLAD_GL_ARB_map_buffer_range;
+int GLAD_GL_ARB_sync;
+PFNGLBUFFERSTORAGEPROC glad_glBufferStorage;
+void APIENTRY glad_debug_impl_glBufferStorage(GLenum arg0, GLsizeiptr arg1, const void *arg2, GLbitfield arg3) {    
+    _pre_call_callback("glBufferStorage", (void*)glBufferStorage, 4, arg0, arg1, arg2, arg3);
+     glad_glBufferStorage(arg0, arg1, arg2, arg3);
+    _post_call_callback("glBufferStorage", (void*)glBufferStorage, 4, arg0, arg1, arg2, arg3);
+    
+}
+PFNGLBUFFERSTORAGEPROC glad_debug_glBufferStorage = glad_debug_impl_glBufferStorage;
+PFNGLMAPBUFFERRANGEPROC glad_glMapBufferRange;
+void * APIENTRY glad_debug_impl_glMapBufferRange(GLenum arg0, GLintptr arg1, GLsizeiptr arg2, GLbitfield arg3) {    
+    void * ret;
+    _pre_call_callback("glMapBufferRange", (void*)glMapBufferRange, 4, arg0, arg1, arg2, arg3);
+    ret =  glad_glMapBufferRange(arg0, arg1, arg2, arg3);
+    _post_call_callback("glMapBufferRange", (void*)glMapBufferRange, 4, arg0, arg1, arg2, arg3);
+    return ret;
+}
+PFNGLMAPBUFFERRANGEPROC glad_debug_glMapBufferRange = glad_debug_impl_glMapBufferRange;
+PFNGLFLUSHMAPPEDBUFFERRANGEPROC glad_glFlushMappedBufferRange;
+void APIENTRY glad_debug_impl_glFlushMappedBufferRange(GLenum arg0, GLintptr arg1, GLsizeiptr arg2) {    
+    _pre_call_callback("glFlushMappedBufferRange", (void*)glFlushMappedBufferRange, 3, arg0, arg1, arg2);
+     glad_glFlushMappedBufferRange(arg0, arg1, arg2);
+    _post_call_callback("glFlushMappedBufferRange", (void*)glFlushMappedBufferRange, 3, arg0, arg1, arg2);
+    
+}
+PFNGLFLUSHMAPPEDBUFFERRANGEPROC glad_debug_glFlushMappedBufferRange = glad_debug_impl_glFlushMappedBufferRange;
+PFNGLFENCESYNCPROC glad_glFenceSync;
+GLsync APIENTRY glad_debug_impl_glFenceSync(GLenum arg0, GLbitfield arg1) {    
+    GLsync ret;
+    _pre_call_callback("glFenceSync", (void*)glFenceSync, 2, arg0, arg1);
+    ret =  glad_glFenceSync(arg0, arg1);
+    _post_call_callback("glFenceSync", (void*)glFenceSync, 2, arg0, arg1);
+    return ret;
+}
+PFNGLFENCESYNCPROC glad_debug_glFenceSync = glad_debug_impl_glFenceSync;
+PFNGLISSYNCPROC glad_glIsSync;
+GLboolean APIENTRY glad_debug_impl_glIsSync(GLsync arg0) {    
+    GLboolean ret;
+    _pre_call_callback("glIsSync", (void*)glIsSync, 1, arg0);
+    ret =  glad_glIsSync(arg0);
+    _post_call_callback("glIsSync", (void*)glIsSync, 1, arg0);
+    return ret;
+}
+PFNGLISSYNCPROC glad_debug_glIsSync = glad_debug_impl_glIsSync;
+PFNGLDELETESYNCPROC glad_glDeleteSync;
+void APIENTRY glad_debug_impl_glDeleteSync(GLsync arg0) {    
+    _pre_call_callback("glDeleteSync", (void*)glDeleteSync, 1, arg0);
+     glad_glDeleteSync(arg0);
+    _post_call_callback("glDeleteSync", (void*)glDeleteSync, 1, arg0);
+    
+}
+PFNGLDELETESYNCPROC glad_debug_glDeleteSync = glad_debug_impl_glDeleteSync;
+PFNGLCLIENTWAITSYNCPROC glad_glClientWaitSync;
+GLenum APIENTRY glad_debug_impl_glClientWaitSync(GLsync arg0, GLbitfield arg1, GLuint64 arg2) {    
+    GLenum ret;
+    _pre_call_callback("glClientWaitSync", (void*)glClientWaitSync, 3, arg0, arg1, arg2);
+    ret =  glad_glClientWaitSync(arg0, arg1, arg2);
+    _post_call_callback("glClientWaitSync", (void*)glClientWaitSync, 3, arg0, arg1, arg2);
+    return ret;
+}
+PFNGLCLIENTWAITSYNCPROC glad_debug_glClientWaitSync = glad_debug_impl_glClientWaitSync;
+PFNGLWAITSYNCPROC glad_glWaitSync;
+void APIENTRY glad_debug_impl_glWaitSync(GLsync arg0, GLbitfield arg1, GLuint64 arg2) {    
+    _pre_call_callback("glWaitSync", (void*)glWaitSync, 3, arg0, arg1, arg2);
+     glad_glWaitSync(arg0, arg1, arg2);
+    _post_call_callback("glWaitSync", (void*)glWaitSync, 3, arg0, arg1, arg2);
+    
+}
+PFNGLWAITSYNCPROC glad_debug_glWaitSync = glad_debug_impl_glWaitSync;
+PFNGLGETINTEGER64VPROC glad_glGetInteger64v;
+void APIENTRY glad_debug_impl_glGetInteger64v(GLenum arg0, GLint64 *arg1) {    
+    _pre_call_callback("glGetInteger64v", (void*)glGetInteger64v, 2, arg0, arg1);
+     glad_glGetInteger64v(arg0, arg1);
+    _post_call_callback("glGetInteger64v", (void*)glGetInteger64v, 2, arg0, arg1);
+    
+}
+PFNGLGETINTEGER64VPROC glad_debug_glGetInteger64v = glad_debug_impl_glGetInteger64v;
+PFNGLGETSYNCIVPROC glad_glGetSynciv;
+void APIENTRY glad_debug_impl_glGetSynciv(GLsync arg0, GLenum arg1, GLsizei arg2, GLsizei *arg3, GLint *arg4) {    
+    _pre_call_callback("glGetSynciv", (void*)glGetSynciv, 5, arg0, arg1, arg2, arg3, arg4);
+     glad_glGetSynciv(arg0, arg1, arg2, arg3, arg4);
+    _post_call_callback("glGetSynciv", (void*)glGetSynciv, 5, arg0, arg1, arg2, arg3, arg4);
+    
+}
+PFNGLGETSYNCIVPROC glad_debug_glGetSynciv = glad_debug_impl_glGetSynciv;
 PFNGLBINDVERTEXARRAYAPPLEPROC glad_glBindVertexArrayAPPLE;
 void APIENTRY glad_debug_impl_glBindVertexArrayAPPLE(GLuint arg0) {    
     _pre_call_callback("glBindVertexArrayAPPLE", (void*)glBindVertexArrayAPPLE, 1, arg0);
@@ -5693,6 +5783,10 @@ static void load_GL_APPLE_vertex_array_object(GLADloadproc load) {
 	glad_glGenVertexArraysAPPLE = (PFNGLGENVERTEXARRAYSAPPLEPROC)load("glGenVertexArraysAPPLE");
 	glad_glIsVertexArrayAPPLE = (PFNGLISVERTEXARRAYAPPLEPROC)load("glIsVertexArrayAPPLE");
 }
+static void load_GL_ARB_buffer_storage(GLADloadproc load) {
+	if(!GLAD_GL_ARB_buffer_storage) return;
+	glad_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+}
 static void load_GL_ARB_framebuffer_object(GLADloadproc load) {
 	if(!GLAD_GL_ARB_framebuffer_object) return;
 	glad_glIsRenderbuffer = (PFNGLISRENDERBUFFERPROC)load("glIsRenderbuffer");
@@ -5716,6 +5810,21 @@ static void load_GL_ARB_framebuffer_object(GLADloadproc load) {
 	glad_glRenderbufferStorageMultisample = (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC)load("glRenderbufferStorageMultisample");
 	glad_glFramebufferTextureLayer = (PFNGLFRAMEBUFFERTEXTURELAYERPROC)load("glFramebufferTextureLayer");
 }
+static void load_GL_ARB_map_buffer_range(GLADloadproc load) {
+	if(!GLAD_GL_ARB_map_buffer_range) return;
+	glad_glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC)load("glMapBufferRange");
+	glad_glFlushMappedBufferRange = (PFNGLFLUSHMAPPEDBUFFERRANGEPROC)load("glFlushMappedBufferRange");
+}
+static void load_GL_ARB_sync(GLADloadproc load) {
+	if(!GLAD_GL_ARB_sync) return;
+	glad_glFenceSync = (PFNGLFENCESYNCPROC)load("glFenceSync");
+	glad_glIsSync = (PFNGLISSYNCPROC)load("glIsSync");
+	glad_glDeleteSync = (PFNGLDELETESYNCPROC)load("glDeleteSync");
+	glad_glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)load("glClientWaitSync");
+	glad_glWaitSync = (PFNGLWAITSYNCPROC)load("glWaitSync");
+	glad_glGetInteger64v = (PFNGLGETINTEGER64VPROC)load("glGetInteger64v");
+	glad_glGetSynciv = (PFNGLGETSYNCIVPROC)load("glGetSynciv");
+}
 static void load_GL_ARB_vertex_array_object(GLADloadproc load) {
 	if(!GLAD_GL_ARB_vertex_array_object) return;
 	glad_glBindVertexArray = (PFNGLBINDVERTEXARRAYPROC)load("glBindVertexArray");
@@ -5760,8 +5869,11 @@ static void load_GL_EXT_framebuffer_object(GLADloadproc load) {
 static int find_extensionsGL(void) {
 	if (!get_exts()) return 0;
 	GLAD_GL_APPLE_vertex_array_object = has_ext("GL_APPLE_vertex_array_object");
+	GLAD_GL_ARB_buffer_storage = has_ext("GL_ARB_buffer_storage");
 	GLAD_GL_ARB_framebuffer_object = has_ext("GL_ARB_framebuffer_object");
+	GLAD_GL_ARB_map_buffer_range = has_ext("GL_ARB_map_buffer_range");
 	GLAD_GL_ARB_pixel_buffer_object = has_ext("GL_ARB_pixel_buffer_object");
+	GLAD_GL_ARB_sync = has_ext("GL_ARB_sync");
 	GLAD_GL_ARB_texture_float = has_ext("GL_ARB_texture_float");
 	GLAD_GL_ARB_vertex_array_object = has_ext("GL_ARB_vertex_array_object");
 	GLAD_GL_ARB_vertex_buffer_object = has_ext("GL_ARB_vertex_buffer_object");
@@ -5835,7 +5947,10 @@ int gladLoadGLLoader(GLADloadproc load) {
 
 	if (!find_extensionsGL()) return 0;
 	load_GL_APPLE_vertex_array_object(load);
+	load_GL_ARB_buffer_storage(load);
 	load_GL_ARB_framebuffer_object(load);
+	load_GL_ARB_map_buffer_range(load);
+	load_GL_ARB_sync(load);
 	load_GL_ARB_vertex_array_object(load);
 	load_GL_ARB_vertex_buffer_object(load);
 	load_GL_EXT_framebuffer_object(load);
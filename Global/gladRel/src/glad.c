@@ -8,8 +8,11 @@
     Profile: compatibility
     Extensions:
         GL_APPLE_vertex_array_object,
+        GL_ARB_buffer_storage,
         GL_ARB_framebuffer_object,
+        GL_ARB_map_buffer_range,
         GL_ARB_pixel_buffer_object,
+        GL_ARB_sync,
         GL_ARB_texture_float,
         GL_ARB_vertex_array_object,
         GL_ARB_vertex_buffer_object,
@@ -19,9 +22,9 @@
     Omit khrplatform: True
 
     Commandline:
-        --profile="compatibility" --api="gl=2.0" --generator="c" --spec="gl" --omit-khrplatform --extensions="GL_APPLE_vertex_array_object,GL_ARB_framebuffer_object,GL_ARB_pixel_buffer_object,GL_ARB_texture_float,GL_ARB_vertex_array_object,GL_ARB_vertex_buffer_object,GL_EXT_framebuffer_object"
+        --profile="compatibility" --api="gl=2.0" --generator="c" --spec="gl" --omit-khrplatform --extensions="GL_APPLE_vertex_array_object,GL_ARB_buffer_storage,GL_ARB_framebuffer_object,GL_ARB_map_buffer_range,GL_ARB_pixel_buffer_object,GL_ARB_sync,GL_ARB_texture_float,GL_ARB_vertex_array_object,GL_ARB_vertex_buffer_object,GL_EXT_framebuffer_object"
     Online:
-        http://glad.dav1d.de/#profile=compatibility&language=c&specification=gl&loader=on&api=gl%3D2.0&extensions=GL_APPLE_vertex_array_object&extensions=GL_ARB_framebuffer_object&extensions=GL_ARB_pixel_buffer_object&extensions=GL_ARB_texture_float&extensions=GL_ARB_vertex_array_object&extensions=GL_ARB_vertex_buffer_object&extensions=GL_EXT_framebuffer_object
+        http://glad.dav1d.de/#profile=compatibility&language=c&specification=gl&loader=on&api=gl%3D2.0&extensions=GL_APPLE_vertex_array_object&extensions=GL_ARB_buffer_storage&extensions=GL_ARB_framebuffer_object&extensions=GL_ARB_map_buffer_range&extensions=GL_ARB_pixel_buffer_object&extensions=GL_ARB_sync&extensions=GL_ARB_texture_float&extensions=GL_ARB_vertex_array_object&extensions=GL_ARB_vertex_buffer_object&extensions=GL_EXT_framebuffer_object
 */
 
 #include <stdio.h>
@@ -800,6 +803,19 @@ int GLAD_GL_ARB_vertex_array_object;
 int GLAD_GL_ARB_vertex_buffer_object;
 int GLAD_GL_ARB_pixel_buffer_object;
 int GLAD_GL_APPLE_vertex_array_object;
+int GLAD_GL_ARB_buffer_storage;
+int GLAD_GL_ARB_map_buffer_range;
+int GLAD_GL_ARB_sync;
+PFNGLBUFFERSTORAGEPROC glad_glBufferStorage;
+PFNGLMAPBUFFERRANGEPROC glad_glMapBufferRange;
+PFNGLFLUSHMAPPEDBUFFERRANGEPROC glad_glFlushMappedBufferRange;
+PFNGLFENCESYNCPROC glad_glFenceSync;
+PFNGLISSYNCPROC glad_glIsSync;
+PFNGLDELETESYNCPROC glad_glDeleteSync;
+PFNGLCLIENTWAITSYNCPROC glad_glClientWaitSync;
+PFNGLWAITSYNCPROC glad_glWaitSync;
+PFNGLGETINTEGER64VPROC glad_glGetInteger64v;
+PFNGLGETSYNCIVPROC glad_glGetSynciv;
 PFNGLBINDVERTEXARRAYAPPLEPROC glad_glBindVertexArrayAPPLE;
 PFNGLDELETEVERTEXARRAYSAPPLEPROC glad_glDeleteVertexArraysAPPLE;
 PFNGLGENVERTEXARRAYSAPPLEPROC glad_glGenVertexArraysAPPLE;
@@ -1429,6 +1445,10 @@ static void load_GL_APPLE_vertex_array_object(GLADloadproc load) {
 	glad_glGenVertexArraysAPPLE = (PFNGLGENVERTEXARRAYSAPPLEPROC)load("glGenVertexArraysAPPLE");
 	glad_glIsVertexArrayAPPLE = (PFNGLISVERTEXARRAYAPPLEPROC)load("glIsVertexArrayAPPLE");
 }
+static void load_GL_ARB_buffer_storage(GLADloadproc load) {
+	if(!GLAD_GL_ARB_buffer_storage) return;
+	glad_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+}
 static void load_GL_ARB_framebuffer_object(GLADloadproc load) {
 	if(!GLAD_GL_ARB_framebuffer_object) return;
 	glad_glIsRenderbuffer = (PFNGLISRENDERBUFFERPROC)load("glIsRenderbuffer");
@@ -1452,6 +1472,21 @@ static void load_GL_ARB_framebuffer_object(GLADloadproc load) {
 	glad_glRenderbufferStorageMultisample = (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC)load("glRenderbufferStorageMultisample");
 	glad_glFramebufferTextureLayer = (PFNGLFRAMEBUFFERTEXTURELAYERPROC)load("glFramebufferTextureLayer");
 }
+static void load_GL_ARB_map_buffer_range(GLADloadproc load) {
+	if(!GLAD_GL_ARB_map_buffer_range) return;
+	glad_glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC)load("glMapBufferRange");
+	glad_glFlushMappedBufferRange = (PFNGLFLUSHMAPPEDBUFFERRANGEPROC)load("glFlushMappedBufferRange");
+}
+static void load_GL_ARB_sync(GLADloadproc load) {
+	if(!GLAD_GL_ARB_sync) return;
+	glad_glFenceSync = (PFNGLFENCESYNCPROC)load("glFenceSync");
+	glad_glIsSync = (PFNGLISSYNCPROC)load("glIsSync");
+	glad_glDeleteSync = (PFNGLDELETESYNCPROC)load("glDeleteSync");
+	glad_glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)load("glClientWaitSync");
+	glad_glWaitSync = (PFNGLWAITSYNCPROC)load("glWaitSync");
+	glad_glGetInteger64v = (PFNGLGETINTEGER64VPROC)load("glGetInteger64v");
+	glad_glGetSynciv = (PFNGLGETSYNCIVPROC)load("glGetSynciv");
+}
 static void load_GL_ARB_vertex_array_object(GLADloadproc load) {
 	if(!GLAD_GL_ARB_vertex_array_object) return;
 	glad_glBindVertexArray = (PFNGLBINDVERTEXARRAYPROC)load("glBindVertexArray");
@@ -1496,8 +1531,11 @@ static void load_GL_EXT_framebuffer_object(GLADloadproc load) {
 static int find_extensionsGL(void) {
 	if (!get_exts()) return 0;
 	GLAD_GL_APPLE_vertex_array_object = has_ext("GL_APPLE_vertex_array_object");
+	GLAD_GL_ARB_buffer_storage = has_ext("GL_ARB_buffer_storage");
 	GLAD_GL_ARB_framebuffer_object = has_ext("GL_ARB_framebuffer_object");
+	GLAD_GL_ARB_map_buffer_range = has_ext("GL_ARB_map_buffer_range");
 	GLAD_GL_ARB_pixel_buffer_object = has_ext("GL_ARB_pixel_buffer_object");
+	GLAD_GL_ARB_sync = has_ext("GL_ARB_sync");
 	GLAD_GL_ARB_texture_float = has_ext("GL_ARB_texture_float");
 	GLAD_GL_ARB_vertex_array_object = has_ext("GL_ARB_vertex_array_object");
 	GLAD_GL_ARB_vertex_buffer_object = has_ext("GL_ARB_vertex_buffer_object");
@@ -1571,7 +1609,10 @@ int gladLoadGLLoader(GLADloadproc load) {
 
 	if (!find_extensionsGL()) return 0;
 	load_GL_APPLE_vertex_array_object(load);
+	load_GL_ARB_buffer_storage(load);
 	load_GL_ARB_framebuffer_object(load);
+	load_GL_ARB_map_buffer_range(load);
+	load_GL_ARB_sync(load);
 	load_GL_ARB_vertex_array_object(load);
 	load_GL_ARB_vertex_buffer_object(load);
 	load_GL_EXT_framebuffer_object(load);
@@ -73,6 +73,8 @@ InfoViewerWidget::InfoViewerWidget(const QString & description,
                              "<font color=orange>Format:</font>  The resolution of the input (where the image is displayed)<br />"
                              "<font color=orange>RoD:</font>  The region of definition of the displayed image (where the data is defined)<br />"
                              "<font color=orange>Fps:</font>  (Only active during playback) The frame-rate of the play-back sustained by the viewer<br />"
+                             "<font color=orange>Playback statistics:</font>  (Only active during playback) The number of frames dropped "
+                             "and the median and 95th percentile of the delay with which the frames were displayed<br />"
                              "<font color=orange>Coordinates:</font>  The coordinates of the current mouse location<br />"
                              "<font color=orange>RGBA:</font>  The RGBA color of the displayed image. Note that if some <b>?</b> are set instead of colors "
                              "that means the underlying image cannot be accessed internally, you should refresh the viewer to make it available. "
@@ -132,6 +134,9 @@ InfoViewerWidget::InfoViewerWidget(const QString & description,
         _fpsLabel->hide();
     }
 
+    _playbackStatsLabel = new Label(this);
+    _playbackStatsLabel->hide();
+
     coordMouse = new Label(this);
     {
         QFontMetrics fm = coordMouse->fontMetrics();
@@ -161,6 +166,7 @@ InfoViewerWidget::InfoViewerWidget(const QString & description,
     layout->addWidget(resolution);
     layout->addWidget(coordDispWindow);
     layout->addWidget(_fpsLabel);
+    layout->addWidget(_playbackStatsLabel);
     layout->addWidget(coordMouse);
     layout->addWidget(rgbaValues);
     layout->addWidget(color);
@@ -202,12 +208,38 @@ InfoViewerWidget::setFps(double actualFps,
     }
 }
 
+void
+InfoViewerWidget::setPlaybackStats(int droppedFrames,
+                                   double latencyMedian,
+                                   double latency95)
+{
+    const QFont& font = _playbackStatsLabel->font();
+    QString colorStr = droppedFrames > 0 ? QString::fromUtf8("orange") : QString::fromUtf8("#DBE0E0");
+    QString str = QString::fromUtf8("<font color=\"") + colorStr + QString::fromUtf8("\" face=\"%1\" size=%2>")
+                  .arg( font.family() )
+                  .arg( font.pixelSize() );
+
+    str.append( tr("%1 dropped, latency %2/%3 ms")
+                .arg(droppedFrames)
+                .arg( QString::number(latencyMedian * 1000., 'f', 0) )
+                .arg( QString::number(latency95 * 1000., 'f', 0) ) );
+    str.append( QString::fromUtf8("</font>") );
+
+    _playbackStatsLabel->setText(str);
+    if ( !_playbackStatsLabel->isVisible() ) {
+        _playbackStatsLabel->show();
+    }
+}
+
 void
 InfoViewerWidget::hideFps()
 {
     if ( _fpsLabel->isVisible() ) {
         _fpsLabel->hide();
     }
+    if ( _playbackStatsLabel->isVisible() ) {
+        _playbackStatsLabel->hide();
+    }
 }
 
 bool
@@ -82,6 +82,7 @@ public Q_SLOTS:
     void hideMouseInfo();
     void showMouseInfo();
     void setFps(double actualFps, double desiredFps);
+    void setPlaybackStats(int droppedFrames, double latencyMedian, double latency95);
     void hideFps();
 
 private:
@@ -102,6 +103,7 @@ private:
     Label* color;
     Label* hvl_lastOption;
     Label* _fpsLabel;
+    Label* _playbackStatsLabel;
     ImagePlaneDesc _comp;
     bool _colorValid;
     bool _colorApprox;
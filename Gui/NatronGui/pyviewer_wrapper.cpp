@@ -165,6 +165,103 @@ static PyObject* Sbk_PyViewerFunc_getFrameRange(PyObject* self)
     return pyResult;
 }
 
+static PyObject* Sbk_PyViewerFunc_getPlaybackDroppedFrames(PyObject* self)
+{
+    ::PyViewer* cppSelf = 0;
+    SBK_UNUSED(cppSelf)
+    if (!Shiboken::Object::isValid(self))
+        return 0;
+    cppSelf = ((::PyViewer*)Shiboken::Conversions::cppPointer(SbkNatronGuiTypes[SBK_PYVIEWER_IDX], (SbkObject*)self));
+    PyObject* pyResult = 0;
+
+    // Call function/method
+    {
+
+        if (!PyErr_Occurred()) {
+            // getPlaybackDroppedFrames()const
+            int cppResult = const_cast<const ::PyViewer*>(cppSelf)->getPlaybackDroppedFrames();
+            pyResult = Shiboken::Conversions::copyToPython(Shiboken::Conversions::PrimitiveTypeConverter<int>(), &cppResult);
+        }
+    }
+
+    if (PyErr_Occurred() || !pyResult) {
+        Py_XDECREF(pyResult);
+        return 0;
+    }
+    return pyResult;
+}
+
+static PyObject* Sbk_PyViewerFunc_getPlaybackFrameLatency(PyObject* self, PyObject* pyArg)
+{
+    ::PyViewer* cppSelf = 0;
+    SBK_UNUSED(cppSelf)
+    if (!Shiboken::Object::isValid(self))
+        return 0;
+    cppSelf = ((::PyViewer*)Shiboken::Conversions::cppPointer(SbkNatronGuiTypes[SBK_PYVIEWER_IDX], (SbkObject*)self));
+    PyObject* pyResult = 0;
+    int overloadId = -1;
+    PythonToCppFunc pythonToCpp;
+    SBK_UNUSED(pythonToCpp)
+
+    // Overloaded function decisor
+    // 0: getPlaybackFrameLatency(double)const
+    if ((pythonToCpp = Shiboken::Conversions::isPythonToCppConvertible(Shiboken::Conversions::PrimitiveTypeConverter<double>(), (pyArg)))) {
+        overloadId = 0; // getPlaybackFrameLatency(double)const
+    }
+
+    // Function signature not found.
+    if (overloadId == -1) goto Sbk_PyViewerFunc_getPlaybackFrameLatency_TypeError;
+
+    // Call function/method
+    {
+        double cppArg0;
+        pythonToCpp(pyArg, &cppArg0);
+
+        if (!PyErr_Occurred()) {
+            // getPlaybackFrameLatency(double)const
+            double cppResult = const_cast<const ::PyViewer*>(cppSelf)->getPlaybackFrameLatency(cppArg0);
+            pyResult = Shiboken::Conversions::copyToPython(Shiboken::Conversions::PrimitiveTypeConverter<double>(), &cppResult);
+        }
+    }
+
+    if (PyErr_Occurred() || !pyResult) {
+        Py_XDECREF(pyResult);
+        return 0;
+    }
+    return pyResult;
+
+    Sbk_PyViewerFunc_getPlaybackFrameLatency_TypeError:
+        const char* overloads[] = {"float", 0};
+        Shiboken::setErrorAboutWrongArguments(pyArg, "NatronGui.PyViewer.getPlaybackFrameLatency", overloads);
+        return 0;
+}
+
+static PyObject* Sbk_PyViewerFunc_getPlaybackFps(PyObject* self)
+{
+    ::PyViewer* cppSelf = 0;
+    SBK_UNUSED(cppSelf)
+    if (!Shiboken::Object::isValid(self))
+        return 0;
+    cppSelf = ((::PyViewer*)Shiboken::Conversions::cppPointer(SbkNatronGuiTypes[SBK_PYVIEWER_IDX], (SbkObject*)self));
+    PyObject* pyResult = 0;
+
+    // Call function/method
+    {
+
+        if (!PyErr_Occurred()) {
+            // getPlaybackFps()const
+            double cppResult = const_cast<const ::PyViewer*>(cppSelf)->getPlaybackFps();
+            pyResult = Shiboken::Conversions::copyToPython(Shiboken::Conversions::PrimitiveTypeConverter<double>(), &cppResult);
+        }
+    }
+
+    if (PyErr_Occurred() || !pyResult) {
+        Py_XDECREF(pyResult);
+        return 0;
+    }
+    return pyResult;
+}
+
 static PyObject* Sbk_PyViewerFunc_getProxyIndex(PyObject* self)
 {
     ::PyViewer* cppSelf = 0;
@@ -690,6 +787,9 @@ static PyMethodDef Sbk_PyViewer_methods[] = {
     {"getCurrentFrame", (PyCFunction)Sbk_PyViewerFunc_getCurrentFrame, METH_NOARGS},
     {"getCurrentView", (PyCFunction)Sbk_PyViewerFunc_getCurrentView, METH_NOARGS},
     {"getFrameRange", (PyCFunction)Sbk_PyViewerFunc_getFrameRange, METH_NOARGS},
+    {"getPlaybackDroppedFrames", (PyCFunction)Sbk_PyViewerFunc_getPlaybackDroppedFrames, METH_NOARGS},
+    {"getPlaybackFps", (PyCFunction)Sbk_PyViewerFunc_getPlaybackFps, METH_NOARGS},
+    {"getPlaybackFrameLatency", (PyCFunction)Sbk_PyViewerFunc_getPlaybackFrameLatency, METH_O},
     {"getProxyIndex", (PyCFunction)Sbk_PyViewerFunc_getProxyIndex, METH_NOARGS},
     {"isProxyModeEnabled", (PyCFunction)Sbk_PyViewerFunc_isProxyModeEnabled, METH_NOARGS},
     {"pause", (PyCFunction)Sbk_PyViewerFunc_pause, METH_NOARGS},
@@ -34,6 +34,7 @@ CLANG_DIAG_ON(uninitialized)
 
 #include "Engine/Node.h"
 #include "Engine/NodeGroup.h"
+#include "Engine/OutputSchedulerThread.h"
 #include "Engine/PyNodeGroup.h"
 #include "Engine/PyNode.h"
 #include "Engine/PyParameter.h" // ColorTuple
@@ -822,5 +823,35 @@ PyViewer::getCurrentView() const
     return _viewer->getCurrentView().value();
 }
 
+double
+PyViewer::getPlaybackFps() const
+{
+    if ( !getInternalNode()->isActivated() ) {
+        return 0.;
+    }
+
+    return getInternalNode()->isEffectViewer()->getRenderEngine()->getActualFPS();
+}
+
+int
+PyViewer::getPlaybackDroppedFrames() const
+{
+    if ( !getInternalNode()->isActivated() ) {
+        return 0;
+    }
+
+    return getInternalNode()->isEffectViewer()->getRenderEngine()->getDroppedFrames();
+}
+
+double
+PyViewer::getPlaybackFrameLatency(double percentile) const
+{
+    if ( !getInternalNode()->isActivated() ) {
+        return 0.;
+    }
+
+    return getInternalNode()->isEffectViewer()->getRenderEngine()->getFrameLatencyPercentile(percentile);
+}
+
 NATRON_PYTHON_NAMESPACE_EXIT
 NATRON_NAMESPACE_EXIT
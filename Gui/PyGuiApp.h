@@ -106,6 +106,13 @@ public:
 
     /* Python API: do not use ViewIdx */
     int getCurrentView() const;
+
+    /* Statistics of the last playback */
+    double getPlaybackFps() const;
+
+    int getPlaybackDroppedFrames() const;
+
+    double getPlaybackFrameLatency(double percentile) const;
 };
 
 class GuiApp
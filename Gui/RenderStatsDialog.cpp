@@ -34,6 +34,7 @@
 #include <QCheckBox>
 #include <QItemSelectionModel>
 #include <QtCore/QRegExp>
+#include <QtCore/QVariant>
 
 #include "Engine/Node.h"
 #include "Engine/Timer.h"
@@ -64,8 +65,10 @@
 #define COL_NB_CACHE_HIT 13
 #define COL_NB_CACHE_HIT_DOWNSCALED 14
 #define COL_NB_CACHE_MISS 15
+#define COL_MUTEX_CONTENTIONS 16
+#define COL_OFX_ACTIONS 17
 
-#define NUM_COLS 16
+#define NUM_COLS 18
 
 NATRON_NAMESPACE_ENTER
 
@@ -76,6 +79,10 @@ enum ItemsRoleEnum
     eItemsRoleIdentityTilesInfo = 102,
     eItemsRoleRenderedTilesNb = 103,
     eItemsRoleRenderedTilesInfo = 104,
+    eItemsRoleMutexContentionsNb = 105,
+    eItemsRoleMutexWaitTime = 106,
+    eItemsRoleActionsTime = 107,
+    eItemsRoleActionsInfo = 108,
 };
 
 struct RowInfo
@@ -110,6 +117,12 @@ struct StatRowsCompare
         case COL_TIME:
 
             return lhs.item->data( (int)eItemsRoleTime ).toDouble() < rhs.item->data( (int)eItemsRoleTime ).toDouble();
+        case COL_MUTEX_CONTENTIONS:
+
+            return lhs.item->data( (int)eItemsRoleMutexWaitTime ).toDouble() < rhs.item->data( (int)eItemsRoleMutexWaitTime ).toDouble();
+        case COL_OFX_ACTIONS:
+
+            return lhs.item->data( (int)eItemsRoleActionsTime ).toDouble() < rhs.item->data( (int)eItemsRoleActionsTime ).toDouble();
         default:
 
             return lhs.item->text() < rhs.item->text();
@@ -645,6 +658,107 @@ public:
                 }
             }
         }
+        {
+            TableItem* item = 0;
+            int nb = 0;
+            double waitTime = 0.;
+            if (exists) {
+                item = view->item(row, COL_MUTEX_CONTENTIONS);
+                if (item) {
+                    nb = item->data( (int)eItemsRoleMutexContentionsNb ).toInt();
+                    waitTime = item->data( (int)eItemsRoleMutexWaitTime ).toDouble();
+                }
+            } else {
+                item = new TableItem;
+                QString tt = NATRON_NAMESPACE::convertFromPlainText(tr("The number of times a thread rendering this node had to wait "
+                                                               "for another thread to release one of the OpenFX mutexes of the plug-in, "
+                                                               "and the time spent waiting across all threads."), NATRON_NAMESPACE::WhiteSpaceNormal);
+                item->setToolTip(tt);
+                item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+            }
+            assert(item);
+            if (item) {
+                int nbContentions;
+                double timeWaited;
+                stats.getMutexContentions(&nbContentions, &timeWaited);
+                nb += nbContentions;
+                waitTime += timeWaited;
+
+                QString str = QString::number(nb);
+                if (nb > 0) {
+                    str += QString::fromUtf8(" (") + Timer::printAsTime(waitTime, false) + QLatin1Char(')');
+                }
+                if (nodeUi) {
+                    item->setTextColor(Qt::black);
+                    item->setBackgroundColor(c);
+                }
+                item->setData( (int)eItemsRoleMutexContentionsNb, nb );
+                item->setData( (int)eItemsRoleMutexWaitTime, waitTime );
+                item->setText(str);
+                if (!exists) {
+                    view->setItem(row, COL_MUTEX_CONTENTIONS, item);
+                }
+            }
+        }
+        {
+            TableItem* item = 0;
+            // For each action: the number of calls and the time spent
+            QVariantMap actions;
+            if (exists) {
+                item = view->item(row, COL_OFX_ACTIONS);
+                if (item) {
+                    actions = item->data( (int)eItemsRoleActionsInfo ).toMap();
+                }
+            } else {
+                item = new TableItem;
+                QString tt = NATRON_NAMESPACE::convertFromPlainText(tr("The number of calls to each OpenFX action of the plug-in and the time spent in them, "
+                                                               "excluding the time spent in the actions they triggered on other nodes."), NATRON_NAMESPACE::WhiteSpaceNormal);
+                item->setToolTip(tt);
+                item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+            }
+            assert(item);
+            if (item) {
+                const ActionCallStatsMap& actionCalls = stats.getActionCalls();
+                for (ActionCallStatsMap::const_iterator it = actionCalls.begin(); it != actionCalls.end(); ++it) {
+                    QString name = QString::fromUtf8( it->first.c_str() );
+                    QVariantList callsInfo = actions.value(name).toList();
+                    int nbCalls = it->second.getNumberOfCalls();
+                    double timeSpent = it->second.getTotalTimeSpent();
+                    if (callsInfo.size() == 2) {
+                        nbCalls += callsInfo[0].toInt();
+                        timeSpent += callsInfo[1].toDouble();
+                    }
+                    callsInfo.clear();
+                    callsInfo << nbCalls << timeSpent;
+                    actions[name] = callsInfo;
+                }
+
+                double totalTimeSpent = 0.;
+                QString str;
+                for (QVariantMap::const_iterator it = actions.begin(); it != actions.end(); ++it) {
+                    QVariantList callsInfo = it.value().toList();
+                    assert(callsInfo.size() == 2);
+                    if (callsInfo.size() != 2) {
+                        continue;
+                    }
+                    totalTimeSpent += callsInfo[1].toDouble();
+                    if ( !str.isEmpty() ) {
+                        str += QString::fromUtf8(", ");
+                    }
+                    str += it.key() + QString::fromUtf8(": ") + QString::number( callsInfo[0].toInt() ) + QString::fromUtf8(" (") + Timer::printAsTime(callsInfo[1].toDouble(), false) + QLatin1Char(')');
+                }
+                if (nodeUi) {
+                    item->setTextColor(Qt::black);
+                    item->setBackgroundColor(c);
+                }
+                item->setData( (int)eItemsRoleActionsInfo, actions );
+                item->setData( (int)eItemsRoleActionsTime, totalTimeSpent );
+                item->setText(str);
+                if (!exists) {
+                    view->setItem(row, COL_OFX_ACTIONS, item);
+                }
+            }
+        }
         if (!exists) {
             rows.push_back(node);
         }
@@ -890,7 +1004,9 @@ RenderStatsDialog::RenderStatsDialog(Gui* gui)
         << tr("Rendered Planes")
         << tr("Cache Hits")
         << tr("Cache Hits Higher Scale")
-        << tr("Cache Misses");
+        << tr("Cache Misses")
+        << tr("Mutex Contentions")
+        << tr("OpenFX Actions");
 
     _imp->view->setColumnCount( dimensionNames.size() );
     _imp->view->setHorizontalHeaderLabels(dimensionNames);
@@ -964,6 +1080,8 @@ RenderStatsDialog::refreshAdvancedColsVisibility()
     _imp->view->setColumnHidden(COL_NB_CACHE_HIT, !checked);
     _imp->view->setColumnHidden(COL_NB_CACHE_HIT_DOWNSCALED, !checked);
     _imp->view->setColumnHidden(COL_NB_CACHE_MISS, !checked);
+    _imp->view->setColumnHidden(COL_MUTEX_CONTENTIONS, !checked);
+    _imp->view->setColumnHidden(COL_OFX_ACTIONS, !checked);
 }
 
 void
@@ -34,7 +34,12 @@ const char* fragRGB =
     "uniform float offset;\n"
     "uniform int lut;\n"
     "uniform float gamma;\n"
+    "uniform int channels;\n" // DisplayChannelsEnum, 0 (RGB) if the texture already holds the display channels
+    "uniform int alphaIndex;\n" // index of the alpha channel for the A and matte channels
     "\n"
+    "float channel_at(vec4 c, int i) {\n"
+    "    return (i == 0) ? c.r : ((i == 1) ? c.g : ((i == 2) ? c.b : c.a));\n"
+    "}\n"
     "float linear_to_srgb(float c) {\n"
     "    return (c<=0.0031308) ? (12.92*c) : (((1.0+0.055)*pow(c,1.0/2.4))-0.055);\n"
     "}\n"
@@ -43,6 +48,19 @@ const char* fragRGB =
     "}\n"
     "void main(){\n"
     "    vec4 color_tmp = texture2D(Tex,gl_TexCoord[0].st);\n"
+    "    if (channels == 1) { // R\n"
+    "       color_tmp.rgb = vec3(color_tmp.r);\n"
+    "    } else if (channels == 2) { // G\n"
+    "       color_tmp.rgb = vec3(color_tmp.g);\n"
+    "    } else if (channels == 3) { // B\n"
+    "       color_tmp.rgb = vec3(color_tmp.b);\n"
+    "    } else if (channels == 4) { // A\n"
+    "       color_tmp.rgb = vec3(alphaIndex < 0 ? color_tmp.a : channel_at(color_tmp, alphaIndex));\n"
+    "    } else if (channels == 5) { // Luminance\n"
+    "       color_tmp.rgb = vec3( dot(color_tmp.rgb, vec3(0.299, 0.587, 0.114)) );\n"
+    "    } else if (channels == 6 && alphaIndex >= 0) { // Matte overlay\n"
+    "       color_tmp.r += channel_at(color_tmp, alphaIndex) * 0.5;\n"
+    "    }\n"
     "    color_tmp.rgb = (color_tmp.rgb * gain) + offset;\n"
     "    if(lut == 0){ // srgb\n"
 // << TO SRGB
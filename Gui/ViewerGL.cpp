@@ -1211,14 +1211,14 @@ ViewerGL::getPboID(int index)
     assert( qApp && qApp->thread() == QThread::currentThread() );
     assert( QGLContext::currentContext() == context() );
 
-    if ( index >= (int)_imp->pboIds.size() ) {
-        GLuint handle;
-        glGenBuffers(1, &handle);
-        _imp->pboIds.push_back(handle);
+    if ( index >= (int)_imp->pbos.size() ) {
+        PixelBufferInfo pbo;
+        glGenBuffers(1, &pbo.id);
+        _imp->pbos.push_back(pbo);
 
-        return handle;
+        return pbo.id;
     } else {
-        return _imp->pboIds[index];
+        return _imp->pbos[index].id;
     }
 }
 
@@ -1321,6 +1321,7 @@ ViewerGL::getExactImageRectangleDisplayed(int texIndex,
     RectI bounds;
     clippedRod.toPixelEnclosing(mipMapLevel, par, &bounds);
     RectI roi = getImageRectangleDisplayed(bounds, par, mipMapLevel);
+    clipImageRectangleToWipe(texIndex, par, mipMapLevel, &roi);
 
     return roi;
 }
@@ -1347,6 +1348,7 @@ ViewerGL::getImageRectangleDisplayedRoundedToTileSize(int texIndex,
     RectI bounds;
     clippedRod.toPixelEnclosing(mipMapLevel, par, &bounds);
     RectI roi = getImageRectangleDisplayed(bounds, par, mipMapLevel);
+    clipImageRectangleToWipe(texIndex, par, mipMapLevel, &roi);
 
     ////Texrect is the coordinates of the 4 corners of the texture in the bounds with the current zoom
     ////factor taken into account.
@@ -1388,6 +1390,68 @@ ViewerGL::getImageRectangleDisplayedRoundedToTileSize(int texIndex,
     return texRect;
 }
 
+void
+ViewerGL::clipImageRectangleToWipe(int texIndex,
+                                   const double par,
+                                   unsigned int mipMapLevel,
+                                   RectI* roi)
+{
+    // MT-SAFE
+    if ( roi->isNull() || getViewerTab()->isFullFrameProcessingEnabled() ) {
+        return;
+    }
+    ViewerCompositingOperatorEnum compOperator = getCompositingOperator();
+    if ( !operatorIsWipe(compOperator) ) {
+        return;
+    }
+    ViewerInstance* internalViewer = getInternalNode();
+    if (!internalViewer) {
+        return;
+    }
+    int activeInputs[2];
+    internalViewer->getActiveInputs(activeInputs[0], activeInputs[1]);
+    if ( (activeInputs[0] == activeInputs[1]) || (activeInputs[1] == -1) ) {
+        // Only the A input is displayed
+        return;
+    }
+
+    // See paintGL(): the B input is only drawn on the right side of the wipe.
+    // The A input is drawn everywhere, except with the "under" operator and a full mix where B hides it on the right side.
+    bool rightPlane;
+    if (texIndex == 1) {
+        rightPlane = true;
+    } else {
+        double wipeMix;
+        {
+            QMutexLocker l(&_imp->wipeControlsMutex);
+            wipeMix = _imp->mixAmount;
+        }
+        if ( (compOperator != eViewerCompositingOperatorWipeUnder) || (wipeMix < 1.) ) {
+            return;
+        }
+        rightPlane = false;
+    }
+
+    RectD canonicalRoI;
+    roi->toCanonical_noClipping(mipMapLevel, par, &canonicalRoI);
+    QPolygonF polygonPoints;
+    Implementation::WipePolygonEnum t = _imp->getWipePolygon(canonicalRoI, rightPlane, &polygonPoints);
+    if (t == Implementation::eWipePolygonEmpty) {
+        roi->clear();
+    } else if (t == Implementation::eWipePolygonPartial) {
+        QRectF polygonBbox = polygonPoints.boundingRect();
+        RectD visibleRect( polygonBbox.left(), polygonBbox.top(), polygonBbox.right(), polygonBbox.bottom() );
+        RectI visibleRectPixel;
+        visibleRect.toPixelEnclosing(mipMapLevel, par, &visibleRectPixel);
+        RectI visibleRoI;
+        if ( roi->intersect(visibleRectPixel, &visibleRoI) ) {
+            *roi = visibleRoI;
+        } else {
+            roi->clear();
+        }
+    }
+} // ViewerGL::clipImageRectangleToWipe
+
 int
 ViewerGL::isExtensionSupported(const char *extension)
 {
@@ -1491,6 +1555,7 @@ ViewerGL::endTransferBufferFromRAMToGPU(int textureIndex,
                                         double gamma,
                                         double offset,
                                         int lut,
+                                        bool displayChannelsInShader,
                                         bool recenterViewer,
                                         const Point& viewportCenter,
                                         bool isPartialRect)
@@ -1514,6 +1579,7 @@ ViewerGL::endTransferBufferFromRAMToGPU(int textureIndex,
         info.memoryHeldByLastRenderedImages = 0;
         info.isPartialImage = true;
         info.isVisible = true;
+        info.displayChannelsInShader = displayChannelsInShader;
         _imp->partialUpdateTextures.push_back(info);
         // Update time otherwise overlays won't refresh
         _imp->displayTextures[0].time = time;
@@ -1528,6 +1594,7 @@ ViewerGL::endTransferBufferFromRAMToGPU(int textureIndex,
         _imp->displayingImageLut = (ViewerColorSpaceEnum)lut;
         _imp->displayTextures[textureIndex].premult = premult;
         _imp->displayTextures[textureIndex].time = time;
+        _imp->displayTextures[textureIndex].displayChannelsInShader = displayChannelsInShader;
 
         if (_imp->displayTextures[textureIndex].memoryHeldByLastRenderedImages > 0) {
             internalNode->unregisterPluginMemory(_imp->displayTextures[textureIndex].memoryHeldByLastRenderedImages);
@@ -1571,18 +1638,20 @@ ViewerGL::transferBufferFromRAMtoGPU(const unsigned char* ramBuffer,
     // always running in the main thread
     assert( qApp && qApp->thread() == QThread::currentThread() );
     assert( QGLContext::currentContext() == context() );
-    GLenum e = glGetError();
-    Q_UNUSED(e);
-
+    // Do not call glGetError() here: this is called for each tile and it would
+    // synchronize with the GPU, defeating the purpose of the PBOs.
     GLint currentBoundPBO = 0;
     glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING_ARB, &currentBoundPBO);
-    GLenum err = glGetError();
-    if ( (err != GL_NO_ERROR) || (currentBoundPBO != 0) ) {
-        qDebug() << "(ViewerGL::allocateAndMapPBO): Another PBO is currently mapped, glMap failed.";
+#ifdef DEBUG
+    if (currentBoundPBO != 0) {
+        qDebug() << "(ViewerGL::transferBufferFromRAMtoGPU): Another PBO is currently bound.";
     }
+#endif
 
-    // We use 2 PBOs to make use of asynchronous data uploading
-    GLuint pboId = getPboID(_imp->updateViewerPboIndex);
+    // We cycle through a ring of PBOs to make use of asynchronous data uploading:
+    // the tile uploaded by the GPU from one PBO does not block the copy of the next tile in the following one
+    const int pboIndex = _imp->updateViewerPboIndex;
+    GLuint pboId = getPboID(pboIndex);
 
     // The bitdepth of the texture
     ImageBitDepthEnum bd = getBitDepth();
@@ -1633,23 +1702,80 @@ ViewerGL::transferBufferFromRAMtoGPU(const unsigned char* ramBuffer,
     // bind PBO to update texture source
     glBindBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB, pboId );
 
-    // Note that glMapBufferARB() causes sync issue.
-    // If GPU is working with this buffer, glMapBufferARB() will wait(stall)
-    // until GPU to finish its job. To avoid waiting (idle), you can call
-    // first glBufferDataARB() with NULL pointer before glMapBufferARB().
-    // If you do that, the previous data in PBO will be discarded and
-    // glMapBufferARB() returns a new allocated pointer immediately
-    // even if GPU is still working with the previous data.
-    glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, bytesCount, NULL, GL_DYNAMIC_DRAW_ARB);
-
-    // map the buffer object into client's memory
-    GLvoid *ret = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
-    glCheckError();
-    assert(ret);
+    PixelBufferInfo& pbo = _imp->pbos[pboIndex];
+    GLvoid *pboData = 0;
+    if (_imp->persistentPbosSupported) {
+        // The data store is immutable and stays mapped for the lifetime of the PBO, so that
+        // uploading a tile never maps, unmaps or re-allocates anything in the driver.
+        // Since the store is coherent, the tile written below is visible to the GPU without flushing.
+        const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        if (bytesCount > pbo.capacity) {
+            // An immutable store cannot be re-specified: replace the buffer object
+            if (pbo.fence) {
+                glDeleteSync(pbo.fence);
+                pbo.fence = 0;
+            }
+            glDeleteBuffers(1, &pbo.id);
+            glGenBuffers(1, &pbo.id);
+            pboId = pbo.id;
+            glBindBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB, pboId );
+            pbo.capacity = bytesCount;
+            glBufferStorage(GL_PIXEL_UNPACK_BUFFER_ARB, pbo.capacity, NULL, mapFlags);
+            pbo.mappedData = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER_ARB, 0, pbo.capacity, mapFlags);
+            if (!pbo.mappedData) {
+                // The driver advertises the extensions but cannot map the store: fall back on orphaning
+                // from now on. The immutable buffers cannot be re-specified, so they are all replaced.
+                _imp->persistentPbosSupported = false;
+                for (std::size_t i = 0; i < _imp->pbos.size(); ++i) {
+                    if (_imp->pbos[i].fence) {
+                        glDeleteSync(_imp->pbos[i].fence);
+                    }
+                    glDeleteBuffers(1, &_imp->pbos[i].id);
+                    glGenBuffers(1, &_imp->pbos[i].id);
+                    _imp->pbos[i].capacity = 0;
+                    _imp->pbos[i].mappedData = 0;
+                    _imp->pbos[i].fence = 0;
+                }
+                pboId = pbo.id;
+                glBindBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB, pboId );
+            }
+        } else if (pbo.fence) {
+            // Wait until the GPU has consumed the tile previously uploaded from this PBO.
+            // With a ring of NATRON_VIEWER_PBO_RING_SIZE PBOs, the fence is almost always already signaled.
+            glClientWaitSync(pbo.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(pbo.fence);
+            pbo.fence = 0;
+        }
+        pboData = pbo.mappedData;
+    }
+
+    const bool persistentPbo = pboData != 0;
+    if (!persistentPbo) {
+        // Note that glMapBufferARB() causes sync issue.
+        // If GPU is working with this buffer, glMapBufferARB() will wait(stall)
+        // until GPU to finish its job. To avoid waiting (idle), you can call
+        // first glBufferDataARB() with NULL pointer before glMapBufferARB().
+        // If you do that, the previous data in PBO will be discarded and
+        // glMapBufferARB() returns a new allocated pointer immediately
+        // even if GPU is still working with the previous data.
+        // The data store keeps the largest size requested so far: since all tiles have the same size,
+        // the driver can recycle the orphaned stores instead of allocating new ones.
+        if (bytesCount > pbo.capacity) {
+            pbo.capacity = bytesCount;
+        }
+        glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo.capacity, NULL, GL_STREAM_DRAW_ARB);
+
+        // map the buffer object into client's memory
+        pboData = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+        glCheckError();
+    }
+    assert(pboData);
     assert(ramBuffer);
-    if (ret && ramBuffer) {
+    if (pboData && ramBuffer) {
         // update data directly on the mapped buffer
-        std::memcpy(ret, (void*)ramBuffer, bytesCount);
+        std::memcpy(pboData, (void*)ramBuffer, bytesCount);
+    }
+    if (pboData && !persistentPbo) {
         GLboolean result = glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB); // release the mapped buffer
         assert(result == GL_TRUE);
         Q_UNUSED(result);
@@ -1661,6 +1787,11 @@ ViewerGL::transferBufferFromRAMtoGPU(const unsigned char* ramBuffer,
     // Use offset instead of pointer (last parameter is 0).
     tex->fillOrAllocateTexture(textureRectangle, tileRect, true, 0);
 
+    if (persistentPbo) {
+        // The PBO can only be written again once the GPU has read this tile
+        pbo.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
     // restore previously bound PBO
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, currentBoundPBO);
     //glBindTexture(GL_TEXTURE_2D, 0); // why should we bind texture 0?
@@ -1668,7 +1799,7 @@ ViewerGL::transferBufferFromRAMtoGPU(const unsigned char* ramBuffer,
 
     *texture = tex;
 
-    _imp->updateViewerPboIndex = (_imp->updateViewerPboIndex + 1) % 2;
+    _imp->updateViewerPboIndex = (_imp->updateViewerPboIndex + 1) % NATRON_VIEWER_PBO_RING_SIZE;
 } // ViewerGL::transferBufferFromRAMtoGPU
 
 void
@@ -2444,6 +2575,8 @@ ViewerGL::penMotionInternal(int x,
         QMutexLocker l(&_imp->wipeControlsMutex);
         _imp->wipeCenter.rx() -= dxSinceLastMove;
         _imp->wipeCenter.ry() -= dySinceLastMove;
+        l.unlock();
+        checkIfWipeRoIValidOrRender();
         mustRedraw = true;
         break;
     }
@@ -2454,6 +2587,8 @@ ViewerGL::penMotionInternal(int x,
                                        oldPosition_opengl.x() - _imp->wipeCenter.x() );
         _imp->mixAmount -= (angle - prevAngle);
         _imp->mixAmount = std::max( 0., std::min(_imp->mixAmount, 1.) );
+        l.unlock();
+        checkIfWipeRoIValidOrRender();
         mustRedraw = true;
         break;
     }
@@ -2466,7 +2601,8 @@ ViewerGL::penMotionInternal(int x,
             // snap to closest multiple of PI / 2.
             _imp->wipeAngle = closestPI2;
         }
-
+        l.unlock();
+        checkIfWipeRoIValidOrRender();
         mustRedraw = true;
         break;
     }
@@ -2723,6 +2859,34 @@ ViewerGL::checkIfViewPortRoIValidOrRenderForInput(int texIndex)
     return true;
 }
 
+void
+ViewerGL::checkIfWipeRoIValidOrRender()
+{
+    if ( getViewerTab()->getGui()->getApp()->getProject()->isLoadingProject() ) {
+        return;
+    }
+    unsigned int mipMapLevel = (unsigned int)std::max( (int)getInternalNode()->getMipMapLevelFromZoomFactor(), (int)getInternalNode()->getViewerMipMapLevel() );
+    for (int i = 0; i < 2; ++i) {
+        if ( !_imp->displayTextures[i].texture || _imp->displayTextures[i].rod.isNull() ) {
+            continue;
+        }
+        // The input may have been rendered only on its side of the wipe or not at all, @see clipImageRectangleToWipe
+        RectI roi = getImageRectangleDisplayedRoundedToTileSize(i, _imp->displayTextures[i].rod, _imp->displayTextures[i].texture->getTextureRect().par, mipMapLevel, 0, 0, 0, 0);
+        if ( roi.isNull() ) {
+            continue;
+        }
+        if ( !_imp->displayTextures[i].isVisible || !_imp->displayTextures[i].texture->getTextureRect().contains(roi) ) {
+            ViewerInstance* viewer = getInternalNode();
+            assert(viewer);
+            if (viewer) {
+                viewer->getRenderEngine()->abortRenderingAutoRestart();
+                viewer->renderCurrentFrame(true);
+            }
+            break;
+        }
+    }
+}
+
 void
 ViewerGL::checkIfViewPortRoIValidOrRender()
 {
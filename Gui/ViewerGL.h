@@ -190,6 +190,7 @@ public:
                                                double gamma,
                                                double offset,
                                                int lut,
+                                               bool displayChannelsInShader,
                                                bool recenterViewer,
                                                const Point& viewportCenter,
                                                bool isPartialRect) OVERRIDE FINAL;
@@ -521,6 +522,17 @@ private:
 
     bool checkIfViewPortRoIValidOrRenderForInput(int texIndex);
 
+    /**
+     * @brief Restricts the RoI of the given input to the part of the viewer where it is visible with the current wipe.
+     * This is MT-safe.
+     **/
+    void clipImageRectangleToWipe(int texIndex, const double par, unsigned int mipMapLevel, RectI* roi);
+
+    /**
+     * @brief Renders the current frame if the wipe moved over a part of an input that was not rendered yet.
+     **/
+    void checkIfWipeRoIValidOrRender();
+
     bool penMotionInternal(int x, int y, double pressure, double timestamp, QInputEvent* event);
 
     /**
@@ -37,6 +37,7 @@
 #include "Engine/Lut.h" // Color
 #include "Engine/Settings.h"
 #include "Engine/Texture.h"
+#include "Engine/ViewerInstance.h"
 
 #include "Gui/Gui.h"
 #include "Gui/GuiApplicationManager.h" // appFont
@@ -62,7 +63,8 @@ NATRON_NAMESPACE_ENTER
 ViewerGL::Implementation::Implementation(ViewerGL* this_,
                                          ViewerTab* parent)
     : _this(this_)
-    , pboIds()
+    , pbos()
+    , persistentPbosSupported(false)
     , vboVerticesId(0)
     , vboTexturesId(0)
     , iboTriangleStripId(0)
@@ -158,8 +160,12 @@ ViewerGL::Implementation::~Implementation()
 
     if ( appPTR && appPTR->isOpenGLLoaded() ) {
         glCheckError();
-        for (U32 i = 0; i < this->pboIds.size(); ++i) {
-            glDeleteBuffers(1, &this->pboIds[i]);
+        for (U32 i = 0; i < this->pbos.size(); ++i) {
+            if (this->pbos[i].fence) {
+                glDeleteSync(this->pbos[i].fence);
+            }
+            // deleting a buffer object unmaps it
+            glDeleteBuffers(1, &this->pbos[i].id);
         }
         glCheckError();
         glDeleteBuffers(1, &this->vboVerticesId);
@@ -433,6 +439,8 @@ ViewerGL::Implementation::initializeGL()
     _this->makeCurrent();
     initAndCheckGlExtensions();
 
+    persistentPbosSupported = GLAD_GL_ARB_buffer_storage && GLAD_GL_ARB_map_buffer_range && GLAD_GL_ARB_sync;
+
     int format, internalFormat, glType;
     Texture::getRecommendedTexParametersForRGBAByteTexture(&format, &internalFormat, &glType);
     displayTextures[0].texture.reset( new Texture(GL_TEXTURE_2D, GL_LINEAR, GL_NEAREST, GL_CLAMP_TO_EDGE, Texture::eDataTypeByte, format, internalFormat, glType) );
@@ -878,6 +886,19 @@ ViewerGL::Implementation::activateShaderRGB(int texIndex)
     shaderRGB->setUniformValue("lut", (GLint)displayingImageLut);
     float gamma = displayTextures[texIndex].gamma;
     shaderRGB->setUniformValue("gamma", gamma);
+
+    // Textures converted on the CPU already contain the display channels, display them as RGB
+    DisplayChannelsEnum channels = eDisplayChannelsRGB;
+    int alphaChannelIndex = -1;
+    ViewerInstance* internalNode = _this->getInternalNode();
+    if ( displayTextures[texIndex].displayChannelsInShader && internalNode &&
+         !internalNode->getDisplayChannelsForShader(texIndex, &channels, &alphaChannelIndex) ) {
+        // A render with the new channels is on its way, show the layer meanwhile
+        channels = eDisplayChannelsRGB;
+        alphaChannelIndex = -1;
+    }
+    shaderRGB->setUniformValue("channels", (GLint)channels);
+    shaderRGB->setUniformValue("alphaIndex", (GLint)alphaChannelIndex);
 }
 
 bool
@@ -48,6 +48,9 @@ CLANG_DIAG_ON(uninitialized)
 
 #define MAX_MIP_MAP_LEVELS 20
 
+// Number of PBOs cycled through when uploading the viewer tiles to the display textures
+#define NATRON_VIEWER_PBO_RING_SIZE 3
+
 NATRON_NAMESPACE_ENTER
 
 /*This class is the the core of the viewer : what displays images, overlays, etc...
@@ -114,6 +117,7 @@ struct TextureInfo
         , memoryHeldByLastRenderedImages(0)
         , isPartialImage(false)
         , isVisible(false)
+        , displayChannelsInShader(false)
     {
     }
 
@@ -138,6 +142,31 @@ struct TextureInfo
 
     // false if this input is disconnected for the viewer
     bool isVisible;
+
+    // true if the texture holds the unconverted layer and the display channels must be selected by the shader
+    bool displayChannelsInShader;
+};
+
+struct PixelBufferInfo
+{
+    PixelBufferInfo()
+        : id(0)
+        , capacity(0)
+        , mappedData(0)
+        , fence(0)
+    {
+    }
+
+    GLuint id;
+
+    // The size of the data store, which is never shrunk
+    std::size_t capacity;
+
+    // When the data store is immutable (ARB_buffer_storage), it stays persistently mapped here
+    void* mappedData;
+
+    // Signaled when the GPU is done uploading the last tile from the persistently mapped store
+    GLsync fence;
 };
 
 struct ViewerGL::Implementation
@@ -151,7 +180,8 @@ struct ViewerGL::Implementation
 
     /////////////////////////////////////////////////////////
     // The following are only accessed from the main thread:
-    std::vector<GLuint> pboIds; //!< PBO's id's used by the OpenGL context
+    std::vector<PixelBufferInfo> pbos; //!< PBOs used by the OpenGL context to upload the tiles
+    bool persistentPbosSupported; //!< true if the PBOs can be persistently mapped and fenced
     //   GLuint vaoId; //!< VAO holding the rendering VBOs for texture mapping.
     GLuint vboVerticesId; //!< VBO holding the vertices for the texture mapping.
     GLuint vboTexturesId; //!< VBO holding texture coordinates.
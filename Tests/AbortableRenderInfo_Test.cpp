@@ -0,0 +1,47 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#include <gtest/gtest.h>
+
+#include "Engine/AbortableRenderInfo.h"
+
+NATRON_NAMESPACE_USING
+
+TEST(AbortableRenderInfo,
+     Priority)
+{
+    ///Renders are interactive unless told otherwise
+    AbortableRenderInfoPtr render = AbortableRenderInfo::create(true, 0);
+    EXPECT_EQ( eRenderPriorityInteractive, render->getPriority() );
+
+    render->setPriority(eRenderPriorityBackground);
+    EXPECT_EQ( eRenderPriorityBackground, render->getPriority() );
+
+    ///The priority is handed as is to the thread pool, which starts the runnables of higher priority first
+    EXPECT_LT( (int)eRenderPriorityBackground, (int)eRenderPriorityPreview );
+    EXPECT_LT( (int)eRenderPriorityPreview, (int)eRenderPriorityPlayback );
+    EXPECT_LT( (int)eRenderPriorityPlayback, (int)eRenderPriorityInteractive );
+}
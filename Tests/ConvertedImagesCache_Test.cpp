@@ -0,0 +1,170 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#include <vector>
+
+#if !defined(Q_MOC_RUN) && !defined(SBK_RUN)
+#include <boost/make_shared.hpp>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "Engine/ConvertedImagesCache.h"
+#include "Engine/Image.h"
+
+NATRON_NAMESPACE_USING
+
+static ImagePtr
+makeImage(const ImagePlaneDesc& components,
+          ImageBitDepthEnum depth,
+          bool useBitmap)
+{
+    RectI bounds(0, 0, 64, 64);
+    RectD rod(0., 0., 64., 64.);
+
+    return boost::make_shared<Image>(components, rod, bounds, 0, 1., depth, eImagePremultiplicationPremultiplied, eImageFieldingOrderNone, useBitmap);
+}
+
+///The conversion of an RGBA byte image to RGB float
+static ConvertedImagesCache::ConversionKey
+makeKey()
+{
+    ConvertedImagesCache::ConversionKey key;
+
+    key.targetComponents = ImagePlaneDesc::getRGBComponents();
+    key.targetDepth = eImageBitDepthFloat;
+    key.srcColorSpace = eViewerColorSpaceSRGB;
+    key.dstColorSpace = eViewerColorSpaceLinear;
+    key.channelForAlpha = 3;
+
+    return key;
+}
+
+TEST(ConvertedImagesCache,
+     Keying)
+{
+    ConvertedImagesCache cache;
+    ImagePtr source = makeImage(ImagePlaneDesc::getRGBAComponents(), eImageBitDepthByte, false);
+    ImagePtr converted = makeImage(ImagePlaneDesc::getRGBComponents(), eImageBitDepthFloat, false);
+    ConvertedImagesCache::ConversionKey key = makeKey();
+    RectI roi(0, 0, 32, 32);
+    RectI roiToConvert;
+
+    ///Nothing is found before the conversion is inserted, and the requested region is to be converted
+    EXPECT_TRUE( !cache.get(source, key, roi, &roiToConvert) );
+    EXPECT_EQ(roi, roiToConvert);
+
+    cache.insert(source, key, converted, roi);
+    EXPECT_EQ( converted, cache.get(source, key, roi, &roiToConvert) );
+    EXPECT_EQ( converted, cache.get(source, key, RectI(8, 8, 16, 16), &roiToConvert) ) << "A region covered by the conversion";
+
+    ///Each parameter of the conversion is part of the key
+    std::vector<ConvertedImagesCache::ConversionKey> otherKeys(8, key);
+    otherKeys[0].targetComponents = ImagePlaneDesc::getRGBAComponents(); // same plane ID, other number of components
+    otherKeys[1].targetComponents = ImagePlaneDesc::getAlphaComponents();
+    otherKeys[2].targetDepth = eImageBitDepthHalf;
+    otherKeys[3].srcColorSpace = eViewerColorSpaceLinear;
+    otherKeys[4].dstColorSpace = eViewerColorSpaceRec709;
+    otherKeys[5].channelForAlpha = -1;
+    otherKeys[6].useAlpha0 = true;
+    otherKeys[7].unPremult = true;
+    for (std::size_t i = 0; i < otherKeys.size(); ++i) {
+        EXPECT_TRUE(otherKeys[i] < key || key < otherKeys[i]) << "key " << i;
+        EXPECT_TRUE( !cache.get(source, otherKeys[i], roi, &roiToConvert) ) << "key " << i;
+    }
+
+    ///Each conversion of the same source has its own entry
+    ImagePtr convertedRGBA = makeImage(ImagePlaneDesc::getRGBAComponents(), eImageBitDepthFloat, false);
+    cache.insert(source, otherKeys[0], convertedRGBA, roi);
+    EXPECT_EQ( convertedRGBA, cache.get(source, otherKeys[0], roi, &roiToConvert) );
+    EXPECT_EQ( converted, cache.get(source, key, roi, &roiToConvert) );
+
+    ///Another source image with the same conversion is not found
+    ImagePtr otherSource = makeImage(ImagePlaneDesc::getRGBAComponents(), eImageBitDepthByte, false);
+    EXPECT_TRUE( !cache.get(otherSource, key, roi, &roiToConvert) );
+
+    cache.clear();
+    EXPECT_TRUE( !cache.get(source, key, roi, &roiToConvert) );
+}
+
+TEST(ConvertedImagesCache,
+     Regions)
+{
+    ConvertedImagesCache cache;
+    ImagePtr source = makeImage(ImagePlaneDesc::getRGBAComponents(), eImageBitDepthByte, true);
+    ImagePtr converted = makeImage(ImagePlaneDesc::getRGBComponents(), eImageBitDepthFloat, false);
+    ConvertedImagesCache::ConversionKey key = makeKey();
+    RectI roi(0, 0, 32, 32);
+    RectI otherRoI(32, 0, 64, 32);
+    RectI roiToConvert;
+
+    cache.insert(source, key, converted, roi);
+
+    ///A region that is not covered is converted on its own while the source is not fully rendered
+    source->markForRendered(roi);
+    EXPECT_TRUE( !cache.get(source, key, otherRoI, &roiToConvert) );
+    EXPECT_EQ(otherRoI, roiToConvert);
+
+    ///Once all the pixels of the source are rendered, the whole image is converted
+    source->markForRendered( source->getBounds() );
+    EXPECT_TRUE( !cache.get(source, key, otherRoI, &roiToConvert) );
+    EXPECT_EQ(source->getBounds(), roiToConvert);
+
+    ImagePtr convertedAll = makeImage(ImagePlaneDesc::getRGBComponents(), eImageBitDepthFloat, false);
+    cache.insert(source, key, convertedAll, roiToConvert);
+    EXPECT_EQ( convertedAll, cache.get(source, key, otherRoI, &roiToConvert) );
+    EXPECT_EQ( convertedAll, cache.get(source, key, roi, &roiToConvert) );
+
+    ///A smaller conversion inserted by another thread does not replace a larger one
+    cache.insert(source, key, converted, roi);
+    EXPECT_EQ( convertedAll, cache.get(source, key, otherRoI, &roiToConvert) );
+}
+
+TEST(ConvertedImagesCache,
+     WeakReferences)
+{
+    ConvertedImagesCache cache;
+    ImagePtr source = makeImage(ImagePlaneDesc::getRGBAComponents(), eImageBitDepthByte, false);
+    ImagePtr converted = makeImage(ImagePlaneDesc::getRGBComponents(), eImageBitDepthFloat, false);
+    ConvertedImagesCache::ConversionKey key = makeKey();
+    RectI roi(0, 0, 32, 32);
+    RectI roiToConvert;
+
+    ///The cache does not keep the converted image alive
+    cache.insert(source, key, converted, roi);
+    ImageWPtr convertedWeak = converted;
+    converted.reset();
+    EXPECT_TRUE( convertedWeak.expired() );
+    EXPECT_TRUE( !cache.get(source, key, roi, &roiToConvert) );
+    EXPECT_EQ(roi, roiToConvert);
+
+    ///Nor the source image
+    converted = makeImage(ImagePlaneDesc::getRGBComponents(), eImageBitDepthFloat, false);
+    cache.insert(source, key, converted, roi);
+    ImageWPtr sourceWeak = source;
+    source.reset();
+    EXPECT_TRUE( sourceWeak.expired() );
+}
@@ -0,0 +1,176 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#if !defined(Q_MOC_RUN) && !defined(SBK_RUN)
+#include <boost/make_shared.hpp>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "Engine/FrameEntry.h"
+#include "Engine/ImagePlaneDesc.h"
+#include "Engine/TextureRect.h"
+#include "Engine/ViewIdx.h"
+
+#define TILE_SIZE 16
+
+NATRON_NAMESPACE_USING
+
+///Makes a viewer cache tile of TILE_SIZE x TILE_SIZE RGBA pixels, held in RAM since there is no cache
+static FrameEntryPtr
+makeTile(ImageBitDepthEnum bitDepth)
+{
+    TextureRect rect(0, 0, TILE_SIZE, TILE_SIZE, TILE_SIZE, 1.);
+    FrameKey key(0, 0, 0, 1., 1., 0, (int)bitDepth, (int)eDisplayChannelsRGB, ViewIdx(0), rect, 0, std::string(),
+                 ImagePlaneDesc::getRGBAComponents(), std::string(), true, false);
+    RectI bounds(0, 0, TILE_SIZE, TILE_SIZE);
+    FrameParamsPtr params( new FrameParams(bounds, (int)bitDepth, bounds, ImagePtr() ) );
+
+    params->getStorageInfo().mode = eStorageModeRAM;
+    FrameEntryPtr entry = boost::make_shared<FrameEntry>(key, params, (const CacheAPI*)0);
+    entry->allocateMemory();
+
+    return entry;
+}
+
+static bool
+hasSignBit(float f)
+{
+    // 1 / -0 is -infinity
+    return (f < 0.f) || ( (f == 0.f) && (1.f / f < 0.f) );
+}
+
+///Checks that the values survive a round-trip through a compressed tile, within the given relative error
+static void
+checkRoundTrip(const std::vector<float>& values,
+               double relativeError)
+{
+    FrameEntryPtr tile = makeTile(eImageBitDepthHalf);
+
+    ASSERT_TRUE( tile->isCompressed() );
+
+    const std::size_t nElements = TILE_SIZE * TILE_SIZE * 4;
+    std::vector<float> src(nElements), dst(nElements);
+    for (std::size_t i = 0; i < nElements; ++i) {
+        src[i] = values[i % values.size()];
+    }
+    tile->compress(&src[0]);
+    tile->decompress(&dst[0]);
+    for (std::size_t i = 0; i < nElements; ++i) {
+        if (relativeError == 0.) {
+            EXPECT_EQ(src[i], dst[i]) << "element " << i;
+        } else {
+            EXPECT_NEAR(src[i], dst[i], std::fabs(src[i]) * relativeError) << "element " << i;
+        }
+    }
+}
+
+TEST(FrameEntry,
+     HalfFloatExactValues)
+{
+    ///Values representable as half-floats are restored exactly, including denormals and signed zeros
+    std::vector<float> values;
+
+    values.push_back(0.f);
+    values.push_back(-0.f);
+    values.push_back(1.f);
+    values.push_back(-2.f);
+    values.push_back(0.5f);
+    values.push_back(0.099975586f); // 0x2e66
+    values.push_back(65504.f); // largest half
+    values.push_back(-65504.f);
+    values.push_back( std::ldexp(1.f, -14) ); // smallest normalized half
+    values.push_back( std::ldexp(1.f, -24) ); // smallest denormalized half
+    values.push_back( std::ldexp(3.f, -20) ); // denormalized half
+    checkRoundTrip(values, 0.);
+
+    ///The sign of zero is kept
+    FrameEntryPtr tile = makeTile(eImageBitDepthHalf);
+    std::vector<float> src(TILE_SIZE * TILE_SIZE * 4, -0.f), dst(TILE_SIZE * TILE_SIZE * 4);
+    tile->compress(&src[0]);
+    tile->decompress(&dst[0]);
+    EXPECT_TRUE( hasSignBit(dst[0]) );
+}
+
+TEST(FrameEntry,
+     HalfFloatRounding)
+{
+    ///Other values are rounded to the nearest half: the relative error is at most 2^-11
+    std::vector<float> values;
+
+    srand(2000);
+    for (int i = 0; i < 1000; ++i) {
+        // coverity[dont_call]
+        float v = (float)rand() / RAND_MAX;
+        // Cover the whole range of normalized halves, with both signs
+        v = std::ldexp(v + 1.f, i % 30 - 14);
+        values.push_back( (i % 2) ? -v : v );
+    }
+    checkRoundTrip( values, std::ldexp(1., -11) );
+
+    ///Ties are rounded to even
+    FrameEntryPtr tile = makeTile(eImageBitDepthHalf);
+    std::vector<float> src(TILE_SIZE * TILE_SIZE * 4), dst(TILE_SIZE * TILE_SIZE * 4);
+    src[0] = 1.f + std::ldexp(1.f, -11); // halfway between 1 and the next half, whose mantissa is odd
+    src[1] = 1.f + 3.f * std::ldexp(1.f, -11); // halfway between two halves, the upper one is even
+    tile->compress(&src[0]);
+    tile->decompress(&dst[0]);
+    EXPECT_EQ(1.f, dst[0]);
+    EXPECT_EQ(1.f + std::ldexp(1.f, -9), dst[1]);
+}
+
+TEST(FrameEntry,
+     HalfFloatSpecialValues)
+{
+    FrameEntryPtr tile = makeTile(eImageBitDepthHalf);
+    std::vector<float> src(TILE_SIZE * TILE_SIZE * 4), dst(TILE_SIZE * TILE_SIZE * 4);
+
+    src[0] = std::numeric_limits<float>::infinity();
+    src[1] = -std::numeric_limits<float>::infinity();
+    src[2] = std::numeric_limits<float>::quiet_NaN();
+    src[3] = 1e6f; // out of the half range
+    src[4] = -1e6f;
+    src[5] = 1e-10f; // below the smallest half
+    src[6] = -1e-10f;
+    tile->compress(&src[0]);
+    tile->decompress(&dst[0]);
+    EXPECT_EQ(std::numeric_limits<float>::infinity(), dst[0]);
+    EXPECT_EQ(-std::numeric_limits<float>::infinity(), dst[1]);
+    EXPECT_TRUE(dst[2] != dst[2]) << "NaNs are preserved";
+    EXPECT_EQ(std::numeric_limits<float>::infinity(), dst[3]);
+    EXPECT_EQ(-std::numeric_limits<float>::infinity(), dst[4]);
+    EXPECT_EQ(0.f, dst[5]);
+    EXPECT_EQ(0.f, dst[6]);
+    EXPECT_TRUE( hasSignBit(dst[6]) );
+
+    ///32-bit tiles are not compressed
+    EXPECT_FALSE( makeTile(eImageBitDepthFloat)->isCompressed() );
+}
@@ -0,0 +1,133 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#include <gtest/gtest.h>
+
+#include <QtConcurrentRun> // QtCore on Qt4, QtConcurrent on Qt5
+
+#include "Engine/OfxMutex.h"
+
+NATRON_NAMESPACE_USING
+
+static bool
+tryLockFromOtherThread(OfxMutex* mutex)
+{
+    bool locked = mutex->tryLock();
+
+    if (locked) {
+        mutex->unlock();
+    }
+
+    return locked;
+}
+
+static bool
+unlockFromOtherThread(OfxMutex* mutex)
+{
+    return mutex->unlock();
+}
+
+TEST(OfxMutex,
+     Recursion)
+{
+    OfxMutex mutex;
+
+    ASSERT_FALSE( mutex.isLocked() );
+
+    mutex.lock();
+    ASSERT_TRUE( mutex.isLocked() );
+
+    ///The owner can lock it again, with lock or tryLock
+    mutex.lock();
+    ASSERT_TRUE( mutex.tryLock() );
+
+    ///It remains locked until it is unlocked as many times as it was locked
+    ASSERT_TRUE( mutex.unlock() );
+    ASSERT_TRUE( mutex.isLocked() );
+    ASSERT_TRUE( mutex.unlock() );
+    ASSERT_TRUE( mutex.isLocked() );
+    ASSERT_TRUE( mutex.unlock() );
+    ASSERT_FALSE( mutex.isLocked() );
+
+    ///Unlocking a mutex that is not held is reported
+    ASSERT_FALSE( mutex.unlock() );
+}
+
+TEST(OfxMutex,
+     OtherThread)
+{
+    OfxMutex mutex;
+
+    mutex.lock();
+    mutex.lock();
+
+    ///Another thread cannot take it nor release it
+    EXPECT_FALSE( QtConcurrent::run(tryLockFromOtherThread, &mutex).result() );
+    EXPECT_FALSE( QtConcurrent::run(unlockFromOtherThread, &mutex).result() );
+    ASSERT_TRUE( mutex.isLocked() );
+
+    mutex.unlock();
+    EXPECT_FALSE( QtConcurrent::run(tryLockFromOtherThread, &mutex).result() ) << "The mutex is still locked once by its owner.";
+
+    mutex.unlock();
+    EXPECT_TRUE( QtConcurrent::run(tryLockFromOtherThread, &mutex).result() );
+    ASSERT_FALSE( mutex.isLocked() );
+}
+
+TEST(OfxMutexPool,
+     Recycling)
+{
+    OfxMutexPool pool;
+    OfxMutex* first = pool.createMutex();
+    OfxMutex* second = pool.createMutex();
+
+    ASSERT_TRUE(first != 0);
+    ASSERT_TRUE(second != 0);
+    ASSERT_TRUE(first != second);
+
+    ///Destroyed mutexes are handed back, the last destroyed first
+    pool.destroyMutex(first);
+    pool.destroyMutex(second);
+    EXPECT_EQ( second, pool.createMutex() );
+    EXPECT_EQ( first, pool.createMutex() );
+
+    ///A recycled mutex behaves like a new one
+    first->lock();
+    first->lock();
+    first->unlock();
+    first->unlock();
+    ASSERT_FALSE( first->isLocked() );
+
+    ///A mutex destroyed while locked is not handed to another plug-in
+    second->lock();
+    pool.destroyMutex(second);
+    OfxMutex* third = pool.createMutex();
+    ASSERT_TRUE(third != 0);
+    EXPECT_FALSE( third->isLocked() );
+
+    pool.destroyMutex(first);
+    pool.destroyMutex(third);
+}
@@ -0,0 +1,212 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#include <list>
+#include <string>
+
+#include <gtest/gtest.h>
+
+CLANG_DIAG_OFF(deprecated)
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+CLANG_DIAG_ON(deprecated)
+
+#include "Engine/OfxPluginIndex.h"
+
+NATRON_NAMESPACE_USING
+
+class OfxPluginIndexTest
+    : public testing::Test
+{
+protected:
+
+    virtual void SetUp()
+    {
+        // A search path holding a single bundle with a fake binary. The index is written outside of the
+        // search path, which it stamps.
+        _root = QDir::cleanPath( QDir::tempPath() + QString::fromUtf8("/NatronOfxPluginIndexTest-%1-%2")
+                                 .arg( QCoreApplication::applicationPid() )
+                                 .arg( QDateTime::currentMSecsSinceEpoch() ) );
+        _pluginDir = _root + QString::fromUtf8("/Plugins");
+        _bundlePath = _pluginDir + QString::fromUtf8("/Test.ofx.bundle");
+        _binaryDir = _bundlePath + QString::fromUtf8("/Contents/Linux-x86-64");
+        _binaryPath = _binaryDir + QString::fromUtf8("/Test.ofx");
+        _indexPath = _root + QString::fromUtf8("/OFXPluginIndex.bin");
+        ASSERT_TRUE( QDir().mkpath(_binaryDir) );
+        writeBinary("binary");
+    }
+
+    virtual void TearDown()
+    {
+        QFile::remove(_indexPath);
+        QFile::remove(_binaryPath);
+        QDir dir;
+        dir.rmpath(_binaryDir);
+    }
+
+    void writeBinary(const char* content)
+    {
+        QFile binary(_binaryPath);
+
+        ASSERT_TRUE( binary.open(QIODevice::WriteOnly | QIODevice::Truncate) );
+        binary.write(content);
+    }
+
+    std::list<std::string> getPluginPath() const
+    {
+        std::list<std::string> pluginPath;
+
+        pluginPath.push_back( _pluginDir.toStdString() );
+
+        return pluginPath;
+    }
+
+    static OfxPluginIndex::PluginEntry makePlugin(const char* pluginID)
+    {
+        OfxPluginIndex::PluginEntry p;
+
+        p.pluginID = QString::fromUtf8(pluginID);
+        p.pluginLabel = QString::fromUtf8("Test");
+        p.resourcesPath = QString::fromUtf8("/resources/");
+        p.iconFilePath = QString::fromUtf8("/resources/icon.png");
+        p.groupIconFilePath.push_back( QString::fromUtf8("/resources/group.png") );
+        p.grouping.push_back( QString::fromUtf8("Image") );
+        p.grouping.push_back( QString::fromUtf8("Readers") );
+        p.majorVersion = 2;
+        p.minorVersion = 3;
+        p.isReader = true;
+        p.renderThreadUnsafe = true;
+        p.openglRenderSupport = ePluginOpenGLRenderSupportYes;
+        p.shortcuts.push_back( PluginActionShortcut( "action", "Action", Key_A, KeyboardModifiers(eKeyboardModifierShift) ) );
+        p.formats.push_back("exr");
+        p.formats.push_back("tif");
+        p.evaluation = 50.;
+
+        return p;
+    }
+
+    QString _root, _pluginDir, _bundlePath, _binaryDir, _binaryPath, _indexPath;
+};
+
+TEST_F(OfxPluginIndexTest,
+       RoundTrip)
+{
+    OfxPluginIndex index;
+
+    index.setPluginPath( getPluginPath() );
+    index.addPlugin( _binaryPath.toStdString(), _bundlePath.toStdString(), makePlugin("net.sf.test.A") );
+    index.addPlugin( _binaryPath.toStdString(), _bundlePath.toStdString(), makePlugin("net.sf.test.B") );
+    ASSERT_TRUE( index.write(_indexPath) );
+
+    OfxPluginIndex readIndex;
+    ASSERT_TRUE( readIndex.read(_indexPath) );
+    ASSERT_TRUE( readIndex.isUpToDate( getPluginPath() ) );
+    ASSERT_EQ( (std::size_t)1, readIndex.getBundles().size() );
+
+    const OfxPluginIndex::BundleEntry* bundle = readIndex.findUpToDateBundle(_bundlePath);
+    ASSERT_TRUE(bundle != 0);
+    const OfxPluginIndex::BundleEntry& written = index.getBundles().begin()->second;
+    EXPECT_EQ(written.bundlePath, bundle->bundlePath);
+    EXPECT_EQ(written.binaryFilePath, bundle->binaryFilePath);
+    EXPECT_EQ(written.binaryModificationTime, bundle->binaryModificationTime);
+    EXPECT_EQ(written.binarySize, bundle->binarySize);
+    ASSERT_EQ( (std::size_t)2, bundle->plugins.size() );
+
+    const OfxPluginIndex::PluginEntry expected = makePlugin("net.sf.test.A");
+    const OfxPluginIndex::PluginEntry& p = bundle->plugins.front();
+    EXPECT_EQ(expected.pluginID, p.pluginID);
+    EXPECT_EQ(expected.pluginLabel, p.pluginLabel);
+    EXPECT_EQ(expected.resourcesPath, p.resourcesPath);
+    EXPECT_EQ(expected.iconFilePath, p.iconFilePath);
+    EXPECT_EQ(expected.groupIconFilePath, p.groupIconFilePath);
+    EXPECT_EQ(expected.grouping, p.grouping);
+    EXPECT_EQ(expected.majorVersion, p.majorVersion);
+    EXPECT_EQ(expected.minorVersion, p.minorVersion);
+    EXPECT_EQ(expected.isReader, p.isReader);
+    EXPECT_EQ(expected.isWriter, p.isWriter);
+    EXPECT_EQ(expected.isDeprecated, p.isDeprecated);
+    EXPECT_EQ(expected.isInternalOnly, p.isInternalOnly);
+    EXPECT_EQ(expected.renderThreadUnsafe, p.renderThreadUnsafe);
+    EXPECT_EQ(expected.openglRenderSupport, p.openglRenderSupport);
+    ASSERT_EQ( (std::size_t)1, p.shortcuts.size() );
+    EXPECT_EQ(expected.shortcuts.front().actionID, p.shortcuts.front().actionID);
+    EXPECT_EQ(expected.shortcuts.front().actionLabel, p.shortcuts.front().actionLabel);
+    EXPECT_EQ(expected.shortcuts.front().modifiers, p.shortcuts.front().modifiers);
+    EXPECT_EQ(expected.shortcuts.front().key, p.shortcuts.front().key);
+    EXPECT_EQ(expected.formats, p.formats);
+    EXPECT_EQ(expected.evaluation, p.evaluation);
+    EXPECT_EQ( QString::fromUtf8("net.sf.test.B"), bundle->plugins.back().pluginID );
+}
+
+TEST_F(OfxPluginIndexTest,
+       Invalidation)
+{
+    OfxPluginIndex index;
+
+    index.setPluginPath( getPluginPath() );
+    index.addPlugin( _binaryPath.toStdString(), _bundlePath.toStdString(), makePlugin("net.sf.test.A") );
+    ASSERT_TRUE( index.write(_indexPath) );
+
+    OfxPluginIndex readIndex;
+    ASSERT_TRUE( readIndex.read(_indexPath) );
+
+    ///Another search path invalidates the index
+    std::list<std::string> otherPluginPath = getPluginPath();
+    otherPluginPath.push_back( QDir::tempPath().toStdString() );
+    EXPECT_FALSE( readIndex.isUpToDate(otherPluginPath) );
+
+    ///Updating the binary invalidates its bundle
+    writeBinary("updated binary");
+    EXPECT_FALSE( readIndex.isBundleUpToDate(_bundlePath) );
+    EXPECT_TRUE( readIndex.findUpToDateBundle(_bundlePath) == 0 );
+    EXPECT_FALSE( readIndex.isUpToDate( getPluginPath() ) );
+}
+
+TEST_F(OfxPluginIndexTest,
+       CorruptedFile)
+{
+    OfxPluginIndex index;
+
+    index.setPluginPath( getPluginPath() );
+    index.addPlugin( _binaryPath.toStdString(), _bundlePath.toStdString(), makePlugin("net.sf.test.A") );
+    ASSERT_TRUE( index.write(_indexPath) );
+
+    ///A truncated index is rejected as a whole
+    QFile file(_indexPath);
+    ASSERT_TRUE( file.open(QIODevice::ReadWrite) );
+    ASSERT_TRUE( file.resize(file.size() - 4) );
+    file.close();
+
+    OfxPluginIndex readIndex;
+    EXPECT_FALSE( readIndex.read(_indexPath) );
+    EXPECT_TRUE( readIndex.getBundles().empty() );
+
+    ///So is a missing one
+    QFile::remove(_indexPath);
+    EXPECT_FALSE( readIndex.read(_indexPath) );
+}
@@ -0,0 +1,177 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#if !defined(Q_MOC_RUN) && !defined(SBK_RUN)
+#include <boost/make_shared.hpp>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "Engine/EffectInstancePrivate.h"
+#include "Engine/ParallelRenderArgs.h"
+#include "Engine/RectD.h"
+#include "Engine/ViewIdx.h"
+
+#include "BaseTest.h"
+
+NATRON_NAMESPACE_USING
+
+static const RectD renderWindow(0., 0., 100., 100.);
+
+static bool
+hasPlan(RenderPlanCache& cache,
+        U64 hash,
+        double time)
+{
+    FrameRequestMap request;
+
+    return cache.getPlan(hash, time, ViewIdx(0), 0, renderWindow, true, &request);
+}
+
+TEST(RenderPlanCache,
+     Keying)
+{
+    RenderPlanCache cache(10);
+    FrameRequestMap request;
+
+    EXPECT_FALSE( hasPlan(cache, 1, 1.) );
+
+    ///A plan depending on the time is only used for the time it was computed at
+    cache.setPlan(1, 1., ViewIdx(0), 0, renderWindow, true, false, FrameRequestMap() );
+    EXPECT_TRUE( hasPlan(cache, 1, 1.) );
+    EXPECT_FALSE( hasPlan(cache, 1, 2.) );
+
+    ///Every other render argument is part of the key
+    EXPECT_FALSE( cache.getPlan(2, 1., ViewIdx(0), 0, renderWindow, true, &request) );
+    EXPECT_FALSE( cache.getPlan(1, 1., ViewIdx(1), 0, renderWindow, true, &request) );
+    EXPECT_FALSE( cache.getPlan(1, 1., ViewIdx(0), 1, renderWindow, true, &request) );
+    EXPECT_FALSE( cache.getPlan(1, 1., ViewIdx(0), 0, RectD(0., 0., 50., 100.), true, &request) );
+    EXPECT_FALSE( cache.getPlan(1, 1., ViewIdx(0), 0, renderWindow, false, &request) );
+
+    ///A time invariant plan is used for all frames
+    cache.setPlan(1, 1., ViewIdx(1), 0, renderWindow, true, true, FrameRequestMap() );
+    EXPECT_TRUE( cache.getPlan(1, 1., ViewIdx(1), 0, renderWindow, true, &request) );
+    EXPECT_TRUE( cache.getPlan(1, 10., ViewIdx(1), 0, renderWindow, true, &request) );
+    EXPECT_TRUE( cache.getPlan(1, -3.5, ViewIdx(1), 0, renderWindow, true, &request) );
+}
+
+TEST(RenderPlanCache,
+     Invalidation)
+{
+    RenderPlanCache cache(10);
+
+    cache.setPlan(1, 1., ViewIdx(0), 0, renderWindow, true, false, FrameRequestMap() );
+    cache.setPlan(1, 2., ViewIdx(0), 0, renderWindow, true, false, FrameRequestMap() );
+    ASSERT_TRUE( hasPlan(cache, 1, 1.) );
+    ASSERT_TRUE( hasPlan(cache, 1, 2.) );
+
+    ///The plans of the previous hash of the tree are released when a plan is computed for the new hash
+    cache.setPlan(2, 1., ViewIdx(0), 0, renderWindow, true, false, FrameRequestMap() );
+    EXPECT_TRUE( hasPlan(cache, 2, 1.) );
+    EXPECT_FALSE( hasPlan(cache, 1, 1.) );
+    EXPECT_FALSE( hasPlan(cache, 1, 2.) );
+
+    ///So is a time invariant plan
+    cache.setPlan(2, 1., ViewIdx(0), 1, renderWindow, true, true, FrameRequestMap() );
+    cache.setPlan(3, 1., ViewIdx(0), 0, renderWindow, true, false, FrameRequestMap() );
+    FrameRequestMap request;
+    EXPECT_FALSE( cache.getPlan(2, 5., ViewIdx(0), 1, renderWindow, true, &request) );
+
+    cache.clearAll();
+    EXPECT_FALSE( hasPlan(cache, 3, 1.) );
+}
+
+TEST(RenderPlanCache,
+     LeastRecentlyUsed)
+{
+    RenderPlanCache cache(2);
+
+    cache.setPlan(1, 1., ViewIdx(0), 0, renderWindow, true, false, FrameRequestMap() );
+    cache.setPlan(1, 2., ViewIdx(0), 0, renderWindow, true, false, FrameRequestMap() );
+
+    ///The least recently used plan is released first
+    ASSERT_TRUE( hasPlan(cache, 1, 1.) );
+    cache.setPlan(1, 3., ViewIdx(0), 0, renderWindow, true, false, FrameRequestMap() );
+    EXPECT_TRUE( hasPlan(cache, 1, 1.) );
+    EXPECT_FALSE( hasPlan(cache, 1, 2.) );
+    EXPECT_TRUE( hasPlan(cache, 1, 3.) );
+}
+
+class RenderPlanCacheTest
+    : public BaseTest
+{
+};
+
+TEST_F(RenderPlanCacheTest,
+       TimeInvariantPlan)
+{
+    NodePtr generator = createNode(_generatorPluginID);
+    ASSERT_TRUE(generator.get() != 0);
+
+    ///A plan computed at time 1 which only references time 1
+    NodeFrameRequestPtr nodeRequest = boost::make_shared<NodeFrameRequest>();
+    nodeRequest->nodeHash = 42;
+    FrameViewPair frameView;
+    frameView.time = 1.;
+    frameView.view = ViewIdx(0);
+    FrameViewRequest& fvRequest = nodeRequest->frames[frameView];
+    fvRequest.globalData.inputIdentityTime = 1.;
+    RangeD range;
+    range.min = range.max = 1.;
+    fvRequest.globalData.frameViewsNeeded[0][ViewIdx(0)].push_back(range);
+
+    FrameRequestMap request;
+    request.insert( std::make_pair(generator, nodeRequest) );
+
+    RenderPlanCache cache(10);
+    cache.setPlan(1, 1., ViewIdx(0), 0, renderWindow, true, true, request);
+
+    ///At the time it was computed, the plan is returned as is
+    FrameRequestMap planAtTime1;
+    ASSERT_TRUE( cache.getPlan(1, 1., ViewIdx(0), 0, renderWindow, true, &planAtTime1) );
+    ASSERT_EQ( (std::size_t)1, planAtTime1.size() );
+    EXPECT_EQ( nodeRequest, planAtTime1[generator] );
+
+    ///At another time, it is a copy moved to that time, which leaves the stored plan untouched
+    FrameRequestMap planAtTime5;
+    ASSERT_TRUE( cache.getPlan(1, 5., ViewIdx(0), 0, renderWindow, true, &planAtTime5) );
+    ASSERT_EQ( (std::size_t)1, planAtTime5.size() );
+    NodeFrameRequestPtr movedRequest = planAtTime5[generator];
+    ASSERT_TRUE(movedRequest.get() != 0);
+    EXPECT_TRUE(movedRequest != nodeRequest);
+    EXPECT_EQ( (U64)42, movedRequest->nodeHash );
+    ASSERT_EQ( (std::size_t)1, movedRequest->frames.size() );
+    EXPECT_EQ( 5., movedRequest->frames.begin()->first.time );
+    const FrameViewRequestGlobalData& movedData = movedRequest->frames.begin()->second.globalData;
+    EXPECT_EQ(5., movedData.inputIdentityTime);
+    const std::vector<RangeD>& ranges = movedData.frameViewsNeeded.find(0)->second.find( ViewIdx(0) )->second;
+    ASSERT_EQ( (std::size_t)1, ranges.size() );
+    EXPECT_EQ(5., ranges[0].min);
+    EXPECT_EQ(5., ranges[0].max);
+
+    EXPECT_EQ( 1., nodeRequest->frames.begin()->first.time );
+    EXPECT_EQ(1., fvRequest.globalData.inputIdentityTime);
+}
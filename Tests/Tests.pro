@@ -49,6 +49,13 @@ SOURCES += \
     KnobFile_Test.cpp \
     Curve_Test.cpp \
     Tracker_Test.cpp \
+    OfxMutex_Test.cpp \
+    OfxPluginIndex_Test.cpp \
+    FrameEntry_Test.cpp \
+    ViewerFlipbookCache_Test.cpp \
+    ConvertedImagesCache_Test.cpp \
+    RenderPlanCache_Test.cpp \
+    AbortableRenderInfo_Test.cpp \
     wmain.cpp
 
 HEADERS += \
@@ -0,0 +1,209 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * This file is part of Natron <https://natrongithub.github.io/>,
+ * Copyright (C) 2013-2018 INRIA and Alexandre Gauthier-Foichat
+ *
+ * Natron is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Natron is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Natron.  If not, see <http://www.gnu.org/licenses/gpl-2.0.html>
+ * ***** END LICENSE BLOCK ***** */
+
+// ***** BEGIN PYTHON BLOCK *****
+// from <https://docs.python.org/3/c-api/intro.html#include-files>:
+// "Since Python may define some pre-processor definitions which affect the standard headers on some systems, you must include Python.h before any standard headers are included."
+#include <Python.h>
+// ***** END PYTHON BLOCK *****
+
+#include "Global/Macros.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if !defined(Q_MOC_RUN) && !defined(SBK_RUN)
+#include <boost/make_shared.hpp>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "Engine/UpdateViewerParams.h"
+#include "Engine/ViewerFlipbookCache.h"
+#include "Engine/ViewIdx.h"
+
+#define FRAME_SIZE 1024
+
+NATRON_NAMESPACE_USING
+
+///Makes the texture of a frame made of a single tile of FRAME_SIZE bytes filled with the time,
+///as produced by a viewer in the given state
+static BufferableObjectPtrList
+makeFrame(int time,
+          const ViewerFlipbookCache::DisplayState& state)
+{
+    UpdateViewerParamsPtr params = boost::make_shared<UpdateViewerParams>();
+
+    params->mustFreeRamBuffer = true;
+    params->time = time;
+    params->depth = state.depth;
+    params->gain = state.gain;
+    params->gamma = state.gamma;
+    params->lut = state.lut;
+    params->layer = state.layer;
+
+    UpdateViewerParams::CachedTile tile;
+    tile.ramBuffer = (unsigned char*)malloc(FRAME_SIZE);
+    tile.bytesCount = FRAME_SIZE;
+    std::memset(tile.ramBuffer, time, FRAME_SIZE);
+    params->tiles.push_back(tile);
+
+    BufferableObjectPtrList frames;
+    frames.push_back(params);
+
+    return frames;
+}
+
+static bool
+hasFrame(const ViewerFlipbookCache& cache,
+         int time,
+         const ViewerFlipbookCache::DisplayState& state)
+{
+    BufferableObjectPtrList frames;
+
+    return cache.getFrame(time, ViewIdx(0), state, &frames);
+}
+
+TEST(ViewerFlipbookCache,
+     GetFrame)
+{
+    ViewerFlipbookCache cache;
+    ViewerFlipbookCache::DisplayState state;
+    BufferableObjectPtrList inserted = makeFrame(1, state);
+
+    cache.insertFrame(1, ViewIdx(0), state, inserted, 10 * FRAME_SIZE);
+    ASSERT_FALSE( cache.isEmpty() );
+
+    ///The stored textures are a copy of the inserted ones, held by the cache
+    BufferableObjectPtrList frames;
+    ASSERT_TRUE( cache.getFrame(1, ViewIdx(0), state, &frames) );
+    ASSERT_EQ( (std::size_t)1, frames.size() );
+    UpdateViewerParamsPtr params = boost::dynamic_pointer_cast<UpdateViewerParams>( frames.front() );
+    ASSERT_TRUE(params.get() != 0);
+    EXPECT_FALSE(params->mustFreeRamBuffer);
+    EXPECT_TRUE(params->flipbookBuffer.get() != 0);
+    ASSERT_EQ( (std::size_t)1, params->tiles.size() );
+    const UpdateViewerParams::CachedTile& tile = params->tiles.front();
+    EXPECT_EQ( (std::size_t)FRAME_SIZE, tile.bytesCount );
+    EXPECT_TRUE( tile.ramBuffer != boost::dynamic_pointer_cast<UpdateViewerParams>( inserted.front() )->tiles.front().ramBuffer );
+    EXPECT_EQ( 0, std::memcmp(tile.ramBuffer, boost::dynamic_pointer_cast<UpdateViewerParams>( inserted.front() )->tiles.front().ramBuffer, FRAME_SIZE) );
+
+    ///Other frames and views are not found
+    EXPECT_FALSE( hasFrame(cache, 2, state) );
+    EXPECT_FALSE( cache.getFrame(1, ViewIdx(1), state, &frames) );
+
+    cache.clear();
+    EXPECT_TRUE( cache.isEmpty() );
+    EXPECT_FALSE( hasFrame(cache, 1, state) );
+}
+
+TEST(ViewerFlipbookCache,
+     Eviction)
+{
+    ViewerFlipbookCache cache;
+    ViewerFlipbookCache::DisplayState state;
+
+    ///The cache holds 3 frames: inserting a 4th one releases the oldest
+    for (int time = 1; time <= 3; ++time) {
+        cache.insertFrame(time, ViewIdx(0), state, makeFrame(time, state), 3 * FRAME_SIZE);
+    }
+    for (int time = 1; time <= 3; ++time) {
+        EXPECT_TRUE( hasFrame(cache, time, state) ) << "frame " << time;
+    }
+
+    cache.insertFrame(4, ViewIdx(0), state, makeFrame(4, state), 3 * FRAME_SIZE);
+    EXPECT_FALSE( hasFrame(cache, 1, state) );
+    EXPECT_TRUE( hasFrame(cache, 2, state) );
+    EXPECT_TRUE( hasFrame(cache, 3, state) );
+    EXPECT_TRUE( hasFrame(cache, 4, state) );
+
+    ///Frames are released in insertion order, even if they were read since
+    cache.insertFrame(5, ViewIdx(0), state, makeFrame(5, state), 3 * FRAME_SIZE);
+    EXPECT_FALSE( hasFrame(cache, 2, state) );
+    EXPECT_TRUE( hasFrame(cache, 3, state) );
+
+    ///A smaller maximum size releases as many frames as needed
+    cache.insertFrame(6, ViewIdx(0), state, makeFrame(6, state), 2 * FRAME_SIZE);
+    EXPECT_FALSE( hasFrame(cache, 3, state) );
+    EXPECT_FALSE( hasFrame(cache, 4, state) );
+    EXPECT_TRUE( hasFrame(cache, 5, state) );
+    EXPECT_TRUE( hasFrame(cache, 6, state) );
+
+    ///A frame larger than the cache is not stored and does not release anything
+    cache.insertFrame(7, ViewIdx(0), state, makeFrame(7, state), FRAME_SIZE / 2);
+    EXPECT_FALSE( hasFrame(cache, 7, state) );
+    EXPECT_TRUE( hasFrame(cache, 5, state) );
+    EXPECT_TRUE( hasFrame(cache, 6, state) );
+}
+
+TEST(ViewerFlipbookCache,
+     DisplayState)
+{
+    ViewerFlipbookCache cache;
+    ViewerFlipbookCache::DisplayState state;
+
+    cache.insertFrame(1, ViewIdx(0), state, makeFrame(1, state), 10 * FRAME_SIZE);
+    ASSERT_TRUE( hasFrame(cache, 1, state) );
+
+    ///Frames are not returned for another viewer state
+    ViewerFlipbookCache::DisplayState otherState = state;
+    otherState.gain = 2.;
+    EXPECT_FALSE( hasFrame(cache, 1, otherState) );
+    otherState = state;
+    otherState.mipMapLevel = 1;
+    EXPECT_FALSE( hasFrame(cache, 1, otherState) );
+
+    ///Storing a frame with another state releases the frames of the previous one
+    cache.insertFrame(2, ViewIdx(0), otherState, makeFrame(2, otherState), 10 * FRAME_SIZE);
+    EXPECT_TRUE( hasFrame(cache, 2, otherState) );
+    EXPECT_FALSE( hasFrame(cache, 1, otherState) );
+    EXPECT_FALSE( hasFrame(cache, 1, state) );
+
+    ///Textures which do not match the state they are stored with are rejected
+    cache.clear();
+    ViewerFlipbookCache::DisplayState gainState = state;
+    gainState.gain = 2.;
+    cache.insertFrame(1, ViewIdx(0), state, makeFrame(1, gainState), 10 * FRAME_SIZE);
+    EXPECT_TRUE( cache.isEmpty() );
+}
+
+TEST(ViewerFlipbookCache,
+     IncompleteFrames)
+{
+    ViewerFlipbookCache cache;
+    ViewerFlipbookCache::DisplayState state;
+
+    ///Partial rectangles, textures of a paused viewer and tiles without a buffer are not stored
+    BufferableObjectPtrList frames = makeFrame(1, state);
+    boost::dynamic_pointer_cast<UpdateViewerParams>( frames.front() )->isPartialRect = true;
+    cache.insertFrame(1, ViewIdx(0), state, frames, 10 * FRAME_SIZE);
+    EXPECT_TRUE( cache.isEmpty() );
+
+    frames = makeFrame(1, state);
+    boost::dynamic_pointer_cast<UpdateViewerParams>( frames.front() )->isViewerPaused = true;
+    cache.insertFrame(1, ViewIdx(0), state, frames, 10 * FRAME_SIZE);
+    EXPECT_TRUE( cache.isEmpty() );
+
+    frames = makeFrame(1, state);
+    boost::dynamic_pointer_cast<UpdateViewerParams>( frames.front() )->tiles.push_back( UpdateViewerParams::CachedTile() );
+    cache.insertFrame(1, ViewIdx(0), state, frames, 10 * FRAME_SIZE);
+    EXPECT_TRUE( cache.isEmpty() );
+
+    cache.insertFrame( 1, ViewIdx(0), state, BufferableObjectPtrList(), 10 * FRAME_SIZE );
+    EXPECT_TRUE( cache.isEmpty() );
+}